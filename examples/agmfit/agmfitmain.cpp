@@ -15,6 +15,9 @@ int main(int argc, char* argv[]) {
   const TInt RndSeed = Env.GetIfArgPrefixInt("-s:", 0, "Random seed for AGM");
   const TFlt Epsilon = Env.GetIfArgPrefixFlt("-e:", 0, "Edge probability between the nodes that do not share any community (default (0.0): set it to be 1 / N^2)");
   const TInt Coms = Env.GetIfArgPrefixInt("-c:", 0, "Number of communities (0: determine it by AGM)");
+  const TInt Chains = Env.GetIfArgPrefixInt("-ch:", 1, "Number of parallel tempering MCMC chains (1: single chain)");
+  const TFlt MaxTemp = Env.GetIfArgPrefixFlt("-mt:", 10.0, "Temperature of the hottest chain (used if -ch: > 1)");
+  const TStr CheckPointFNm = Env.GetIfArgPrefixStr("-cp:", "", "Checkpoint file name; an existing checkpoint is continued (used if -ch: > 1)");
 
   PUNGraph G = TUNGraph::New();
   TVec<TIntV> CmtyVV;
@@ -63,7 +66,11 @@ int main(int argc, char* argv[]) {
   }
   TAGMFit AGMFit(G, NumComs, RndSeed);
   if (Epsilon > 0) { AGMFit.SetPNoCom(Epsilon);  }
-  AGMFit.RunMCMC(MaxIter, 10);
+  if (Chains > 1) {
+    AGMFit.RunParallelMCMC(Chains, MaxIter, 10, 1000, MaxTemp, CheckPointFNm, MaxIter / 20);
+  } else {
+    AGMFit.RunMCMC(MaxIter, 10);
+  }
   AGMFit.GetCmtyVV(CmtyVV, 0.9999);
 
   TAGMUtil::DumpCmtyVV(OutFPrx + "cmtyvv.txt", CmtyVV, NIDNameH);
@@ -22,6 +22,7 @@ int main(int argc, char* argv[]) {
   const int NumThreads = Env.GetIfArgPrefixInt("-nt:", 4, "Number of threads for parallelization");
   const double StepAlpha = Env.GetIfArgPrefixFlt("-sa:", 0.05, "Alpha for backtracking line search");
   const double StepBeta = Env.GetIfArgPrefixFlt("-sb:", 0.3, "Beta for backtracking line search");
+  const bool Hogwild = Env.GetIfArgPrefixBool("-hw:", false, "Lock-free parallel updates of a dense membership matrix (needs 4*nodes*communities bytes)");
 
 #ifdef USE_OPENMP
   omp_set_num_threads(NumThreads);
@@ -52,7 +53,9 @@ int main(int argc, char* argv[]) {
   }
 
   RAGM.NeighborComInit(OptComs);
-  if (NumThreads == 1 || G->GetEdges() < 1000) {
+  if (Hogwild) {
+    RAGM.MLEGradAscentHogwild(0.0001, 1000, "", StepAlpha, StepBeta);
+  } else if (NumThreads == 1 || G->GetEdges() < 1000) {
     RAGM.MLEGradAscent(0.0001, 1000 * G->GetNodes(), "", StepAlpha, StepBeta);
   } else {
     RAGM.MLEGradAscentParallel(0.0001, 1000, NumThreads, "", StepAlpha, StepBeta);
@@ -10,17 +10,35 @@ int main(int argc, char* argv[]) {
   const TStr MtxNm = Env.GetIfArgPrefixStr("-m:", "0.9 0.5; 0.5 0.1", "Matrix (in Maltab notation)");
   const int NIter = Env.GetIfArgPrefixInt("-i:", 5, "Iterations of Kronecker product");
   const int Seed = Env.GetIfArgPrefixInt("-s:", 0, "Random seed (0 - time seed)");
+  // parsed as a double, so that edge counts beyond 2^31 fit (with -stream)
+  const double Edges = Env.GetIfArgPrefixFlt("-e:", -1, "Number of edges (-1: expected number of edges)");
+  const bool Parallel = Env.GetIfArgPrefixBool("-p:", false, "Parallel generator, the graph does not depend on the number of threads");
+  const bool Stream = Env.GetIfArgPrefixBool("-stream:", false, "Stream sampled edges to the output file, keeps duplicate edges (implies -p)");
+  const bool Binary = Env.GetIfArgPrefixBool("-bin:", false, "Save binary pairs of 32-bit node ids (with -stream)");
 
   TKronMtx SeedMtx = TKronMtx::GetMtx(MtxNm);
   printf("\n*** Seed matrix:\n");
   SeedMtx.Dump();
   printf("\n*** Kronecker:\n");
-  // slow but exact O(n^2) algorightm
-  //PNGraph Graph = TKronMtx::GenKronecker(SeedMtx, NIter, true, Seed); 
-  // fast O(e) approximate algorithm
-  PNGraph Graph = TKronMtx::GenFastKronecker(SeedMtx, NIter, true, Seed); 
-  // save edge list
-  TSnap::SaveEdgeList(Graph, OutFNm, TStr::Fmt("Kronecker Graph: seed matrix [%s]", MtxNm.CStr()));
+  const int64 NEdges = Edges < 0 ? int64(pow(double(SeedMtx.GetMtxSum()), double(NIter))) : int64(Edges);
+  // the parallel generators use Seed as is, so 0 is replaced by a time seed here
+  const int MPSeed = Seed != 0 ? Seed : TRnd(0).GetUniDevInt(1, TInt::Mx-1);
+  if (Parallel || Stream) { printf("Random seed: %d\n", MPSeed); }
+  if (Stream) {
+    // edges go straight to the file, the graph is never built
+    TKronMtx::SaveFastKroneckerMP(OutFNm, SeedMtx, NIter, NEdges, Binary, MPSeed);
+  } else {
+    EAssertR(NEdges <= TInt::Mx, TStr::Fmt("%s edges do not fit in a graph, use -stream:T", TInt::GetStr(NEdges).CStr()));
+    // slow but exact O(n^2) algorightm
+    //PNGraph Graph = TKronMtx::GenKronecker(SeedMtx, NIter, true, Seed); 
+    // fast O(e) approximate algorithm
+    PNGraph Graph;
+    if (Parallel) { Graph = TKronMtx::GenFastKroneckerMP(SeedMtx, NIter, int(NEdges), true, MPSeed); }
+    else if (Edges < 0) { Graph = TKronMtx::GenFastKronecker(SeedMtx, NIter, true, Seed); }
+    else { Graph = TKronMtx::GenFastKronecker(SeedMtx, NIter, int(NEdges), true, Seed); }
+    // save edge list
+    TSnap::SaveEdgeList(Graph, OutFNm, TStr::Fmt("Kronecker Graph: seed matrix [%s]", MtxNm.CStr()));
+  }
   Catch
   printf("\nrun time: %s (%s)\n", ExeTm.GetTmStr(), TSecTm::GetCurTm().GetTmStr().CStr());
   return 0;
@@ -19,6 +19,7 @@ int main(int argc, char* argv[]) {
   const bool Debug = Env.GetIfArgPrefixBool("-debug:", false, "Turns on the debugging option");
   const bool FastEstep = Env.GetIfArgPrefixBool("-fe:", true, "Turns on the fast E-step");
   const bool FastMstep = Env.GetIfArgPrefixBool("-fm:", true, "Turns on the fast M-step");
+  const int NonEdgeSample = Env.GetIfArgPrefixInt("-nes:", 0, "Node pairs sampled for the non-edge term of the debug log-likelihood (0: all pairs)");
   
   if (OutFNm.Empty()) { OutFNm = TStr::Fmt("%s-magfit", InFNm.GetFMid().CStr()); }
   
@@ -45,6 +46,7 @@ int main(int argc, char* argv[]) {
   
   MAGFit.SetAlgConf(FastEstep, FastMstep);
   MAGFit.SetDebug(Debug);
+  MAGFit.SetNonEdgeSample(NonEdgeSample);
   
   MAGFit.DoEMAlg(Nstep, NEstep, NMstep, LrnRate, MaxGrad, Lambda, ReInit);
   MAGFit.SaveTxt(OutFNm);
@@ -36,7 +36,7 @@ int main(int argc, char* argv[]) {
   // count frequency of connected subgraphs in G that have MotifSz nodes
   TD34GraphCounter GraphCounter(MotifSz);
   TSubGraphEnum<TD34GraphCounter> GraphEnum;
-  GraphEnum.GetSubGraphs(G, MotifSz, GraphCounter);
+  GraphEnum.GetSubGraphsMP(G, MotifSz, GraphCounter);
   FILE *F = fopen(TStr::Fmt("%s-counts.tab", OutFNm.CStr()).CStr(), "wt");
   fprintf(F, "MotifId\tNodes\tEdges\tCount\n");
   for (int i = 0; i < GraphCounter.Len(); i++) {
@@ -9,7 +9,7 @@
 void ParseArgs(int& argc, char* argv[], TStr& InFile, TStr& OutFile,
  int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter,
  bool& Verbose, double& ParamP, double& ParamQ, bool& Directed, bool& Weighted,
- bool& OutputWalks) {
+ bool& OutputWalks, int64& MaxExactMem) {
   Env = TEnv(argc, argv, TNotify::StdNotify);
   Env.PrepArgs(TStr::Fmt("\nAn algorithmic framework for representational learning on graphs."));
   InFile = Env.GetIfArgPrefixStr("-i:", "graph/karate.edgelist",
@@ -30,6 +30,8 @@ void ParseArgs(int& argc, char* argv[], TStr& InFile, TStr& OutFile,
    "Return hyperparameter. Default is 1");
   ParamQ = Env.GetIfArgPrefixFlt("-q:", 1,
    "Inout hyperparameter. Default is 1");
+  MaxExactMem = int64(Env.GetIfArgPrefixInt("-mem:", 1024,
+   "Max memory in MB for exact transition tables, rejection sampling above it. Default is 1024")) << 20;
   Verbose = Env.IsArgStr("-v", "Verbose output.");
   Directed = Env.IsArgStr("-dr", "Graph is directed.");
   Weighted = Env.IsArgStr("-w", "Graph is weighted.");
@@ -106,14 +108,15 @@ int main(int argc, char* argv[]) {
   int Dimensions, WalkLen, NumWalks, WinSize, Iter;
   double ParamP, ParamQ;
   bool Directed, Weighted, Verbose, OutputWalks;
+  int64 MaxExactMem;
   ParseArgs(argc, argv, InFile, OutFile, Dimensions, WalkLen, NumWalks, WinSize,
-   Iter, Verbose, ParamP, ParamQ, Directed, Weighted, OutputWalks);
+   Iter, Verbose, ParamP, ParamQ, Directed, Weighted, OutputWalks, MaxExactMem);
   PWNet InNet = PWNet::New();
   TIntFltVH EmbeddingsHV;
   TVVec <TInt, int64> WalksVV;
   ReadGraph(InFile, Directed, Weighted, Verbose, InNet);
   node2vec(InNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, OutputWalks, WalksVV, EmbeddingsHV);
+   Verbose, OutputWalks, WalksVV, EmbeddingsHV, MaxExactMem);
   WriteOutput(OutFile, EmbeddingsHV, WalksVV, OutputWalks);
   return 0;
 }
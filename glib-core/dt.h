@@ -72,6 +72,29 @@ public:
   void SaveTxt(TOLx& Lx) const;
 };
 
+/////////////////////////////////////////////////
+// Counter-Based Random
+// Stream of random numbers determined only by (Seed, Counter), so the
+// Counter-th stream can be created directly (e.g. one stream per generated
+// edge) and parallel code gives the same result for any number of threads.
+// SplitMix64: Weyl sequence started at a hash of (Seed, Counter).
+class TCntRnd{
+private:
+  uint64 State;
+  static uint64 Mix(uint64 Val){
+    Val=(Val^(Val>>30))*0xbf58476d1ce4e5b9ULL;
+    Val=(Val^(Val>>27))*0x94d049bb133111ebULL;
+    return Val^(Val>>31);}
+public:
+  TCntRnd(const uint64& Seed, const uint64& Counter):
+    State(Mix(Mix(Seed)+Counter)){}
+
+  uint64 GetUInt64(){State+=0x9e3779b97f4a7c15ULL; return Mix(State);}
+  double GetUniDev(){return (GetUInt64()>>11)*(1.0/9007199254740992.0);}
+  int GetUniDevInt(const int& Range){
+    IAssert(Range>0); return int((GetUInt64()>>32)*uint64(Range)>>32);}
+};
+
 /////////////////////////////////////////////////
 // Memory
 ClassTP(TMem, PMem)//{
@@ -131,18 +131,42 @@ void TCesna::SetGraph(const PUNGraph& GraphPt, const THash<TInt, TIntV>& NIDAttr
     }
   }
   Attrs = NumAttr;
+  PutAttrCsr();
   InitW();
 }
 
+void TCesna::PutAttrCsr() {
+  int NNZ = 0;
+  for (int u = 0; u < X.Len(); u++) { NNZ += X[u].Len(); }
+  AttrOffV.Gen(X.Len() + 1, 0);
+  AttrIdV.Gen(NNZ, 0);
+  TIntV KIDV;
+  for (int u = 0; u < X.Len(); u++) {
+    AttrOffV.Add(AttrIdV.Len());
+    X[u].GetKeyV(KIDV);
+    KIDV.Sort();
+    AttrIdV.AddV(KIDV);
+  }
+  AttrOffV.Add(AttrIdV.Len());
+}
+
+void TCesna::PutWC() {
+  const int K1 = NumComs + 1;
+  WCV.Gen(int64(K1) * Attrs);
+  for (int k = 0; k < W.Len(); k++) {
+    for (int c = 0; c < K1 && c < W[k].Len(); c++) {
+      WCV[int64(c) * Attrs + k] = W[k][c];
+    }
+  }
+}
+
 double TCesna::Likelihood(const bool _DoParallel) { 
   TExeTm ExeTm;
   double L = 0.0;
   if (_DoParallel) {
-  #pragma omp parallel for 
+  #pragma omp parallel for schedule(dynamic, 64) reduction(+:L)
     for (int u = 0; u < F.Len(); u++) {
-      double LU = LikelihoodForRow(u);
-      #pragma omp atomic
-        L += LU;
+      L += LikelihoodForRow(u);
     }
   }
   else {
@@ -191,9 +215,10 @@ double TCesna::LikelihoodForRow(const int UID, const TIntFltH& FU) {
   }
   L *= (1.0 - WeightAttr);
   // add attribute part
-  for (int k = 0; k < Attrs; k++) {
-    if (HOKIDSV[UID].IsKey(k)) { continue; }
-    L += WeightAttr * LikelihoodAttrKForRow(UID, k, FU);
+  if (WeightAttr > 0.0) {
+    TFltV AttrPredV;
+    PredictAttrForRow(FU, AttrPredV);
+    L += WeightAttr * LikelihoodAttrForRow(UID, AttrPredV);
   }
   return L;
 }
@@ -210,6 +235,163 @@ double TCesna::LikelihoodAttrKForRow(const int UID, const int K, const TIntFltH&
   return L;
 }
 
+static double AttrDot(const double* UV, const double* VV, const int& Len) {
+  double S0 = 0, S1 = 0, S2 = 0, S3 = 0;
+  int k = 0;
+  for (; k + 4 <= Len; k += 4) {
+    S0 += UV[k] * VV[k];  S1 += UV[k+1] * VV[k+1];
+    S2 += UV[k+2] * VV[k+2];  S3 += UV[k+3] * VV[k+3];
+  }
+  for (; k < Len; k++) { S0 += UV[k] * VV[k]; }
+  return (S0 + S2) + (S1 + S3);
+}
+
+static void AttrAxpy(double* YV, const double& A, const double* XV, const int& Len) {
+  for (int k = 0; k < Len; k++) { YV[k] += A * XV[k]; }
+}
+
+/// PredV[k] = P(X_uk = 1 | FU, W) for all attributes k (one pass over W per community of FU)
+void TCesna::PredictAttrForRow(const TIntFltH& FU, TFltV& PredV) {
+  PredV.Gen(Attrs);
+  if (Attrs == 0) { return; }
+  double* ZV = &PredV[0].Val;
+  const double* BiasV = &WCV[int64(NumComs) * Attrs].Val;
+  for (int k = 0; k < Attrs; k++) { ZV[k] = BiasV[k]; }
+  for (TIntFltH::TIter FI = FU.BegI(); FI < FU.EndI(); FI++) {
+    AttrAxpy(ZV, FI.GetDat(), &WCV[int64(FI.GetKey()) * Attrs].Val, Attrs);
+  }
+  for (int k = 0; k < Attrs; k++) { ZV[k] = Sigmoid(ZV[k]); }
+}
+
+/// sum of LikelihoodAttrKForRow(UID, k) over the attributes k not held out, given PredV from PredictAttrForRow
+double TCesna::LikelihoodAttrForRow(const int UID, const TFltV& PredV) {
+  double L = 0.0;
+  for (int k = 0; k < PredV.Len(); k++) {
+    L += PredV[k] == 1.0? -100.0: log(1.0 - PredV[k]);
+  }
+  // correct for X_uk = 1
+  for (int i = AttrOffV[UID]; i < AttrOffV[UID + 1]; i++) {
+    const double Prob = PredV[AttrIdV[i]];
+    L += (Prob == 0.0? -100.0: log(Prob)) - (Prob == 1.0? -100.0: log(1.0 - Prob));
+  }
+  for (int i = 0; i < HOKIDSV[UID].Len(); i++) {
+    const int K = HOKIDSV[UID][i];
+    const double Prob = PredV[K];
+    if (GetAttr(UID, K)) {
+      L -= Prob == 0.0? -100.0: log(Prob);
+    } else {
+      L -= Prob == 1.0? -100.0: log(1.0 - Prob);
+    }
+  }
+  return L;
+}
+
+/// attribute likelihood LV[j] of attributes K0+j (j < Len) over all nodes, with w_ck = WB[c * Stride + k - K0].
+/// If DoGrad, GradWV[c * Len + j] gets the gradient of LV[j] w.r.t. w_ck (without the Lasso term)
+void TCesna::LikelihoodForWBlock(const int K0, const int Len, const double* WB, const int64 Stride, TFltV& LV, TFltV& GradWV, const bool DoGrad) {
+  const int K1 = NumComs + 1;
+  LV.Gen(Len);
+  if (DoGrad) { GradWV.Gen(K1 * Len); }
+  TFltV ZV(Len), XV(Len), MaskV(Len);
+  double* Z = &ZV[0].Val;
+  for (int u = 0; u < F.Len(); u++) {
+    const double* BiasV = WB + int64(NumComs) * Stride;
+    for (int j = 0; j < Len; j++) { Z[j] = BiasV[j]; }
+    for (TIntFltH::TIter FI = F[u].BegI(); FI < F[u].EndI(); FI++) {
+      AttrAxpy(Z, FI.GetDat(), WB + int64(FI.GetKey()) * Stride, Len);
+    }
+    XV.PutAll(0.0);
+    for (int i = AttrOffV[u]; i < AttrOffV[u + 1]; i++) {
+      const int K = AttrIdV[i];
+      if (K < K0) { continue; }
+      if (K >= K0 + Len) { break; }
+      XV[K - K0] = 1.0;
+    }
+    MaskV.PutAll(1.0);
+    for (int i = 0; i < HOKIDSV[u].Len(); i++) {
+      const int K = HOKIDSV[u][i];
+      if (K >= K0 && K < K0 + Len) { MaskV[K - K0] = 0.0; }
+    }
+    for (int j = 0; j < Len; j++) {
+      if (MaskV[j] == 0.0) { Z[j] = 0.0; continue; }
+      const double Prob = Sigmoid(Z[j]);
+      if (XV[j] > 0.0) {
+        LV[j] += Prob == 0.0? -100.0: log(Prob);
+      } else {
+        LV[j] += Prob == 1.0? -100.0: log(1.0 - Prob);
+      }
+      Z[j] = XV[j] - Prob;
+    }
+    if (! DoGrad) { continue; }
+    for (TIntFltH::TIter FI = F[u].BegI(); FI < F[u].EndI(); FI++) {
+      AttrAxpy(&GradWV[FI.GetKey() * Len].Val, FI.GetDat(), Z, Len);
+    }
+    AttrAxpy(&GradWV[NumComs * Len].Val, 1.0, Z, Len);
+  }
+}
+
+/// one gradient step with backtracking line search for every W[k] (same steps as GradientForWK and GetStepSizeByLineSearchForWK).
+/// Attributes are processed in blocks, each thread accumulates the gradient of its block in one pass over the nodes
+void TCesna::MLEGradAscentForW(const double& StepAlpha, const double& StepBeta, const int MaxIter) {
+  const int K1 = NumComs + 1;
+  const int BlockSz = 256;
+  const int Blocks = (Attrs + BlockSz - 1) / BlockSz;
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int b = 0; b < Blocks; b++) {
+    const int K0 = b * BlockSz;
+    const int Len = TMath::Mn(BlockSz, Attrs - K0);
+    TFltV InitLV, NewLV, GradWV, TmpV;
+    LikelihoodForWBlock(K0, Len, &WCV[K0].Val, Attrs, InitLV, GradWV, true);
+    TFltV NewWV(K1 * Len), StepV(Len), GradNormV(Len);
+    TIntV StateV(Len); // 0: no update, 1: line search, 2: step found
+    for (int j = 0; j < Len; j++) {
+      const int K = K0 + j;
+      for (int c = 0; c < NumComs; c++) {
+        GradWV[c * Len + j] -= LassoCoef * TMath::Sign(GetW(c, K));
+        InitLV[j] -= LassoCoef * fabs(GetW(c, K));
+      }
+      for (int c = 0; c < K1; c++) { GradNormV[j] += GradWV[c * Len + j] * GradWV[c * Len + j]; }
+      StepV[j] = 1.0;
+      StateV[j] = GradNormV[j] < 1e-4? 0: 1;
+    }
+    for (int iter = 0; iter < MaxIter; iter++) {
+      int Pending = 0;
+      for (int j = 0; j < Len; j++) {
+        const int K = K0 + j;
+        for (int c = 0; c < K1; c++) {
+          double NewVal = W[K][c];
+          if (StateV[j] == 1) { NewVal += StepV[j] * GradWV[c * Len + j]; Pending++; }
+          if (NewVal < MinValW) { NewVal = MinValW; }
+          if (NewVal > MaxValW) { NewVal = MaxValW; }
+          NewWV[c * Len + j] = NewVal;
+        }
+      }
+      if (Pending == 0) { break; }
+      LikelihoodForWBlock(K0, Len, &NewWV[0].Val, Len, NewLV, TmpV, false);
+      for (int j = 0; j < Len; j++) {
+        if (StateV[j] != 1) { continue; }
+        for (int c = 0; c < NumComs; c++) { NewLV[j] -= LassoCoef * fabs(NewWV[c * Len + j]); }
+        if (NewLV[j] < InitLV[j] + StepAlpha * StepV[j] * GradNormV[j]) {
+          StepV[j] *= StepBeta;
+          if (iter == MaxIter - 1) { StateV[j] = 0; }
+        } else {
+          StateV[j] = 2;
+        }
+      }
+    }
+    for (int j = 0; j < Len; j++) {
+      if (StateV[j] != 2) { continue; }
+      const int K = K0 + j;
+      for (int c = 0; c < K1; c++) {
+        W[K][c] += StepV[j] * GradWV[c * Len + j];
+        if (W[K][c] < MinValW) { W[K][c] = MinValW; }
+        if (W[K][c] > MaxValW) { W[K][c] = MaxValW; }
+        WCV[int64(c) * Attrs + K] = W[K][c];
+      }
+    }
+  }
+}
+
 void TCesna::GradientForRow(const int UID, TIntFltH& GradU, const TIntSet& CIDSet) {
   GradU.Gen(CIDSet.Len());
   TFltV HOSumFV; //adjust for Fv of v hold out
@@ -260,16 +442,15 @@ void TCesna::GradientForRow(const int UID, TIntFltH& GradU, const TIntSet& CIDSe
   for (int c = 0; c < GradV.Len(); c++) {
     GradV[c] *= (1.0 - WeightAttr);
   }
-  //add attribute part
-  TFltV AttrPredV(Attrs);
-  for (int k = 0; k < Attrs; k++) {
-    if (HOKIDSV[UID].IsKey(k)) { continue; }
-    AttrPredV[k] = PredictAttrK(F[UID], W[k]);
-  }
-  for (int c = 0; c < GradV.Len(); c++) {
-    for (int k = 0; k < Attrs; k++) {
-      if (HOKIDSV[UID].IsKey(k)) { continue; }
-      GradV[c] += WeightAttr * (GetAttr(UID, k) - AttrPredV[k]) * GetW(CIDV[c], k);
+  //add attribute part: GradV[c] += WeightAttr * sum_k (X_uk - P_uk) * w_ck
+  if (WeightAttr > 0.0 && Attrs > 0) {
+    TFltV ResV;
+    PredictAttrForRow(F[UID], ResV);
+    for (int k = 0; k < Attrs; k++) { ResV[k] = - ResV[k]; }
+    for (int i = AttrOffV[UID]; i < AttrOffV[UID + 1]; i++) { ResV[AttrIdV[i]] += 1.0; }
+    for (int i = 0; i < HOKIDSV[UID].Len(); i++) { ResV[HOKIDSV[UID][i]] = 0.0; }
+    for (int c = 0; c < GradV.Len(); c++) {
+      GradV[c] += WeightAttr * AttrDot(&ResV[0].Val, &WCV[int64(CIDV[c]) * Attrs].Val, Attrs);
     }
   }
 
@@ -557,18 +738,7 @@ int TCesna::MLEGradAscent(const double& Thres, const int& MaxIter, const TStr Pl
       }
     }
     // fit W (logistic regression)
-    for (int k = 0; k < Attrs; k++) {
-      TFltV GradWV(NumComs);
-      GradientForWK(GradWV, k);
-      if (TLinAlg::Norm2(GradWV) < 1e-4) { continue; }
-      double LearnRate = GetStepSizeByLineSearchForWK(k, GradWV, GradWV, StepAlpha, StepBeta);
-      if (LearnRate == 0.0) { continue; }
-      for (int c = 0; c < GradWV.Len(); c++){
-        W[k][c] += LearnRate * GradWV[c];
-        if (W[k][c] < MinValW) { W[k][c] = MinValW; }
-        if (W[k][c] > MaxValW) { W[k][c] = MaxValW; }
-      }
-    }
+    MLEGradAscentForW(StepAlpha, StepBeta);
     printf("\r%d iterations (%f) [%lu sec]", iter, CurL, time(NULL) - InitTime);
     fflush(stdout);
     if (iter - PrevIter >= 2 * G->GetNodes() && iter > 10000) {
@@ -613,54 +783,52 @@ int TCesna::MLEGradAscentParallel(const double& Thres, const int& MaxIter, const
     }
     IAssert (NIdxV.Len() <= F.Len());
     NIdxV.Shuffle(Rnd);
-    // compute gradient for chunk of nodes
-#pragma omp parallel for schedule(static, 1)
-    for (int TIdx = 0; TIdx < ChunkNum; TIdx++) {
+    // compute gradient for the batch of nodes (rows are independent, read F and write NewF)
+#pragma omp parallel for schedule(dynamic, 8)
+    for (int ui = 0; ui < ChunkNum * ChunkSize; ui++) {
       TIntFltH GradV;
-      for (int ui = TIdx * ChunkSize; ui < (TIdx + 1) * ChunkSize; ui++) {
-        NewNIDV[ui] = -1;
-        if (ui >= NIdxV.Len()) { continue; }
-        int u = NIdxV[ui]; //
-        //find set of candidate c (we only need to consider c to which a neighbor of u belongs to)
-        TUNGraph::TNodeI UI = G->GetNI(u);
-        TIntSet CIDSet(5 * UI.GetDeg());
-        TIntFltH CurFU = F[u];
-        for (int e = 0; e < UI.GetDeg(); e++) {
-          if (HOVIDSV[u].IsKey(UI.GetNbrNId(e))) { continue; }
-          TIntFltH& NbhCIDH = F[UI.GetNbrNId(e)];
-          for (TIntFltH::TIter CI = NbhCIDH.BegI(); CI < NbhCIDH.EndI(); CI++) {
-            CIDSet.AddKey(CI.GetKey());
-          }
-        }
-        if (CIDSet.Empty()) { 
-          CurFU.Clr();
+      NewNIDV[ui] = -1;
+      if (ui >= NIdxV.Len()) { continue; }
+      int u = NIdxV[ui]; //
+      //find set of candidate c (we only need to consider c to which a neighbor of u belongs to)
+      TUNGraph::TNodeI UI = G->GetNI(u);
+      TIntSet CIDSet(5 * UI.GetDeg());
+      TIntFltH CurFU = F[u];
+      for (int e = 0; e < UI.GetDeg(); e++) {
+        if (HOVIDSV[u].IsKey(UI.GetNbrNId(e))) { continue; }
+        TIntFltH& NbhCIDH = F[UI.GetNbrNId(e)];
+        for (TIntFltH::TIter CI = NbhCIDH.BegI(); CI < NbhCIDH.EndI(); CI++) {
+          CIDSet.AddKey(CI.GetKey());
         }
-        else {
-          for (TIntFltH::TIter CI = CurFU.BegI(); CI < CurFU.EndI(); CI++) { //remove the community membership which U does not share with its neighbors
-            if (! CIDSet.IsKey(CI.GetKey())) {
-              CurFU.DelIfKey(CI.GetKey());
-            }
+      }
+      if (CIDSet.Empty()) { 
+        CurFU.Clr();
+      }
+      else {
+        for (TIntFltH::TIter CI = CurFU.BegI(); CI < CurFU.EndI(); CI++) { //remove the community membership which U does not share with its neighbors
+          if (! CIDSet.IsKey(CI.GetKey())) {
+            CurFU.DelIfKey(CI.GetKey());
           }
-          GradientForRow(u, GradV, CIDSet);
-          if (Norm2(GradV) < 1e-4) { NIDOPTV[u] = 1; continue; }
-          double LearnRate = GetStepSizeByLineSearch(u, GradV, GradV, StepAlpha, StepBeta);
-          if (LearnRate == 0.0) { NewNIDV[ui] = -2; continue; }
-          for (int ci = 0; ci < GradV.Len(); ci++) {
-            int CID = GradV.GetKey(ci);
-            double Change = LearnRate * GradV.GetDat(CID);
-            double NewFuc = CurFU.IsKey(CID)? CurFU.GetDat(CID) + Change : Change;
-            if (NewFuc <= 0.0) {
-              CurFU.DelIfKey(CID);
-            } else {
-              CurFU.AddDat(CID) = NewFuc;
-            }
+        }
+        GradientForRow(u, GradV, CIDSet);
+        if (Norm2(GradV) < 1e-4) { NIDOPTV[u] = 1; continue; }
+        double LearnRate = GetStepSizeByLineSearch(u, GradV, GradV, StepAlpha, StepBeta);
+        if (LearnRate == 0.0) { NewNIDV[ui] = -2; continue; }
+        for (int ci = 0; ci < GradV.Len(); ci++) {
+          int CID = GradV.GetKey(ci);
+          double Change = LearnRate * GradV.GetDat(CID);
+          double NewFuc = CurFU.IsKey(CID)? CurFU.GetDat(CID) + Change : Change;
+          if (NewFuc <= 0.0) {
+            CurFU.DelIfKey(CID);
+          } else {
+            CurFU.AddDat(CID) = NewFuc;
           }
-          CurFU.Defrag();
         }
-        //store changes
-        NewF[ui] = CurFU;
-        NewNIDV[ui] = u;
+        CurFU.Defrag();
       }
+      //store changes
+      NewF[ui] = CurFU;
+      NewNIDV[ui] = u;
     }
     int NumNoChangeGrad = 0;
     int NumNoChangeStepSize = 0;
@@ -704,19 +872,7 @@ int TCesna::MLEGradAscentParallel(const double& Thres, const int& MaxIter, const
       fflush(stdout);
     }
     if (iter == 0 || (iter - PrevIter) * ChunkSize * ChunkNum >= G->GetNodes()) {
-  #pragma omp parallel for
-      for (int k = 0; k < Attrs; k++) {
-        TFltV GradWV(NumComs);
-        GradientForWK(GradWV, k);
-        if (TLinAlg::Norm2(GradWV) < 1e-4) { continue; }
-        double LearnRate = GetStepSizeByLineSearchForWK(k, GradWV, GradWV, StepAlpha, StepBeta);
-        if (LearnRate == 0.0) { continue; }
-        for (int c = 0; c < GradWV.Len(); c++){
-          W[k][c] += LearnRate * GradWV[c];
-          if (W[k][c] < MinValW) { W[k][c] = MinValW; }
-          if (W[k][c] > MaxValW) { W[k][c] = MaxValW; }
-        }
-      }
+      MLEGradAscentForW(StepAlpha, StepBeta);
       PrevIter = iter;
       double CurL = Likelihood(true);
       IterLV.Add(TIntFltPr(iter * ChunkSize * ChunkNum, CurL));
@@ -257,6 +257,9 @@ private:
   TInt NumComs; // number of communities
   TVec<TIntSet> HOVIDSV; //NID pairs to hold out for cross validation
   TVec<TIntSet> HOKIDSV; //set of attribute index (k) to hold out
+  TIntV AttrOffV; // X in CSR form: attributes of u are AttrIdV[AttrOffV[u]..AttrOffV[u+1]-1] (sorted)
+  TIntV AttrIdV;
+  TVec<TFlt, int64> WCV; // copy of W stored community-major: w_ck = WCV[c * Attrs + k], c = NumComs is the bias
 public:
   TFlt MinVal; // minimum value of F (0)
   TFlt MaxVal; // maximum value of F (for numerical reason)
@@ -310,6 +313,8 @@ public:
     MaxValW.Load(SIn);
     NegWgt.Load(SIn);
     PNoCom.Load(SIn);
+    PutAttrCsr();
+    PutWC();
   }
 
   void SetGraph(const PUNGraph& GraphPt, const THash<TInt, TIntV>& NIDAttrH);
@@ -333,6 +338,7 @@ public:
     for (int k = 0; k < Attrs; k++) {
       W[k].Gen(NumComs + 1);
     }
+    PutWC();
   }
   void SetAttrHoldOut(const int NID, const int KID) {
     int NIdx = NIDToIdx.GetKeyId(NID);
@@ -344,7 +350,9 @@ public:
     }
   }
   void GetW(TVec<TFltV>& _W) { _W = W; }
-  void SetW(TVec<TFltV>& _W) { W = _W; }
+  void SetW(TVec<TFltV>& _W) { W = _W; PutWC(); }
+  void PutAttrCsr();
+  void PutWC();
   void RandomInit(const int InitComs);
   void NeighborComInit(const int InitComs);
   void NeighborComInit(TFltIntPrV& NIdPhiV, const int InitComs);
@@ -356,6 +364,9 @@ public:
   double LikelihoodAttrKForRow(const int UID, const int K) { return LikelihoodAttrKForRow(UID, K, F[UID]); }
   double LikelihoodAttrKForRow(const int UID, const int K, const TIntFltH& FU) { return LikelihoodAttrKForRow(UID, K, FU, W[K]); }
   double LikelihoodAttrKForRow(const int UID, const int K, const TIntFltH& FU, const TFltV& WK);
+  void PredictAttrForRow(const TIntFltH& FU, TFltV& PredV);
+  double LikelihoodAttrForRow(const int UID, const TFltV& PredV);
+  void LikelihoodForWBlock(const int K0, const int Len, const double* WB, const int64 Stride, TFltV& LV, TFltV& GradWV, const bool DoGrad);
   double LikelihoodForWK(const int K, const TFltV& WK) {
     double L = 0.0;
     for (int u = 0; u < F.Len(); u++) {
@@ -516,6 +527,7 @@ public:
     }
     return PosCnt;
   }
+  void MLEGradAscentForW(const double& StepAlpha, const double& StepBeta, const int MaxIter = 10);
   int MLEGradAscent(const double& Thres, const int& MaxIter, const TStr PlotNm, const double StepAlpha = 0.3, const double StepBeta = 0.1);
   int MLEGradAscentParallel(const double& Thres, const int& MaxIter, const int ChunkNum, const int ChunkSize, const TStr PlotNm, const double StepAlpha = 0.3, const double StepBeta = 0.1);
   int MLEGradAscentParallel(const double& Thres, const int& MaxIter, const int ChunkNum, const TStr PlotNm = TStr(), const double StepAlpha = 0.3, const double StepBeta = 0.1) {
@@ -892,3 +892,240 @@ int TAGMFast::MLEGradAscentParallel(const double& Thres, const int& MaxIter, con
   }
   return iter;
 }
+
+/////////////////////////////////////////////////
+// Dense F with lock-free (Hogwild) parallel updates
+
+// the kernels below work on contiguous float rows, the compiler vectorizes the loops
+// (dot products keep 8 partial sums so that they vectorize without reassociating)
+static double DenseDot(const float* UV, const float* VV, const int& Len) {
+  float S0 = 0, S1 = 0, S2 = 0, S3 = 0, S4 = 0, S5 = 0, S6 = 0, S7 = 0;
+  int c = 0;
+  for (; c + 8 <= Len; c += 8) {
+    S0 += UV[c] * VV[c];  S1 += UV[c+1] * VV[c+1];
+    S2 += UV[c+2] * VV[c+2];  S3 += UV[c+3] * VV[c+3];
+    S4 += UV[c+4] * VV[c+4];  S5 += UV[c+5] * VV[c+5];
+    S6 += UV[c+6] * VV[c+6];  S7 += UV[c+7] * VV[c+7];
+  }
+  double DP = double(S0 + S4) + double(S1 + S5) + double(S2 + S6) + double(S3 + S7);
+  for (; c < Len; c++) { DP += UV[c] * VV[c]; }
+  return DP;
+}
+
+static void DenseAxpy(float* YV, const double& A, const float* XV, const int& Len) {
+  const float FA = float(A);
+  for (int c = 0; c < Len; c++) { YV[c] += FA * XV[c]; }
+}
+
+void TAGMFast::PutDenseF() {
+  const int Coms = NumComs;
+  DenseFV.Gen(int64(F.Len()) * Coms);
+  for (int u = 0; u < F.Len(); u++) {
+    float* FU = GetDenseRow(u);
+    for (TIntFltH::TIter HI = F[u].BegI(); HI < F[u].EndI(); HI++) {
+      FU[HI.GetKey()] = float(HI.GetDat());
+    }
+  }
+}
+
+void TAGMFast::GetDenseF() {
+  const int Coms = NumComs;
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < F.Len(); u++) {
+    const float* FU = GetDenseRow(u);
+    F[u].Clr();
+    for (int c = 0; c < Coms; c++) {
+      if (FU[c] > 0.0) { F[u].AddDat(c, FU[c]); }
+    }
+  }
+  GetDenseSumF();
+  DenseFV.Clr();
+}
+
+// recomputes SumFV from the dense rows (the Hogwild updates of SumFV are not exact)
+void TAGMFast::GetDenseSumF() {
+  const int Coms = NumComs;
+  SumFV.Gen(Coms);
+  #pragma omp parallel
+  {
+    TFltV ThreadSumV(Coms);
+    #pragma omp for schedule(static)
+    for (int u = 0; u < F.Len(); u++) {
+      const float* FU = GetDenseRow(u);
+      for (int c = 0; c < Coms; c++) { ThreadSumV[c] += FU[c]; }
+    }
+    #pragma omp critical
+    {
+      for (int c = 0; c < Coms; c++) { SumFV[c] += ThreadSumV[c]; }
+    }
+  }
+}
+
+double TAGMFast::DenseLikelihood() {
+  const int Coms = NumComs;
+  double L = 0.0;
+  #pragma omp parallel
+  {
+    TVec<TSFlt> NegFV(Coms);
+    #pragma omp for schedule(dynamic, 1000) reduction(+:L)
+    for (int u = 0; u < F.Len(); u++) {
+      const float* FU = GetDenseRow(u);
+      for (int c = 0; c < Coms; c++) { NegFV[c] = float(SumFV[c] - FU[c]); }
+      for (int e = 0; e < HOVIDSV[u].Len(); e++) {
+        DenseAxpy(&NegFV[0].Val, -1.0, GetDenseRow(HOVIDSV[u][e]), Coms); }
+      L += DenseLikelihoodForRow(u, FU, &NegFV[0].Val);
+    }
+  }
+  return L;
+}
+
+/// likelihood of row FU of node UID, NegFV holds sum_{v not u, not held out} F_v
+double TAGMFast::DenseLikelihoodForRow(const int UID, const float* FU, const float* NegFV) {
+  const int Coms = NumComs;
+  const double LogNoCom = log(1.0 / (1.0 - PNoCom));
+  double L = 0.0;
+  TUNGraph::TNodeI NI = G->GetNI(UID);
+  for (int e = 0; e < NI.GetDeg(); e++) {
+    const int v = NI.GetNbrNId(e);
+    if (v == UID) { continue; }
+    if (HOVIDSV[UID].IsKey(v)) { continue; }
+    const double DP = DenseDot(FU, GetDenseRow(v), Coms);
+    L += log(1.0 - exp(- LogNoCom - DP)) + NegWgt * DP;
+  }
+  L -= NegWgt * DenseDot(FU, NegFV, Coms);
+  //add regularization
+  if (RegCoef > 0.0) { //L1
+    double Sum = 0.0;
+    for (int c = 0; c < Coms; c++) { Sum += FU[c]; }
+    L -= RegCoef * Sum;
+  }
+  if (RegCoef < 0.0) { //L2
+    L += RegCoef * DenseDot(FU, FU, Coms);
+  }
+  return L;
+}
+
+/// one projected gradient step with backtracking line search on the row of UID, writes the row in place.
+/// Returns 0 if the gradient vanishes, 1 if the row changed and 2 if the line search found no step.
+int TAGMFast::DenseUpdateRow(const int UID, const double& StepAlpha, const double& StepBeta, TFltV& WgtV, TVec<TSFlt>& BufV) {
+  const int Coms = NumComs;
+  const double LogNoCom = log(1.0 / (1.0 - PNoCom));
+  float* FU = GetDenseRow(UID);
+  float* NbrFV = &BufV[0].Val;      // sum of the rows of the neighbors
+  float* NegFV = &BufV[Coms].Val;   // sum of the rows of the non-neighbors
+  float* GradV = &BufV[2*Coms].Val;
+  float* NewFV = &BufV[3*Coms].Val;
+  TUNGraph::TNodeI NI = G->GetNI(UID);
+  const int Deg = NI.GetDeg();
+  for (int c = 0; c < Coms; c++) { NbrFV[c] = 0;  GradV[c] = 0; }
+  WgtV.Gen(Deg);
+  for (int e = 0; e < Deg; e++) {
+    const int v = NI.GetNbrNId(e);
+    if (v == UID || HOVIDSV[UID].IsKey(v)) { WgtV[e] = -1;  continue; }
+    const float* FV = GetDenseRow(v);
+    const double Pred = exp(- LogNoCom - DenseDot(FU, FV, Coms));
+    WgtV[e] = Pred / (1.0 - Pred) + NegWgt;
+    DenseAxpy(NbrFV, 1.0, FV, Coms);
+    DenseAxpy(GradV, WgtV[e], FV, Coms);
+  }
+  for (int c = 0; c < Coms; c++) { NegFV[c] = float(SumFV[c] - FU[c]); }
+  for (int e = 0; e < HOVIDSV[UID].Len(); e++) {
+    DenseAxpy(NegFV, -1.0, GetDenseRow(HOVIDSV[UID][e]), Coms); }
+  // only communities of the neighbors are candidates, the node leaves the others
+  double GradNorm2 = 0.0;
+  for (int c = 0; c < Coms; c++) {
+    if (NbrFV[c] <= 0.0) { GradV[c] = 0;  continue; }
+    double Grad = GradV[c] - NegWgt * NegFV[c];
+    if (RegCoef > 0.0) { Grad -= RegCoef; } //L1
+    if (RegCoef < 0.0) { Grad += 2 * RegCoef * FU[c]; } //L2
+    if ((FU[c] == 0.0 && Grad < 0.0) || fabs(Grad) < 0.0001) { Grad = 0.0; }
+    if (Grad >= 10) { Grad = 10; }
+    if (Grad <= -10) { Grad = -10; }
+    GradV[c] = float(Grad);
+    GradNorm2 += Grad * Grad;
+  }
+  if (GradNorm2 < 1e-4) { return 0; }
+  // backtracking line search
+  const double InitL = DenseLikelihoodForRow(UID, FU, NegFV);
+  double StepSize = 1.0;
+  const int MaxIter = 5;
+  for (int iter = 0; iter < MaxIter; iter++) {
+    for (int c = 0; c < Coms; c++) {
+      float NewVal = NbrFV[c] <= 0.0 ? 0.0f : FU[c] + float(StepSize) * GradV[c];
+      if (NewVal < MinVal) { NewVal = float(MinVal); }
+      if (NewVal > MaxVal) { NewVal = float(MaxVal); }
+      NewFV[c] = NewVal;
+    }
+    if (DenseLikelihoodForRow(UID, NewFV, NegFV) < InitL + StepAlpha * StepSize * GradNorm2) {
+      StepSize *= StepBeta;
+    } else {
+      break;
+    }
+    if (iter == MaxIter - 1) { return 2; }
+  }
+  // write the row without locking, other threads may read it meanwhile
+  for (int c = 0; c < Coms; c++) {
+    const float NewVal = NewFV[c] <= 0.0 ? 0.0f : NewFV[c];
+    if (NewVal == FU[c]) { continue; }
+    const double Change = NewVal - FU[c];
+    FU[c] = NewVal;
+    #pragma omp atomic
+    SumFV[c].Val += Change;
+  }
+  return 1;
+}
+
+/// Gradient ascent on a dense row-major float copy of F. Threads update the rows in place without locks (Hogwild).
+/// A node is skipped until one of its neighbors changes once its gradient vanishes.
+int TAGMFast::MLEGradAscentHogwild(const double& Thres, const int& MaxIter, const TStr& PlotNm, const double StepAlpha, const double StepBeta) {
+  time_t InitTime = time(NULL);
+  TExeTm ExeTm;
+  const int Coms = NumComs;
+  printf("dense F: %d x %d (%.1f MB)\n", F.Len(), Coms, double(F.Len()) * Coms * sizeof(TSFlt) / double(Mega(1)));
+  PutDenseF();
+  GetDenseSumF();
+  double PrevL = DenseLikelihood();
+  TIntFltPrV IterLV;
+  TIntV NIdxV(F.Len(), 0);
+  TIntV NIDOPTV(F.Len()); //check if a node needs optimization or not 1: does not require optimization
+  NIDOPTV.PutAll(0);
+  int iter = 0;
+  for (iter = 0; iter < MaxIter; iter++) {
+    NIdxV.Clr(false);
+    for (int i = 0; i < F.Len(); i++) { 
+      if (NIDOPTV[i] == 0) {  NIdxV.Add(i); }
+    }
+    NIdxV.Shuffle(Rnd);
+    int NumNoChangeGrad = 0, NumNoChangeStepSize = 0;
+    #pragma omp parallel reduction(+:NumNoChangeGrad, NumNoChangeStepSize)
+    {
+      TFltV WgtV;
+      TVec<TSFlt> BufV(4 * Coms);
+      #pragma omp for schedule(dynamic, 64)
+      for (int ui = 0; ui < NIdxV.Len(); ui++) {
+        const int u = NIdxV[ui];
+        const int Status = DenseUpdateRow(u, StepAlpha, StepBeta, WgtV, BufV);
+        if (Status == 0) { NIDOPTV[u] = 1;  NumNoChangeGrad++;  continue; }
+        if (Status == 2) { NumNoChangeStepSize++;  continue; }
+        // the neighbors have to be looked at again
+        TUNGraph::TNodeI UI = G->GetNI(u);
+        for (int e = 0; e < UI.GetDeg(); e++) {
+          NIDOPTV[UI.GetNbrNId(e)] = 0;
+        }
+      }
+    }
+    GetDenseSumF();
+    const double CurL = DenseLikelihood();
+    IterLV.Add(TIntFltPr(iter, CurL));
+    printf("\r%d iterations, Likelihood: %f, Diff: %f, %d g %d s [%d secs]", iter, CurL, CurL - PrevL, NumNoChangeGrad, NumNoChangeStepSize, int(time(NULL) - InitTime));
+    fflush(stdout);
+    if (CurL - PrevL <= Thres * fabs(PrevL)) { break; }
+    PrevL = CurL;
+  }
+  GetDenseF();
+  printf("\nMLE completed with %d iterations(%s)\n", iter, ExeTm.GetTmStr());
+  if (! PlotNm.Empty()) {
+    TGnuPlot::PlotValV(IterLV, PlotNm + ".likelihood_Q");
+  }
+  return iter;
+}
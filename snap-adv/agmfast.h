@@ -14,6 +14,7 @@ private:
   TFltV SumFV; // sum_u F_uc for each community c. Needed for efficient calculation
   TBool NodesOk; // Node ID is from 0 ~ N-1
   TInt NumComs; // number of communities
+  TVec<TSFlt, int64> DenseFV; // F as a row-major Nodes * NumComs matrix (only while MLEGradAscentHogwild() runs)
 public:
   TVec<TIntSet> HOVIDSV; //NID pairs to hold out for cross validation
   TFlt MinVal; // minimum value of F (0)
@@ -51,6 +52,7 @@ public:
     if (ChunkSize == 0) { ChunkSize = 1; }
     return MLEGradAscentParallel(Thres, MaxIter, ChunkNum, ChunkSize, PlotNm, StepAlpha, StepBeta);
   }
+  int MLEGradAscentHogwild(const double& Thres, const int& MaxIter, const TStr& PlotNm = TStr(), const double StepAlpha = 0.3, const double StepBeta = 0.1);
   //double FindOptimalThres(const TVec<TIntV>& TrueCmtyVV, TVec<TIntV>& CmtyVV);
   void Save(TSOut& SOut);
   void Load(TSIn& SIn, const int& RndSeed = 0);
@@ -117,6 +119,14 @@ public:
     }
     return N;
   }
+private:
+  float* GetDenseRow(const int& UID) { return &DenseFV[int64(UID) * NumComs].Val; }
+  void PutDenseF();
+  void GetDenseF();
+  void GetDenseSumF();
+  double DenseLikelihood();
+  double DenseLikelihoodForRow(const int UID, const float* FU, const float* NegFV);
+  int DenseUpdateRow(const int UID, const double& StepAlpha, const double& StepBeta, TFltV& WgtV, TVec<TSFlt>& BufV);
 };
 
 
@@ -7,6 +7,17 @@
 
 void TAGMFit::Save(TSOut& SOut) {
   G->Save(SOut);
+  SaveState(SOut);
+}
+
+void TAGMFit::Load(TSIn& SIn, const int& RndSeed) {
+  G = TUNGraph::Load(SIn);
+  LoadState(SIn);
+  Rnd.PutSeed(RndSeed);
+}
+
+// Save everything except the graph.
+void TAGMFit::SaveState(TSOut& SOut) {
   CIDNSetV.Save(SOut);
   EdgeComVH.Save(SOut);
   NIDComVH.Save(SOut);
@@ -21,8 +32,7 @@ void TAGMFit::Save(TSOut& SOut) {
   BaseCID.Save(SOut);
 }
 
-void TAGMFit::Load(TSIn& SIn, const int& RndSeed) {
-  G = TUNGraph::Load(SIn);
+void TAGMFit::LoadState(TSIn& SIn) {
   CIDNSetV.Load(SIn);
   EdgeComVH.Load(SIn);
   NIDComVH.Load(SIn);
@@ -35,7 +45,9 @@ void TAGMFit::Load(TSIn& SIn, const int& RndSeed) {
   MaxLambda.Load(SIn);
   RegCoef.Load(SIn);
   BaseCID.Load(SIn);
-  Rnd.PutSeed(RndSeed);
+  ComSetOk = false;
+  InitEdgeCache();
+  UpdateEdgeLambdaSum();
 }
 
 // Randomly initialize bipartite community affiliation graph.
@@ -66,6 +78,78 @@ void TAGMFit::GetEdgeJointCom() {
     }
   }
   IAssert(EdgeComVH.Len() == G->GetEdges());
+  ComSetOk = false;
+  InitEdgeCache();
+}
+
+void TAGMFit::InitEdgeCache() {
+  NbrOffV.Gen(NIDComVH.Len() + 1, 0);
+  NbrEIdV.Gen(2 * EdgeComVH.Len(), 0);
+  for (int u = 0; u < NIDComVH.Len(); u++) {
+    const int NID = NIDComVH.GetKey(u);
+    NbrOffV.Add(NbrEIdV.Len());
+    TUNGraph::TNodeI NI = G->GetNI(NID);
+    for (int e = 0; e < NI.GetDeg(); e++) {
+      const int VID = NI.GetNbrNId(e);
+      const int EId = EdgeComVH.GetKeyId(TIntPr(TMath::Mn(NID, VID), TMath::Mx(NID, VID)));
+      IAssert(EId != -1);
+      NbrEIdV.Add(EId);
+    }
+  }
+  NbrOffV.Add(NbrEIdV.Len());
+}
+
+void TAGMFit::GetComSets() {
+  THash<TIntV, TInt> SetIdH(ComSetCntV.Len()); // the previous number of sets is a good size estimate
+  TIntV ComV, SingleSetV(CIDNSetV.Len());
+  SingleSetV.PutAll(-1);
+  int EmptySet = -1;
+  ComSetOffV.Gen(0);
+  ComSetIdV.Gen(0);
+  ComSetCntV.Gen(0);
+  EdgeComSetV.Gen(EdgeComVH.Len());
+  for (int e = 0; e < EdgeComVH.Len(); e++) {
+    ComV.Clr(false);
+    for (TIntSet::TIter SI = EdgeComVH[e].BegI(); SI < EdgeComVH[e].EndI(); SI++) { ComV.Add(SI.GetKey()); }
+    int SetId = -1;
+    // empty and single community sets are the most common, look them up without hashing
+    if (ComV.Len() == 0) {
+      if (EmptySet == -1) { EmptySet = ComSetCntV.Len(); }
+      SetId = EmptySet;
+    } else if (ComV.Len() == 1) {
+      if (SingleSetV[ComV[0]] == -1) { SingleSetV[ComV[0]] = ComSetCntV.Len(); }
+      SetId = SingleSetV[ComV[0]];
+    } else {
+      ComV.ISort(0, ComV.Len() - 1, true);
+      const int KeyId = SetIdH.GetKeyId(ComV);
+      if (KeyId == -1) { SetIdH.AddDat(ComV, ComSetCntV.Len()); }
+      SetId = KeyId == -1 ? ComSetCntV.Len() : SetIdH[KeyId].Val;
+    }
+    if (SetId == ComSetCntV.Len()) { // new set
+      ComSetOffV.Add(ComSetIdV.Len());
+      ComSetIdV.AddV(ComV);
+      ComSetCntV.Add(0);
+    }
+    ComSetCntV[SetId]++;
+    EdgeComSetV[e] = SetId;
+  }
+  ComSetOffV.Add(ComSetIdV.Len());
+  ComSetOk = true;
+}
+
+void TAGMFit::UpdateEdgeLambdaSum() {
+  if (! ComSetOk) { GetComSets(); }
+  TFltV SetLambdaSumV(ComSetCntV.Len());
+  for (int s = 0; s < ComSetCntV.Len(); s++) {
+    for (int i = ComSetOffV[s]; i < ComSetOffV[s + 1]; i++) { SetLambdaSumV[s] += LambdaV[ComSetIdV[i]]; }
+  }
+  EdgeComCntV.Gen(EdgeComVH.Len());
+  EdgeLambdaSumV.Gen(EdgeComVH.Len());
+  for (int e = 0; e < EdgeComVH.Len(); e++) {
+    const int SetId = EdgeComSetV[e];
+    EdgeComCntV[e] = ComSetOffV[SetId + 1] - ComSetOffV[SetId];
+    EdgeLambdaSumV[e] = SetLambdaSumV[SetId];
+  }
 }
 
 // Set epsilon by the default value.
@@ -77,13 +161,14 @@ double TAGMFit::Likelihood(const TFltV& NewLambdaV, double& LEdges, double& LNoE
   IAssert(CIDNSetV.Len() == NewLambdaV.Len());
   IAssert(ComEdgesV.Len() == CIDNSetV.Len());
   LEdges = 0.0; LNoEdges = 0.0;
-  for (int e = 0; e < EdgeComVH.Len(); e++) {
-    TIntSet& JointCom = EdgeComVH[e];
-    double LambdaSum = SelectLambdaSum(NewLambdaV, JointCom);
+  if (! ComSetOk) { GetComSets(); }
+  for (int s = 0; s < ComSetCntV.Len(); s++) {
+    double LambdaSum = 0.0;
+    for (int i = ComSetOffV[s]; i < ComSetOffV[s + 1]; i++) { LambdaSum += NewLambdaV[ComSetIdV[i]]; }
     double Puv = 1 - exp(- LambdaSum);
-    if (JointCom.Len() == 0) {  Puv = PNoCom;  }
+    if (ComSetOffV[s] == ComSetOffV[s + 1]) {  Puv = PNoCom;  }
     IAssert(! _isnan(log(Puv)));
-    LEdges += log(Puv);
+    LEdges += ComSetCntV[s] * log(Puv);
   }
   for (int k = 0; k < NewLambdaV.Len(); k++) {
     int MaxEk = CIDNSetV[k].Len() * (CIDNSetV[k].Len() - 1) / 2;
@@ -158,6 +243,7 @@ int TAGMFit::MLEGradAscentGivenCAG(const double& Thres, const int& MaxIter, cons
       IterGradNormV.Add(TIntFltPr(iter, TLinAlg::Norm(GradV)));
     }
   }
+  UpdateEdgeLambdaSum();
   if (! PlotNm.Empty()) {
     TGnuPlot::PlotValV(IterLV, PlotNm + ".likelihood_Q");
     TGnuPlot::PlotValV(IterGradNormV, PlotNm + ".gradnorm_Q");
@@ -281,6 +367,7 @@ void TAGMFit::InitNodeData() {
     if (LambdaV[c] > MaxLambda) {  LambdaV[c] = MaxLambda;  }
     if (LambdaV[c] < MinLambda) {  LambdaV[c] = MinLambda;  }
   }
+  UpdateEdgeLambdaSum();
   NIDCIDPrS.Gen(G->GetNodes() * 10);
   for (int c = 0; c < CIDNSetV.Len(); c++) {
     for (TIntSet::TIter SI = CIDNSetV[c].BegI(); SI < CIDNSetV[c].EndI(); SI++) {
@@ -292,12 +379,16 @@ void TAGMFit::InitNodeData() {
 // After MCMC, NID leaves community CID.
 void TAGMFit::LeaveCom(const int& NID, const int& CID) {
   TUNGraph::TNodeI NI = G->GetNI(NID);
+  const int NbrOff = NbrOffV[NIDComVH.GetKeyId(NID)];
   for (int e = 0; e < NI.GetDeg(); e++) {
     int VID = NI.GetNbrNId(e);
     if (NIDComVH.GetDat(VID).IsKey(CID)) {
-      TIntPr SrcDstNIDPr = TIntPr(TMath::Mn(NID,VID), TMath::Mx(NID,VID));
-      EdgeComVH.GetDat(SrcDstNIDPr).DelKey(CID);
+      const int EId = NbrEIdV[NbrOff + e];
+      EdgeComVH[EId].DelKey(CID);
+      EdgeComCntV[EId]--;
+      EdgeLambdaSumV[EId] = EdgeComCntV[EId] == 0 ? 0.0 : EdgeLambdaSumV[EId] - LambdaV[CID];
       ComEdgesV[CID]--;
+      ComSetOk = false;
     }
   }
   CIDNSetV[CID].DelKey(NID);
@@ -308,12 +399,16 @@ void TAGMFit::LeaveCom(const int& NID, const int& CID) {
 // After MCMC, NID joins community CID.
 void TAGMFit::JoinCom(const int& NID, const int& JoinCID) {
   TUNGraph::TNodeI NI = G->GetNI(NID);
+  const int NbrOff = NbrOffV[NIDComVH.GetKeyId(NID)];
   for (int e = 0; e < NI.GetDeg(); e++) {
     int VID = NI.GetNbrNId(e);
     if (NIDComVH.GetDat(VID).IsKey(JoinCID)) {
-      TIntPr SrcDstNIDPr = TIntPr(TMath::Mn(NID,VID), TMath::Mx(NID,VID));
-      EdgeComVH.GetDat(SrcDstNIDPr).AddKey(JoinCID);
+      const int EId = NbrEIdV[NbrOff + e];
+      EdgeComVH[EId].AddKey(JoinCID);
+      EdgeComCntV[EId]++;
+      EdgeLambdaSumV[EId] += LambdaV[JoinCID];
       ComEdgesV[JoinCID]++;
+      ComSetOk = false;
     }
   }
   CIDNSetV[JoinCID].AddKey(NID);
@@ -331,7 +426,7 @@ void TAGMFit::SampleTransition(int& NID, int& JoinCID, int& LeaveCID, double& De
   if (Option == 0) {
     do {
       JoinCID = Rnd.GetUniDevInt(CIDNSetV.Len());
-      NID = G->GetRndNId();
+      NID = G->GetRndNId(Rnd);
     } while (TryCnt++ < MaxTryCnt && NIDCIDPrS.IsKey(TIntPr(NID, JoinCID)));
     if (TryCnt < MaxTryCnt) { //if successfully find a move
       DeltaL = SeekJoin(NID, JoinCID);
@@ -365,7 +460,7 @@ void TAGMFit::SampleTransition(int& NID, int& JoinCID, int& LeaveCID, double& De
 /// MCMC fitting
 void TAGMFit::RunMCMC(const int& MaxIter, const int& EvalLambdaIter, const TStr& PlotFPrx) {
   TExeTm IterTm, TotalTm;
-  double PrevL = Likelihood(), DeltaL = 0;
+  double PrevL = Likelihood();
   double BestL = PrevL;
   printf("initial likelihood = %f\n",PrevL);
   TIntFltPrV IterTrueLV, IterJoinV, IterLeaveV, IterAcceptV, IterSwitchV, IterLBV;
@@ -383,24 +478,12 @@ void TAGMFit::RunMCMC(const int& MaxIter, const int& EvalLambdaIter, const TStr&
     IterTm.Tick();
     int NID = -1;
     int JoinCID = -1, LeaveCID = -1;
-    SampleTransition(NID, JoinCID, LeaveCID, DeltaL); //sample a move
     double OptL = PrevL;
-    if (DeltaL > 0 || Rnd.GetUniDev() < exp(DeltaL)) { //if it is accepted
-      IterTm.Tick();
-      if (LeaveCID > -1 && LeaveCID != BaseCID) { LeaveCom(NID, LeaveCID); }
-      if (JoinCID > -1 && JoinCID != BaseCID) { JoinCom(NID, JoinCID); }
+    if (MCMCStep(iter, EvalLambdaIter, 1.0, OptL, NID, JoinCID, LeaveCID)) { //if it is accepted
       if (LeaveCID > -1 && JoinCID > -1 && JoinCID != BaseCID && LeaveCID != BaseCID) { SwitchCnt++; }
       else if (LeaveCID > -1  && LeaveCID != BaseCID) { LeaveCnt++;}
       else if (JoinCID > -1 && JoinCID != BaseCID) { JoinCnt++;}
       AcceptCnt++;
-      if ((iter + 1) % EvalLambdaIter == 0) {
-        IterTm.Tick();
-        MLEGradAscentGivenCAG(0.01, 3);
-        OptL = Likelihood();
-      }
-      else{
-        OptL = PrevL + DeltaL;
-      }
       if (BestL <= OptL && CIDNSetV.Len() > 0) {
         BestCmtySetV = CIDNSetV;
         BestLV = LambdaV;
@@ -447,6 +530,131 @@ void TAGMFit::RunMCMC(const int& MaxIter, const int& EvalLambdaIter, const TStr&
   printf("\nMCMC completed (best likelihood: %.2f) [%s]\n", BestL, TotalTm.GetTmStr());
 }
 
+// One Metropolis-Hastings step; the likelihood is flattened to L / Temp.
+bool TAGMFit::MCMCStep(const int& Iter, const int& EvalLambdaIter, const double& Temp, double& CurL, int& NID, int& JoinCID, int& LeaveCID) {
+  double DeltaL = 0.0;
+  NID = -1;  JoinCID = -1;  LeaveCID = -1;
+  SampleTransition(NID, JoinCID, LeaveCID, DeltaL); //sample a move
+  if (! (DeltaL > 0 || Rnd.GetUniDev() < exp(DeltaL / Temp))) { return false; }
+  if (LeaveCID > -1 && LeaveCID != BaseCID) { LeaveCom(NID, LeaveCID); }
+  if (JoinCID > -1 && JoinCID != BaseCID) { JoinCom(NID, JoinCID); }
+  if ((Iter + 1) % EvalLambdaIter == 0) {
+    MLEGradAscentGivenCAG(0.01, 3);
+    CurL = Likelihood();
+  } else {
+    CurL += DeltaL;
+  }
+  return true;
+}
+
+/// Parallel tempering: chain c runs at temperature TempV[t] where LevelChainV[t] = c.
+/// Chains share the graph; each has its own communities, caches and random number generator.
+void TAGMFit::RunParallelMCMC(const int& Chains, const int& MaxIter, const int& EvalLambdaIter, const int& SwapIter, const double& MaxTemp, const TStr& CheckPointFNm, const int& CheckPointIter) {
+  IAssert(Chains > 0 && SwapIter > 0 && MaxTemp >= 1.0);
+  TExeTm TotalTm;
+  TVec<TAGMFit> ChainV(Chains);
+  TFltV TempV(Chains), CurLV(Chains), BestLV(Chains);
+  TIntV LevelChainV(Chains);
+  TVec<TVec<TIntSet> > BestCmtyVV(Chains);
+  TVec<TFltV> BestLambdaVV(Chains);
+  for (int t = 0; t < Chains; t++) {
+    TempV[t] = Chains == 1 ? 1.0 : pow(MaxTemp, (double) t / (double) (Chains - 1));
+  }
+  int Iter = 0;
+  if (TFile::Exists(CheckPointFNm)) {
+    TFIn FIn(CheckPointFNm);
+    TInt SavedChains(FIn), SavedIter(FIn);
+    IAssertR(SavedChains == Chains, TStr::Fmt("%s has %d chains", CheckPointFNm.CStr(), SavedChains.Val));
+    Iter = SavedIter;
+    Rnd = TRnd(FIn);
+    LevelChainV.Load(FIn);
+    CurLV.Load(FIn);
+    BestLV.Load(FIn);
+    BestCmtyVV.Load(FIn);
+    BestLambdaVV.Load(FIn);
+    for (int c = 0; c < Chains; c++) {
+      ChainV[c].G = G;
+      ChainV[c].LoadState(FIn);
+      ChainV[c].EdgeLambdaSumV.Load(FIn); // incremental sums, restored exactly
+      ChainV[c].Rnd = TRnd(FIn);
+    }
+    printf("restarted from %s at iteration %d\n", CheckPointFNm.CStr(), Iter);
+  } else {
+    const double InitL = Likelihood();
+    for (int c = 0; c < Chains; c++) {
+      ChainV[c] = *this;
+      ChainV[c].Rnd.PutSeed(Rnd.GetUniDevInt(TInt::Mx - 1) + 1);
+      LevelChainV[c] = c;
+      CurLV[c] = InitL;
+      BestLV[c] = InitL;
+      BestCmtyVV[c] = CIDNSetV;
+      BestLambdaVV[c] = LambdaV;
+    }
+    printf("initial likelihood = %f\n", InitL);
+  }
+  int LastCheckPoint = Iter, SwapCnt = 0, SwapTry = 0;
+  while (Iter < MaxIter) {
+    const int Steps = TMath::Mn(SwapIter, MaxIter - Iter);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < Chains; t++) {
+      const int c = LevelChainV[t];
+      const double Temp = TempV[t];
+      TAGMFit& Chain = ChainV[c];
+      int NID, JoinCID, LeaveCID;
+      for (int i = Iter; i < Iter + Steps; i++) {
+        if (! Chain.MCMCStep(i, EvalLambdaIter, Temp, CurLV[c].Val, NID, JoinCID, LeaveCID)) { continue; }
+        if (BestLV[c] <= CurLV[c] && Chain.CIDNSetV.Len() > 0) {
+          BestCmtyVV[c] = Chain.CIDNSetV;
+          BestLambdaVV[c] = Chain.LambdaV;
+          BestLV[c] = CurLV[c];
+        }
+      }
+    }
+    Iter += Steps;
+    // propose to swap the chains at neighboring temperatures
+    for (int t = 0; t + 1 < Chains; t++) {
+      const int C1 = LevelChainV[t], C2 = LevelChainV[t + 1];
+      const double LogA = (1.0 / TempV[t] - 1.0 / TempV[t + 1]) * (CurLV[C2] - CurLV[C1]);
+      SwapTry++;
+      if (LogA >= 0.0 || Rnd.GetUniDev() < exp(LogA)) {
+        LevelChainV[t] = C2;
+        LevelChainV[t + 1] = C1;
+        SwapCnt++;
+      }
+    }
+    if (! CheckPointFNm.Empty() && ((CheckPointIter > 0 && Iter - LastCheckPoint >= CheckPointIter) || Iter == MaxIter)) {
+      { TFOut FOut(CheckPointFNm + ".tmp");
+      TInt(Chains).Save(FOut);
+      TInt(Iter).Save(FOut);
+      Rnd.Save(FOut);
+      LevelChainV.Save(FOut);
+      CurLV.Save(FOut);
+      BestLV.Save(FOut);
+      BestCmtyVV.Save(FOut);
+      BestLambdaVV.Save(FOut);
+      for (int c = 0; c < Chains; c++) {
+        ChainV[c].SaveState(FOut);
+        ChainV[c].EdgeLambdaSumV.Save(FOut);
+        ChainV[c].Rnd.Save(FOut);
+      } }
+      TFile::Rename(CheckPointFNm + ".tmp", CheckPointFNm);
+      LastCheckPoint = Iter;
+    }
+    printf("\r%d iterations completed [%.2f] (likelihood at T=1: %.2f, swaps accepted: %.2f)", Iter, (double) Iter / (double) MaxIter, CurLV[LevelChainV[0]].Val, SwapTry > 0 ? (double) SwapCnt / (double) SwapTry : 0.0);
+    fflush(stdout);
+  }
+  int BestC = 0;
+  for (int c = 1; c < Chains; c++) {
+    if (BestLV[c] > BestLV[BestC]) { BestC = c; }
+  }
+  CIDNSetV = BestCmtyVV[BestC];
+  LambdaV = BestLambdaVV[BestC];
+
+  InitNodeData();
+  MLEGradAscentGivenCAG(0.001, 100);
+  printf("\nMCMC with %d chains completed (best likelihood: %.2f) [%s]\n", Chains, BestLV[BestC].Val, TotalTm.GetTmStr());
+}
+
 // Returns \v QV, a vector of (1 - p_c) for each community c.
 void TAGMFit::GetQV(TFltV& OutV) {
   OutV.Gen(LambdaV.Len());
@@ -477,17 +685,17 @@ double TAGMFit::SeekLeave(const int& UID, const int& CID) {
   IAssert(G->IsNode(UID));
   double Delta = 0.0;
   TUNGraph::TNodeI NI = G->GetNI(UID);
+  const int NbrOff = NbrOffV[NIDComVH.GetKeyId(UID)];
   int NbhsInC = 0;
   for (int e = 0; e < NI.GetDeg(); e++) {
     const int VID = NI.GetNbrNId(e);
     if (! NIDComVH.GetDat(VID).IsKey(CID)) { continue; }
-    TIntPr SrcDstNIDPr(TMath::Mn(UID,VID), TMath::Mx(UID,VID));
-    TIntSet& JointCom = EdgeComVH.GetDat(SrcDstNIDPr);
-    double CurPuv, NewPuv, LambdaSum = SelectLambdaSum(JointCom);
+    const int EId = NbrEIdV[NbrOff + e];
+    double CurPuv, NewPuv, LambdaSum = EdgeLambdaSumV[EId];
     CurPuv = 1 - exp(- LambdaSum);
     NewPuv = 1 - exp(- LambdaSum + LambdaV[CID]);
-    IAssert(JointCom.Len() > 0);
-    if (JointCom.Len() == 1) {
+    IAssert(EdgeComCntV[EId] > 0);
+    if (EdgeComCntV[EId] == 1) {
       NewPuv = PNoCom;
     }
     Delta += (log(NewPuv) - log(CurPuv));
@@ -503,15 +711,15 @@ double TAGMFit::SeekJoin(const int& UID, const int& CID) {
   IAssert(! CIDNSetV[CID].IsKey(UID));
   double Delta = 0.0;
   TUNGraph::TNodeI NI = G->GetNI(UID);
+  const int NbrOff = NbrOffV[NIDComVH.GetKeyId(UID)];
   int NbhsInC = 0;
   for (int e = 0; e < NI.GetDeg(); e++) {
     const int VID = NI.GetNbrNId(e);
     if (! NIDComVH.GetDat(VID).IsKey(CID)) { continue; }
-    TIntPr SrcDstNIDPr(TMath::Mn(UID,VID), TMath::Mx(UID,VID));
-    TIntSet& JointCom = EdgeComVH.GetDat(SrcDstNIDPr);
-    double CurPuv, NewPuv, LambdaSum = SelectLambdaSum(JointCom);
+    const int EId = NbrEIdV[NbrOff + e];
+    double CurPuv, NewPuv, LambdaSum = EdgeLambdaSumV[EId];
     CurPuv = 1 - exp(- LambdaSum);
-    if (JointCom.Len() == 0) { CurPuv = PNoCom; }
+    if (EdgeComCntV[EId] == 0) { CurPuv = PNoCom; }
     NewPuv = 1 - exp(- LambdaSum - LambdaV[CID]);
     Delta += (log(NewPuv) - log(CurPuv));
     IAssert(!_isnan(Delta));
@@ -528,17 +736,17 @@ double TAGMFit::SeekSwitch(const int& UID, const int& CurCID, const int& NewCID)
   double Delta = SeekJoin(UID, NewCID) + SeekLeave(UID, CurCID);
   //correct only for intersection between new com and current com
   TUNGraph::TNodeI NI = G->GetNI(UID);
+  const int NbrOff = NbrOffV[NIDComVH.GetKeyId(UID)];
   for (int e = 0; e < NI.GetDeg(); e++) {
     const int VID = NI.GetNbrNId(e);
     if (! NIDComVH.GetDat(VID).IsKey(CurCID) || ! NIDComVH.GetDat(VID).IsKey(NewCID)) {continue;}
-    TIntPr SrcDstNIDPr(TMath::Mn(UID,VID), TMath::Mx(UID,VID));
-    TIntSet& JointCom = EdgeComVH.GetDat(SrcDstNIDPr);
-    double CurPuv, NewPuvAfterJoin, NewPuvAfterLeave, NewPuvAfterSwitch, LambdaSum = SelectLambdaSum(JointCom);
+    const int EId = NbrEIdV[NbrOff + e];
+    double CurPuv, NewPuvAfterJoin, NewPuvAfterLeave, NewPuvAfterSwitch, LambdaSum = EdgeLambdaSumV[EId];
     CurPuv = 1 - exp(- LambdaSum);
     NewPuvAfterLeave = 1 - exp(- LambdaSum + LambdaV[CurCID]);
     NewPuvAfterJoin = 1 - exp(- LambdaSum - LambdaV[NewCID]);
     NewPuvAfterSwitch = 1 - exp(- LambdaSum - LambdaV[NewCID] + LambdaV[CurCID]);
-    if (JointCom.Len() == 1 || NewPuvAfterLeave == 0.0) {
+    if (EdgeComCntV[EId] == 1 || NewPuvAfterLeave == 0.0) {
       NewPuvAfterLeave = PNoCom;
     }
     Delta += (log(NewPuvAfterSwitch) + log(CurPuv) - log(NewPuvAfterLeave) - log(NewPuvAfterJoin));
@@ -595,13 +803,14 @@ void TAGMFit::SetCmtyVV(const TVec<TIntV>& CmtyVV) {
 void TAGMFit::GradLogLForLambda(TFltV& GradV) {
   GradV.Gen(LambdaV.Len());
   TFltV SumEdgeProbsV(LambdaV.Len());
-  for (int e = 0; e < EdgeComVH.Len(); e++) {
-    TIntSet& JointCom = EdgeComVH[e];
-    double LambdaSum = SelectLambdaSum(JointCom);
+  if (! ComSetOk) { GetComSets(); }
+  for (int s = 0; s < ComSetCntV.Len(); s++) {
+    double LambdaSum = 0.0;
+    for (int i = ComSetOffV[s]; i < ComSetOffV[s + 1]; i++) { LambdaSum += LambdaV[ComSetIdV[i]]; }
     double Puv = 1 - exp(- LambdaSum);
-    if (JointCom.Len() == 0) {  Puv = PNoCom;  }
-    for (TIntSet::TIter SI = JointCom.BegI(); SI < JointCom.EndI(); SI++) {
-      SumEdgeProbsV[SI.GetKey()] += (1 - Puv) / Puv;
+    if (ComSetOffV[s] == ComSetOffV[s + 1]) {  Puv = PNoCom;  }
+    for (int i = ComSetOffV[s]; i < ComSetOffV[s + 1]; i++) {
+      SumEdgeProbsV[ComSetIdV[i]] += ComSetCntV[s] * (1 - Puv) / Puv;
     }
   }
   for (int k = 0; k < LambdaV.Len(); k++) {
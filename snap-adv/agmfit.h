@@ -21,6 +21,18 @@ private:
   TFlt MaxLambda; ///< Maximum value of regularization parameter lambda (default = 10).
   TFlt RegCoef; ///< Regularization parameter when we fit for P_c (for finding # communities).
   TInt BaseCID; ///< ID of the Epsilon-community (in case we fit P_c of the epsilon community). We do not fit for the Epsilon-community in general.
+  TIntV NbrOffV; ///< Offset of each node (key id in NIDComVH) in NbrEIdV.
+  TIntV NbrEIdV; ///< Edge ID (key id in EdgeComVH) of the e-th neighbor of node u is NbrEIdV[NbrOffV[u] + e].
+  TIntV EdgeComCntV; ///< |C_uv| for each edge (key id in EdgeComVH), kept up to date by JoinCom and LeaveCom.
+  TFltV EdgeLambdaSumV; ///< Sum of lambda_c over C_uv for each edge (key id in EdgeComVH), kept up to date by JoinCom and LeaveCom.
+  TIntV ComSetOffV; ///< Distinct sets C_uv over all edges: set s is ComSetIdV[ComSetOffV[s]..ComSetOffV[s+1]-1].
+  TIntV ComSetIdV;
+  TIntV ComSetCntV; ///< Number of edges whose C_uv is set s.
+  TIntV EdgeComSetV; ///< Index of the set C_uv for each edge (key id in EdgeComVH).
+  TBool ComSetOk; ///< False if C_uv changed since the distinct sets were built.
+
+  void SaveState(TSOut& SOut);
+  void LoadState(TSIn& SIn);
 
 public:
   TAGMFit() { }
@@ -45,6 +57,12 @@ public:
   void SetRegCoef(const double Val) { RegCoef = Val; }
   /// For each <tt>(u, v)</tt> in edges, precompute \c C_uv (the set of communities nodes u and v share).
   void GetEdgeJointCom();
+  /// Build the edge ID of each (node, neighbor) pair in \c EdgeComVH, used to index the per-edge caches.
+  void InitEdgeCache();
+  /// Recompute |C_uv| and the sum of lambda over C_uv for every edge (needed whenever \c LambdaV changes).
+  void UpdateEdgeLambdaSum();
+  /// Build the distinct sets C_uv and their edge counts. Likelihood and its gradient for lambda only depend on these.
+  void GetComSets();
   /// Initialize node community memberships using best neighborhood communities (see D. Gleich et al. KDD'12).
   void NeighborComInit(const int InitComs);
   // Gradient of likelihood for \c P_c.
@@ -69,6 +87,12 @@ public:
   void RandomInit(const int& MaxK);
   /// Main procedure for fitting the AGM to a given graph using MCMC.
   void RunMCMC(const int& MaxIter, const int& EvalLambdaIter, const TStr& PlotFPrx = TStr());
+  /// Fit the AGM using parallel tempering: \c Chains MCMC chains at temperatures 1..MaxTemp run in parallel (\c MaxIter iterations each)
+  /// and swap temperatures every \c SwapIter iterations. If \c CheckPointFNm is given, the chains are saved to it every \c CheckPointIter iterations
+  /// and at the end, and a later call with the same file name continues from the saved state.
+  void RunParallelMCMC(const int& Chains, const int& MaxIter, const int& EvalLambdaIter, const int& SwapIter = 1000, const double& MaxTemp = 10.0, const TStr& CheckPointFNm = TStr(), const int& CheckPointIter = 0);
+  /// One Metropolis-Hastings step at temperature \c Temp. Returns true if the move was accepted, \c CurL is updated to the new likelihood.
+  bool MCMCStep(const int& Iter, const int& EvalLambdaIter, const double& Temp, double& CurL, int& NID, int& JoinCID, int& LeaveCID);
   /// Sample MMCM transitions: Choose among (<tt>join, leave, switch</tt>), and then sample (<tt>NID, CID</tt>).
   void SampleTransition(int& NID, int& JoinCID, int& LeaveCID, double& DeltaL);
   /// COMMENT.
@@ -89,7 +113,7 @@ public:
   /// Step size search for updating P_c (which is parametarized by regularization parameter lambda).
   double GetStepSizeByLineSearchForLambda(const TFltV& DeltaV, const TFltV& GradV, const double& Alpha, const double& Beta);
   /// COMMENT.
-  void SetLambdaV(const TFltV& LambdaPt) {LambdaV = LambdaPt;}
+  void SetLambdaV(const TFltV& LambdaPt) {LambdaV = LambdaPt; UpdateEdgeLambdaSum();}
   /// COMMENT.
   void GetLambdaV(TFltV& OutV) {OutV = LambdaV;}
   /// Returns \c QV, a vector of (1 - \c p_c) for each community \c c.
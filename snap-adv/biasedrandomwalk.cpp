@@ -2,6 +2,11 @@
 #include "Snap.h"
 #include "biasedrandomwalk.h"
 
+//Key of the first-order alias table in the node data, node ids are non-negative
+const int FirstOrderKey = -1;
+//Rejected draws after which a step of SimulateWalkRejection is sampled exactly
+const int MxRejections = 32;
+
 //Preprocess alias sampling method
 void GetNodeAlias(TFltV& PTblV, TIntVFltVPr& NTTable) {
   int64 N = PTblV.Len();
@@ -141,3 +146,97 @@ void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, TRnd& Rnd, TIntV&
     WalkV.Add(InNet->GetNI(Dst).GetNbrNId(Next));
   }
 }
+
+//Preprocess first-order transition probabilities, the alias table of v is stored under FirstOrderKey
+//and the last element of its probability table holds the sum of the weights of v
+void PreprocessRejectionProbs(PWNet& InNet, bool& Verbose) {
+  TIntV NIds;
+  for (TWNet::TNodeI NI = InNet->BegNI(); NI < InNet->EndNI(); NI++) {
+    TIntIntVFltVPrH NDat;
+    NDat.AddDat(FirstOrderKey, TPair<TIntV,TFltV>(TIntV(NI.GetOutDeg()),TFltV(NI.GetOutDeg()+1)));
+    InNet->SetNDat(NI.GetId(), NDat);
+    NIds.Add(NI.GetId());
+  }
+#pragma omp parallel for schedule(dynamic, 1000)
+  for (int64 i = 0; i < NIds.Len(); i++) {
+    TWNet::TNodeI NI = InNet->GetNI(NIds[i]);
+    if (NI.GetOutDeg() == 0) { continue; }
+    double Psum = 0;
+    TFltV PTable(NI.GetOutDeg());
+    for (int64 j = 0; j < NI.GetOutDeg(); j++) {
+      PTable[j] = NI.GetOutEDat(j);
+      Psum += PTable[j];
+    }
+    for (int64 j = 0; j < NI.GetOutDeg(); j++) {
+      PTable[j] /= Psum;
+    }
+    TIntVFltVPr& NTTable = NI.GetDat().GetDat(FirstOrderKey);
+    GetNodeAlias(PTable, NTTable);
+    NTTable.Val2.Last() = Psum;
+  }
+  if (Verbose) {
+    printf("Preprocessed first-order transition probabilities of %d nodes\n", NIds.Len());
+  }
+}
+
+//Draws the next node after t->v from the exact second-order distribution, O(deg(v)) time
+int64 DrawNextExact(PWNet& InNet, TWNet::TNodeI& SrcI, TWNet::TNodeI& DstI, double& ParamP, double& ParamQ, TRnd& Rnd) {
+  double Psum = 0;
+  TFltV PTable(DstI.GetOutDeg());
+  for (int64 j = 0; j < DstI.GetOutDeg(); j++) {
+    const int64 FId = DstI.GetNbrNId(j);
+    const double Bias = FId == SrcI.GetId() ? 1.0 / ParamP : (SrcI.IsOutNId(FId) ? 1.0 : 1.0 / ParamQ);
+    Psum += DstI.GetOutEDat(j) * Bias;
+    PTable[j] = Psum;
+  }
+  const double X = Rnd.GetUniDev() * Psum;
+  int64 j = 0;
+  while (j < PTable.Len()-1 && PTable[j] <= X) { j++; }
+  return DstI.GetNbrNId(j);
+}
+
+//Simulates a random walk. After t->v, a neighbor x of v is drawn with probability proportional to the weight
+//of (v,x) and accepted with probability Bias(t,x)/Env(x), where Env(x) = max(1, 1/q) for x != t. The return
+//edge gets its own proposal bin of mass P(v,t)*max(0, 1/p - max(1, 1/q)), so Env(t) = max(1, 1/p, 1/q) and small
+//p does not slow down the other draws (outlier folding of KnightKing). After MxRejections rejected draws the
+//step is sampled exactly, which bounds the work per step for extreme p and q.
+void SimulateWalkRejection(PWNet& InNet, int64 StartNId, int& WalkLen, double& ParamP, double& ParamQ, TRnd& Rnd, TIntV& WalkV) {
+  WalkV.Add(StartNId);
+  if (WalkLen == 1) { return; }
+  if (InNet->GetNI(StartNId).GetOutDeg() == 0) { return; }
+  WalkV.Add(InNet->GetNI(StartNId).GetNbrNId(Rnd.GetUniDevInt(InNet->GetNI(StartNId).GetOutDeg())));
+  const double NbrEnv = TMath::Mx(1.0, 1.0 / ParamQ);
+  const double RetEnv = TMath::Mx(NbrEnv, 1.0 / ParamP);
+  while (WalkV.Len() < WalkLen) {
+    int64 Dst = WalkV.Last();
+    int64 Src = WalkV.LastLast();
+    TWNet::TNodeI DstI = InNet->GetNI(Dst);
+    TWNet::TNodeI SrcI = InNet->GetNI(Src);
+    if (DstI.GetOutDeg() == 0) { return; }
+    TIntVFltVPr& NTTable = DstI.GetDat().GetDat(FirstOrderKey);
+    //mass of the return bin relative to the mass NbrEnv of the first-order table
+    TFlt RetWeight = 0;
+    InNet->GetEDat(Dst, Src, RetWeight);
+    const double RetMass = RetWeight / NTTable.Val2.Last() * (RetEnv - NbrEnv);
+    int64 NextNId = -1;
+    for (int Draw = 0; Draw < MxRejections && NextNId == -1; Draw++) {
+      if (Rnd.GetUniDev() * (NbrEnv + RetMass) < RetMass) {
+        NextNId = Src;
+        continue;
+      }
+      const int64 FId = DstI.GetNbrNId(AliasDrawInt(NTTable, Rnd));
+      double Bias, Env = NbrEnv;
+      if (FId == Src) {
+        Bias = 1.0 / ParamP;
+        Env = RetEnv;
+      } else if (SrcI.IsOutNId(FId)) {
+        Bias = 1.0;
+      } else {
+        Bias = 1.0 / ParamQ;
+      }
+      if (Rnd.GetUniDev() * Env < Bias) { NextNId = FId; }
+    }
+    if (NextNId == -1) { NextNId = DrawNextExact(InNet, SrcI, DstI, ParamP, ParamQ, Rnd); }
+    WalkV.Add(NextNId);
+  }
+}
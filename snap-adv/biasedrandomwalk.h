@@ -13,4 +13,12 @@ void SimulateWalk(PWNet& InNet, int64 StartNId, int& WalkLen, TRnd& Rnd, TIntV&
 //Predicts approximate memory required for preprocessing the graph
 int64 PredictMemoryRequirements(PWNet& InNet);
 
+///Preprocesses first-order transition probabilities, one alias table per node, O(edges) memory. Has to be called once before SimulateWalkRejection calls
+void PreprocessRejectionProbs(PWNet& InNet, bool& Verbose);
+
+///Simulates one walk, sampling second-order transitions by rejection from the first-order tables, and writes it into Walk vector.
+///The return edge has its own proposal bin, so draws are rejected at a rate that depends only on q; after 32 rejected draws
+///a step is sampled exactly in O(degree) time
+void SimulateWalkRejection(PWNet& InNet, int64 StartNId, int& WalkLen, double& ParamP, double& ParamQ, TRnd& Rnd, TIntV& Walk);
+
 #endif //RAND_WALK_H
@@ -213,11 +213,304 @@ void TCliqueOverlap::GetOverlapCliques(const TVec<TIntV>& OverlapMtx, const TVec
 	}
 }
 
+/////////////////////////////////////////////////
+// Maximal clique enumeration (Eppstein, Loffler and Strash)
+/// Returns the number of the calling thread.
+static int GetCliqueThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/// Returns the maximum number of threads of a parallel region.
+static int GetCliqueThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/// Returns the number of set bits of Word.
+static inline int GetBitCnt(uint64 Word) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(Word);
+#else
+  Word = Word - ((Word >> 1) & 0x5555555555555555ULL);
+  Word = (Word & 0x3333333333333333ULL) + ((Word >> 2) & 0x3333333333333333ULL);
+  Word = (Word + (Word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return int((Word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// Returns the position of the lowest set bit of Word, which must not be 0.
+static inline int GetLowBitN(const uint64& Word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(Word);
+#else
+  return GetBitCnt((Word & (0-Word)) - 1);
+#endif
+}
+
+/// Computes a degeneracy ordering of the nodes of G (Batagelj and Zaversnik): every node has at most
+/// degeneracy(G) neighbors that come after it. PosV[NIdx] is the position of node index NIdx in the ordering.
+static void GetDegeneracyOrder(const TCsrGraph& G, TIntV& OrderV, TIntV& PosV) {
+  const int Nodes = G.GetNodes();
+  TIntV DegV(Nodes), BinV, VertV(Nodes);
+  int MxDeg = 0;
+  for (int n = 0; n < Nodes; n++) {
+    for (int e = 0; e < G.GetOutDeg(n); e++) {
+      if (G.GetOutNbr(n, e) != n) { DegV[n]++; } }
+    MxDeg = TMath::Mx(MxDeg, DegV[n].Val);
+  }
+  // nodes sorted by degree, BinV[d] is the position of the first node of degree d
+  BinV.Gen(MxDeg+1);
+  for (int n = 0; n < Nodes; n++) { BinV[DegV[n]]++; }
+  for (int d = 0, Beg = 0; d <= MxDeg; d++) { const int Cnt = BinV[d];  BinV[d] = Beg;  Beg += Cnt; }
+  PosV.Gen(Nodes);
+  for (int n = 0; n < Nodes; n++) { PosV[n] = BinV[DegV[n]];  BinV[DegV[n]]++;  VertV[PosV[n]] = n; }
+  for (int d = MxDeg; d > 0; d--) { BinV[d] = BinV[d-1]; }
+  BinV[0] = 0;
+  // repeatedly remove the node of the smallest remaining degree
+  for (int i = 0; i < Nodes; i++) {
+    const int NIdx = VertV[i];
+    for (int e = 0; e < G.GetOutDeg(NIdx); e++) {
+      const int Nbr = G.GetOutNbr(NIdx, e);
+      if (Nbr == NIdx || DegV[Nbr] <= DegV[NIdx]) { continue; }
+      // swap Nbr with the first node of its degree bin and shrink the bin
+      const int Deg = DegV[Nbr], FirstPos = BinV[Deg], First = VertV[FirstPos];
+      if (First != Nbr) {
+        VertV[PosV[Nbr]] = First;  PosV[First] = PosV[Nbr];
+        VertV[FirstPos] = Nbr;  PosV[Nbr] = FirstPos;
+      }
+      BinV[Deg]++;
+      DegV[Nbr]--;
+    }
+  }
+  OrderV = VertV;
+}
+
+//#//////////////////////////////////////////////
+/// Bron-Kerbosch search with pivoting from the nodes of a degeneracy ordering, one instance per thread.
+/// Small searches relabel the nodes of P (candidates) and X (excluded nodes) to 0...K-1 and keep P, X and the
+/// adjacency among them as bitsets; large ones keep P and X as sorted vectors of node indices.
+class TMaxCliqueEnum {
+private:
+  static const int MxBitNodes = 1024;
+  const TCsrGraph& G;
+  const TIntV& PosV;
+  const int MinSize, ThreadN;
+  TMaxCliqueVisitor& Visitor;
+  TIntV CliqueNIdV;                 // node ids of the current clique R
+  TIntV LocV;                       // node index -> local bitset index, -1 if not in P or X
+  TIntV LocNIdxV;                   // local bitset index -> node index
+  int Words;                        // 64-bit words per bitset
+  TVec<uint64> RowV;                // adjacency bitset of every local node
+  TVec<uint64> SetV;                // P, X and branching candidates of every recursion depth
+private:
+  uint64* GetRow(const int& LocN) { return RowV.BegI() + int64(LocN)*Words; }
+  uint64* GetSet(const int& Depth, const int& SetN) { return SetV.BegI() + int64(3*Depth+SetN)*Words; }
+  void Report() { if (CliqueNIdV.Len() >= MinSize) { Visitor.OnClique(CliqueNIdV, ThreadN); } }
+  void ExpandBit(const int& Depth);
+  void ExpandVec(TIntV& PV, TIntV& XV);
+  /// Appends to ResV the nodes of the sorted SetV that are (or, if InNbrs is false, are not) neighbors of NIdx.
+  void GetNbrSet(const TIntV& SetV, const int& NIdx, const bool& InNbrs, TIntV& ResV) const;
+public:
+  TMaxCliqueEnum(const TCsrGraph& Graph, const TIntV& NodePosV, const int& MinCliqueSize, TMaxCliqueVisitor& CliqueVisitor, const int& ThreadNum) :
+    G(Graph), PosV(NodePosV), MinSize(MinCliqueSize), ThreadN(ThreadNum), Visitor(CliqueVisitor), CliqueNIdV(), LocV(Graph.GetNodes()), LocNIdxV(), Words(0), RowV(), SetV() {
+    LocV.PutAll(-1); }
+  /// Reports all maximal cliques whose first node in the degeneracy ordering is NIdx.
+  void Enum(const int& NIdx);
+};
+
+void TMaxCliqueEnum::GetNbrSet(const TIntV& SetV, const int& NIdx, const bool& InNbrs, TIntV& ResV) const {
+  const TVec<TInt, int64>& NbrV = G.GetOutNbrV();
+  int64 e = G.GetOutOff(NIdx);
+  const int64 EndE = G.GetOutOff(NIdx+1);
+  for (int i = 0; i < SetV.Len(); i++) {
+    const int Val = SetV[i];
+    while (e < EndE && NbrV[e] < Val) { e++; }
+    const bool IsNbr = e < EndE && NbrV[e] == Val && Val != NIdx;
+    if (IsNbr == InNbrs) { ResV.Add(Val); }
+  }
+}
+
+void TMaxCliqueEnum::Enum(const int& NIdx) {
+  CliqueNIdV.Clr(false);
+  CliqueNIdV.Add(G.GetNId(NIdx));
+  // P: neighbors after NIdx in the ordering, X: neighbors before it
+  TIntV PV, XV;
+  for (int e = 0; e < G.GetOutDeg(NIdx); e++) {
+    const int Nbr = G.GetOutNbr(NIdx, e);
+    if (Nbr == NIdx) { continue; }
+    if (PosV[Nbr] > PosV[NIdx]) { PV.Add(Nbr); } else { XV.Add(Nbr); }
+  }
+  if (PV.Empty()) { if (XV.Empty()) { Report(); }  return; }
+  if (1 + PV.Len() < MinSize) { return; }
+  // nodes of X without neighbors in P leave X at the first branching, so they are never needed
+  LocNIdxV.Clr(false);
+  for (int i = 0; i < PV.Len(); i++) { LocV[PV[i]] = LocNIdxV.Len();  LocNIdxV.Add(PV[i]); }
+  for (int i = 0; i < XV.Len(); i++) { LocV[XV[i]] = -2; }
+  for (int i = 0; i < PV.Len(); i++) {
+    for (int e = 0; e < G.GetOutDeg(PV[i]); e++) {
+      const int Nbr = G.GetOutNbr(PV[i], e);
+      if (LocV[Nbr] == -2) { LocV[Nbr] = LocNIdxV.Len();  LocNIdxV.Add(Nbr); }
+    }
+  }
+  const int LocNodes = LocNIdxV.Len();
+  if (LocNodes <= MxBitNodes) {
+    Words = (LocNodes + 63) / 64;
+    if (RowV.Len() < LocNodes*Words) { RowV.Gen(LocNodes*Words); }
+    for (int w = 0; w < LocNodes*Words; w++) { RowV[w] = 0; }
+    for (int i = 0; i < PV.Len(); i++) {
+      for (int e = 0; e < G.GetOutDeg(PV[i]); e++) {
+        const int Loc = LocV[G.GetOutNbr(PV[i], e)];
+        if (Loc < 0 || Loc == i) { continue; }
+        GetRow(i)[Loc/64] |= 1ULL << (Loc%64);
+        GetRow(Loc)[i/64] |= 1ULL << (i%64);
+      }
+    }
+    if (SetV.Len() < 3*(PV.Len()+1)*Words) { SetV.Gen(3*(PV.Len()+1)*Words); }
+    uint64* P = GetSet(0, 0);
+    uint64* X = GetSet(0, 1);
+    for (int w = 0; w < Words; w++) { P[w] = 0;  X[w] = 0; }
+    for (int l = 0; l < LocNodes; l++) {
+      if (l < PV.Len()) { P[l/64] |= 1ULL << (l%64); } else { X[l/64] |= 1ULL << (l%64); }
+    }
+    for (int i = 0; i < LocNodes; i++) { LocV[LocNIdxV[i]] = -1; }
+    for (int i = 0; i < XV.Len(); i++) { LocV[XV[i]] = -1; }
+    ExpandBit(0);
+  } else {
+    TIntV RelXV;
+    for (int i = PV.Len(); i < LocNodes; i++) { RelXV.Add(LocNIdxV[i]); }
+    TSnap::SortMP(RelXV);
+    for (int i = 0; i < LocNodes; i++) { LocV[LocNIdxV[i]] = -1; }
+    for (int i = 0; i < XV.Len(); i++) { LocV[XV[i]] = -1; }
+    ExpandVec(PV, RelXV);
+  }
+}
+
+void TMaxCliqueEnum::ExpandBit(const int& Depth) {
+  uint64* P = GetSet(Depth, 0);
+  uint64* X = GetSet(Depth, 1);
+  uint64* CandV = GetSet(Depth, 2);
+  int PCnt = 0, XCnt = 0;
+  for (int w = 0; w < Words; w++) { PCnt += GetBitCnt(P[w]);  XCnt += GetBitCnt(X[w]); }
+  if (PCnt == 0) { if (XCnt == 0) { Report(); }  return; }
+  if (CliqueNIdV.Len() + PCnt < MinSize) { return; }
+  // pivot: the node of P or X with the most neighbors in P
+  int Pivot = -1, MxNbrs = -1;
+  for (int w = 0; w < Words; w++) {
+    for (uint64 Bits = P[w] | X[w]; Bits != 0; Bits &= Bits-1) {
+      const int Loc = 64*w + GetLowBitN(Bits);
+      const uint64* Row = GetRow(Loc);
+      int Nbrs = 0;
+      for (int v = 0; v < Words; v++) { Nbrs += GetBitCnt(P[v] & Row[v]); }
+      if (Nbrs > MxNbrs) { MxNbrs = Nbrs;  Pivot = Loc; }
+    }
+  }
+  const uint64* PivotRow = GetRow(Pivot);
+  for (int w = 0; w < Words; w++) { CandV[w] = P[w] & ~PivotRow[w]; }
+  uint64* NewP = GetSet(Depth+1, 0);
+  uint64* NewX = GetSet(Depth+1, 1);
+  for (int w = 0; w < Words; w++) {
+    for (uint64 Bits = CandV[w]; Bits != 0; Bits &= Bits-1) {
+      const int Loc = 64*w + GetLowBitN(Bits);
+      const uint64* Row = GetRow(Loc);
+      for (int v = 0; v < Words; v++) { NewP[v] = P[v] & Row[v];  NewX[v] = X[v] & Row[v]; }
+      CliqueNIdV.Add(G.GetNId(LocNIdxV[Loc]));
+      ExpandBit(Depth+1);
+      CliqueNIdV.DelLast();
+      P[w] &= ~(1ULL << (Loc%64));
+      X[w] |= 1ULL << (Loc%64);
+    }
+  }
+}
+
+void TMaxCliqueEnum::ExpandVec(TIntV& PV, TIntV& XV) {
+  if (PV.Empty()) { if (XV.Empty()) { Report(); }  return; }
+  if (CliqueNIdV.Len() + PV.Len() < MinSize) { return; }
+  int Pivot = -1, MxNbrs = -1;
+  TIntV NbrV;
+  for (int s = 0; s < 2; s++) {
+    const TIntV& SetV = s == 0 ? PV : XV;
+    for (int i = 0; i < SetV.Len(); i++) {
+      NbrV.Clr(false);
+      GetNbrSet(PV, SetV[i], true, NbrV);
+      if (NbrV.Len() > MxNbrs) { MxNbrs = NbrV.Len();  Pivot = SetV[i]; }
+    }
+  }
+  TIntV CandV, NewPV, NewXV;
+  GetNbrSet(PV, Pivot, false, CandV);
+  for (int c = 0; c < CandV.Len(); c++) {
+    const int NIdx = CandV[c];
+    NewPV.Clr(false);  NewXV.Clr(false);
+    GetNbrSet(PV, NIdx, true, NewPV);
+    GetNbrSet(XV, NIdx, true, NewXV);
+    CliqueNIdV.Add(G.GetNId(NIdx));
+    ExpandVec(NewPV, NewXV);
+    CliqueNIdV.DelLast();
+    PV.DelIfIn(NIdx);
+    XV.AddSorted(NIdx);
+  }
+}
+
+/// Stores the cliques of every thread separately.
+class TMaxCliqueCollector : public TMaxCliqueVisitor {
+public:
+  TVec<TVec<TIntV> > CliqueVV;
+  TMaxCliqueCollector(const int& Threads) : CliqueVV(Threads) { }
+  void OnClique(const TIntV& CliqueNIdV, const int& ThreadN) { CliqueVV[ThreadN].Add(CliqueNIdV); }
+};
+
+/// Counts the cliques of every thread separately.
+class TMaxCliqueCounter : public TMaxCliqueVisitor {
+public:
+  TVec<TInt64> CntV;
+  TMaxCliqueCounter(const int& Threads) : CntV(8*Threads) { }
+  void OnClique(const TIntV& CliqueNIdV, const int& ThreadN) { CntV[8*ThreadN]++; }
+};
+
+void TCliqueOverlap::EnumMaxCliques(const PUNGraph& G, int MinMaxCliqueSize, TMaxCliqueVisitor& Visitor) {
+  const TCsrGraph Graph(G);
+  TIntV OrderV, PosV;
+  GetDegeneracyOrder(Graph, OrderV, PosV);
+  const int Nodes = Graph.GetNodes();
+  #pragma omp parallel
+  {
+    TMaxCliqueEnum CliqueEnum(Graph, PosV, MinMaxCliqueSize, Visitor, GetCliqueThreadN());
+    // nodes late in the ordering lie in the dense core and have the largest searches, start with them
+    #pragma omp for schedule(dynamic,1)
+    for (int i = Nodes-1; i >= 0; i--) {
+      CliqueEnum.Enum(OrderV[i]);
+    }
+  }
+}
+
+int64 TCliqueOverlap::GetMaxCliqueCnt(const PUNGraph& G, int MinMaxCliqueSize) {
+  TMaxCliqueCounter Counter(GetCliqueThreads());
+  EnumMaxCliques(G, MinMaxCliqueSize, Counter);
+  int64 Cnt = 0;
+  for (int i = 0; i < Counter.CntV.Len(); i++) { Cnt += Counter.CntV[i]; }
+  return Cnt;
+}
+
 /// Enumerate maximal cliques of the network on more than MinMaxCliqueSize nodes
 void TCliqueOverlap::GetMaxCliques(const PUNGraph& G, int MinMaxCliqueSize, TVec<TIntV>& MaxCliques) {
-  TCliqueOverlap CO;
+  TMaxCliqueCollector Collector(GetCliqueThreads());
+  EnumMaxCliques(G, MinMaxCliqueSize, Collector);
   MaxCliques.Clr(false);
-  CO.GetMaximalCliques(G, MinMaxCliqueSize, MaxCliques);
+  for (int t = 0; t < Collector.CliqueVV.Len(); t++) {
+    for (int c = 0; c < Collector.CliqueVV[t].Len(); c++) {
+      MaxCliques.Add();
+      MaxCliques.Last().MoveFrom(Collector.CliqueVV[t][c]);
+      MaxCliques.Last().Sort();
+    }
+    Collector.CliqueVV[t].Clr();
+  }
+  MaxCliques.Sort();
 }
 
 /// Clique Percolation method communities
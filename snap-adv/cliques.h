@@ -3,6 +3,18 @@
 
 #include "Snap.h"
 
+/////////////////////////////////////////////////
+// Maximal clique visitor
+//#//////////////////////////////////////////////
+/// Receives maximal cliques from TCliqueOverlap::EnumMaxCliques() as they are found, so they do not have to be stored.
+class TMaxCliqueVisitor {
+public:
+  virtual ~TMaxCliqueVisitor() { }
+  /// Called once for every maximal clique with the ids of its nodes (in no particular order).
+  /// ThreadN is the number of the calling thread, 0...omp_get_max_threads()-1. Calls from different threads can be concurrent.
+  virtual void OnClique(const TIntV& CliqueNIdV, const int& ThreadN) = 0;
+};
+
 /////////////////////////////////////////////////
 // Clique Percolation Method for Overlapping community detection
 class TCliqueOverlap {
@@ -29,7 +41,16 @@ public:
   TCliqueOverlap() : m_G(), m_Q(), m_maxCliques(NULL), m_minMaxCliqueSize(3) { }
 	void GetMaximalCliques(const PUNGraph& G, int MinMaxCliqueSize, TVec<TIntV>& MaxCliques);
   /// Enumerate maximal cliques of the network on more than MinMaxCliqueSize nodes
+  /// Cliques are returned with sorted node ids, in increasing lexicographic order. Uses EnumMaxCliques().
   static void GetMaxCliques(const PUNGraph& G, int MinMaxCliqueSize, TVec<TIntV>& MaxCliques);
+  /// Passes every maximal clique of the network on at least MinMaxCliqueSize nodes to Visitor.
+  /// Uses the algorithm of Eppstein, Loffler and Strash: every node v of a degeneracy ordering starts a Bron-Kerbosch
+  /// search with pivoting, restricted to its neighbors that come after it, so each clique is found exactly once.
+  /// Searches whose candidate and excluded sets have at most 1024 nodes use bitsets. Nodes are processed in parallel,
+  /// idle threads take the next node from the shared queue.
+  static void EnumMaxCliques(const PUNGraph& G, int MinMaxCliqueSize, TMaxCliqueVisitor& Visitor);
+  /// Returns the number of maximal cliques of the network on at least MinMaxCliqueSize nodes, without storing them.
+  static int64 GetMaxCliqueCnt(const PUNGraph& G, int MinMaxCliqueSize);
   /// Clique Percolation method communities
   static void GetCPMCommunities(const PUNGraph& G, int MinMaxCliqueSize, TVec<TIntV>& Communities);
 };
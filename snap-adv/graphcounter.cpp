@@ -73,6 +73,9 @@ TD34GraphCounter::TD34GraphCounter(int GraphSz) {
 	//
 	m_subGraphSize = GraphSz;
 	//
+	TIntV canonIdV;
+	TGraphEnumUtils::GetCanonIdV(GraphSz, canonIdV);
+	//
 	int numOfGraphs = 0;
 	if(GraphSz==3) numOfGraphs = TD3Graph::m_numOfGraphs;
 	else if(GraphSz==4) numOfGraphs = TD4Graph::m_numOfGraphs;
@@ -82,15 +85,14 @@ TD34GraphCounter::TD34GraphCounter(int GraphSz) {
 		if(GraphSz==3) graphId = TD3Graph::m_graphIds[i];
 		else if(GraphSz==4) graphId = TD4Graph::m_graphIds[i];
 		//
-		TVec<PNGraph> isoG;
-		TGraphEnumUtils::GetIsoGraphs(graphId, GraphSz, isoG);
-		//
-		TVec<uint64> graphIds(isoG.Len());
-		uint64 minGraphId = TGraphEnumUtils::GetMinAndGraphIds(isoG, graphIds);
-		for(int j=0; j<graphIds.Len(); j++)
-			m_graphMaps.AddDat((int)graphIds[j], (int)minGraphId);
-		//
-		m_graphCounters.AddDat((int)minGraphId, 0);
+		m_graphCounters.AddDat(canonIdV[graphId], 0);
+	}
+	//Lookup table from every graph id to the counter of its canonical graph
+	m_graphMaps.Gen(canonIdV.Len());
+	for(int graphId=0; graphId<canonIdV.Len(); graphId++) {
+		int keyId = -1;
+		if(canonIdV[graphId] != -1) m_graphCounters.IsKey(canonIdV[graphId], keyId);
+		m_graphMaps[graphId] = keyId;
 	}
 }
 void TD34GraphCounter::operator()(const PNGraph &G, const TIntV &sg) {
@@ -98,10 +100,19 @@ void TD34GraphCounter::operator()(const PNGraph &G, const TIntV &sg) {
 	if(m_subGraphSize==3) graphId = TD3Graph::getId(G, sg);
 	else if(m_subGraphSize==4) graphId = TD4Graph::getId(G, sg);
 	//
-	if(!m_graphMaps.IsKey(graphId)) { printf("This graph does not exist: %d\n", graphId); getchar(); return; }
-	int minGraphId = m_graphMaps.GetDat(graphId);
+	const int keyId = m_graphMaps[graphId];
+	if(keyId == -1) { printf("This graph does not exist: %d\n", graphId); getchar(); return; }
 	//
-	m_graphCounters.GetDat(minGraphId)++;
+	m_graphCounters[keyId]++;
+}
+
+void TD34GraphCounter::ClrCnt() {
+	for(int i=0; i<m_graphCounters.Len(); i++) m_graphCounters[i] = 0;
+}
+
+void TD34GraphCounter::AddCnt(const TD34GraphCounter& Counter) {
+	IAssert(m_subGraphSize == Counter.m_subGraphSize);
+	for(int i=0; i<m_graphCounters.Len(); i++) m_graphCounters[i] += Counter.m_graphCounters[i];
 }
 
 PNGraph TD34GraphCounter::GetGraph(const int& GraphId) const {
@@ -131,6 +142,177 @@ void TDGraphCounter::operator()(const PNGraph &G, const TIntV &sg) {
 	}
 }
 
+void TDGraphCounter::ClrCnt() {
+	for(int i=m_graphCounters.FFirstKeyId(); m_graphCounters.FNextKeyId(i); ) m_graphCounters[i] = 0;
+}
+
+void TDGraphCounter::AddCnt(const TDGraphCounter& Counter) {
+	for(int i=Counter.m_graphMaps.FFirstKeyId(); Counter.m_graphMaps.FNextKeyId(i); ) {
+		if(!m_graphMaps.IsKey(Counter.m_graphMaps.GetKey(i))) m_graphMaps.AddDat(Counter.m_graphMaps.GetKey(i), Counter.m_graphMaps[i]);
+	}
+	for(int i=Counter.m_graphCounters.FFirstKeyId(); Counter.m_graphCounters.FNextKeyId(i); ) {
+		m_graphCounters.AddDat(Counter.m_graphCounters.GetKey(i)) += Counter.m_graphCounters[i];
+	}
+}
+
+/////////////////////////////////////////////////
+// Undirected graphlet orbit counter implementation
+const int TGraphletOrbitCounter::Orbits;
+const int TGraphletOrbitCounter::Graphlets;
+
+TGraphletOrbitCounter::TGraphletOrbitCounter(const PUNGraph &G) {
+	const TCsrGraph csrG(G);
+	const int nodes = csrG.GetNodes();
+	m_nIdV = csrG.GetNIdV();
+	m_nIdxH.Gen(nodes);
+	for(int n=0; n<nodes; n++) m_nIdxH.AddDat(m_nIdV[n], n);
+	//Sorted neighbor lists without self-loops
+	TVec<TInt64> offV(nodes+1);
+	TVec<TInt,int64> nbrV(csrG.GetArcs(), 0);
+	TIntV degV(nodes);
+	for(int n=0; n<nodes; n++) {
+		for(int e=0; e<csrG.GetOutDeg(n); e++) {
+			if(csrG.GetOutNbr(n, e) != n) nbrV.Add(csrG.GetOutNbr(n, e));
+		}
+		offV[n+1] = nbrV.Len();
+		degV[n] = int(offV[n+1] - offV[n]);
+	}
+	//Triangles on every arc and at every node, non-induced 4-cycles through every node
+	TVec<TInt,int64> triV(nbrV.Len());
+	TVec<TInt64> nodeTriV(nodes), cycV(nodes);
+	#pragma omp parallel
+	{
+		TIntV cntV(nodes), touchedV;
+		#pragma omp for schedule(dynamic,100)
+		for(int v=0; v<nodes; v++) {
+			touchedV.Clr(false);
+			for(int64 e=offV[v]; e<offV[v+1]; e++) {
+				const int u = nbrV[e];
+				for(int64 f=offV[u]; f<offV[u+1]; f++) {
+					const int w = nbrV[f];
+					if(w == v) continue;
+					if(cntV[w] == 0) touchedV.Add(w);
+					cntV[w]++;
+				}
+			}
+			int64 tri = 0;
+			for(int64 e=offV[v]; e<offV[v+1]; e++) { triV[e] = cntV[nbrV[e]];  tri += triV[e]; }
+			nodeTriV[v] = tri/2;
+			int64 cyc = 0;
+			for(int i=0; i<touchedV.Len(); i++) {
+				const int64 c = cntV[touchedV[i]];
+				cyc += c*(c-1)/2;
+				cntV[touchedV[i]] = 0;
+			}
+			cycV[v] = cyc;
+		}
+	}
+	//4-cliques, each one is found once from its lowest node in the (degree, index) order
+	TVec<TInt64> cliqueV(nodes);
+	#pragma omp parallel
+	{
+		TIntV markV(nodes), mark2V(nodes), candV;
+		#pragma omp for schedule(dynamic,100)
+		for(int v=0; v<nodes; v++) {
+			for(int64 e=offV[v]; e<offV[v+1]; e++) {
+				const int u = nbrV[e];
+				if(degV[u] > degV[v] || (degV[u] == degV[v] && u > v)) markV[u] = v+1;
+			}
+			for(int64 e=offV[v]; e<offV[v+1]; e++) {
+				const int u = nbrV[e];
+				if(markV[u] != v+1) continue;
+				//higher common neighbors of v and u
+				candV.Clr(false);
+				for(int64 f=offV[u]; f<offV[u+1]; f++) {
+					const int w = nbrV[f];
+					if(markV[w] != v+1 || degV[w] < degV[u] || (degV[w] == degV[u] && w < u)) continue;
+					candV.Add(w);  mark2V[w] = u+1;
+				}
+				for(int i=0; i<candV.Len(); i++) {
+					const int w = candV[i];
+					for(int64 g=offV[w]; g<offV[w+1]; g++) {
+						const int x = nbrV[g];
+						if(markV[x] != v+1 || mark2V[x] != u+1 || degV[x] < degV[w] || (degV[x] == degV[w] && x < w)) continue;
+						__sync_fetch_and_add(&cliqueV[v].Val, 1);
+						__sync_fetch_and_add(&cliqueV[u].Val, 1);
+						__sync_fetch_and_add(&cliqueV[w].Val, 1);
+						__sync_fetch_and_add(&cliqueV[x].Val, 1);
+					}
+				}
+			}
+		}
+	}
+	//Sum of (degree-1) over the neighbors of every node
+	TVec<TInt64> nbrDegV(nodes);
+	for(int v=0; v<nodes; v++) {
+		for(int64 e=offV[v]; e<offV[v+1]; e++) nbrDegV[v] += degV[nbrV[e]]-1;
+	}
+	//Non-induced orbit counts, then induced ones from the overlaps between graphlets
+	m_orbitCntV.Gen(int64(nodes)*Orbits);
+	#pragma omp parallel
+	{
+		TIntV markV(nodes);
+		#pragma omp for schedule(dynamic,100)
+		for(int v=0; v<nodes; v++) {
+			const int64 d = degV[v], t = nodeTriV[v];
+			int64 n1=0, n4=0, n5=0, n6=0, n9=0, n10=0, n12=0, n13=0;
+			for(int64 e=offV[v]; e<offV[v+1]; e++) markV[nbrV[e]] = v+1;
+			for(int64 e=offV[v]; e<offV[v+1]; e++) {
+				const int u = nbrV[e];
+				const int64 du = degV[u], tu = triV[e];
+				n1 += du-1;
+				n4 += nbrDegV[u]-(d-1);
+				n5 += (d-1)*(du-1);
+				n6 += (du-1)*(du-2)/2;
+				n9 += nodeTriV[u]-tu;
+				n10 += tu*(du-2);
+				n13 += tu*(tu-1)/2;
+				for(int64 f=offV[u]; f<offV[u+1]; f++) {
+					if(markV[nbrV[f]] == v+1) n12 += triV[f]-1;
+				}
+			}
+			int64 o[Orbits];
+			o[14] = cliqueV[v];
+			o[13] = n13 - 3*o[14];
+			o[12] = n12/2 - 3*o[14];
+			o[11] = t*(d-2) - 2*o[13] - 3*o[14];
+			o[10] = n10 - 2*o[13] - 2*o[12] - 6*o[14];
+			o[9] = n9 - 2*o[12] - 3*o[14];
+			o[8] = cycV[v] - o[12] - o[13] - 3*o[14];
+			o[7] = d*(d-1)*(d-2)/6 - o[11] - o[13] - o[14];
+			o[6] = n6 - o[9] - o[10] - 2*o[12] - o[13] - 3*o[14];
+			o[5] = n5 - 2*t - 2*o[8] - o[10] - 2*o[11] - 2*o[12] - 4*o[13] - 6*o[14];
+			o[4] = n4 - 2*t - 2*o[8] - 2*o[9] - o[10] - 4*o[12] - 2*o[13] - 6*o[14];
+			o[3] = t;
+			o[2] = d*(d-1)/2 - t;
+			o[1] = n1 - 2*t;
+			o[0] = d;
+			for(int i=0; i<Orbits; i++) m_orbitCntV[int64(v)*Orbits+i] = uint64(o[i]);
+		}
+	}
+}
+
+uint64 TGraphletOrbitCounter::GetOrbitCnt(const int& NId, const int& Orbit) const {
+	IAssert(0 <= Orbit && Orbit < Orbits);
+	return m_orbitCntV[int64(m_nIdxH.GetDat(NId))*Orbits+Orbit];
+}
+
+void TGraphletOrbitCounter::GetOrbitCntV(const int& NId, TVec<TUInt64> &CntV) const {
+	const int64 offset = int64(m_nIdxH.GetDat(NId))*Orbits;
+	CntV.Gen(Orbits);
+	for(int i=0; i<Orbits; i++) CntV[i] = m_orbitCntV[offset+i];
+}
+
+uint64 TGraphletOrbitCounter::GetGraphletCnt(const int& Graphlet) const {
+	IAssert(0 <= Graphlet && Graphlet < Graphlets);
+	//an orbit of every graphlet and the number of its nodes in that orbit
+	static const int orbit[] = {0, 2, 3, 4, 7, 8, 11, 13, 14};
+	static const int orbitNodes[] = {2, 1, 3, 2, 1, 4, 1, 2, 4};
+	uint64 cnt = 0;
+	for(int v=0; v<GetNodes(); v++) cnt += m_orbitCntV[int64(v)*Orbits+orbit[Graphlet]];
+	return cnt / orbitNodes[Graphlet];
+}
+
 /////////////////////////////////////////////////
 // Directed ghash graph counter implementation
 void TDGHashGraphCounter::operator()(const PNGraph &G, const TIntV &sg) {
@@ -248,6 +430,30 @@ void TGraphEnumUtils::GetIsoGraphs(const PNGraph &G, TVec<PNGraph> &isoG) {
 	}
 }
 
+void TGraphEnumUtils::GetCanonIdV(int nodes, TIntV &canonIdV) {
+	IAssert(nodes > 0 && nodes <= 4);
+	TIntV v(nodes); for(int i=0; i<nodes; i++) v[i]=i;
+	TVec<TIntV> perms; GetPermutations(v, 0, perms);
+	//
+	int selfMask = 0;
+	for(int i=0; i<nodes; i++) selfMask |= 1 << (i*nodes+i);
+	canonIdV.Gen(1 << (nodes*nodes));
+	for(int graphId=0; graphId<canonIdV.Len(); graphId++) {
+		if((graphId & selfMask) != 0) { canonIdV[graphId] = -1; continue; }
+		int minGraphId = graphId;
+		for(int i=0; i<perms.Len(); i++) {
+			int permId = 0;
+			for(int row=0; row<nodes; row++) {
+				for(int col=0; col<nodes; col++) {
+					if((graphId >> (row*nodes+col)) & 1) permId |= 1 << (perms[i][row]*nodes + perms[i][col]);
+				}
+			}
+			if(permId < minGraphId) minGraphId = permId;
+		}
+		canonIdV[graphId] = minGraphId;
+	}
+}
+
 void TGraphEnumUtils::GetIndGraph(const PNGraph &G, const TIntV &sg, PNGraph &indG) {
 	//Add nodes
 	for(int i=0; i<sg.Len(); i++) indG->AddNode(sg[i]);
@@ -15,8 +15,12 @@ public:
   int GetId(const int& i) const { return m_graphCounters.GetKey(i); }
   uint64 GetCnt(const  int& GraphId) const { return m_graphCounters.GetDat(GraphId); }
   PNGraph GetGraph(const int& GraphId) const;
+  // Sets all counts to zero
+  void ClrCnt();
+  // Adds the counts of Counter (used to merge per-thread counters)
+  void AddCnt(const TD34GraphCounter& Counter);
 private:
-  THash<TInt,TInt> m_graphMaps;
+  TIntV m_graphMaps; // graph id -> key id of its canonical graph in m_graphCounters, -1 if the graph is not connected
   THash<TInt,TUInt64> m_graphCounters;
   int m_subGraphSize;
 };
@@ -27,6 +31,10 @@ class TDGraphCounter{
 public:
   void operator()(const PNGraph &G, const TIntV &sg);
   THash<TUInt64,TUInt64> &GraphCounters() { return m_graphCounters; }
+  // Sets all counts to zero
+  void ClrCnt();
+  // Adds the counts of Counter (used to merge per-thread counters)
+  void AddCnt(const TDGraphCounter& Counter);
 private:
   THash<TUInt64,TUInt64> m_graphMaps;
   THash<TUInt64,TUInt64> m_graphCounters;
@@ -44,6 +52,40 @@ private:
   TGHash<TUInt64> m_graphs;
 };
 
+/////////////////////////////////////////////////
+// Undirected graphlet orbit counter
+//
+// Counts, for every node, in how many induced connected graphlets on 2, 3
+// and 4 nodes the node appears in each of the 15 automorphism orbits
+// (orbit numbering of Przulj, Bioinformatics, 2007). Only 4-cliques are
+// enumerated, all other orbits are obtained from degrees, triangles on
+// edges and common neighbors, as in the ORCA algorithm by Hocevar and
+// Demsar, Bioinformatics, 2014. Self-loops are ignored.
+//   0: edge               1, 2: 3-path (end, middle)   3: triangle
+//   4, 5: 4-path (end, inner)    6, 7: 3-star (leaf, center)   8: 4-cycle
+//   9, 10, 11: paw (tail, triangle node, attachment node)
+//   12, 13: diamond (degree 2, degree 3 node)   14: 4-clique
+class TGraphletOrbitCounter {
+public:
+  static const int Orbits = 15;
+  static const int Graphlets = 9;
+public:
+  TGraphletOrbitCounter(const PUNGraph &G);
+public:
+  int GetNodes() const { return m_nIdV.Len(); }
+  // Returns the number of times node NId appears in orbit Orbit
+  uint64 GetOrbitCnt(const int& NId, const int& Orbit) const;
+  // Returns the counts of all 15 orbits of node NId
+  void GetOrbitCntV(const int& NId, TVec<TUInt64> &CntV) const;
+  // Returns the number of induced graphlets number Graphlet (0: edge, 1: 3-path, 2: triangle, 3: 4-path,
+  // 4: 3-star, 5: 4-cycle, 6: paw, 7: diamond, 8: 4-clique)
+  uint64 GetGraphletCnt(const int& Graphlet) const;
+private:
+  TIntV m_nIdV;                       // node index -> node id
+  THash<TInt,TInt> m_nIdxH;           // node id -> node index
+  TVec<TUInt64,int64> m_orbitCntV;    // Orbits counts of every node index
+};
+
 /////////////////////////////////////////////////
 // Directed 3 graph
 class TD3Graph {
@@ -93,6 +135,8 @@ public:
 public:
   static void GetIsoGraphs(uint64 graphId, int nodes, TVec<PNGraph> &isoG);
   static void GetIsoGraphs(const PNGraph &G, TVec<PNGraph> &isoG);
+  // Maps every graph id on nodes<=4 nodes to the smallest id of its isomorphic graphs, -1 for ids with self-loops
+  static void GetCanonIdV(int nodes, TIntV &canonIdV);
 public:
   static uint64 GraphId(const PNGraph &G);
   static uint64 GraphId(const PNGraph &G, const TIntV &sg);
@@ -455,6 +455,62 @@ PNGraph TKronMtx::GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, co
   return Graph;
 }
 
+// RMat like recursive descent of GenFastKronecker() for edge EdgeN
+class TKronEdgeGen {
+private:
+  int NIter, MtxDim, Nodes;
+  uint64 Seed;
+  TFltV CumProbV; // cumulative cell probability
+  TIntV RowV, ColV;
+public:
+  TKronEdgeGen(const TKronMtx& SeedMtx, const int& _NIter, const int& _Seed) :
+      NIter(_NIter), MtxDim(SeedMtx.GetDim()), Nodes(SeedMtx.GetNodes(_NIter)), Seed(_Seed) {
+    const double MtxSum = SeedMtx.GetMtxSum();
+    double CumProb = 0.0;
+    for (int r = 0; r < MtxDim; r++) {
+      for (int c = 0; c < MtxDim; c++) {
+        const double Prob = SeedMtx.At(r, c);
+        if (Prob > 0.0) {
+          CumProb += Prob;
+          CumProbV.Add(CumProb/MtxSum);  RowV.Add(r);  ColV.Add(c);
+        }
+      }
+    }
+    IAssert(! CumProbV.Empty());
+  }
+  void GetEdge(const int64& EdgeN, int& Row, int& Col) const {
+    TCntRnd Rnd(Seed, EdgeN);
+    const int LastN = CumProbV.Len()-1;
+    int Rng = Nodes;  Row = 0;  Col = 0;
+    for (int iter = 0; iter < NIter; iter++) {
+      const double Prob = Rnd.GetUniDev();
+      int n = 0;
+      while (n < LastN && Prob > CumProbV[n]) { n++; }
+      Rng /= MtxDim;
+      Row += RowV[n] * Rng;
+      Col += ColV[n] * Rng;
+    }
+  }
+};
+
+// Edges is the number of distinct edges, for undirected graphs each edge counts twice (as in GenFastKronecker)
+PNGraph TKronMtx::GenFastKroneckerMP(const TKronMtx& SeedMtx, const int& NIter, const int& Edges, const bool& IsDir, const int& Seed) {
+  const int NNodes = SeedMtx.GetNodes(NIter);
+  printf("  FastKroneckerMP: %d nodes, %d edges, %s...\n", NNodes, Edges, IsDir ? "Directed":"UnDirected");
+  const TKronEdgeGen EdgeGen(SeedMtx, NIter, Seed);
+  const int DistEdges = IsDir ? Edges : (Edges+1)/2;
+  int64 Draws = 0;
+  PNGraph Graph = TSnap::TSnapDetail::GenEdgeGraphMP(EdgeGen, NNodes, DistEdges, IsDir, Draws);
+  printf("             collisions: %s (%.4f)\n", TInt::GetStr(Draws-DistEdges).CStr(), (Draws-DistEdges)/(double)Graph->GetEdges());
+  return Graph;
+}
+
+void TKronMtx::SaveFastKroneckerMP(const TStr& OutFNm, const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& Binary, const int& Seed) {
+  const TKronEdgeGen EdgeGen(SeedMtx, NIter, Seed);
+  TSnap::TSnapDetail::SaveEdgesMP(EdgeGen, OutFNm, SeedMtx.GetNodes(NIter), Edges, Binary,
+    TStr::Fmt("Kronecker Graph: seed matrix [%s], %d iterations, seed %d", SeedMtx.GetMtxStr().CStr(), NIter, Seed));
+}
+
 PNGraph TKronMtx::GenDetKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir) {
   const TKronMtx& SeedGraph = SeedMtx;
   const int NNodes = SeedGraph.GetNodes(NIter);
@@ -778,6 +834,86 @@ TKronMtx TKronMtx::LoadTxt(const TStr& MtxFNm) {
 }
 
 
+/////////////////////////////////////////////////
+// Kronecker Edge Log Likelihood Table
+const int TKronLLTbl::MxParams = 64;
+
+void TKronLLTbl::Gen(const TKronMtx& LLMtxPt, const int& NKronIters) {
+  if (IsFor(LLMtxPt, NKronIters)) { return; }
+  LLMtx = LLMtxPt;  KronIters = NKronIters;
+  Dim = LLMtx.GetDim();  Params = LLMtx.Len();
+  BlkCntV.Clr();  TailCntV.Clr();
+  // zero probabilities and large initiators use TKronMtx::GetEdgeLL()
+  if (KronIters < 1 || Params > MxParams) { return; }
+  for (int p = 0; p < Params; p++) {
+    if (LLMtx.At(p) == TKronMtx::NInf) { return; } }
+  // blocks of levels with at most 16x16 (row, col) digit combinations
+  int BlkLevels = 1;  BlkDim = Dim;
+  while (BlkDim*Dim <= 16 && BlkLevels < KronIters) { BlkDim = BlkDim*Dim;  BlkLevels++; }
+  Blocks = KronIters / BlkLevels;
+  const int TailLevels = KronIters % BlkLevels;
+  TailDim = 1;
+  for (int l = 0; l < TailLevels; l++) { TailDim = TailDim*Dim; }
+  GenCntV(BlkDim, BlkLevels, BlkCntV);
+  GenCntV(TailDim, TailLevels, TailCntV);
+  TrParamV.Gen(Params);  InvProbV.Gen(Params);
+  for (int p = 0; p < Params; p++) {
+    TrParamV[p] = Dim*(p % Dim) + p / Dim;
+    InvProbV[p] = 1.0 / exp(LLMtx.At(p));
+  }
+}
+
+void TKronLLTbl::GenCntV(const int& BDim, const int& Levels, TIntV& CntV) const {
+  CntV.Gen(BDim*BDim*Params);
+  for (int Row = 0; Row < BDim; Row++) {
+    for (int Col = 0; Col < BDim; Col++) {
+      const int Off = (Row*BDim + Col)*Params;
+      int R = Row, C = Col;
+      for (int level = 0; level < Levels; level++) {
+        CntV[Off + Dim*(R % Dim) + C % Dim]++;
+        R /= Dim;  C /= Dim;
+      }
+    }
+  }
+}
+
+void TKronLLTbl::GetCnt(int NId1, int NId2, int* CntV) const {
+  for (int p = 0; p < Params; p++) { CntV[p] = 0; }
+  for (int b = 0; b < Blocks; b++) {
+    const int Off = ((NId1 % BlkDim)*BlkDim + NId2 % BlkDim)*Params;
+    for (int p = 0; p < Params; p++) { CntV[p] += BlkCntV[Off+p]; }
+    NId1 /= BlkDim;  NId2 /= BlkDim;
+  }
+  if (TailDim > 1) {
+    const int Off = (NId1*TailDim + NId2)*Params;
+    for (int p = 0; p < Params; p++) { CntV[p] += TailCntV[Off+p]; }
+  }
+}
+
+double TKronLLTbl::GetApxEdgeLL(const int& NId1, const int& NId2) const {
+  int CntV[MxParams];
+  GetCnt(NId1, NId2, CntV);
+  double LL = 0.0;
+  for (int p = 0; p < Params; p++) { LL += CntV[p]*LLMtx.At(p); }
+  const double Prob = exp(LL);
+  return LL + Prob + 0.5*Prob*Prob;
+}
+
+// same parameter indexing as TKronMtx::GetEdgeDLL() and TKronMtx::GetApxNoEdgeDLL()
+void TKronLLTbl::AddApxEdgeDLL(const int& NId1, const int& NId2, const double& Sign, TFltV& DLLV) const {
+  int CntV[MxParams];
+  GetCnt(NId1, NId2, CntV);
+  double LL = 0.0;
+  for (int p = 0; p < Params; p++) { LL += CntV[p]*LLMtx.At(p); }
+  const double Prob = exp(LL);
+  const double NoEdgeD = Prob + Prob*Prob;
+  for (int p = 0; p < Params; p++) {
+    const int Cnt = CntV[TrParamV[p]];
+    if (Cnt == 0) { continue; }
+    DLLV[p] += Sign*Cnt*(InvProbV[p] + NoEdgeD*InvProbV[TrParamV[p]]);
+  }
+}
+
 /////////////////////////////////////////////////
 // Kronecker Log Likelihood
 TKroneckerLL::TKroneckerLL(const PNGraph& GraphPt, const TFltV& ParamV, const double& PermPSwapNd): PermSwapNodeProb(PermPSwapNd) {
@@ -1035,17 +1171,22 @@ double TKroneckerLL::CalcGraphLL() {
 
 // approximate graph log-likelihood, takes O(E + N_0)
 double TKroneckerLL::CalcApxGraphLL() {
-  LogLike = GetApxEmptyGraphLL(); // O(N_0)
-  for (int nid = 0; nid < Nodes; nid++) {
+  LLTbl.Gen(LLMtx, KronIters);
+  LogLike = CalcApxGraphLL(NodePerm, IsLLTbl());
+  return LogLike;
+}
+
+double TKroneckerLL::CalcApxGraphLL(const TIntV& Perm, const bool& UseTbl) const {
+  const int NNodes = Nodes;
+  double LL = 0.0;
+  #pragma omp parallel for schedule(dynamic, 1024) reduction(+:LL)
+  for (int nid = 0; nid < NNodes; nid++) {
     const TNGraph::TNodeI Node = Graph->GetNI(nid);
-    const int SrcNId = NodePerm[nid];
+    const int SrcNId = Perm[nid];
     for (int e = 0; e < Node.GetOutDeg(); e++) {
-      const int DstNId = NodePerm[Node.GetOutNId(e)];
-      LogLike = LogLike - LLMtx.GetApxNoEdgeLL(SrcNId, DstNId, KronIters)
-        + LLMtx.GetEdgeLL(SrcNId, DstNId, KronIters);
-    }
+      LL += GetApxEdgeLL(SrcNId, Perm[Node.GetOutNId(e)], UseTbl); }
   }
-  return LogLike;
+  return GetApxEmptyGraphLL() + LL; // O(N_0)
 }
 
 // Used in TKroneckerLL::SwapNodesLL: DeltaLL if we
@@ -1053,27 +1194,24 @@ double TKroneckerLL::CalcApxGraphLL() {
 // of its in- and out-edges).
 // Zero is for the empty row/column (isolated node)
 double TKroneckerLL::NodeLLDelta(const int& NId) const {
+  return NodeLLDelta(NId, NodePerm, IsLLTbl());
+}
+
+double TKroneckerLL::NodeLLDelta(const int& NId, const TIntV& Perm, const bool& UseTbl) const {
   if (! Graph->IsNode(NId)) { return 0.0; } // zero degree node
   double Delta = 0.0;
   const TNGraph::TNodeI Node = Graph->GetNI(NId);
   // out-edges
-  const int SrcRow = NodePerm[NId];
+  const int SrcRow = Perm[NId];
   for (int e = 0; e < Node.GetOutDeg(); e++) {
-    const int DstCol = NodePerm[Node.GetOutNId(e)];
-    Delta += - LLMtx.GetApxNoEdgeLL(SrcRow, DstCol, KronIters)
-      + LLMtx.GetEdgeLL(SrcRow, DstCol, KronIters);
-  }
+    Delta += GetApxEdgeLL(SrcRow, Perm[Node.GetOutNId(e)], UseTbl); }
   //in-edges
-  const int SrcCol = NodePerm[NId];
+  const int SrcCol = Perm[NId];
   for (int e = 0; e < Node.GetInDeg(); e++) {
-    const int DstRow = NodePerm[Node.GetInNId(e)];
-    Delta += - LLMtx.GetApxNoEdgeLL(DstRow, SrcCol, KronIters)
-      + LLMtx.GetEdgeLL(DstRow, SrcCol, KronIters);
-  }
+    Delta += GetApxEdgeLL(Perm[Node.GetInNId(e)], SrcCol, UseTbl); }
   // double counted self-edge
   if (Graph->IsEdge(NId, NId)) {
-    Delta += + LLMtx.GetApxNoEdgeLL(SrcRow, SrcCol, KronIters)
-      - LLMtx.GetEdgeLL(SrcRow, SrcCol, KronIters);
+    Delta -= GetApxEdgeLL(SrcRow, SrcCol, UseTbl);
     IAssert(SrcRow == SrcCol);
   }
   return Delta;
@@ -1081,54 +1219,56 @@ double TKroneckerLL::NodeLLDelta(const int& NId) const {
 
 // swapping two nodes, only need to go over two rows and columns
 double TKroneckerLL::SwapNodesLL(const int& NId1, const int& NId2) {
+  LogLike = SwapNodesLL(NId1, NId2, NodePerm, InvertPerm, LogLike, IsLLTbl());
+  return LogLike;
+}
+
+double TKroneckerLL::SwapNodesLL(const int& NId1, const int& NId2, TIntV& Perm, TIntV& IPerm, double LL, const bool& UseTbl) const {
   // subtract old LL (remove nodes)
-  LogLike = LogLike - NodeLLDelta(NId1) - NodeLLDelta(NId2);
-  const int PrevId1 = NodePerm[NId1], PrevId2 = NodePerm[NId2];
+  LL = LL - NodeLLDelta(NId1, Perm, UseTbl) - NodeLLDelta(NId2, Perm, UseTbl);
+  const int PrevId1 = Perm[NId1], PrevId2 = Perm[NId2];
   // double-counted edges
-  if (Graph->IsEdge(NId1, NId2)) {
-    LogLike += - LLMtx.GetApxNoEdgeLL(PrevId1, PrevId2, KronIters)
-      + LLMtx.GetEdgeLL(PrevId1, PrevId2, KronIters); }
-  if (Graph->IsEdge(NId2, NId1)) {
-    LogLike += - LLMtx.GetApxNoEdgeLL(PrevId2, PrevId1, KronIters)
-      + LLMtx.GetEdgeLL(PrevId2, PrevId1, KronIters); }
+  if (Graph->IsEdge(NId1, NId2)) { LL += GetApxEdgeLL(PrevId1, PrevId2, UseTbl); }
+  if (Graph->IsEdge(NId2, NId1)) { LL += GetApxEdgeLL(PrevId2, PrevId1, UseTbl); }
   // swap
-  NodePerm.Swap(NId1, NId2);
-  InvertPerm.Swap(NodePerm[NId1], NodePerm[NId2]);
+  Perm.Swap(NId1, NId2);
+  IPerm.Swap(Perm[NId1], Perm[NId2]);
   // add new LL (add nodes)
-  LogLike = LogLike + NodeLLDelta(NId1) + NodeLLDelta(NId2);
-  const int NewId1 = NodePerm[NId1], NewId2 = NodePerm[NId2];
+  LL = LL + NodeLLDelta(NId1, Perm, UseTbl) + NodeLLDelta(NId2, Perm, UseTbl);
+  const int NewId1 = Perm[NId1], NewId2 = Perm[NId2];
   // correct for double-counted edges
-  if (Graph->IsEdge(NId1, NId2)) {
-    LogLike += + LLMtx.GetApxNoEdgeLL(NewId1, NewId2, KronIters)
-      - LLMtx.GetEdgeLL(NewId1, NewId2, KronIters); }
-  if (Graph->IsEdge(NId2, NId1)) {
-    LogLike += + LLMtx.GetApxNoEdgeLL(NewId2, NewId1, KronIters)
-      - LLMtx.GetEdgeLL(NewId2, NewId1, KronIters); }
-  return LogLike;
+  if (Graph->IsEdge(NId1, NId2)) { LL -= GetApxEdgeLL(NewId1, NewId2, UseTbl); }
+  if (Graph->IsEdge(NId2, NId1)) { LL -= GetApxEdgeLL(NewId2, NewId1, UseTbl); }
+  return LL;
 }
 
 // metropolis sampling from P(permutation|graph)
 bool TKroneckerLL::SampleNextPerm(int& NId1, int& NId2) {
+  return SampleNextPerm(NId1, NId2, TKronMtx::Rnd, NodePerm, InvertPerm, LogLike.Val, IsLLTbl());
+}
+
+bool TKroneckerLL::SampleNextPerm(int& NId1, int& NId2, TRnd& Rnd, TIntV& Perm, TIntV& IPerm, double& LL, const bool& UseTbl) const {
   // pick 2 uniform nodes and swap
-  if (TKronMtx::Rnd.GetUniDev() < PermSwapNodeProb) {
-    NId1 = TKronMtx::Rnd.GetUniDevInt(Nodes);
-    NId2 = TKronMtx::Rnd.GetUniDevInt(Nodes);
-    while (NId2 == NId1) { NId2 = TKronMtx::Rnd.GetUniDevInt(Nodes); }
+  if (Rnd.GetUniDev() < PermSwapNodeProb) {
+    NId1 = Rnd.GetUniDevInt(Nodes);
+    NId2 = Rnd.GetUniDevInt(Nodes);
+    while (NId2 == NId1) { NId2 = Rnd.GetUniDevInt(Nodes); }
   } else {
     // pick uniform edge and swap endpoints (slow as it moves around high degree nodes)
-    const int e = TKronMtx::Rnd.GetUniDevInt(GEdgeV.Len());
+    const int e = Rnd.GetUniDevInt(GEdgeV.Len());
     NId1 = GEdgeV[e].Val1;  NId2 = GEdgeV[e].Val2;
   }
-  const double U = TKronMtx::Rnd.GetUniDev();
-  const double OldLL = LogLike;
-  const double NewLL = SwapNodesLL(NId1, NId2);
+  const double U = Rnd.GetUniDev();
+  const double OldLL = LL;
+  const double NewLL = SwapNodesLL(NId1, NId2, Perm, IPerm, LL, UseTbl);
   const double LogU = log(U);
   if (LogU > NewLL - OldLL) { // reject
-    LogLike = OldLL;
-    NodePerm.Swap(NId2, NId1); //swap back
-	InvertPerm.Swap(NodePerm[NId2], NodePerm[NId1]); // swap back
+    LL = OldLL;
+    Perm.Swap(NId2, NId1); //swap back
+    IPerm.Swap(Perm[NId2], Perm[NId1]); // swap back
     return false;
   }
+  LL = NewLL;
   return true; // accept new sample
 }
 
@@ -1192,20 +1332,40 @@ const TFltV& TKroneckerLL::CalcFullApxGraphDLL() {
 
 // fast approximate gradient, runs O(E)
 const TFltV& TKroneckerLL::CalcApxGraphDLL() {
+  LLTbl.Gen(LLMtx, KronIters);
+  CalcApxGraphDLL(NodePerm, IsLLTbl(), GradV);
+  return GradV;
+}
+
+void TKroneckerLL::AddApxEdgeDLL(const int& Row, const int& Col, const double& Sign, const bool& UseTbl, TFltV& DLLV) const {
+  if (UseTbl) { LLTbl.AddApxEdgeDLL(Row, Col, Sign, DLLV); return; }
   for (int ParamId = 0; ParamId < LLMtx.Len(); ParamId++) {
-    double DLL = GetApxEmptyGraphDLL(ParamId);
-    for (int nid = 0; nid < Nodes; nid++) {
+    DLLV[ParamId] += Sign*(LLMtx.GetEdgeDLL(ParamId, Row, Col, KronIters)
+      - LLMtx.GetApxNoEdgeDLL(ParamId, Row, Col, KronIters));
+  }
+}
+
+void TKroneckerLL::CalcApxGraphDLL(const TIntV& Perm, const bool& UseTbl, TFltV& DLLV) const {
+  const int NNodes = Nodes, Params = LLMtx.Len();
+  DLLV.Gen(Params);
+  for (int ParamId = 0; ParamId < Params; ParamId++) {
+    DLLV[ParamId] = GetApxEmptyGraphDLL(ParamId); }
+  #pragma omp parallel
+  {
+    TFltV ThDLLV(Params);
+    #pragma omp for schedule(dynamic, 1024)
+    for (int nid = 0; nid < NNodes; nid++) {
       const TNGraph::TNodeI Node = Graph->GetNI(nid);
-      const int SrcNId = NodePerm[nid];
+      const int SrcNId = Perm[nid];
       for (int e = 0; e < Node.GetOutDeg(); e++) {
-        const int DstNId = NodePerm[Node.GetOutNId(e)];
-        DLL = DLL - LLMtx.GetApxNoEdgeDLL(ParamId, SrcNId, DstNId, KronIters)
-          + LLMtx.GetEdgeDLL(ParamId, SrcNId, DstNId, KronIters);
-      }
+        AddApxEdgeDLL(SrcNId, Perm[Node.GetOutNId(e)], 1.0, UseTbl, ThDLLV); }
+    }
+    #pragma omp critical
+    {
+      for (int ParamId = 0; ParamId < Params; ParamId++) {
+        DLLV[ParamId] += ThDLLV[ParamId]; }
     }
-    GradV[ParamId] = DLL;
   }
-  return GradV;
 }
 
 // Used in TKroneckerLL::UpdateGraphDLL: DeltaDLL if we
@@ -1236,39 +1396,53 @@ double TKroneckerLL::NodeDLLDelta(const int ParamId, const int& NId) const {
   return Delta;
 }
 
+// all parameters at once, adds Sign*DeltaDLL to DLLV
+void TKroneckerLL::NodeDLLDelta(const int& NId, const TIntV& Perm, const double& Sign, const bool& UseTbl, TFltV& DLLV) const {
+  if (! Graph->IsNode(NId)) { return; } // zero degree node
+  const TNGraph::TNodeI Node = Graph->GetNI(NId);
+  const int SrcRow = Perm[NId];
+  for (int e = 0; e < Node.GetOutDeg(); e++) {
+    AddApxEdgeDLL(SrcRow, Perm[Node.GetOutNId(e)], Sign, UseTbl, DLLV); }
+  const int SrcCol = Perm[NId];
+  for (int e = 0; e < Node.GetInDeg(); e++) {
+    AddApxEdgeDLL(Perm[Node.GetInNId(e)], SrcCol, Sign, UseTbl, DLLV); }
+  // double counter self-edge
+  if (Graph->IsEdge(NId, NId)) {
+    AddApxEdgeDLL(SrcRow, SrcCol, -Sign, UseTbl, DLLV);
+    IAssert(SrcRow == SrcCol);
+  }
+}
+
 // given old DLL and new permutation, efficiently updates the DLL
 // permutation is new, but DLL is old
 void TKroneckerLL::UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2) {
-  for (int ParamId = 0; ParamId < LLMtx.Len(); ParamId++) {
-    // permutation before the swap (swap back to previous position)
-    NodePerm.Swap(SwapNId1, SwapNId2);
-    // subtract old DLL
-    TFlt& DLL = GradV[ParamId];
-    DLL = DLL - NodeDLLDelta(ParamId, SwapNId1) - NodeDLLDelta(ParamId, SwapNId2);
-    // double-counted edges
-    const int PrevId1 = NodePerm[SwapNId1], PrevId2 = NodePerm[SwapNId2];
-    if (Graph->IsEdge(SwapNId1, SwapNId2)) {
-      DLL += - LLMtx.GetApxNoEdgeDLL(ParamId, PrevId1, PrevId2, KronIters)
-        + LLMtx.GetEdgeDLL(ParamId, PrevId1, PrevId2, KronIters); }
-    if (Graph->IsEdge(SwapNId2, SwapNId1)) {
-      DLL += - LLMtx.GetApxNoEdgeDLL(ParamId, PrevId2, PrevId1, KronIters)
-        + LLMtx.GetEdgeDLL(ParamId, PrevId2, PrevId1, KronIters); }
-    // permutation after the swap (restore the swap)
-    NodePerm.Swap(SwapNId1, SwapNId2);
-    // add new DLL
-    DLL = DLL + NodeDLLDelta(ParamId, SwapNId1) + NodeDLLDelta(ParamId, SwapNId2);
-    const int NewId1 = NodePerm[SwapNId1], NewId2 = NodePerm[SwapNId2];
-    // double-counted edges
-    if (Graph->IsEdge(SwapNId1, SwapNId2)) {
-      DLL += + LLMtx.GetApxNoEdgeDLL(ParamId, NewId1, NewId2, KronIters)
-        - LLMtx.GetEdgeDLL(ParamId, NewId1, NewId2, KronIters); }
-    if (Graph->IsEdge(SwapNId2, SwapNId1)) {
-      DLL += + LLMtx.GetApxNoEdgeDLL(ParamId, NewId2, NewId1, KronIters)
-        - LLMtx.GetEdgeDLL(ParamId, NewId2, NewId1, KronIters); }
-  }
+  UpdateGraphDLL(SwapNId1, SwapNId2, NodePerm, IsLLTbl(), GradV);
+}
+
+void TKroneckerLL::UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2, TIntV& Perm, const bool& UseTbl, TFltV& DLLV) const {
+  // permutation before the swap (swap back to previous position)
+  Perm.Swap(SwapNId1, SwapNId2);
+  // subtract old DLL
+  NodeDLLDelta(SwapNId1, Perm, -1.0, UseTbl, DLLV);
+  NodeDLLDelta(SwapNId2, Perm, -1.0, UseTbl, DLLV);
+  // double-counted edges
+  const int PrevId1 = Perm[SwapNId1], PrevId2 = Perm[SwapNId2];
+  if (Graph->IsEdge(SwapNId1, SwapNId2)) { AddApxEdgeDLL(PrevId1, PrevId2, 1.0, UseTbl, DLLV); }
+  if (Graph->IsEdge(SwapNId2, SwapNId1)) { AddApxEdgeDLL(PrevId2, PrevId1, 1.0, UseTbl, DLLV); }
+  // permutation after the swap (restore the swap)
+  Perm.Swap(SwapNId1, SwapNId2);
+  // add new DLL
+  NodeDLLDelta(SwapNId1, Perm, 1.0, UseTbl, DLLV);
+  NodeDLLDelta(SwapNId2, Perm, 1.0, UseTbl, DLLV);
+  const int NewId1 = Perm[SwapNId1], NewId2 = Perm[SwapNId2];
+  // double-counted edges
+  if (Graph->IsEdge(SwapNId1, SwapNId2)) { AddApxEdgeDLL(NewId1, NewId2, -1.0, UseTbl, DLLV); }
+  if (Graph->IsEdge(SwapNId2, SwapNId1)) { AddApxEdgeDLL(NewId2, NewId1, -1.0, UseTbl, DLLV); }
 }
 
 void TKroneckerLL::SampleGradient(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& AvgGradV) {
+  if (GetChains() > 1) {
+    SampleGradientChains(WarmUp, NSamples, AvgLL, AvgGradV);  return; }
   printf("SampleGradient: %s (%s warm-up):", TInt::GetMegaStr(NSamples).CStr(), TInt::GetMegaStr(WarmUp).CStr());
   int NId1=0, NId2=0, NAccept=0;
   TExeTm ExeTm1;
@@ -1296,6 +1470,67 @@ void TKroneckerLL::SampleGradient(const int& WarmUp, const int& NSamples, double
     double(100*NAccept)/double(NSamples));
 }
 
+// runs Chains independent Metropolis chains in parallel, each with its own
+// permutation, LL and DLL. Chains persist across calls and are restarted from
+// NodePerm when it was changed from the outside. NodePerm, LogLike and GradV
+// are set to the state of the first chain.
+void TKroneckerLL::SampleGradientChains(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& AvgGradV) {
+  const int NChains = GetChains(), Params = LLMtx.Len();
+  printf("SampleGradient: %s (%s warm-up), %d chains:", TInt::GetMegaStr(NSamples).CStr(), TInt::GetMegaStr(WarmUp).CStr(), NChains);
+  TExeTm ExeTm1;
+  LLTbl.Gen(LLMtx, KronIters);
+  const bool UseTbl = IsLLTbl();
+  if (ChainPermV.Len() != NChains || ! (ChainPermV[0] == NodePerm)) {
+    ChainPermV.Gen(NChains);  ChainIPermV.Gen(NChains);  ChainRndV.Gen(NChains);
+    for (int c = 0; c < NChains; c++) {
+      ChainPermV[c] = NodePerm;  ChainIPermV[c] = InvertPerm;
+      ChainRndV[c].PutSeed(TKronMtx::Rnd.GetUniDevInt(1, TInt::Mx-1));
+    }
+  }
+  TFltV SumLLV(NChains), LastLLV(NChains);
+  TVec<TFltV> SumDLLV(NChains), LastDLLV(NChains);
+  TIntV AcceptV(NChains);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < NChains; c++) {
+    TIntV& Perm = ChainPermV[c];
+    TIntV& IPerm = ChainIPermV[c];
+    TRnd& Rnd = ChainRndV[c];
+    const int Samples = NSamples / NChains + (c < NSamples % NChains ? 1 : 0);
+    int NId1=0, NId2=0, NAccept=0;
+    double LL;
+    if (WarmUp > 0) {
+      LL = CalcApxGraphLL(Perm, UseTbl);
+      for (int s = 0; s < WarmUp; s++) { SampleNextPerm(NId1, NId2, Rnd, Perm, IPerm, LL, UseTbl); }
+    }
+    LL = CalcApxGraphLL(Perm, UseTbl); // re-calculate LL (due to numerical errors)
+    TFltV& DLLV = LastDLLV[c];
+    CalcApxGraphDLL(Perm, UseTbl, DLLV);
+    TFltV& SumV = SumDLLV[c];
+    SumV.Gen(Params);
+    double SumLL = 0.0;
+    for (int s = 0; s < Samples; s++) {
+      if (SampleNextPerm(NId1, NId2, Rnd, Perm, IPerm, LL, UseTbl)) { // new permutation
+        UpdateGraphDLL(NId1, NId2, Perm, UseTbl, DLLV);  NAccept++; }
+      for (int m = 0; m < Params; m++) { SumV[m] += DLLV[m]; }
+      SumLL += LL;
+    }
+    SumLLV[c] = SumLL;  LastLLV[c] = LL;  AcceptV[c] = NAccept;
+  }
+  int NAccept = 0;
+  AvgLL = 0;
+  AvgGradV.Gen(Params);  AvgGradV.PutAll(0.0);
+  for (int c = 0; c < NChains; c++) {
+    AvgLL += SumLLV[c];  NAccept += AcceptV[c];
+    for (int m = 0; m < Params; m++) { AvgGradV[m] += SumDLLV[c][m]; }
+  }
+  AvgLL = AvgLL / double(NSamples);
+  for (int m = 0; m < Params; m++) {
+    AvgGradV[m] = AvgGradV[m] / double(NSamples); }
+  NodePerm = ChainPermV[0];  InvertPerm = ChainIPermV[0];
+  LogLike = LastLLV[0];  GradV = LastDLLV[0];
+  printf(" %s, accept %.1f%%\n", ExeTm1.GetTmStr(), double(100*NAccept)/double(NSamples));
+}
+
 double TKroneckerLL::GradDescent(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples) {
   printf("\n----------------------------------------------------------------------\n");
   printf("Fitting graph on %d nodes, %d edges\n", Graph->GetNodes(), Graph->GetEdges());
@@ -88,6 +88,9 @@ public:
   static PNGraph GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir, const int& Seed=0);
   static PNGraph GenFastKronecker(const TKronMtx& SeedMtx, const int& NIter, const int& Edges, const bool& IsDir, const int& Seed=0);
   static PNGraph GenDetKronecker(const TKronMtx& SeedMtx, const int& NIter, const bool& IsDir);
+  // parallel versions of GenFastKronecker, edge i comes from the counter-based random stream (Seed, i)
+  static PNGraph GenFastKroneckerMP(const TKronMtx& SeedMtx, const int& NIter, const int& Edges, const bool& IsDir, const int& Seed=1);
+  static void SaveFastKroneckerMP(const TStr& OutFNm, const TKronMtx& SeedMtx, const int& NIter, const int64& Edges, const bool& Binary=false, const int& Seed=1); // keeps duplicate edges
   static void PlotCmpGraphs(const TKronMtx& SeedMtx, const PNGraph& Graph, const TStr& OutFNm, const TStr& Desc);
   static void PlotCmpGraphs(const TKronMtx& SeedMtx1, const TKronMtx& SeedMtx2, const PNGraph& Graph, const TStr& OutFNm, const TStr& Desc);
   static void PlotCmpGraphs(const TVec<TKronMtx>& SeedMtxV, const PNGraph& Graph, const TStr& FNmPref, const TStr& Desc);
@@ -108,6 +111,36 @@ public:
   static void PutRndSeed(const int& Seed) { TKronMtx::Rnd.PutSeed(Seed); }
 };
 
+/////////////////////////////////////////////////
+// Kronecker Edge Log Likelihood Table
+// Log-likelihood of an edge is linear in the number of times each
+// initiator cell is visited by the digits of (NId1, NId2). The table
+// stores these counts for blocks of levels, so the per-level loop of
+// TKronMtx::GetEdgeLL() becomes a few lookups per edge.
+class TKronLLTbl {
+private:
+  static const int MxParams;
+  TKronMtx LLMtx;        // LL matrix the table was built for
+  TInt KronIters, Dim, Params;
+  TInt BlkDim, Blocks;   // Dim^levels of a full block, number of full blocks
+  TInt TailDim;          // Dim^levels of the remaining (partial) block
+  TIntV BlkCntV, TailCntV; // cell counts per (row digits, col digits) block
+  TIntV TrParamV;        // transposed cell of each parameter
+  TFltV InvProbV;        // 1/exp(LL) of each cell
+private:
+  void GenCntV(const int& BDim, const int& Levels, TIntV& CntV) const;
+  void GetCnt(int NId1, int NId2, int* CntV) const;
+public:
+  TKronLLTbl() : KronIters(-1) { }
+  void Gen(const TKronMtx& LLMtxPt, const int& NKronIters);
+  bool IsFor(const TKronMtx& LLMtxPt, const int& NKronIters) const {
+    return ! BlkCntV.Empty() && KronIters == NKronIters && LLMtx == LLMtxPt; }
+  // GetEdgeLL() - GetApxNoEdgeLL()
+  double GetApxEdgeLL(const int& NId1, const int& NId2) const;
+  // adds Sign*(GetEdgeDLL() - GetApxNoEdgeDLL()) for all parameters
+  void AddApxEdgeDLL(const int& NId1, const int& NId2, const double& Sign, TFltV& DLLV) const;
+};
+
 /////////////////////////////////////////////////
 // Kronecker Log Likelihood
 
@@ -142,6 +175,28 @@ private:
   TFltV LLV;			// Log-likelihood (per EM iteration)
   TVec<TKronMtx> MtxV;	// Kronecker initiator matrix (per EM iteration)
 
+  TKronLLTbl LLTbl;      // per-edge LL lookup table for LLMtx
+  TInt Chains;           // number of parallel Metropolis chains in SampleGradient
+  TVec<TIntV> ChainPermV, ChainIPermV; // permutation of each chain
+  TVec<TRnd> ChainRndV;  // random generator of each chain
+
+private:
+  // edge terms, either from LLTbl or from LLMtx
+  double GetApxEdgeLL(const int& Row, const int& Col, const bool& UseTbl) const {
+    return UseTbl ? LLTbl.GetApxEdgeLL(Row, Col) :
+      LLMtx.GetEdgeLL(Row, Col, KronIters) - LLMtx.GetApxNoEdgeLL(Row, Col, KronIters); }
+  void AddApxEdgeDLL(const int& Row, const int& Col, const double& Sign, const bool& UseTbl, TFltV& DLLV) const;
+  bool IsLLTbl() const { return LLTbl.IsFor(LLMtx, KronIters); }
+  // LL and DLL for a given permutation (state of a Metropolis chain)
+  double CalcApxGraphLL(const TIntV& Perm, const bool& UseTbl) const;
+  void CalcApxGraphDLL(const TIntV& Perm, const bool& UseTbl, TFltV& DLLV) const;
+  double NodeLLDelta(const int& NId, const TIntV& Perm, const bool& UseTbl) const;
+  double SwapNodesLL(const int& NId1, const int& NId2, TIntV& Perm, TIntV& IPerm, double LL, const bool& UseTbl) const;
+  bool SampleNextPerm(int& NId1, int& NId2, TRnd& Rnd, TIntV& Perm, TIntV& IPerm, double& LL, const bool& UseTbl) const;
+  void NodeDLLDelta(const int& NId, const TIntV& Perm, const double& Sign, const bool& UseTbl, TFltV& DLLV) const;
+  void UpdateGraphDLL(const int& SwapNId1, const int& SwapNId2, TIntV& Perm, const bool& UseTbl, TFltV& DLLV) const;
+  void SampleGradientChains(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& AvgGradV);
+
 public:
   // RS 07/03/12, changed the order in the constructor initializer list
   //    so that it matches the declaration order. This changes also
@@ -165,6 +220,9 @@ public:
   int GetDim() const { return ProbMtx.GetDim(); }
 
   void SetDebug(const bool Debug) { DebugMode = Debug; }
+  // number of independent Metropolis chains (run in parallel) used by SampleGradient
+  void SetChains(const int& NChains) { Chains = NChains; }
+  int GetChains() const { return TMath::Mx(Chains(), 1); }
   const TFltV& GetLLHist() const { return LLV; }
   const TVec<TKronMtx>& GetParamHist() const { return MtxV; }
 
@@ -218,7 +276,7 @@ public:
   const TFltV& GetDLL() const { return GradV; }
   double GetDLL(const int& ParamId) const { return GradV[ParamId]; }
 
-  // gradient
+  // gradient (NSamples are split among the chains, their averages are combined)
   void SampleGradient(const int& WarmUp, const int& NSamples, double& AvgLL, TFltV& GradV);
   double GradDescent(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples);
   double GradDescent2(const int& NIter, const double& LrnRate, double MnStep, double MxStep, const int& WarmUp, const int& NSamples);
@@ -113,12 +113,52 @@ Section: Preprocessing unweighted graphs, including:
 2. obtain a transformed weighted graph.
 */
 
+// Atomically adds {val} to the count of motif {idx} on edge (u, v).
+// The entry for (u, v) must already exist, so that the hash table is not modified.
+static void addCount(CountVH& Counts, int u, int v, int idx, int val) {
+  __sync_fetch_and_add(&Counts[u].GetDat(v)[idx].Val, val);
+}
+
+// Adds a zero count vector of length {len} for every edge of {graph}, in both directions.
+static void initCounts(const PUNGraph& graph, int len, CountVH& Counts) {
+  Counts = CountVH(graph->GetMxNId());
+  TIntV NodeIds;
+  graph->GetNIdV(NodeIds);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < NodeIds.Len(); i ++) {
+    TUNGraph::TNodeI NI = graph->GetNI(NodeIds[i]);
+    THash<TInt, TIntV>& CountsHere = Counts[NI.GetId()];
+    CountsHere.Gen(NI.GetOutDeg());
+    for (int e = 0; e < NI.GetOutDeg(); e++) {
+      CountsHere(NI.GetOutNId(e)) = TIntV(len);
+    }
+  }
+}
+
 // Initializing for undirected graph input.
 ProcessedGraph::ProcessedGraph(PUNGraph graph, MotifType mt){
   Graph_org = graph;
   assignWeights_undir(mt);
 }
 
+// Loading and saving, which keeps the motif counts.
+ProcessedGraph::ProcessedGraph(TSIn& SIn) {
+  Graph_org = TUNGraph::Load(SIn);
+  Graph_trans = TUNGraph::Load(SIn);
+  Counts.Load(SIn);
+  Weights.Load(SIn);
+  TFlt Vol(SIn);
+  TotalVol = Vol;
+}
+
+void ProcessedGraph::Save(TSOut& SOut) const {
+  Graph_org->Save(SOut);
+  Graph_trans->Save(SOut);
+  Counts.Save(SOut);
+  Weights.Save(SOut);
+  TFlt(TotalVol).Save(SOut);
+}
+
 // This function will return true if degree of nodeID1 is higher than nodeID2.
 // If the degrees equal, it will return true if nodeID1 > nodeID2.
 // Used in ChibaNishizeki's clique enumeration method
@@ -152,40 +192,54 @@ void ProcessedGraph::countClique(PUNGraph& G, int KSize, TIntV& PrevNodes, int l
     for (TUNGraph::TEdgeI EI = G->BegEI(); EI < G->EndEI(); EI ++ ) {
       int SrcNId = EI.GetSrcNId();
       int DstNId = EI.GetDstNId();
-      Counts[SrcNId](DstNId)[level-1] ++;
-      Counts[DstNId](SrcNId)[level-1] ++;
+      addCount(Counts, SrcNId, DstNId, level-1, 1);
+      addCount(Counts, DstNId, SrcNId, level-1, 1);
     }
   }
-  for (TUNGraph::TNodeI NI = G->BegNI(); NI < G->EndNI(); NI ++ ) {
-    int NodeId = NI.GetId();
-    int degHere = NI.GetOutDeg();
-    for (int i = 0; i < level; i ++) {
-      Counts[PrevNodes[i]](NodeId)[level-1] += degHere;
-      Counts[NodeId](PrevNodes[i])[level-1] += degHere;
+  if (level == 0) {
+    TIntV NodeIds;
+    G->GetNIdV(NodeIds);
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < NodeIds.Len(); i ++) {
+      TIntV PrevNodesHere(PrevNodes);
+      countCliqueAtNode(G, G->GetNI(NodeIds[i]), KSize, PrevNodesHere, level);
     }
-
-    if (level == KSize - 2) {
-      continue;
+  } else {
+    for (TUNGraph::TNodeI NI = G->BegNI(); NI < G->EndNI(); NI ++ ) {
+      countCliqueAtNode(G, NI, KSize, PrevNodes, level);
     }
-    // Go to the next level
-    PrevNodes[level] = NodeId;
-    TIntV neighborsID;
-    for (int e = 0; e < NI.GetOutDeg(); e++) {
-      int nbrID = NI.GetOutNId(e);
-      if (higherDeg(G, NodeId, nbrID)) {
-          neighborsID.Add(nbrID);
-      }
+  }
+}
+
+void ProcessedGraph::countCliqueAtNode(PUNGraph& G, const TUNGraph::TNodeI& NI, int KSize, TIntV& PrevNodes, int level) {
+  int NodeId = NI.GetId();
+  int degHere = NI.GetOutDeg();
+  for (int i = 0; i < level; i ++) {
+    addCount(Counts, PrevNodes[i], NodeId, level-1, degHere);
+    addCount(Counts, NodeId, PrevNodes[i], level-1, degHere);
+  }
+
+  if (level == KSize - 2) {
+    return;
+  }
+  // Go to the next level
+  PrevNodes[level] = NodeId;
+  TIntV neighborsID;
+  for (int e = 0; e < NI.GetOutDeg(); e++) {
+    int nbrID = NI.GetOutNId(e);
+    if (higherDeg(G, NodeId, nbrID)) {
+        neighborsID.Add(nbrID);
     }
-    PUNGraph subGraph = TSnap::GetSubGraph(G, neighborsID);
-    int numEdges = subGraph->GetEdges();
-    for (int i = 0; i <= level; i ++) {
-      for (int j = i + 1; j <= level; j ++) {
-        Counts[PrevNodes[i]](PrevNodes[j])[level] += numEdges;
-        Counts[PrevNodes[j]](PrevNodes[i])[level] += numEdges;
-      }
+  }
+  PUNGraph subGraph = TSnap::GetSubGraph(G, neighborsID);
+  int numEdges = subGraph->GetEdges();
+  for (int i = 0; i <= level; i ++) {
+    for (int j = i + 1; j <= level; j ++) {
+      addCount(Counts, PrevNodes[i], PrevNodes[j], level, numEdges);
+      addCount(Counts, PrevNodes[j], PrevNodes[i], level, numEdges);
     }
-    countClique(subGraph, KSize, PrevNodes, level + 1);
   }
+  countClique(subGraph, KSize, PrevNodes, level + 1);
 }
 
 // Functions for undirected graph that
@@ -193,12 +247,16 @@ void ProcessedGraph::countClique(PUNGraph& G, int KSize, TIntV& PrevNodes, int l
 //  2) assign weights
 //  3) obtain the transformed graph
 void ProcessedGraph::assignWeights_undir(MotifType mt) {
-  Weights = WeightVH(Graph_org->GetMxNId());
-  Graph_trans = TSnap::ConvertGraph<PUNGraph>(Graph_org);
   int KSize = getCliqueSize(mt);
   if (KSize == 2) {
     // Don't need to count, assign weights directly!
-    for (TUNGraph::TNodeI NI = Graph_org->BegNI(); NI < Graph_org->EndNI(); NI ++ ) {
+    Weights = WeightVH(Graph_org->GetMxNId());
+    Graph_trans = TSnap::ConvertGraph<PUNGraph>(Graph_org);
+    TIntV NodeIds;
+    Graph_org->GetNIdV(NodeIds);
+    #pragma omp parallel for schedule(dynamic, 1000)
+    for (int i = 0; i < NodeIds.Len(); i ++) {
+      TUNGraph::TNodeI NI = Graph_org->GetNI(NodeIds[i]);
       int NodeId = NI.GetId();
       for (int e = 0; e < NI.GetOutDeg(); e++) {
         Weights[NodeId](NI.GetOutNId(e)) = 1;
@@ -209,36 +267,56 @@ void ProcessedGraph::assignWeights_undir(MotifType mt) {
   } else { 
     if (Counts.Len() == 0 || Counts.BegI()->Len() == 0 || Counts.BegI()->BegI()->Dat.Len() < KSize - 2) {
       // If the KSize-clique has not been counted yet, then we count.
-      Counts = CountVH(Graph_org->GetMxNId());
-      for (TUNGraph::TNodeI NI = Graph_org->BegNI(); NI < Graph_org->EndNI(); NI ++ ) {
-        int NodeId = NI.GetId();
-        for (int e = 0; e < NI.GetOutDeg(); e++) {
-          Counts[NodeId](NI.GetOutNId(e)) = TIntV(KSize - 2);
-        }
-      }
+      initCounts(Graph_org, KSize - 2, Counts);
       TIntV PrevNodes(KSize - 2);
       countClique(Graph_org, KSize, PrevNodes, 0);
     }
 
     // Now we assign weights!
-    TotalVol = 0;
-    for (TUNGraph::TNodeI NI = Graph_org->BegNI(); NI < Graph_org->EndNI(); NI ++ ) {
-      int NodeId = NI.GetId();
-      float deg_w = 0;
-      for (int e = 0; e < NI.GetOutDeg(); e++) {
-        int NbrId = NI.GetOutNId(e);
-        int MtfCntHere = Counts[NodeId](NbrId)[KSize-3];
-        if (MtfCntHere) {
-          Weights[NodeId](NbrId) = MtfCntHere;
-          deg_w += MtfCntHere;
-        } else {
-          Graph_trans->DelEdge(NodeId, NbrId);
-        }
+    TIntV MtfInclude;
+    MtfInclude.Add(KSize-3);
+    assignWeightsFromCounts(MtfInclude);
+  }
+}
+
+// Assigns the weights in parallel. The edges without any motif instance are collected
+// and removed from the transformed graph afterwards.
+void ProcessedGraph::assignWeightsFromCounts(const TIntV& MtfInclude) {
+  Graph_trans = TSnap::ConvertGraph<PUNGraph>(Graph_org);
+  Weights = WeightVH(Graph_org->GetMxNId());
+  TIntV NodeIds;
+  Graph_org->GetNIdV(NodeIds);
+  TVec<TIntV> ZeroNbrs(NodeIds.Len());
+  double Vol = 0;
+  #pragma omp parallel for schedule(dynamic, 1000) reduction(+:Vol)
+  for (int i = 0; i < NodeIds.Len(); i ++) {
+    TUNGraph::TNodeI NI = Graph_org->GetNI(NodeIds[i]);
+    int NodeId = NI.GetId();
+    THash<TInt, TFlt>& WeightsHere = Weights[NodeId];
+    float deg_w = 0;
+    for (int e = 0; e < NI.GetOutDeg(); e++) {
+      int NbrId = NI.GetOutNId(e);
+      const TIntV& CountHere = Counts[NodeId].GetDat(NbrId);
+      int WeightHere = 0;
+      for (int j = 0; j < MtfInclude.Len(); j ++) {
+        WeightHere += CountHere[MtfInclude[j]];
       }
-      Weights[NodeId](NodeId) = deg_w;
-      TotalVol += deg_w;
+      if (WeightHere) {
+        WeightsHere(NbrId) = WeightHere;
+        deg_w += WeightHere;
+      } else if (NodeId <= NbrId) {
+        ZeroNbrs[i].Add(NbrId);
+      }
+    }
+    WeightsHere(NodeId) = deg_w;
+    Vol += deg_w;
+  }
+  for (int i = 0; i < NodeIds.Len(); i ++) {
+    for (int j = 0; j < ZeroNbrs[i].Len(); j ++) {
+      Graph_trans->DelEdge(NodeIds[i], ZeroNbrs[i][j]);
     }
   }
+  TotalVol = Vol;
 }
 
 
@@ -397,36 +475,34 @@ bool higherDeg(PNGraph& G, int nodeID1, int nodeID2) {
 // To count the directed triangle motifs
 void ProcessedGraph::countDirTriadMotif(PNGraph graph) {
   int numBasicDirMtf = 9;
-  Counts = CountVH(Graph_org->GetMxNId());
-  for (TUNGraph::TNodeI NI = Graph_org->BegNI(); NI < Graph_org->EndNI(); NI ++ ) {
-    int NodeId = NI.GetId();
-    for (int e = 0; e < NI.GetOutDeg(); e++) {
-      Counts[NodeId](NI.GetOutNId(e)) = TIntV(numBasicDirMtf);
-    }
-  }
-  for (TNGraph::TNodeI NI = graph->BegNI(); NI < graph->EndNI(); NI ++ ) {
+  initCounts(Graph_org, numBasicDirMtf, Counts);
+  TIntV NodeIds;
+  graph->GetNIdV(NodeIds);
+  #pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < NodeIds.Len(); n ++) {
+    TNGraph::TNodeI NI = graph->GetNI(NodeIds[n]);
     long nodeID = NI.GetId();
     TIntV neighborsID;
     for (long e = 0; e < NI.GetOutDeg(); e++) {
       long nbrID = NI.GetOutNId(e);
       if (higherDeg(graph, nodeID, nbrID)) {
         neighborsID.Add(nbrID);
-        Counts[nodeID](nbrID)[0] ++;
-        Counts[nbrID](nodeID)[0] ++;
+        addCount(Counts, nodeID, nbrID, 0, 1);
+        addCount(Counts, nbrID, nodeID, 0, 1);
       }
     }
     for (long e = 0; e < NI.GetInDeg(); e++) {
       long nbrID = NI.GetInNId(e);
       if (higherDeg(graph, nodeID, nbrID)) {
         if (graph->IsEdge(nodeID, nbrID)) {
-          Counts[nodeID](nbrID)[0] --;
-          Counts[nbrID](nodeID)[0] --;
-          Counts[nodeID](nbrID)[1] ++;
-          Counts[nbrID](nodeID)[1] ++;
+          addCount(Counts, nodeID, nbrID, 0, -1);
+          addCount(Counts, nbrID, nodeID, 0, -1);
+          addCount(Counts, nodeID, nbrID, 1, 1);
+          addCount(Counts, nbrID, nodeID, 1, 1);
         } else {
           neighborsID.Add(nbrID);
-          Counts[nodeID](nbrID)[0] ++;
-          Counts[nbrID](nodeID)[0] ++;
+          addCount(Counts, nodeID, nbrID, 0, 1);
+          addCount(Counts, nbrID, nodeID, 0, 1);
         }
       }
     }
@@ -438,12 +514,12 @@ void ProcessedGraph::countDirTriadMotif(PNGraph graph) {
       if (srcNId > dstNId || !subGraph->IsEdge(dstNId, srcNId)) {
         MotifNumber = checkTriadMotif(graph, nodeID, srcNId, dstNId);
         MotifNumber ++;
-        Counts[nodeID](srcNId)[MotifNumber] ++;
-        Counts[srcNId](nodeID)[MotifNumber] ++;
-        Counts[nodeID](dstNId)[MotifNumber] ++;
-        Counts[dstNId](nodeID)[MotifNumber] ++;
-        Counts[srcNId](dstNId)[MotifNumber] ++;
-        Counts[dstNId](srcNId)[MotifNumber] ++;
+        addCount(Counts, nodeID, srcNId, MotifNumber, 1);
+        addCount(Counts, srcNId, nodeID, MotifNumber, 1);
+        addCount(Counts, nodeID, dstNId, MotifNumber, 1);
+        addCount(Counts, dstNId, nodeID, MotifNumber, 1);
+        addCount(Counts, srcNId, dstNId, MotifNumber, 1);
+        addCount(Counts, dstNId, srcNId, MotifNumber, 1);
       }
     }
   }
@@ -499,31 +575,7 @@ void ProcessedGraph::assignWeights_dir(MotifType mt) {
     }    
   }
 
-  Graph_trans = TSnap::ConvertGraph<PUNGraph>(Graph_org);
-  Weights = WeightVH(Graph_org->GetMxNId());
-
-  TotalVol = 0;
-  for (TUNGraph::TNodeI NI = Graph_org->BegNI(); NI < Graph_org->EndNI(); NI ++ ) {
-    int NodeId = NI.GetId();
-    float deg_w = 0;
-    for (int e = 0; e < NI.GetOutDeg(); e++) {
-      int NbrId = NI.GetOutNId(e);
-      TIntV& CountHere = Counts[NodeId](NbrId);
-      int WeightHere = 0;
-      for (int i = 0; i < MtfInclude.Len(); i ++) {
-        WeightHere += CountHere[MtfInclude[i]];
-      }
-      if (WeightHere) {
-        Weights[NodeId](NbrId) = WeightHere;
-        deg_w += WeightHere;
-      } else {
-        Graph_trans->DelEdge(NodeId, NbrId);
-      }
-    }
-    Weights[NodeId](NodeId) = deg_w;
-    TotalVol += deg_w;
-  }
-
+  assignWeightsFromCounts(MtfInclude);
   return;
 }
 
@@ -590,6 +642,10 @@ void MAPPR::computeAPPR(const ProcessedGraph& graph_p, const int SeedNodeId, flo
   THash<TInt, TFlt> residual;
   NumPushs = 0;
   appr_norm = 0;
+  NodeInOrder.Clr(false);
+  MtfCondProfile.Clr(false);
+  SizeGlobalMin = 0;
+  SizeFirstLocalMin = -1;
   const WeightVH& Weights = graph_p.getWeights();
   if (Weights[SeedNodeId].GetDat(SeedNodeId) * eps >= 1) {
     appr_vec(SeedNodeId) = 0;
@@ -635,21 +691,25 @@ void MAPPR::computeAPPR(const ProcessedGraph& graph_p, const int SeedNodeId, flo
 // Results are stored in {this->NodeInOrder and MtfCondProfile}.
 // It will also compute the global min and first local min of the NCP.
 void MAPPR::computeProfile(const ProcessedGraph& graph_p) {
-  THash<TInt, TFlt> Quotient;
+  // Nodes by decreasing quotient, ties go to the later node of appr_vec.
+  // Batches run this from many threads, so it sorts with TSnap::SortMP.
   const WeightVH& Weights = graph_p.getWeights();
+  TVec<TFltIntPr> Quotient(appr_vec.Len(), 0);
+  TIntV QuotientNodeIds(appr_vec.Len(), 0);
   for (THash<TInt, TFlt>::TIter it = appr_vec.BegI(); it < appr_vec.EndI(); it++) {
     int NodeId = it->Key;
-    Quotient(NodeId) = it->Dat / Weights[NodeId].GetDat(NodeId);
+    Quotient.Add(TFltIntPr(it->Dat / Weights[NodeId].GetDat(NodeId), QuotientNodeIds.Len()));
+    QuotientNodeIds.Add(NodeId);
   }
-  Quotient.SortByDat(false);
+  TSnap::SortMP(Quotient, false);
 
   double vol = 0, cut = 0;
   TIntSet IsIn;           // the current set
   int VolSmall = 1;       // =1 if volume(IsIn) <= VolAll/2, and = -1 otherwise;
   float TotalVol = graph_p.getTotalVolume();
 
-  for (THash<TInt, TFlt>::TIter it = Quotient.BegI(); it < Quotient.EndI(); it++) {
-    int NodeId = it->Key;
+  for (int q = 0; q < Quotient.Len(); q++) {
+    int NodeId = QuotientNodeIds[Quotient[q].Val2];
     TUNGraph::TNodeI NI = graph_p.getTransformedGraph()->GetNI(NodeId);
     const THash<TInt, TFlt>& WeightsHere = Weights[NodeId];
 
@@ -753,6 +813,36 @@ void MAPPR::sweepAPPR(int option) {
 }
 
 
+// Batch version of {computeAPPR(...)} and {sweepAPPR(...)} over many seeds.
+void MAPPR::computeAPPRBatch(const ProcessedGraph& graph_p, const TIntV& SeedNodeIds, float alpha, float eps,
+                             int option, TVec<TIntV>& Clusters, TVec<TFltV>& CondProfiles) {
+  if (option < -1) {
+    TExcept::Throw("Invalid input in option!");
+  }
+  for (int i = 0; i < SeedNodeIds.Len(); i ++) {
+    if (! graph_p.getTransformedGraph()->IsNode(SeedNodeIds[i])) {
+      TExcept::Throw("Seed node is not in the graph!");
+    }
+  }
+  Clusters.Gen(SeedNodeIds.Len());
+  CondProfiles.Gen(SeedNodeIds.Len());
+  #pragma omp parallel
+  {
+    MAPPR mappr;
+    #pragma omp for schedule(dynamic)
+    for (int i = 0; i < SeedNodeIds.Len(); i ++) {
+      mappr.computeAPPR(graph_p, SeedNodeIds[i], alpha, eps);
+      if (mappr.NodeInOrder.Len() == 0) {
+        Clusters[i].Gen(1, 0);
+        Clusters[i].Add(SeedNodeIds[i]);
+        continue;
+      }
+      mappr.sweepAPPR(option > 0 ? MIN(option, mappr.NodeInOrder.Len()) : option);
+      Clusters[i] = mappr.Cluster;
+      CondProfiles[i] = mappr.MtfCondProfile;
+    }
+  }
+}
 
 void MAPPR::printAPPR() {
   for (THash<TInt, TFlt>::TIter it = appr_vec.BegI(); it < appr_vec.EndI(); it++) {
@@ -84,12 +84,21 @@ class ProcessedGraph {
   // Input {TIntV& PrevNodes} denotes a set of nodes that are directed connected to any node in the current graph G
   //    and {int level = PrevNodes.Len()} is the number of PreNodes. Therefore, any k-clique in G corresponds to 
   //    a (k+level)-clique after all nodes in PrevNodes are added in the current graph G.
+  // At level 0 the nodes of G are processed in parallel, each thread with its own copy of {PrevNodes}.
   void countClique(PUNGraph& G, int KSize, TIntV& PrevNodes, int level);
 
+  // One step of {countClique(...)}: counts the cliques containing node {NI} and its higher degree neighbors.
+  void countCliqueAtNode(PUNGraph& G, const TUNGraph::TNodeI& NI, int KSize, TIntV& PrevNodes, int level);
+
   // This function counts the directed graph motif instances on each edge.
   // void countDirEdgeMotif(PNGraph graph);
+  // The nodes are processed in parallel, and the counts are updated atomically.
   void countDirTriadMotif(PNGraph graph);
 
+  // Assigns the weight of each edge as the sum of Counts[u](v)[i] over all i in {MtfInclude},
+  // and removes the edges of zero weight from the transformed graph.
+  void assignWeightsFromCounts(const TIntV& MtfInclude);
+
 
  public :
   // Initialing, which will run assignWeights* functions and obtain the weighted transformed graph.
@@ -98,6 +107,9 @@ class ProcessedGraph {
   ProcessedGraph(PUNGraph graph, MotifType mt);
   // For directed input graph
   ProcessedGraph(PNGraph graph, MotifType mt);
+  // Loads a processed graph saved by {Save(...)}, so that the motif counting does not have to be repeated.
+  ProcessedGraph(TSIn& SIn);
+  void Save(TSOut& SOut) const;
 
   // Two functions, for undirected graph and directed graph respectively, that
   //  1) counts motifs on each pair of nodes
@@ -107,8 +119,8 @@ class ProcessedGraph {
   void assignWeights_dir(MotifType mt);
 
   // Output and printing
-  PUNGraph getOriginalGraph() const {return Graph_org; };
-  PUNGraph getTransformedGraph() const {return Graph_trans; };
+  const PUNGraph& getOriginalGraph() const {return Graph_org; };
+  const PUNGraph& getTransformedGraph() const {return Graph_trans; };
   CountVH getCounts() const { return Counts; };
   const WeightVH& getWeights() const { return Weights; };
   float getTotalVolume() const { return TotalVol; };
@@ -145,7 +157,7 @@ class MAPPR {
   TIntV Cluster;              // To store the desired cluster
 
   // To compute the NCP of the graph with precomputed APPR vector
-  // Results are stored in {this->NodeInOrder and MtfCondProfile}.
+  // Results are stored in {this->NodeInOrder and MtfCondProfile}, replacing the results for any previous seed.
   // It will also compute the global min and first local min of the NCP.
   void computeProfile(const ProcessedGraph& graph_p);
 
@@ -177,9 +189,19 @@ class MAPPR {
   // Note that this function can only be run after finishing {computeAPPR(...)}
   void sweepAPPR(int option = -1);
 
+  // Runs {computeAPPR(...)} and {sweepAPPR(option)} for every seed in {SeedNodeIds} in parallel.
+  // Each thread reuses one MAPPR object, so the APPR and residual vectors are thread-local.
+  // {Clusters[i]} and {CondProfiles[i]} are the cluster and the conductance profile for seed {SeedNodeIds[i]}.
+  // If no push could be made from a seed (the seed is too heavy for {eps}), its cluster is the seed itself
+  // and its profile is empty. Option > 0 is capped at the length of the profile.
+  static void computeAPPRBatch(const ProcessedGraph& graph_p, const TIntV& SeedNodeIds, float alpha, float eps,
+                               int option, TVec<TIntV>& Clusters, TVec<TFltV>& CondProfiles);
+
   // Output and printing
   THash<TInt, TFlt> getAPPR() { return appr_vec; };
   TIntV getCluster() { return Cluster; };
+  const TIntV& getNodeInOrder() const { return NodeInOrder; };
+  const TFltV& getCondProfile() const { return MtfCondProfile; };
   void printAPPR();
   void printProfile();
 };
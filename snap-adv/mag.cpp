@@ -574,8 +574,7 @@ const double TMAGFitBern::GetProbPhi(const int& NId1, const int& NId2, const int
 }
 
 const double TMAGFitBern::GetProbMu(const int& NId1, const int& NId2, const int& AId, const int& Attr1, const int& Attr2, const bool Left, const bool Right) const {
-	TMAGNodeBern DistParam = Param.GetNodeAttr();
-//	double Mu = DistParam.GetMu(AId);
+//	double Mu = Param.GetNodeAttr().GetMu(AId);
 	double Mu = AvgPhiV[AId] / double(Param.GetNodes());
 	double Prob1 = (Left) ? double(PhiVV.At(NId1, AId)) : double(Mu);
 	double Prob2 = (Right)? double(PhiVV.At(NId2, AId)) : double(Mu);
@@ -704,16 +703,15 @@ const double TMAGFitBern::GradPhiMI(const double& x, const int& NId, const int&
 	const int NAttrs = CntVV.GetYDim();
 	double Grad = DeltaQ - log(x) + log(1.0-x);
 
+	//	log(a/b) instead of log(a)-log(b), half as many logs
 	for(int l = 0; l < NAttrs; l++) {
 		if(l == AId) {  continue;  }
 		const double C0 = PhiVV(NId, l);
 		const double C1 = 1.0 - C0;
-		Grad -= Lambda * C0 * log(CntVV(0, l) + C0 * x);
-		Grad -= Lambda * C1 * log(CntVV(1, l) + C1 * x);
-		Grad += Lambda * C0 * log(CntVV(2, l) + C0 * (1-x));
-		Grad += Lambda * C1 * log(CntVV(3, l) + C1 * (1-x));
-		Grad -= Lambda * log(CntVV(0, l) + CntVV(1, l) + x);
-		Grad += Lambda * log(CntVV(2, l) + CntVV(3, l) + (1-x));
+		const double Cnt0 = CntVV(0, l), Cnt1 = CntVV(1, l), Cnt2 = CntVV(2, l), Cnt3 = CntVV(3, l);
+		Grad += Lambda * C0 * log((Cnt2 + C0 * (1-x)) / (Cnt0 + C0 * x));
+		Grad += Lambda * C1 * log((Cnt3 + C1 * (1-x)) / (Cnt1 + C1 * x));
+		Grad += Lambda * log((Cnt2 + Cnt3 + (1-x)) / (Cnt0 + Cnt1 + x));
 	}
 
 	return Grad;
@@ -928,6 +926,13 @@ const double TMAGFitBern::UpdatePhiMI(const double& Lambda, const int& NId, cons
 
 
 const double TMAGFitBern::UpdateApxPhiMI(const double& Lambda, const int& NId, const int& AId, double& Phi, TFltVV& ProdVV) {
+	TFltV NbrLinWV, NbrSqWV;
+	GetNbrProdWeight(NId, NbrLinWV, NbrSqWV);
+	return UpdateApxPhiMI(Lambda, NId, AId, Phi, ProdVV, NbrLinWV, NbrSqWV);
+}
+
+//	NbrLinWV and NbrSqWV are the weights of the edges of NId from GetNbrProdWeight()
+const double TMAGFitBern::UpdateApxPhiMI(const double& Lambda, const int& NId, const int& AId, double& Phi, TFltVV& ProdVV, const TFltV& NbrLinWV, const TFltV& NbrSqWV) {
 	TMAGAffMtx LLTheta, Theta = Param.GetMtx(AId); 
 	const int NNodes = Param.GetNodes();
 	const int NAttrs = Param.GetAttrs();
@@ -953,7 +958,7 @@ const double TMAGFitBern::UpdateApxPhiMI(const double& Lambda, const int& NId, c
 	for(int i = 0; i < 2; i++) {
 		EdgeQ[i] = 0.0;
 		MaxExp[i] = -DBL_MAX;
-		NonEdgeLLV[i].Gen(4 * NNodes, 0);
+		NonEdgeLLV[i].Gen(4, 0);
 	}
 
 	for(int F = 0; F < 2; F++) {
@@ -979,11 +984,12 @@ const double TMAGFitBern::UpdateApxPhiMI(const double& Lambda, const int& NId, c
 	}
 
 	TNGraph::TNodeI NI = Graph->GetNI(NId);
-	for(int d = 0; d < NI.GetOutDeg(); d++) {
+	const int OutDeg = NI.GetOutDeg();
+	for(int d = 0; d < OutDeg; d++) {
 		int Out = NI.GetOutNId(d);
 		if(NId == Out) {  continue;  }
-		double LinW = GetProdLinWeight(NId, Out) - GetThetaLL(NId, Out, AId);
-		double SqW = GetProdSqWeight(NId, Out) - GetSqThetaLL(NId, Out, AId);
+		double LinW = NbrLinWV[d] - GetThetaLL(NId, Out, AId);
+		double SqW = NbrSqWV[d] - GetSqThetaLL(NId, Out, AId);
 
 		for(int F = 0; F < 2; F++) {
 			EdgeQ[F] += GetOutCoeff(NId, Out, AId, F, LLTheta);
@@ -994,8 +1000,8 @@ const double TMAGFitBern::UpdateApxPhiMI(const double& Lambda, const int& NId, c
 	for(int d = 0; d < NI.GetInDeg(); d++) {
 		int In = NI.GetInNId(d);
 		if(NId == In) {  continue;  }
-		double LinW = GetProdLinWeight(In, NId) - GetThetaLL(In, NId, AId);
-		double SqW = GetProdSqWeight(In, NId) - GetSqThetaLL(In, NId, AId);
+		double LinW = NbrLinWV[OutDeg + d] - GetThetaLL(In, NId, AId);
+		double SqW = NbrSqWV[OutDeg + d] - GetSqThetaLL(In, NId, AId);
 
 		for(int F = 0; F < 2; F++) {
 			EdgeQ[F] += GetInCoeff(In, NId, AId, F, LLTheta);
@@ -1131,32 +1137,86 @@ double TMAGFitBern::DoEStepOneIter(const TFltV& TrueMuV, TFltVV& NewPhiVV, const
 }
 
 
+//	product weights of all the edges of NId, out-edges first
+void TMAGFitBern::GetNbrProdWeight(const int& NId, TFltV& NbrLinWV, TFltV& NbrSqWV) const {
+	TNGraph::TNodeI NI = Graph->GetNI(NId);
+	NbrLinWV.Gen(NI.GetOutDeg() + NI.GetInDeg(), 0);
+	NbrSqWV.Gen(NI.GetOutDeg() + NI.GetInDeg(), 0);
+	for(int d = 0; d < NI.GetOutDeg(); d++) {
+		NbrLinWV.Add(GetProdLinWeight(NId, NI.GetOutNId(d)));
+		NbrSqWV.Add(GetProdSqWeight(NId, NI.GetOutNId(d)));
+	}
+	for(int d = 0; d < NI.GetInDeg(); d++) {
+		NbrLinWV.Add(GetProdLinWeight(NI.GetInNId(d), NId));
+		NbrSqWV.Add(GetProdSqWeight(NI.GetInNId(d), NId));
+	}
+}
+
+//	sets PhiVV(NId, AId) and updates ProdVV, AvgPhiV and AvgPhiPairVV
+void TMAGFitBern::SetApxPhi(const int& NId, const int& AId, const double& Phi, TFltVV& ProdVV) {
+	const int NAttrs = Param.GetAttrs();
+
+	ProdVV(NId, 0) -= GetAvgThetaLL(NId, NId, AId, true, false);
+	ProdVV(NId, 1) -= GetAvgThetaLL(NId, NId, AId, false, true);
+	ProdVV(NId, 2) -= GetAvgSqThetaLL(NId, NId, AId, true, false);
+	ProdVV(NId, 3) -= GetAvgSqThetaLL(NId, NId, AId, false, true);
+	for(int p = 0; p < NAttrs; p++) {
+		if(p > AId) {
+			int index = 4 * p;
+			AvgPhiPairVV(AId, index) -= PhiVV(NId, AId) * PhiVV(NId, p);
+			AvgPhiPairVV(AId, index+1) -= PhiVV(NId, AId) * (1.0-PhiVV(NId, p));
+			AvgPhiPairVV(AId, index+2) -= (1.0-PhiVV(NId, AId)) * PhiVV(NId, p);
+			AvgPhiPairVV(AId, index+3) -= (1.0-PhiVV(NId, AId)) * (1.0-PhiVV(NId, p));
+		} else if (p < AId) {
+			int index = 4 * AId;
+			AvgPhiPairVV(p, index) -= PhiVV(NId, p) * PhiVV(NId, AId);
+			AvgPhiPairVV(p, index+1) -= PhiVV(NId, p) * (1.0-PhiVV(NId, AId));
+			AvgPhiPairVV(p, index+2) -= (1.0-PhiVV(NId, p)) * PhiVV(NId, AId);
+			AvgPhiPairVV(p, index+3) -= (1.0-PhiVV(NId, p)) * (1.0-PhiVV(NId, AId));
+		}
+	}
+	AvgPhiV[AId] -= PhiVV(NId, AId);
+
+	PhiVV.At(NId, AId) = Phi;
+	
+	ProdVV(NId, 0) += GetAvgThetaLL(NId, NId, AId, true, false);
+	ProdVV(NId, 1) += GetAvgThetaLL(NId, NId, AId, false, true);
+	ProdVV(NId, 2) += GetAvgSqThetaLL(NId, NId, AId, true, false);
+	ProdVV(NId, 3) += GetAvgSqThetaLL(NId, NId, AId, false, true);
+	for(int p = 0; p < NAttrs; p++) {
+		if(p > AId) {
+			int index = 4 * p;
+			AvgPhiPairVV(AId, index) += PhiVV(NId, AId) * PhiVV(NId, p);
+			AvgPhiPairVV(AId, index+1) += PhiVV(NId, AId) * (1.0-PhiVV(NId, p));
+			AvgPhiPairVV(AId, index+2) += (1.0-PhiVV(NId, AId)) * PhiVV(NId, p);
+			AvgPhiPairVV(AId, index+3) += (1.0-PhiVV(NId, AId)) * (1.0-PhiVV(NId, p));
+		} else if (p < AId) {
+			int index = 4 * AId;
+			AvgPhiPairVV(p, index) += PhiVV(NId, p) * PhiVV(NId, AId);
+			AvgPhiPairVV(p, index+1) += PhiVV(NId, p) * (1.0-PhiVV(NId, AId));
+			AvgPhiPairVV(p, index+2) += (1.0-PhiVV(NId, p)) * PhiVV(NId, AId);
+			AvgPhiPairVV(p, index+3) += (1.0-PhiVV(NId, p)) * (1.0-PhiVV(NId, AId));
+		}
+	}
+	AvgPhiV[AId] += PhiVV(NId, AId);
+}
+
 double TMAGFitBern::DoEStepApxOneIter(const TFltV& TrueMuV, TFltVV& NewPhiVV, const double& Lambda) {
 	const int NNodes = Param.GetNodes();
 	const int NAttrs = Param.GetAttrs();
-	double MaxDelta = 0, L1 = 0;
-	double Val;
-	TFltIntIntTrV NewVal;
+	double L1 = 0;
 	int RndCount = 0;
-	// double OldMI = 0.0, NewMI = 0.0;
 	TFltV MuV(NAttrs);	MuV.PutAll(0.0);
 	TFltVV ProdVV(NNodes, 4);	ProdVV.PutAll(0.0);
-	TIntV NIndV(NNodes), AIndV(NAttrs);
-
-	//	Update Phi
-	/*
-	for(int i = 0; i < NNodes; i++) {  NIndV[i] = i;  }
-	for(int l = 0; l < NAttrs; l++) {  AIndV[l] = l;  }
-	if(Randomized) {
-		NIndV.Shuffle(TMAGNodeBern::Rnd);
-		AIndV.Shuffle(TMAGNodeBern::Rnd);
-	}
-	*/
+	TIntV NIdV(NNodes);
+	if(NewPhiVV.GetXDim() != NNodes || NewPhiVV.GetYDim() != NAttrs) {  NewPhiVV.Gen(NNodes, NAttrs);  }
 
 	AvgPhiV.Gen(NAttrs);	AvgPhiV.PutAll(0.0);
 	AvgPhiPairVV.Gen(NAttrs, 4*NAttrs);		AvgPhiPairVV.PutAll(0.0);
-	for(int i = 0; i < NNodes; i++) {
-		for(int l = 0; l < NAttrs; l++) {
+	//	every thread sums its own attributes
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int l = 0; l < NAttrs; l++) {
+		for(int i = 0; i < NNodes; i++) {
 			for(int p = l+1; p < NAttrs; p++) {
 				int index = 4 * p;
 				AvgPhiPairVV(l, index) += PhiVV(i, l) * PhiVV(i, p);
@@ -1167,6 +1227,7 @@ double TMAGFitBern::DoEStepApxOneIter(const TFltV& TrueMuV, TFltVV& NewPhiVV, co
 			AvgPhiV[l] += PhiVV(i, l);
 		}
 	}
+	#pragma omp parallel for schedule(static)
 	for(int i = 0; i < NNodes; i++) {
 		ProdVV(i, 0) = GetAvgProdLinWeight(i, i, true, false);
 		ProdVV(i, 1) = GetAvgProdLinWeight(i, i, false, true);
@@ -1174,77 +1235,39 @@ double TMAGFitBern::DoEStepApxOneIter(const TFltV& TrueMuV, TFltVV& NewPhiVV, co
 		ProdVV(i, 3) = GetAvgProdSqWeight(i, i, false, true);
 	}
 
+	//	Update Phi node by node in random order. The nodes of a block get all their attributes
+	//	updated in parallel from the same PhiVV and averages, then the new values are set in
+	//	node order, so the result does not depend on the number of threads.
 	const int Iter = 3;
-
-	NewVal.Gen(NAttrs * Iter);
-	for(int i = 0; i < NNodes * Iter; i++) {
-		for(int l = 0; l < NAttrs; l++) {
-			const int NId = TMAGNodeBern::Rnd.GetUniDevInt(NNodes);
-			const int AId = TMAGNodeBern::Rnd.GetUniDevInt(NAttrs);
-			double Delta = 0.0;
-			if(KnownVV(NId, AId)) {
-				Val = PhiVV.At(NId, AId);
-			} else {
-				Delta = UpdateApxPhiMI(Lambda, NId, AId, Val, ProdVV);
-			}
-
-//			PhiVV.At(NId, AId) = Val;
-			NewVal[l] = TFltIntIntTr(Val, NId, AId);
-			
-//			MuV[AId] = MuV[AId] + Val;
-			if(fabs(Delta) > MaxDelta) {
-				MaxDelta = fabs(Delta);
-			}
-			if(Val > 0.3 && Val < 0.7) {	RndCount++;	}
-		}
-
-		for(int l = 0; l < NAttrs; l++) {
-			const int NId = NewVal[l].Val2;
-			const int AId = NewVal[l].Val3;
-
-			ProdVV(NId, 0) -= GetAvgThetaLL(NId, NId, AId, true, false);
-			ProdVV(NId, 1) -= GetAvgThetaLL(NId, NId, AId, false, true);
-			ProdVV(NId, 2) -= GetAvgSqThetaLL(NId, NId, AId, true, false);
-			ProdVV(NId, 3) -= GetAvgSqThetaLL(NId, NId, AId, false, true);
-			for(int p = 0; p < NAttrs; p++) {
-				if(p > AId) {
-					int index = 4 * p;
-					AvgPhiPairVV(AId, index) -= PhiVV(NId, AId) * PhiVV(NId, p);
-					AvgPhiPairVV(AId, index+1) -= PhiVV(NId, AId) * (1.0-PhiVV(NId, p));
-					AvgPhiPairVV(AId, index+2) -= (1.0-PhiVV(NId, AId)) * PhiVV(NId, p);
-					AvgPhiPairVV(AId, index+3) -= (1.0-PhiVV(NId, AId)) * (1.0-PhiVV(NId, p));
-				} else if (p < AId) {
-					int index = 4 * AId;
-					AvgPhiPairVV(p, index) -= PhiVV(NId, p) * PhiVV(NId, AId);
-					AvgPhiPairVV(p, index+1) -= PhiVV(NId, p) * (1.0-PhiVV(NId, AId));
-					AvgPhiPairVV(p, index+2) -= (1.0-PhiVV(NId, p)) * PhiVV(NId, AId);
-					AvgPhiPairVV(p, index+3) -= (1.0-PhiVV(NId, p)) * (1.0-PhiVV(NId, AId));
+	const int BlockLen = TMath::Mx(1, TMath::Mn(1024, NNodes / 64));
+	for(int i = 0; i < NNodes; i++) {  NIdV[i] = i;  }
+	for(int it = 0; it < Iter; it++) {
+		NIdV.Shuffle(TMAGNodeBern::Rnd);
+		for(int b = 0; b < NNodes; b += BlockLen) {
+			const int BlockEnd = TMath::Mn(b + BlockLen, NNodes);
+			#pragma omp parallel
+			{
+				TFltV NbrLinWV, NbrSqWV;
+				#pragma omp for schedule(dynamic, 1) reduction(+:RndCount)
+				for(int n = b; n < BlockEnd; n++) {
+					const int NId = NIdV[n];
+					GetNbrProdWeight(NId, NbrLinWV, NbrSqWV);
+					for(int l = 0; l < NAttrs; l++) {
+						double Val = PhiVV.At(NId, l);
+						if(! KnownVV(NId, l)) {
+							UpdateApxPhiMI(Lambda, NId, l, Val, ProdVV, NbrLinWV, NbrSqWV);
+						}
+						NewPhiVV.At(NId, l) = Val;
+						if(Val > 0.3 && Val < 0.7) {	RndCount++;	}
+					}
 				}
 			}
-			AvgPhiV[AId] -= PhiVV(NId, AId);
-
-			PhiVV.At(NId, AId) = NewVal[l].Val1;
-			
-			ProdVV(NId, 0) += GetAvgThetaLL(NId, NId, AId, true, false);
-			ProdVV(NId, 1) += GetAvgThetaLL(NId, NId, AId, false, true);
-			ProdVV(NId, 2) += GetAvgSqThetaLL(NId, NId, AId, true, false);
-			ProdVV(NId, 3) += GetAvgSqThetaLL(NId, NId, AId, false, true);
-			for(int p = 0; p < NAttrs; p++) {
-				if(p > AId) {
-					int index = 4 * p;
-					AvgPhiPairVV(AId, index) += PhiVV(NId, AId) * PhiVV(NId, p);
-					AvgPhiPairVV(AId, index+1) += PhiVV(NId, AId) * (1.0-PhiVV(NId, p));
-					AvgPhiPairVV(AId, index+2) += (1.0-PhiVV(NId, AId)) * PhiVV(NId, p);
-					AvgPhiPairVV(AId, index+3) += (1.0-PhiVV(NId, AId)) * (1.0-PhiVV(NId, p));
-				} else if (p < AId) {
-					int index = 4 * AId;
-					AvgPhiPairVV(p, index) += PhiVV(NId, p) * PhiVV(NId, AId);
-					AvgPhiPairVV(p, index+1) += PhiVV(NId, p) * (1.0-PhiVV(NId, AId));
-					AvgPhiPairVV(p, index+2) += (1.0-PhiVV(NId, p)) * PhiVV(NId, AId);
-					AvgPhiPairVV(p, index+3) += (1.0-PhiVV(NId, p)) * (1.0-PhiVV(NId, AId));
+			for(int n = b; n < BlockEnd; n++) {
+				const int NId = NIdV[n];
+				for(int l = 0; l < NAttrs; l++) {
+					if(! KnownVV(NId, l)) {  SetApxPhi(NId, l, NewPhiVV.At(NId, l), ProdVV);  }
 				}
 			}
-			AvgPhiV[AId] += PhiVV(NId, AId);
 		}
 	}
 
@@ -1263,7 +1286,6 @@ double TMAGFitBern::DoEStepApxOneIter(const TFltV& TrueMuV, TFltVV& NewPhiVV, co
 	printf("\n");
 	printf("  Rnd = %d(%.3f)", RndCount, double(RndCount) / double(NNodes * NAttrs));
 	printf("  Avg = %.3f\n", Avg / double(NAttrs));
-//	printf("  Linf = %f\n", MaxDelta);
 //	L1 /= double(NAttrs);
 
 	return L1;
@@ -1349,42 +1371,50 @@ const void TMAGFitBern::GradApxAffMtx(const int& AId, const TFltVV& ProdVV, cons
 	// const int NSq = NNodes * (NNodes - 1);
 	GradV.PutAll(0.0);
 
-	TFltV LogSumV;
+	TFltV LogSumV(NNodes * 4);
 	for(int p = 0; p < 4; p++) {
 		int Ai = p / 2;
 		int Aj = p % 2;
-		LogSumV.Gen(NNodes * 4, 0);
 
+		#pragma omp parallel for schedule(static)
 		for(int i = 0; i < NNodes; i++) {
 			const double LProd = ProdVV(i, 0) - GetAvgThetaLL(i, i, AId, true, false);
 			const double LSq = SqVV(i, 0) - GetAvgSqThetaLL(i, i, AId, true, false);
 			const double RProd = ProdVV(i, 1) - GetAvgThetaLL(i, i, AId, false, true);
 			const double RSq = SqVV(i, 1) - GetAvgSqThetaLL(i, i, AId, false, true);
 
-			LogSumV.Add(LProd + log(GetProbMu(i, i, AId, Ai, Aj, true, false)));
-			LogSumV.Add(LSq + log(GetProbMu(i, i, AId, Ai, Aj, true, false)) + log(CurMtx.At(p)));
-			LogSumV.Add(RProd + log(GetProbMu(i, i, AId, Ai, Aj, false, true)));
-			LogSumV.Add(RSq + log(GetProbMu(i, i, AId, Ai, Aj, false, true)) + log(CurMtx.At(p)));
+			LogSumV[4*i] = LProd + log(GetProbMu(i, i, AId, Ai, Aj, true, false));
+			LogSumV[4*i+1] = LSq + log(GetProbMu(i, i, AId, Ai, Aj, true, false)) + log(CurMtx.At(p));
+			LogSumV[4*i+2] = RProd + log(GetProbMu(i, i, AId, Ai, Aj, false, true));
+			LogSumV[4*i+3] = RSq + log(GetProbMu(i, i, AId, Ai, Aj, false, true)) + log(CurMtx.At(p));
 		}
 		double LogSum = LogSumExp(LogSumV);
 		GradV[p] -= (NNodes - 1) * 0.5 * exp(LogSum);
 	}
 	
-	for(TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
-		const int NId1 = EI.GetSrcNId();
-		const int NId2 = EI.GetDstNId();
-		const double ProdOne = GetProdLinWeight(NId1, NId2) - GetThetaLL(NId1, NId2, AId);
-		const double SqOne = GetProdSqWeight(NId1, NId2) - GetSqThetaLL(NId1, NId2, AId);
+	//	EdgeProdV and EdgeSqV hold the product weights of the edges, see PrepareUpdateApxAffMtx()
+	double Grad0 = 0.0, Grad1 = 0.0, Grad2 = 0.0, Grad3 = 0.0;
+	#pragma omp parallel for schedule(static) reduction(+:Grad0,Grad1,Grad2,Grad3)
+	for(int e = 0; e < EdgeV.Len(); e++) {
+		const int NId1 = EdgeV[e].Val1;
+		const int NId2 = EdgeV[e].Val2;
+		const double ProdOne = EdgeProdV[e] - GetThetaLL(NId1, NId2, AId);
+		const double SqOne = EdgeSqV[e] - GetSqThetaLL(NId1, NId2, AId);
+		double EdgeGrad[4];
 
 		for(int p = 0; p < 4; p++) {
 			int Ai = p / 2;
 			int Aj = p % 2;
 			double Prob = GetProbPhi(NId1, NId2, AId, Ai, Aj);
-			GradV[p] += Prob / CurMtx.At(p);
-			GradV[p] += Prob * exp(ProdOne);
-			GradV[p] += Prob * exp(SqOne) * CurMtx.At(p);
+			EdgeGrad[p] = Prob / CurMtx.At(p);
+			EdgeGrad[p] += Prob * exp(ProdOne);
+			EdgeGrad[p] += Prob * exp(SqOne) * CurMtx.At(p);
 		}
+		Grad0 += EdgeGrad[0];  Grad1 += EdgeGrad[1];
+		Grad2 += EdgeGrad[2];  Grad3 += EdgeGrad[3];
 	}
+	GradV[0] += Grad0;  GradV[1] += Grad1;
+	GradV[2] += Grad2;  GradV[3] += Grad3;
 
 #if 0
 	const double Prod = ProdVV(0, 0) - GetAvgThetaLL(0, 0, AId, false, false);
@@ -1547,23 +1577,45 @@ const void TMAGFitBern::PrepareUpdateApxAffMtx(TFltVV& ProdVV, TFltVV& SqVV) {
 	ProdVV.Gen(NNodes, 2);
 	SqVV.Gen(NNodes, 2);
 
+	#pragma omp parallel for schedule(static)
 	for(int i = 0; i < NNodes; i++) {
 		ProdVV(i, 0) = GetAvgProdLinWeight(i, i, true, false);
 		ProdVV(i, 1) = GetAvgProdLinWeight(i, i, false, true);
 		SqVV(i, 0) = GetAvgProdSqWeight(i, i, true, false);
 		SqVV(i, 1) = GetAvgProdSqWeight(i, i, false, true);
 	}
+
+	//	product weights of the edges, kept up to date by UpdateEdgeProd()
+	EdgeV.Gen(Graph->GetEdges(), 0);
+	for(TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+		EdgeV.Add(TIntPr(EI.GetSrcNId(), EI.GetDstNId()));
+	}
+	EdgeProdV.Gen(EdgeV.Len());
+	EdgeSqV.Gen(EdgeV.Len());
+	#pragma omp parallel for schedule(static)
+	for(int e = 0; e < EdgeV.Len(); e++) {
+		EdgeProdV[e] = GetProdLinWeight(EdgeV[e].Val1, EdgeV[e].Val2);
+		EdgeSqV[e] = GetProdSqWeight(EdgeV[e].Val1, EdgeV[e].Val2);
+	}
+}
+
+//	adds Sign times the terms of attribute AId to the edge product weights
+void TMAGFitBern::UpdateEdgeProd(const int& AId, const double& Sign) {
+	#pragma omp parallel for schedule(static)
+	for(int e = 0; e < EdgeV.Len(); e++) {
+		EdgeProdV[e] += Sign * GetThetaLL(EdgeV[e].Val1, EdgeV[e].Val2, AId);
+		EdgeSqV[e] += Sign * GetSqThetaLL(EdgeV[e].Val1, EdgeV[e].Val2, AId);
+	}
 }
 	
 const double TMAGFitBern::UpdateAffMtxV(const int& GradIter, const double& LrnRate, const double& MaxGrad, const double& Lambda, const int& NReal) {
-	const int NNodes = Param.GetNodes();
 	const int NAttrs = Param.GetAttrs();
 	const TMAGNodeBern DistParam = Param.GetNodeAttr();
 	const TFltV MuV = DistParam.GetMuV();
 	double Delta = 0.0;
 	double DecLrnRate = LrnRate, DecMaxGrad = MaxGrad;
 	
-	TFltVV ProdVV(NNodes, NNodes), SqVV(NNodes, NNodes);
+	TFltVV ProdVV, SqVV;	// sized by PrepareUpdateAffMtx() and PrepareUpdateApxAffMtx()
 	TMAGAffMtxV NewMtxV, OldMtxV;
 	Param.GetMtxV(OldMtxV);
 	Param.GetMtxV(NewMtxV);
@@ -1579,7 +1631,9 @@ const double TMAGFitBern::UpdateAffMtxV(const int& GradIter, const double& LrnRa
 //		for(int l = 0; l < NAttrs; l++) {
 		for(int l = NReal; l < NAttrs; l++) {
 			UpdateAffMtx(l, DecLrnRate, DecMaxGrad, Lambda, ProdVV, SqVV, NewMtxV[l]);
+			if(MSpeedUp) {  UpdateEdgeProd(l, -1.0);  }
 			Param.SetMtxV(NewMtxV);
+			if(MSpeedUp) {  UpdateEdgeProd(l, 1.0);  }
 		}
 		DecLrnRate *= 0.97;
 		DecMaxGrad *= 0.97;
@@ -1602,6 +1656,7 @@ const double TMAGFitBern::UpdateAffMtxV(const int& GradIter, const double& LrnRa
 	}
 	Param.SetMtxV(NewMtxV);
 	ProdVV.Clr();		SqVV.Clr();
+	EdgeV.Clr();		EdgeProdV.Clr();		EdgeSqV.Clr();
 	return Delta;
 }
 
@@ -2022,23 +2077,61 @@ const double TMAGFitBern::ComputeApxLL() const {
 		Theta.GetLLMtx(LLMtxV[l]);
 	}
 
+	if(NonEdgeSample > 0) {
+		//	edges exactly, non-edges from a sample of node pairs
+		TIntPrV EdgeV(Graph->GetEdges(), 0);
+		for(TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+			if(EI.GetSrcNId() != EI.GetDstNId()) {  EdgeV.Add(TIntPr(EI.GetSrcNId(), EI.GetDstNId()));  }
+		}
+		const double NonEdges = double(NNodes) * double(NNodes - 1) - EdgeV.Len();
+		TIntPrV PairV(NonEdgeSample, 0);
+		TRnd Rnd(2000);
+		while(NonEdges > 0 && PairV.Len() < NonEdgeSample) {
+			const int i = Rnd.GetUniDevInt(NNodes);
+			const int j = Rnd.GetUniDevInt(NNodes);
+			if(i != j && ! Graph->IsEdge(i, j)) {  PairV.Add(TIntPr(i, j));  }
+		}
+		double EdgeLL = 0.0, NonEdgeLL = 0.0;
+		#pragma omp parallel for schedule(static) reduction(+:EdgeLL)
+		for(int e = 0; e < EdgeV.Len(); e++) {
+			const int i = EdgeV[e].Val1, j = EdgeV[e].Val2;
+			for(int l = 0; l < NAttrs; l++) {
+				EdgeLL += GetProbPhi(i, j, l, 0, 0) * LLMtxV[l].At(0, 0);
+				EdgeLL += GetProbPhi(i, j, l, 0, 1) * LLMtxV[l].At(0, 1);
+				EdgeLL += GetProbPhi(i, j, l, 1, 0) * LLMtxV[l].At(1, 0);
+				EdgeLL += GetProbPhi(i, j, l, 1, 1) * LLMtxV[l].At(1, 1);
+			}
+			EdgeLL += log(NormConst);
+		}
+		#pragma omp parallel for schedule(static) reduction(+:NonEdgeLL)
+		for(int e = 0; e < PairV.Len(); e++) {
+			NonEdgeLL += log(1-exp(GetProdLinWeight(PairV[e].Val1, PairV[e].Val2)));
+		}
+		LL += EdgeLL;
+		if(! PairV.Empty()) {  LL += NonEdgeLL * NonEdges / double(PairV.Len());  }
+		return LL;
+	}
+
+	double PairLL = 0.0;
+	#pragma omp parallel for schedule(dynamic, 16) reduction(+:PairLL)
 	for(int i = 0; i < NNodes; i++) {
 		for(int j = 0; j < NNodes; j++) {
 			if(i == j) {  continue;  }
 
 			if(Graph->IsEdge(i, j)) {
 				for(int l = 0; l < NAttrs; l++) {
-					LL += GetProbPhi(i, j, l, 0, 0) * LLMtxV[l].At(0, 0);
-					LL += GetProbPhi(i, j, l, 0, 1) * LLMtxV[l].At(0, 1);
-					LL += GetProbPhi(i, j, l, 1, 0) * LLMtxV[l].At(1, 0);
-					LL += GetProbPhi(i, j, l, 1, 1) * LLMtxV[l].At(1, 1);
+					PairLL += GetProbPhi(i, j, l, 0, 0) * LLMtxV[l].At(0, 0);
+					PairLL += GetProbPhi(i, j, l, 0, 1) * LLMtxV[l].At(0, 1);
+					PairLL += GetProbPhi(i, j, l, 1, 0) * LLMtxV[l].At(1, 0);
+					PairLL += GetProbPhi(i, j, l, 1, 1) * LLMtxV[l].At(1, 1);
 				}
-				LL += log(NormConst);
+				PairLL += log(NormConst);
 			} else {
-				LL += log(1-exp(GetProdLinWeight(i, j)));
+				PairLL += log(1-exp(GetProdLinWeight(i, j)));
 			}
 		}
 	}
+	LL += PairLL;
 
 	return LL;
 }
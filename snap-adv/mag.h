@@ -348,6 +348,9 @@ private:
 	TFltV AvgPhiV;
 	TFltVV AvgPhiPairVV;
 	TFlt NormConst;
+	TInt NonEdgeSample;
+	TIntPrV EdgeV;
+	TFltV EdgeProdV, EdgeSqV;
 
 	TVec<TFltV> MuHisV;
 	TVec<TMAGAffMtxV> MtxHisV;
@@ -385,6 +388,8 @@ public:
 
 	void SetDebug(const bool _Debug) {  Debug = _Debug;  }
 	void SetAlgConf(const bool EStep = true, const bool MStep = true)  {  ESpeedUp = EStep;  MSpeedUp = MStep;  }
+	//	ComputeApxLL() estimates the non-edge term from NSample node pairs (0 uses all pairs)
+	void SetNonEdgeSample(const int& NSample) {  NonEdgeSample = NSample;  }
 
 	void Init(const TFltV& MuV, const TMAGAffMtxV& AffMtxV);
 //	void PerturbInit(const TFltV& MuV, const TMAGAffMtxV& AffMtxV, const double& PerturbRate);
@@ -413,6 +418,7 @@ public:
 	const double ObjPhiMI(const double& x, const int& NId, const int& AId, const double& Lambda, const double& Q0, const double& Q1, const TFltVV& CntVV);
 	const double UpdatePhiMI(const double& Lambda, const int& NId, const int& AId, double& Phi);
 	const double UpdateApxPhiMI(const double& Lambda, const int& NId, const int& AId, double& Phi, TFltVV& ProdVV);
+	const double UpdateApxPhiMI(const double& Lambda, const int& NId, const int& AId, double& Phi, TFltVV& ProdVV, const TFltV& NbrLinWV, const TFltV& NbrSqWV);
 	const double UpdatePhi(const int& NId, const int& AId, double& Phi);
 	const double UpdateMu(const int& AId);
 	const void PrepareUpdateAffMtx(TFltVV& ProdVV, TFltVV& SqVV);
@@ -450,6 +456,9 @@ public:
 	void UnNormalizeAffMtxV(TMAGAffMtxV& MtxV, const bool UseMu = false);
 private:
 	const bool NextPermutation(TIntV& IndexV) const;
+	void GetNbrProdWeight(const int& NId, TFltV& NbrLinWV, TFltV& NbrSqWV) const;
+	void SetApxPhi(const int& NId, const int& AId, const double& Phi, TFltVV& ProdVV);
+	void UpdateEdgeProd(const int& AId, const double& Sign);
 };
 
 const double LogSumExp(const double LogVal1, const double LogVal2);
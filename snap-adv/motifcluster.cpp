@@ -22,6 +22,14 @@ extern "C" {
                         double *workd, double *workl, int *lworkl, int *info);
 }
 
+// Computes the smallest algebraic eigenvalues of A with ARPACK, as described
+// for SymeigsSmallest().  A can be any symmetric operator that provides
+// GetCols() and Multiply(x, y) for y = A * x.
+template <class TOperator>
+static void ArpackSymeigsSmallest(const TOperator& A, int nev, TFltV& evals,
+                                  TFullColMatrix& evecs, double tol,
+                                  int maxiter);
+
 /////////////////////////////////////////////////
 // Utility functions
 
@@ -696,12 +704,480 @@ void ChibaNishizekiWeighter::CliqueEnum(int k, const TIntV& U) {
 }
 
 
+/////////////////////////////////////////////////
+// Parallel motif adjacency formation
+
+// Edge types in the undirected view of a directed graph, as seen from the
+// first endpoint u of an edge (u, v).
+static const char kOutEdge   = 1;  // u  --> v
+static const char kInEdge    = 2;  // v  --> u
+static const char kBidirEdge = 3;  // u <--> v
+
+// Undirected view of a directed graph with one row per node id.  The neighbors
+// of node u are nbrs[offsets[u]], ..., nbrs[offsets[u + 1] - 1] in increasing
+// order, and dirs holds the type of each of these edges.  Self-loops are
+// dropped.
+class TDirNbrs {
+ public:
+  int num_nodes() const { return offsets.Len() - 1; }
+  TVec<TInt64> offsets;
+  TVec<TInt, int64> nbrs;
+  TVec<TCh, int64> dirs;
+};
+
+// Merges the sorted in- and out-neighbors of NI.  Returns the number of
+// neighbors and stores them in nbrs and dirs unless these are NULL.
+static int MergeNbrs(const TNGraph::TNodeI& NI, TInt* nbrs, TCh* dirs) {
+  int src = NI.GetId();
+  int out_deg = NI.GetOutDeg();
+  int in_deg = NI.GetInDeg();
+  int num_nbrs = 0;
+  int i = 0;
+  int j = 0;
+  while (i < out_deg || j < in_deg) {
+    int nbr = 0;
+    char dir = 0;
+    if (j == in_deg || (i < out_deg && NI.GetOutNId(i) < NI.GetInNId(j))) {
+      nbr = NI.GetOutNId(i++);
+      dir = kOutEdge;
+    } else if (i == out_deg || NI.GetInNId(j) < NI.GetOutNId(i)) {
+      nbr = NI.GetInNId(j++);
+      dir = kInEdge;
+    } else {
+      nbr = NI.GetOutNId(i++);
+      j++;
+      dir = kBidirEdge;
+    }
+    if (nbr == src) { continue; }
+    if (nbrs != NULL) {
+      nbrs[num_nbrs] = nbr;
+      dirs[num_nbrs] = dir;
+    }
+    num_nbrs++;
+  }
+  return num_nbrs;
+}
+
+static void GetDirNbrs(PNGraph graph, TDirNbrs& view) {
+  int max_nodes = graph->GetMxNId() + 1;
+  TIntV nodes;
+  graph->GetNIdV(nodes);
+  view.offsets = TVec<TInt64>(max_nodes + 1);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < nodes.Len(); i++) {
+    const TNGraph::TNodeI NI = graph->GetNI(nodes[i]);
+    view.offsets[nodes[i] + 1] = MergeNbrs(NI, NULL, NULL);
+  }
+  for (int u = 0; u < max_nodes; u++) {
+    view.offsets[u + 1] += view.offsets[u];
+  }
+  view.nbrs.Gen(view.offsets[max_nodes]);
+  view.dirs.Gen(view.offsets[max_nodes]);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < nodes.Len(); i++) {
+    const TNGraph::TNodeI NI = graph->GetNI(nodes[i]);
+    int64 start = view.offsets[nodes[i]];
+    MergeNbrs(NI, view.nbrs.BegI() + start, view.dirs.BegI() + start);
+  }
+}
+
+// Returns the directed triangle motif (M1-M7) formed by nodes u, v, w, given
+// the types of the edges (u, v), (u, w) and (v, w).
+static MotifType TriangleMotifType(int uv, int uw, int vw) {
+  int num_bidir = (uv == kBidirEdge) + (uw == kBidirEdge) + (vw == kBidirEdge);
+  if (num_bidir == 3) { return M4; }
+  if (num_bidir == 2) { return M3; }
+  // Number of unidirectional edges leaving each node
+  int out_u = (uv == kOutEdge) + (uw == kOutEdge);
+  int out_v = (uv == kInEdge)  + (vw == kOutEdge);
+  int out_w = (uw == kInEdge)  + (vw == kInEdge);
+  if (num_bidir == 0) {
+    return (out_u == 1 && out_v == 1 && out_w == 1) ? M1 : M5;
+  }
+  // The node off the bidirectional edge points to both (M6), neither (M7) or
+  // one (M2) of its endpoints.
+  int out_other = out_u;
+  if (uv == kBidirEdge) { out_other = out_w; }
+  if (uw == kBidirEdge) { out_other = out_v; }
+  if (out_other == 2) { return M6; }
+  if (out_other == 0) { return M7; }
+  return M2;
+}
+
+// Check if an edge of the given type can be part of the wedge motif, as seen
+// from the center of the wedge.
+static bool IsWedgeMotifEdge(MotifType motif, int dir) {
+  switch (motif) {
+  case M8:  return dir == kOutEdge;
+  case M9:  return dir != kBidirEdge;
+  case M10: return dir == kInEdge;
+  case M11: return dir != kInEdge;
+  case M12: return dir != kOutEdge;
+  case M13: return dir == kBidirEdge;
+  default:
+    TExcept::Throw("Unknown directed wedge motif");
+  }
+  return false;
+}
+
+// Check if two edges (center, v) and (center, w) of the given types form the
+// wedge motif, provided that v and w are not adjacent.
+static bool IsWedgeMotif(MotifType motif, int cv, int cw) {
+  switch (motif) {
+  case M8:  return cv == kOutEdge && cw == kOutEdge;
+  case M9:  return (cv == kOutEdge && cw == kInEdge) ||
+                   (cv == kInEdge && cw == kOutEdge);
+  case M10: return cv == kInEdge && cw == kInEdge;
+  case M11: return (cv == kBidirEdge && cw == kOutEdge) ||
+                   (cv == kOutEdge && cw == kBidirEdge);
+  case M12: return (cv == kBidirEdge && cw == kInEdge) ||
+                   (cv == kInEdge && cw == kBidirEdge);
+  case M13: return cv == kBidirEdge && cw == kBidirEdge;
+  default:
+    TExcept::Throw("Unknown directed wedge motif");
+  }
+  return false;
+}
+
+// Counts the instances of a directed triangle motif on the edges of the view.
+// Every triangle is found once, from its first node in the degree ordering,
+// by intersecting lists of neighbors that come later in the ordering.
+static void TriangleMotifWeights(const TDirNbrs& view, const TIntV& order,
+                                 MotifType motif, TVec<TInt, int64>& weights) {
+  int max_nodes = view.num_nodes();
+  // Positions in view.nbrs of the edges to neighbors later in the ordering
+  TVec<TInt64> higher_offsets(max_nodes + 1);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < max_nodes; u++) {
+    int num_higher = 0;
+    for (int64 e = view.offsets[u]; e < view.offsets[u + 1]; e++) {
+      if (order[view.nbrs[e]] > order[u]) { num_higher++; }
+    }
+    higher_offsets[u + 1] = num_higher;
+  }
+  for (int u = 0; u < max_nodes; u++) {
+    higher_offsets[u + 1] += higher_offsets[u];
+  }
+  TVec<TInt64, int64> higher(higher_offsets[max_nodes]);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < max_nodes; u++) {
+    int64 pos = higher_offsets[u];
+    for (int64 e = view.offsets[u]; e < view.offsets[u + 1]; e++) {
+      if (order[view.nbrs[e]] > order[u]) { higher[pos++] = e; }
+    }
+  }
+
+  #pragma omp parallel
+  {
+    // edge_to[v] is the position of the edge (src, v) if v is a higher
+    // neighbor of the current src, and -1 otherwise.
+    TVec<TInt64> edge_to(max_nodes);
+    edge_to.PutAll(-1);
+    #pragma omp for schedule(dynamic, 100)
+    for (int src = 0; src < max_nodes; src++) {
+      for (int64 h = higher_offsets[src]; h < higher_offsets[src + 1]; h++) {
+        edge_to[view.nbrs[higher[h]]] = higher[h];
+      }
+      for (int64 h1 = higher_offsets[src]; h1 < higher_offsets[src + 1]; h1++) {
+        int64 e1 = higher[h1];
+        int dst1 = view.nbrs[e1];
+        for (int64 h2 = higher_offsets[dst1]; h2 < higher_offsets[dst1 + 1];
+             h2++) {
+          int64 e12 = higher[h2];
+          int64 e2 = edge_to[view.nbrs[e12]];
+          if (e2 < 0) { continue; }
+          if (TriangleMotifType(view.dirs[e1], view.dirs[e2],
+                                view.dirs[e12]) == motif) {
+            __sync_fetch_and_add(&weights[e1].Val, 1);
+            __sync_fetch_and_add(&weights[e2].Val, 1);
+            __sync_fetch_and_add(&weights[e12].Val, 1);
+          }
+        }
+      }
+      for (int64 h = higher_offsets[src]; h < higher_offsets[src + 1]; h++) {
+        edge_to[view.nbrs[higher[h]]] = -1;
+      }
+    }
+  }
+}
+
+// Counts the instances of a directed wedge motif.  The weights of the two
+// edges at the center are accumulated on the edges of the view.  The wedges
+// between non-adjacent endpoints v < w are counted row by row of v with a
+// touched list, so each pair (v, w) is appended once with its count to the
+// thread-local buffers returned in pairs and pair_counts, and memory grows with
+// the number of distinct pairs rather than with the number of wedges.
+static void WedgeMotifWeights(const TDirNbrs& view, MotifType motif,
+                              TVec<TInt, int64>& weights,
+                              TVec< TVec<TUInt64, int64> >& pairs,
+                              TVec< TVec<TInt, int64> >& pair_counts) {
+  int max_nodes = view.num_nodes();
+  pairs.Clr();
+  pair_counts.Clr();
+  #pragma omp parallel
+  {
+    TVec<TUInt64, int64> local_pairs;
+    TVec<TInt, int64> local_counts;
+    // marker[x] == v if x is a neighbor of the current row v
+    TIntV marker(max_nodes);
+    marker.PutAll(-1);
+    // counts[w] is the number of wedges between v and w
+    TIntV counts(max_nodes), touched;
+    #pragma omp for schedule(dynamic, 100)
+    for (int v = 0; v < max_nodes; v++) {
+      for (int64 e = view.offsets[v]; e < view.offsets[v + 1]; e++) {
+        marker[view.nbrs[e]] = v;
+      }
+      for (int64 e1 = view.offsets[v]; e1 < view.offsets[v + 1]; e1++) {
+        int center = view.nbrs[e1];
+        // The type of the edge (center, v), as seen from the center
+        int cv = view.dirs[e1];
+        if (cv != kBidirEdge) { cv = (cv == kOutEdge) ? kInEdge : kOutEdge; }
+        if (!IsWedgeMotifEdge(motif, cv)) { continue; }
+        for (int64 e2 = view.offsets[center]; e2 < view.offsets[center + 1];
+             e2++) {
+          int w = view.nbrs[e2];
+          if (w <= v || marker[w] == v) { continue; }
+          if (IsWedgeMotif(motif, cv, view.dirs[e2])) {
+            // e1 stands in for the edge (center, v), edge weights are
+            // symmetrized later
+            __sync_fetch_and_add(&weights[e1].Val, 1);
+            __sync_fetch_and_add(&weights[e2].Val, 1);
+            if (counts[w] == 0) { touched.Add(w); }
+            counts[w]++;
+          }
+        }
+      }
+      for (int i = 0; i < touched.Len(); i++) {
+        local_pairs.Add((uint64(v) << 32) | uint64(touched[i].Val));
+        local_counts.Add(counts[touched[i]]);
+        counts[touched[i]] = 0;
+      }
+      touched.Clr(false);
+    }
+    #pragma omp critical
+    {
+      pairs.Add();
+      pairs.Last().Swap(local_pairs);
+      pair_counts.Add();
+      pair_counts.Last().Swap(local_counts);
+    }
+  }
+}
+
+// Groups the distinct node pairs in the buffers by row, in both directions.
+// The neighbors of row u are cols[offsets[u]], ..., cols[offsets[u] + lens[u]
+// - 1] in increasing order, with multiplicities in counts.
+static void MergePairs(const TVec< TVec<TUInt64, int64> >& pairs,
+                       const TVec< TVec<TInt, int64> >& pair_counts,
+                       int max_nodes, TVec<TInt64>& offsets, TIntV& lens,
+                       TVec<TInt, int64>& cols, TVec<TInt, int64>& counts) {
+  offsets = TVec<TInt64>(max_nodes + 1);
+  for (int t = 0; t < pairs.Len(); t++) {
+    const TVec<TUInt64, int64>& buffer = pairs[t];
+    #pragma omp parallel for schedule(static)
+    for (int64 i = 0; i < buffer.Len(); i++) {
+      __sync_fetch_and_add(&offsets[int(buffer[i] >> 32) + 1].Val, 1);
+      __sync_fetch_and_add(&offsets[int(buffer[i] & 0xffffffff) + 1].Val, 1);
+    }
+  }
+  for (int u = 0; u < max_nodes; u++) {
+    offsets[u + 1] += offsets[u];
+  }
+  // Every row gets (column, count) entries packed with the column in the high
+  // bits, so that sorting them orders the row by column
+  TVec<TInt64> next(offsets);
+  TVec<TUInt64, int64> entries(offsets[max_nodes]);
+  for (int t = 0; t < pairs.Len(); t++) {
+    const TVec<TUInt64, int64>& buffer = pairs[t];
+    const TVec<TInt, int64>& buffer_counts = pair_counts[t];
+    #pragma omp parallel for schedule(static)
+    for (int64 i = 0; i < buffer.Len(); i++) {
+      uint64 u = buffer[i] >> 32;
+      uint64 v = buffer[i] & 0xffffffff;
+      uint64 count = uint64(buffer_counts[i].Val);
+      entries[__sync_fetch_and_add(&next[int(u)].Val, 1)] = (v << 32) | count;
+      entries[__sync_fetch_and_add(&next[int(v)].Val, 1)] = (u << 32) | count;
+    }
+  }
+  lens = TIntV(max_nodes);
+  cols.Gen(entries.Len());
+  counts.Gen(entries.Len());
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < max_nodes; u++) {
+    TSnap::SortMP(entries.BegI() + offsets[u], entries.BegI() + offsets[u + 1]);
+    for (int64 i = offsets[u]; i < offsets[u + 1]; i++) {
+      cols[i] = int(entries[i] >> 32);
+      counts[i] = int(entries[i] & 0xffffffff);
+    }
+    lens[u] = int(offsets[u + 1] - offsets[u]);
+  }
+}
+
+// Returns the position of the edge (u, v) in the view.
+static int64 FindEdge(const TDirNbrs& view, int u, int v) {
+  int64 lo = view.offsets[u];
+  int64 hi = view.offsets[u + 1] - 1;
+  while (lo < hi) {
+    int64 mid = (lo + hi) / 2;
+    if (view.nbrs[mid] < v) { lo = mid + 1; } else { hi = mid; }
+  }
+  return lo;
+}
+
+void MotifCluster::MotifAdjacency(PNGraph graph, MotifType motif,
+                                  TWeightCsr& weights) {
+  switch (motif) {
+  case M1: case M2: case M3: case M4: case M5: case M6: case M7:
+  case M8: case M9: case M10: case M11: case M12: case M13:
+  case edge:
+    break;
+  case bifan: {
+    WeightVH weights_vh;
+    MotifAdjacency(graph, motif, weights_vh);
+    WeightsToCsr(weights_vh, weights);
+    return;
+  }
+  default:
+    TExcept::Throw("Unknown directed motif type");
+  }
+
+  TDirNbrs view;
+  GetDirNbrs(graph, view);
+  int max_nodes = view.num_nodes();
+  // Motif counts on the edges of the view.  The weight of the pair (u, v) is
+  // the sum of the counts on the edges (u, v) and (v, u).
+  TVec<TInt, int64> edge_counts(view.nbrs.Len());
+  // Weights of the pairs that are not edges (wedge motifs only)
+  TVec<TInt64> pair_offsets;
+  TIntV pair_lens(max_nodes);
+  TVec<TInt, int64> pair_cols, pair_counts;
+
+  if (motif == edge) {
+    #pragma omp parallel for schedule(dynamic, 1000)
+    for (int u = 0; u < max_nodes; u++) {
+      for (int64 e = view.offsets[u]; e < view.offsets[u + 1]; e++) {
+        if (view.nbrs[e] > u) { edge_counts[e] = 1; }
+      }
+    }
+  } else if (motif >= M8) {
+    TVec< TVec<TUInt64, int64> > pairs;
+    TVec< TVec<TInt, int64> > counts;
+    WedgeMotifWeights(view, motif, edge_counts, pairs, counts);
+    MergePairs(pairs, counts, max_nodes, pair_offsets, pair_lens, pair_cols,
+               pair_counts);
+  } else {
+    TIntV order;
+    DegreeOrdering(graph, order);
+    TriangleMotifWeights(view, order, motif, edge_counts);
+  }
+
+  // Symmetric weights on the edges of the view
+  TVec<TInt, int64> edge_weights(view.nbrs.Len());
+  weights.offsets = TVec<TInt64>(max_nodes + 1);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < max_nodes; u++) {
+    int row_len = pair_lens[u];
+    for (int64 e = view.offsets[u]; e < view.offsets[u + 1]; e++) {
+      int64 rev = FindEdge(view, view.nbrs[e], u);
+      edge_weights[e] = edge_counts[e] + edge_counts[rev];
+      if (edge_weights[e] > 0) { row_len++; }
+    }
+    weights.offsets[u + 1] = row_len;
+  }
+  for (int u = 0; u < max_nodes; u++) {
+    weights.offsets[u + 1] += weights.offsets[u];
+  }
+
+  // Merge the two sorted lists of each row
+  weights.cols.Gen(weights.offsets[max_nodes]);
+  weights.vals.Gen(weights.offsets[max_nodes]);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int u = 0; u < max_nodes; u++) {
+    int64 pos = weights.offsets[u];
+    int64 e = view.offsets[u];
+    int64 p = 0;
+    if (pair_lens[u] > 0) { p = pair_offsets[u]; }
+    int64 p_end = p + pair_lens[u];
+    while (e < view.offsets[u + 1] || p < p_end) {
+      if (e < view.offsets[u + 1] && edge_weights[e] == 0) {
+        e++;
+      } else if (p == p_end ||
+                 (e < view.offsets[u + 1] && view.nbrs[e] < pair_cols[p])) {
+        weights.cols[pos] = view.nbrs[e];
+        weights.vals[pos++] = edge_weights[e++];
+      } else {
+        weights.cols[pos] = pair_cols[p];
+        weights.vals[pos++] = pair_counts[p++];
+      }
+    }
+  }
+}
+
+void MotifCluster::MotifAdjacency(PUNGraph graph, MotifType motif,
+                                  TWeightCsr& weights) {
+  WeightVH weights_vh;
+  MotifAdjacency(graph, motif, weights_vh);
+  WeightsToCsr(weights_vh, weights);
+}
+
+void MotifCluster::WeightsToCsr(const WeightVH& weights, TWeightCsr& csr) {
+  int num_rows = weights.Len();
+  csr.offsets = TVec<TInt64>(num_rows + 1);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < num_rows; i++) {
+    const THash<TInt, TInt>& edge_list = weights[i];
+    for (THash<TInt, TInt>::TIter it = edge_list.BegI(); it < edge_list.EndI();
+         it++) {
+      __sync_fetch_and_add(&csr.offsets[i + 1].Val, 1);
+      if (it->Key != i) { __sync_fetch_and_add(&csr.offsets[it->Key + 1].Val, 1); }
+    }
+  }
+  for (int i = 0; i < num_rows; i++) {
+    csr.offsets[i + 1] += csr.offsets[i];
+  }
+  TVec<TInt64> next(csr.offsets);
+  csr.cols.Gen(csr.offsets[num_rows]);
+  csr.vals.Gen(csr.offsets[num_rows]);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < num_rows; i++) {
+    const THash<TInt, TInt>& edge_list = weights[i];
+    for (THash<TInt, TInt>::TIter it = edge_list.BegI(); it < edge_list.EndI();
+         it++) {
+      int j = it->Key;
+      double val = it->Dat;
+      int64 pos = __sync_fetch_and_add(&next[i].Val, 1);
+      csr.cols[pos] = j;
+      csr.vals[pos] = (i == j) ? 2 * val : val;
+      if (i != j) {
+        pos = __sync_fetch_and_add(&next[j].Val, 1);
+        csr.cols[pos] = i;
+        csr.vals[pos] = val;
+      }
+    }
+  }
+  // Sort the columns of each row
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < num_rows; i++) {
+    TVec< TKeyDat<TInt, TFlt> > row;
+    for (int64 pos = csr.offsets[i]; pos < csr.offsets[i + 1]; pos++) {
+      row.Add(TKeyDat<TInt, TFlt>(csr.cols[pos], csr.vals[pos]));
+    }
+    TSnap::SortMP(row);
+    for (int ind = 0; ind < row.Len(); ind++) {
+      csr.cols[csr.offsets[i] + ind] = row[ind].Key;
+      csr.vals[csr.offsets[i] + ind] = row[ind].Dat;
+    }
+  }
+}
+
+
 /////////////////////////////////////////////////
 // Spectral stuff
 void MotifCluster::GetMotifCluster(PNGraph graph, MotifType motif,
 				   TSweepCut& sweepcut, double tol,
 				   int maxiter) {
-  WeightVH weights;
+  TWeightCsr weights;
   MotifAdjacency(graph, motif, weights);
   SpectralCut(weights, sweepcut, tol, maxiter);
 }
@@ -709,7 +1185,7 @@ void MotifCluster::GetMotifCluster(PNGraph graph, MotifType motif,
 void MotifCluster::GetMotifCluster(PUNGraph graph, MotifType motif,
 				   TSweepCut& sweepcut, double tol,
 				   int maxiter) {
-  WeightVH weights;
+  TWeightCsr weights;
   MotifAdjacency(graph, motif, weights);
   SpectralCut(weights, sweepcut, tol, maxiter);
 }
@@ -767,53 +1243,134 @@ double MotifCluster::NFiedlerVector(const TSparseColMatrix& W, TFltV& fvec,
   return evals[1] - 1;
 }
 
-// Given a vector of hashmaps representing weights in a graph, construct the
-// undirected, unweighted. graph with the same network structure.
-static PUNGraph UnweightedGraphRepresentation(const WeightVH& weights) {
-  int num_edges = 0;
-  for (int i = 0; i < weights.Len(); i++) {
-    num_edges += weights[i].Len();
+// The operator I + Ln = 2 I - D^{-1/2} W D^{-1/2} of a CSR matrix W, where Ln
+// is the normalized Laplacian and dnorm holds the entries of D^{-1/2}.
+class ShiftedNormalizedLaplacian {
+ public:
+  ShiftedNormalizedLaplacian(const TWeightCsr& W, const TFltV& dnorm)
+    : W_(W), dnorm_(dnorm) {}
+
+  int GetCols() const { return W_.num_rows(); }
+
+  // Computes y = (I + Ln) * x in parallel.
+  void Multiply(const TFltV& x, TFltV& y) const {
+    int N = W_.num_rows();
+    if (y.Len() != N) { y.Gen(N); }
+    #pragma omp parallel for schedule(dynamic, 1000)
+    for (int i = 0; i < N; i++) {
+      double sum = 0;
+      for (int64 pos = W_.offsets[i]; pos < W_.offsets[i + 1]; pos++) {
+        int j = W_.cols[pos];
+        sum += W_.vals[pos] * dnorm_[j] * x[j];
+      }
+      y[i] = 2.0 * x[i] - dnorm_[i] * sum;
+    }
   }
-  PUNGraph graph = TUNGraph::New(weights.Len(), num_edges);
-  for (int i = 0; i < weights.Len(); i++) {
-    graph->AddNode(i);
+
+ private:
+  const TWeightCsr& W_;
+  const TFltV& dnorm_;
+};
+
+double MotifCluster::NFiedlerVector(const TWeightCsr& W, TFltV& fvec,
+                                    double tol, int maxiter) {
+  int N = W.num_rows();
+
+  // degree vector
+  TFltV d(N);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < N; i++) {
+    double sum = 0;
+    for (int64 pos = W.offsets[i]; pos < W.offsets[i + 1]; pos++) {
+      sum += W.vals[pos];
+    }
+    d[i] = sum;
   }
-  for (int i = 0; i < weights.Len(); i++) {
-    const THash<TInt, TInt>& edge_list = weights[i];
-    for (THash<TInt, TInt>::TIter it = edge_list.BegI(); it < edge_list.EndI();
-	 it++) {    
-      graph->AddEdge(i, it->Key);
+
+  // d^{-1/2}
+  TFltV dnorm(N);
+  for (int i = 0; i < N; i++) {
+    if (d[i] <= 0.0) {
+      TExcept::Throw("Node with zero degree.");
     }
+    dnorm[i] = 1.0 / TMath::Sqrt(d[i]);
   }
 
-  return graph;
+  ShiftedNormalizedLaplacian L(W, dnorm);
+  TFltV evals;
+  TFullColMatrix evecs;
+  ArpackSymeigsSmallest(L, 2, evals, evecs, tol, maxiter);
+  fvec = evecs.ColV[1];
+  for (int i = 0; i < fvec.Len(); i++) {
+    fvec[i] *= dnorm[i];
+  }
+  // Adjust by 1 on the eigenvalue since we added the identity
+  return evals[1] - 1;
 }
 
-// Maps a vector of unique ids to 0, 1, ..., num_ids - 1.  Sets up data
-// structures id_map and rev_id_map so that
-//     id_map[original_id] = new_id
-//     rev_id_map[new_id]  = original_id
-static void MapIdsToFirstN(const TIntV& ids, THash<TInt, TInt>& id_map,
-                           TIntV& rev_id_map) {
-  id_map = THash<TInt, TInt>();
-  rev_id_map = TIntV(ids.Len());
-  for (int i = 0; i < ids.Len(); i++) {
-    int id = ids[i];
-    if (id_map.IsKey(id)) {
-      TExcept::Throw("List of ids is not unique.");
+// Fills comp with the node ids of the largest connected component of the
+// graph with adjacency matrix W, in increasing order.
+static void LargestComponent(const TWeightCsr& W, TIntV& comp) {
+  int num_rows = W.num_rows();
+  comp.Clr();
+  if (num_rows <= 0) { return; }
+  TBoolV visited(num_rows);
+  TIntV queue;
+  for (int start = 0; start < num_rows; start++) {
+    if (visited[start]) { continue; }
+    visited[start] = true;
+    queue.Clr(false);
+    queue.Add(start);
+    for (int head = 0; head < queue.Len(); head++) {
+      int node = queue[head];
+      for (int64 pos = W.offsets[node]; pos < W.offsets[node + 1]; pos++) {
+        int nbr = W.cols[pos];
+        if (!visited[nbr]) {
+          visited[nbr] = true;
+          queue.Add(nbr);
+        }
+      }
+    }
+    if (queue.Len() > comp.Len()) { comp.Swap(queue); }
+  }
+  comp.Sort();
+}
+
+// Forms the submatrix of W induced by the connected component comp (sorted
+// node ids).  Row and column i of the submatrix correspond to node comp[i].
+static void ComponentMatrix(const TWeightCsr& W, const TIntV& comp,
+                            TWeightCsr& W_comp) {
+  TIntV id_map(W.num_rows());
+  for (int i = 0; i < comp.Len(); i++) {
+    id_map[comp[i]] = i;
+  }
+  W_comp.offsets = TVec<TInt64>(comp.Len() + 1);
+  for (int i = 0; i < comp.Len(); i++) {
+    int node = comp[i];
+    W_comp.offsets[i + 1] = W_comp.offsets[i] + W.offsets[node + 1] -
+      W.offsets[node];
+  }
+  W_comp.cols.Gen(W_comp.offsets[comp.Len()]);
+  W_comp.vals.Gen(W_comp.offsets[comp.Len()]);
+  #pragma omp parallel for schedule(dynamic, 1000)
+  for (int i = 0; i < comp.Len(); i++) {
+    int node = comp[i];
+    int64 pos = W_comp.offsets[i];
+    for (int64 ind = W.offsets[node]; ind < W.offsets[node + 1]; ind++) {
+      // The ids are sorted, so the columns stay sorted
+      W_comp.cols[pos] = id_map[W.cols[ind]];
+      W_comp.vals[pos++] = W.vals[ind];
     }
-    id_map(id) = i;
-    rev_id_map[i] = id;
   }
 }
 
 // Run a sweep cut on the network represented by W and Fiedler vector fvec,
 // storing the conductances from the sweep in conds and the order of the nodes
-// in order.
-static void Sweep(const TSparseColMatrix& W, const TFltV& fvec, TFltV& conds,
+// in order.  The changes of the cut and the volume contributed by each node
+// are computed in parallel and then accumulated along the order.
+static void Sweep(const TWeightCsr& W, const TFltV& fvec, TFltV& conds,
                   TIntV& order) {
   // Get ordering of nodes
-  
   TVec< TKeyDat<TFlt, TInt> > fvec_inds(fvec.Len());
   for (int i = 0; i < fvec.Len(); i++) {
     fvec_inds[i] = TKeyDat<TFlt, TInt>(fvec[i], i);
@@ -826,40 +1383,37 @@ static void Sweep(const TSparseColMatrix& W, const TFltV& fvec, TFltV& conds,
     rank[order[i]] = i;
   }
 
-  // Sweep by adjusting cut and volume
-  conds = TFltV(order.Len() - 1);
-  double cut = 0;
-  double vol = 0;
+  // Change of the cut and volume when moving the node at each position
+  TFltV cut_diff(order.Len());
+  TFltV vol_diff(order.Len());
   double total_vol = 0;
+  #pragma omp parallel for schedule(dynamic, 1000) reduction(+:total_vol)
   for (int ind = 0; ind < order.Len(); ind++) {
-    const TIntFltKdV& nbr_weights = W.ColSpVV[ind];
-    for (TIntFltKdV::TIter it = nbr_weights.BegI(); it < nbr_weights.EndI();
-	 it++) {
-      total_vol += it->Dat;
-    }
-  }
-  double vol_comp = total_vol;
-  
-  for (int ind = 0; ind < order.Len() - 1; ind++) {
     int node = order[ind];
-    const TIntFltKdV& nbr_weights = W.ColSpVV[node];
-    for (TIntFltKdV::TIter it = nbr_weights.BegI(); it < nbr_weights.EndI();
-	 it++) {
-      int nbr = it->Key;
+    double cut = 0;
+    double vol = 0;
+    for (int64 pos = W.offsets[node]; pos < W.offsets[node + 1]; pos++) {
+      int nbr = W.cols[pos];
+      double val = W.vals[pos];
+      total_vol += val;
       if (node == nbr) { continue; }
-      double val = it->Dat;
-      // Adjust the cut amount
-      if (rank[nbr] > ind) {
-        // nbr is on the other side: add to the cut
-        cut += val;
-      } else {
-        // now on the same side as nbr: subtract from the cut
-        cut -= val;
-      }
+      // nbr is on the other side: add to the cut, otherwise subtract from it
+      cut += (rank[nbr] > ind) ? val : -val;
       vol += val;
-      vol_comp -= val;
     }
+    cut_diff[ind] = cut;
+    vol_diff[ind] = vol;
+  }
 
+  // Sweep by adjusting cut and volume
+  conds = TFltV(order.Len() - 1);
+  double cut = 0;
+  double vol = 0;
+  double vol_comp = total_vol;
+  for (int ind = 0; ind < order.Len() - 1; ind++) {
+    cut += cut_diff[ind];
+    vol += vol_diff[ind];
+    vol_comp -= vol_diff[ind];
     double mvol = MIN(vol, vol_comp);
     if (mvol <= 0.0) {
       TExcept::Throw("Nonpositive set volume.");
@@ -870,56 +1424,30 @@ static void Sweep(const TSparseColMatrix& W, const TFltV& fvec, TFltV& conds,
 
 void MotifCluster::SpectralCut(const WeightVH& weights, TSweepCut& sweepcut,
 			       double tol, int maxiter) {
-  // Form graph and get maximum component
-  PUNGraph graph = UnweightedGraphRepresentation(weights);
-  TCnComV components;
-  TSnap::GetWccs(graph, components);
-  int max_wcc_size = 0;
-  int max_wcc_ind = -1;
-  for (int i = 0; i < components.Len(); i++) {
-    int size = components[i].Len();
-    if (size > max_wcc_size) {
-      max_wcc_size = size;
-      max_wcc_ind = i;
-    }
-  }
-  TCnCom comp = components[max_wcc_ind];
-  sweepcut.component = comp;
-  if (comp.Len() == 1) {
+  TWeightCsr csr;
+  WeightsToCsr(weights, csr);
+  SpectralCut(csr, sweepcut, tol, maxiter);
+}
+
+void MotifCluster::SpectralCut(const TWeightCsr& weights, TSweepCut& sweepcut,
+			       double tol, int maxiter) {
+  // Get maximum component
+  TIntV comp;
+  LargestComponent(weights, comp);
+  sweepcut.component = TCnCom(comp);
+  if (comp.Len() <= 1) {
     printf("WARNING: No non-trivial connected components "
 	   "(likely due to no instances of the motif)\n");
     sweepcut.cond = 0;
     sweepcut.eig = 0;
     return;
   }
-  
 
   // Map largest connected component to a matrix, keeping track of ids.
-  THash<TInt, TInt> id_map;
-  TIntV rev_id_map;
-  MapIdsToFirstN(comp.NIdV, id_map, rev_id_map);
-
-  TVec<TIntFltKdV> matrix_entries(comp.Len());
-  for (int ind1 = 0; ind1 < comp.Len(); ++ind1) {
-    int c_ind = comp[ind1];
-    const THash<TInt, TInt>& edge_list = weights[c_ind];
-    int i_ind = id_map(c_ind);
-    TIntFltKdV& col = matrix_entries[i_ind];
-    for (THash<TInt, TInt>::TIter it = edge_list.BegI(); it < edge_list.EndI();
-	 it++) {
-      int ind2 = it->Key;
-      int val = it->Dat;
-      if (comp.IsNIdIn(ind2)) {
-        int j_ind = id_map(ind2);
-        col.Add(TIntFltKd(j_ind, val));
-        // Add symmetric part
-        matrix_entries[j_ind].Add(TIntFltKd(i_ind, val));
-      }
-    }
-  }
+  TWeightCsr W;
+  ComponentMatrix(weights, comp, W);
 
   // Get Fiedler vector and run the sweep
-  TSparseColMatrix W(matrix_entries, comp.Len(), comp.Len());
   TFltV fvec;
   sweepcut.eig = NFiedlerVector(W, fvec, tol, maxiter);
 
@@ -947,13 +1475,20 @@ void MotifCluster::SpectralCut(const WeightVH& weights, TSweepCut& sweepcut,
     end = conds.Len() + 1;
   }
   for (int i = start; i < end; i++) {
-    cluster.Add(rev_id_map[order[i]]);    
+    cluster.Add(comp[order[i]]);
   }
   sweepcut.cluster = cluster;
 }
 
 void SymeigsSmallest(const TSparseColMatrix& A, int nev, TFltV& evals,
                      TFullColMatrix& evecs, double tol, int maxiter) {
+  ArpackSymeigsSmallest(A, nev, evals, evecs, tol, maxiter);
+}
+
+template <class TOperator>
+static void ArpackSymeigsSmallest(const TOperator& A, int nev, TFltV& evals,
+                                  TFullColMatrix& evecs, double tol,
+                                  int maxiter) {
   // type of problem
   int mode = 1;
   // communication variable
@@ -44,6 +44,18 @@ class TSweepCut {
   TCnCom component;     // connected component that the cut runs on
 };
 
+// Symmetric weighted matrix in compressed sparse row (CSR) format.  The
+// nonzeros of row i are stored at positions offsets[i], ..., offsets[i + 1] - 1
+// of cols and vals, with column indices in increasing order.  Unlike WeightVH,
+// both the lower and the upper triangular part of the matrix are stored.
+class TWeightCsr {
+ public:
+  int num_rows() const { return offsets.Len() - 1; }
+  TVec<TInt64> offsets;    // Row offsets (number of rows + 1 entries)
+  TVec<TInt, int64> cols;  // Column index of each nonzero
+  TVec<TFlt, int64> vals;  // Value of each nonzero
+};
+
 // Wrapper around ARPACK for computing the smallest algebraic eigenvalues of a
 // matrix A.  A is the matrix, nev is the number of eigenvectors to compute, tol
 // is the stopping tolerance, and maxiter is the maximum number of iterations.
@@ -72,6 +84,19 @@ class MotifCluster {
   // lower triangular part of the matrix).
   static void MotifAdjacency(PNGraph graph, MotifType motif, WeightVH& weights);
   static void MotifAdjacency(PUNGraph graph, MotifType motif, WeightVH& weights);
+
+  // Same as above, but stores the full symmetric motif adjacency matrix in CSR
+  // format, with one row per node id (0, ..., GetMxNId()).  For directed
+  // triangle motifs (M1-M7), wedges (M8-M13) and edges the matrix is built in
+  // parallel: motif instances are enumerated over a degree ordering and the
+  // weights are accumulated in thread-local buffers before being merged.
+  static void MotifAdjacency(PNGraph graph, MotifType motif,
+			     TWeightCsr& weights);
+  static void MotifAdjacency(PUNGraph graph, MotifType motif,
+			     TWeightCsr& weights);
+
+  // Converts the lower triangular weights into a full symmetric CSR matrix.
+  static void WeightsToCsr(const WeightVH& weights, TWeightCsr& csr);
   
   // Given a weighted network, compute a cut of the graph using the Fiedler
   // vector and a sweep cut.  Results are stored in the sweepcut data structure.
@@ -79,6 +104,8 @@ class MotifCluster {
   // number of iterations used by the eigensolver.
   static void SpectralCut(const WeightVH& weights, TSweepCut& sweepcut,
 			  double tol=kDefaultTol, int maxiter=kMaxIter);
+  static void SpectralCut(const TWeightCsr& weights, TSweepCut& sweepcut,
+			  double tol=kDefaultTol, int maxiter=kMaxIter);
 
   // Compute the normalized Fiedler vector for the normalized Laplacian of the
   // graph corresponding to the nonnegative matrix W and store the result in
@@ -87,6 +114,10 @@ class MotifCluster {
   // inverse square root of the node degrees.
   static double NFiedlerVector(const TSparseColMatrix& W, TFltV& fvec,
 			       double tol=kDefaultTol, int maxiter=kMaxIter);
+  // Same as above for a CSR matrix.  The matrix-vector products with the
+  // normalized Laplacian are computed in parallel.
+  static double NFiedlerVector(const TWeightCsr& W, TFltV& fvec,
+			       double tol=kDefaultTol, int maxiter=kMaxIter);
 
   // Given a string representation of a motif name, parse it to a MotifType.
   static MotifType ParseMotifType(const TStr& motif);
@@ -3,9 +3,15 @@
 
 void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV) {
-  //Preprocess transition probabilities
-  PreprocessTransitionProbs(InNet, ParamP, ParamQ, Verbose);
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem) {
+  //Preprocess transition probabilities, exact tables take O(sum of deg^2) memory
+  const bool Exact = PredictMemoryRequirements(InNet) <= MaxExactMem;
+  if (Exact) {
+    PreprocessTransitionProbs(InNet, ParamP, ParamQ, Verbose);
+  } else {
+    PreprocessRejectionProbs(InNet, Verbose);
+  }
   TIntV NIdsV;
   for (TWNet::TNodeI NI = InNet->BegNI(); NI < InNet->EndNI(); NI++) {
     NIdsV.Add(NI.GetId());
@@ -23,7 +29,11 @@ void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
         printf("\rWalking Progress: %.2lf%%",(double)WalksDone*100/(double)AllWalks);fflush(stdout);
       }
       TIntV WalkV;
-      SimulateWalk(InNet, NIdsV[j], WalkLen, Rnd, WalkV);
+      if (Exact) {
+        SimulateWalk(InNet, NIdsV[j], WalkLen, Rnd, WalkV);
+      } else {
+        SimulateWalkRejection(InNet, NIdsV[j], WalkLen, ParamP, ParamQ, Rnd, WalkV);
+      }
       for (int64 k = 0; k < WalkV.Len(); k++) { 
         WalksVV.PutXY(i*NIdsV.Len()+j, k, WalkV[k]);
       }
@@ -51,7 +61,8 @@ void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
 
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV) {
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem) {
   PWNet NewNet = PWNet::New();
   for (TNGraph::TEdgeI EI = InNet->BegEI(); EI < InNet->EndEI(); EI++) {
     if (!NewNet->IsNode(EI.GetSrcNId())) { NewNet->AddNode(EI.GetSrcNId()); }
@@ -59,7 +70,7 @@ void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
     NewNet->AddEdge(EI.GetSrcNId(), EI.GetDstNId(), 1.0);
   }
   node2vec(NewNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, OutputWalks, WalksVV, EmbeddingsHV);
+   Verbose, OutputWalks, WalksVV, EmbeddingsHV, MaxExactMem);
 }
 
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
@@ -73,7 +84,8 @@ void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
 
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ,
  int& Dimensions, int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV) {
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem) {
   PWNet NewNet = PWNet::New();
   for (TNEANet::TEdgeI EI = InNet->BegEI(); EI < InNet->EndEI(); EI++) {
     if (!NewNet->IsNode(EI.GetSrcNId())) { NewNet->AddNode(EI.GetSrcNId()); }
@@ -81,7 +93,7 @@ void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ,
     NewNet->AddEdge(EI.GetSrcNId(), EI.GetDstNId(), InNet->GetFltAttrDatE(EI,"weight"));
   }
   node2vec(NewNet, ParamP, ParamQ, Dimensions, WalkLen, NumWalks, WinSize, Iter, 
-   Verbose, OutputWalks, WalksVV, EmbeddingsHV);
+   Verbose, OutputWalks, WalksVV, EmbeddingsHV, MaxExactMem);
 }
 
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
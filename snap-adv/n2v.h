@@ -8,9 +8,13 @@
 #include "word2vec.h"
 
 /// Calculates node2vec feature representation for nodes and writes them into EmbeddinsHV, see http://arxiv.org/pdf/1607.00653v1.pdf
+/// Walks use second-order alias tables if PredictMemoryRequirements() is at most MaxExactMem bytes and rejection sampling otherwise.
+/// Rejection sampling bounds the draws per step: a step that rejects 32 draws (likely only for extreme q) is sampled exactly
+/// from the neighbors of the current node, so its cost is O(degree) instead of unbounded.
 void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV); 
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem = int64(1) << 30); 
 
 /// Version without walk output flag. For backward compatibility.
 void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
@@ -20,7 +24,8 @@ void node2vec(PWNet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
 /// Version for unweighted graphs
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV); 
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem = int64(1) << 30); 
 
 /// Version for unweighted graphs without walk output flag. For backward compatibility.
 void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
@@ -30,7 +35,8 @@ void node2vec(PNGraph& InNet, double& ParamP, double& ParamQ, int& Dimensions,
 /// Version for weighted graphs. Edges must have TFlt attribute "weight"
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
  int& WalkLen, int& NumWalks, int& WinSize, int& Iter, bool& Verbose,
- bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV); 
+ bool& OutputWalks, TVVec<TInt, int64>& WalksVV, TIntFltVH& EmbeddingsHV,
+ const int64& MaxExactMem = int64(1) << 30); 
 
 /// Version for weighted graphs. Edges must have TFlt attribute "weight". No walk output flag. For backward compatibility.
 void node2vec(PNEANet& InNet, double& ParamP, double& ParamQ, int& Dimensions,
@@ -6,33 +6,53 @@
 
 bool TLocClust::Verbose = true;
 
+// orders node indices by decreasing (degree normalized) PageRank, ties go to the smaller index
+class TLocClustProbCmp {
+private:
+  const TFltV& ProbV;
+public:
+  TLocClustProbCmp(const TFltV& _ProbV) : ProbV(_ProbV) { }
+  bool operator () (const int& NIdx1, const int& NIdx2) const {
+    return ProbV[NIdx2] < ProbV[NIdx1] || (ProbV[NIdx2] == ProbV[NIdx1] && NIdx1 < NIdx2); }
+};
+
+void TLocClust::Init() {
+  ProbV.Gen(Nodes);  ResV.Gen(Nodes);
+  RankV.Gen(Nodes);  RankV.PutAll(-1);
+  SeedNId = -1;  BestCutIdx = -1;
+}
+
 int TLocClust::ApproxPageRank(const int& SeedNode, const double& Eps) {
-  for (int i = 0; i < ProbH.Len(); i++) { ProbH[i]=0.0; }
-  for (int i = 0; i < ResH.Len(); i++) { ResH[i]=0.0; }
-  ProbH.Clr(false, -1, false);
-  ResH.Clr(false, -1, false);
-  ResH.AddDat(SeedNode, 1.0);
+  // only reset the entries touched by the previous walk
+  for (int i = 0; i < ProbIdxV.Len(); i++) { ProbV[ProbIdxV[i]]=0.0;  RankV[ProbIdxV[i]]=-1; }
+  for (int i = 0; i < ResIdxV.Len(); i++) { ResV[ResIdxV[i]]=0.0; }
+  ProbIdxV.Clr(false);
+  ResIdxV.Clr(false);
+  const TVec<TInt, int64>& NbrV = Csr->GetOutNbrV();
+  const int SeedIdx = Csr->GetNIdx(SeedNode);
+  ResV[SeedIdx] = 1.0;  ResIdxV.Add(SeedIdx);
   int iter = 0;
   double OldRes = 0.0;
   NodeQ.Clr(false);
-  NodeQ.Push(SeedNode);
+  NodeQ.Push(SeedIdx);
   TExeTm ExeTm;
   while (! NodeQ.Empty()) {
-    const int NId = NodeQ.Top(); NodeQ.Pop();
-    const TUNGraph::TNodeI& Node = Graph->GetNI(NId);
-    const int NIdDeg = Node.GetOutDeg();
-    const double PushVal = ResH.GetDat(NId) - 0.5*Eps*NIdDeg;
+    const int NIdx = NodeQ.Top(); NodeQ.Pop();
+    const int NIdDeg = Csr->GetOutDeg(NIdx);
+    const double PushVal = ResV[NIdx] - 0.5*Eps*NIdDeg;
     const double PutVal = (1.0-Alpha) * PushVal / double(NIdDeg);
-    ProbH.AddDat(NId) += Alpha*PushVal;
-    ResH.AddDat(NId) = 0.5 * Eps * NIdDeg;
-    for (int e = 0; e < NIdDeg; e++) {
-      const int DstNId = Node.GetOutNId(e);
-      const int DstDeg = Graph->GetNI(DstNId).GetOutDeg();
-      double& ResVal = ResH.AddDat(DstNId).Val;
+    if (RankV[NIdx] == -1) { RankV[NIdx] = ProbIdxV.Add(NIdx); }
+    ProbV[NIdx] += Alpha*PushVal;
+    ResV[NIdx] = 0.5 * Eps * NIdDeg;
+    for (int64 e = Csr->GetOutOff(NIdx); e < Csr->GetOutOff(NIdx+1); e++) {
+      const int DstIdx = NbrV[e];
+      const int DstDeg = Csr->GetOutDeg(DstIdx);
+      double& ResVal = ResV[DstIdx].Val;
+      if (ResVal == 0.0) { ResIdxV.Add(DstIdx); }
       OldRes = ResVal;
       ResVal += PutVal;
       if (ResVal >= Eps*DstDeg && OldRes < Eps*DstDeg) {
-        NodeQ.Push(DstNId); }
+        NodeQ.Push(DstIdx); }
     }
     iter++;
     if (iter % Mega(1) == 0) { 
@@ -43,28 +63,28 @@ int TLocClust::ApproxPageRank(const int& SeedNode, const double& Eps) {
     }
   }
   // check that the residuals are sufficiently small
-  /*for (int i =0; i < ProbH.Len(); i++) {
-    const int Deg = Graph->GetNI(ResH.GetKey(i)).GetOutDeg();
-    IAssert(ResH[i] < Eps*Deg); } //*/
+  /*for (int i =0; i < ResIdxV.Len(); i++) {
+    const int Deg = Csr->GetOutDeg(ResIdxV[i]);
+    IAssert(ResV[ResIdxV[i]] < Eps*Deg); } //*/
   return iter;
 }
 
 void TLocClust::SupportSweep() {
   TExeTm ExeTm;
   VolV.Clr(false);  CutV.Clr(false);  PhiV.Clr(false);
-  if (ProbH.Empty()) { return; }
-  const int TopNId = ProbH.GetKey(0);
-  const int TopNIdDeg = Graph->GetNI(TopNId).GetOutDeg();
+  if (ProbIdxV.Empty()) { return; }
+  for (int i = 0; i < ProbIdxV.Len(); i++) { RankV[ProbIdxV[i]] = i; }
+  const TVec<TInt, int64>& NbrV = Csr->GetOutNbrV();
+  const int TopNIdDeg = Csr->GetOutDeg(ProbIdxV[0]);
   int Vol = TopNIdDeg, Cut = TopNIdDeg;
   double Phi = Cut/double(Vol);
   VolV.Add(Vol);  CutV.Add(Cut);  PhiV.Add(1.0);
-  for (int i = 1; i < ProbH.Len(); i++) {
-    const int NId = ProbH.GetKey(i);
-    const TUNGraph::TNodeI& Node = Graph->GetNI(NId);
-    const int OutDeg = Node.GetOutDeg();
+  for (int i = 1; i < ProbIdxV.Len(); i++) {
+    const int NIdx = ProbIdxV[i];
+    const int OutDeg = Csr->GetOutDeg(NIdx);
     int CutSz = OutDeg; // edges outside
-    for (int e = 0; e < OutDeg; e++) {
-      const int Rank = ProbH.GetKeyId(Node.GetOutNId(e));
+    for (int64 e = Csr->GetOutOff(NIdx); e < Csr->GetOutOff(NIdx+1); e++) {
+      const int Rank = RankV[NbrV[e]];
       if ( Rank > -1 && Rank < i) { CutSz -= 2;  }
     }
     Vol += OutDeg;  Cut += CutSz;
@@ -76,7 +96,8 @@ void TLocClust::SupportSweep() {
     }
     IAssert((Phi+1e-6) >= double(1.0)/double(i*(i+1)+1)); // conductance is worse than the best possible
     VolV.Add(Vol);  CutV.Add(Cut);  PhiV.Add(Phi);
-  }}
+  }
+}
 
 void TLocClust::FindBestCut(const int& SeedNode, const int& ClustSz, const double& MinSizeFrac) {
   double MaxPhi = TFlt::Mx;
@@ -84,15 +105,15 @@ void TLocClust::FindBestCut(const int& SeedNode, const int& ClustSz, const doubl
   SeedNId = SeedNode;
   // calculate pagerank and cut sets
   ApproxPageRank(SeedNId, 1.0/double(ClustSz));
-  for (int i = 0; i < ProbH.Len(); i++) {
-    ProbH[i] /= Graph->GetNI(ProbH.GetKey(i)).GetOutDeg(); }
-  ProbH.SortByDat(false);
+  for (int i = 0; i < ProbIdxV.Len(); i++) {
+    ProbV[ProbIdxV[i]] /= Csr->GetOutDeg(ProbIdxV[i]); }
+  TSnap::SortCmpMP(ProbIdxV.BegI(), ProbIdxV.EndI(), TLocClustProbCmp(ProbV));
   SupportSweep();
   // find best cut
   NIdV.Clr(false);
   for (int i = 0; i < PhiV.Len(); i++) {
     const double Phi = PhiV[i];
-    NIdV.Add(ProbH.GetKey(i));
+    NIdV.Add(Csr->GetNId(ProbIdxV[i]));
     if (Phi < MaxPhi) { MaxPhi = Phi;  BestCutIdx = i; }
   }
 }
@@ -274,7 +295,7 @@ double TLocClustStat::TCutInfo::GetFracDegOut(const PUNGraph& Graph, double& MxF
 
 TLocClustStat::TLocClustStat(const double& _Alpha, const int& _KMin, const int& _KMax, const double& _KFac,
   const int& _Coverage, const double& _SizeFrac) : Alpha(_Alpha), SizeFrac(_SizeFrac), KFac(_KFac),
-  KMin(_KMin), KMax(_KMax), Coverage(_Coverage) {
+  KMin(_KMin), KMax(_KMax), Coverage(_Coverage), MxSecs(-1) {
 }
 
 void TLocClustStat::Save(TSOut& SOut) const {
@@ -297,6 +318,38 @@ void TLocClustStat::Clr() {
   BagOfWhiskerV.Clr(false); // (Size, Conductance) of bag of whiskers clusters
 }
 
+static int GetNcpThreadN() {
+#ifdef USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+static int GetNcpThreads() {
+#ifdef USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+// cut statistics a thread collects over its runs at one cluster size K of TLocClustStat::Run(),
+// every cut remembers its run so that ties can be broken the way a sequential pass over the runs would
+class TLocClustRunStat {
+public:
+  double MeanSz, MeanVol, Count;
+  double BestPhi;  int BestRun;             // best over-all cut of the thread
+  TLocClustStat::TCutInfo BestCut;
+  THash<TInt, TLocClustStat::TCutInfo> BestCutH;  // best cut at each size
+  TIntIntH BestRunH;                        // run of the best cut at each size
+  THash<TInt, TFltV> SizePhiH;
+public:
+  TLocClustRunStat() : MeanSz(0), MeanVol(0), Count(0), BestPhi(TFlt::Mx), BestRun(-1) { }
+  void Clr() { MeanSz=0;  MeanVol=0;  Count=0;  BestPhi=TFlt::Mx;  BestRun=-1;
+    BestCutH.Clr(false);  BestRunH.Clr(false);  SizePhiH.Clr(false); }
+};
+
 void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const bool& SaveAllCond, const bool& SaveBestNodesAtK) {
   Graph = TSnap::GetMxWcc(_Graph);
   const int Nodes = Graph->GetNodes();
@@ -305,15 +358,24 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
   printf("  Alpha:    %g\n", Alpha());
   printf("  K: %d -- %g -- %dm\n", KMin(), KFac(), int(KMax/Mega(1)));
   printf("  Coverage: %d\n", Coverage());
-  printf("  SizeFrac: %g\n\n", SizeFrac());
+  printf("  SizeFrac: %g\n", SizeFrac());
+  if (MxSecs > 0) { printf("  Time limit: %gs\n", MxSecs()); }
+  printf("\n");
   TExeTm TotTm;
+  const time_t StartTm = time(NULL); // wall clock for the time limit (TExeTm measures the CPU time of all threads)
   Clr();
-  TLocClust Clust(Graph, Alpha);
+  // one local clustering per thread, all share the same CSR snapshot of the graph
+  const int Threads = GetNcpThreads();
+  const PCsrGraph Csr = TCsrGraph::New(Graph);
+  TVec<TLocClust> ClustV(Threads);
+  TVec<TLocClustRunStat> RunStatV(Threads);
+  for (int t = 0; t < Threads; t++) {
+    ClustV[t] = TLocClust(Graph, Csr, Alpha); }
   BestCut.CutNIdV.Clr(false); 
   BestCut.CutSz=-1;  BestCut.Edges=-1;
   double BestPhi = TFlt::Mx;
   int prevK=-1;
-  bool NextDone=false;
+  bool NextDone=false, TimeUp=false;
   if (SaveBestNodesAtK) { // fill buckets (only store nodes in clusters for sizes in SizeBucketSet)
     SizeBucketSet.Clr();
     double PrevBPos = 1, BPos = 1;
@@ -324,6 +386,10 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
       SizeBucketSet.AddKey(int(floor(BPos) - 1));
     }
   }
+  // the seeds come from their own generator, so runs do not depend on the thread schedule
+  TRnd SeedRnd(TInt::Rnd.GetUniDevInt(TInt::Mx-1)+1);
+  TIntV SeedV;
+  TVec<TNodeSweep> RunSweepV;
   for (int K = KMin, cnt=1; K < KMax; K = int(KFac * double(K))+1, cnt++) {
     if (K == prevK) { K++; } prevK = K;
     const int Runs = 2 + int(Coverage /**pow(1.1, cnt)*/ * floor(double(Graph->GetEdges()) / double(K)));
@@ -331,18 +397,26 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
     if (NextDone) { break; } // done
     if (K+1 > 2*Graph->GetEdges()) { K = Graph->GetEdges(); NextDone=true; }
     //if (K+1 > Graph->GetEdges()) { K = Graph->GetEdges(); NextDone=true; }
-    TExeTm ExeTm, IterTm;
-    double MeanSz=0.0, MeanVol=0.0, Count=0.0;
+    TExeTm ExeTm;
+    SeedV.Gen(Runs, 0);
     for (int run = 0; run < Runs; run++) {
-      const int SeedNId = Graph->GetRndNId();  IterTm.Tick();
+      SeedV.Add(Graph->GetRndNId(SeedRnd)); }
+    if (SaveAllSweeps) { RunSweepV.Gen(Runs); }
+    for (int t = 0; t < Threads; t++) { RunStatV[t].Clr(); }
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int run = 0; run < Runs; run++) {
+      if (MxSecs > 0 && difftime(time(NULL), StartTm) > MxSecs) { TimeUp = true;  continue; }
+      TLocClust& Clust = ClustV[GetNcpThreadN()];
+      TLocClustRunStat& Stat = RunStatV[GetNcpThreadN()];
+      const int SeedNId = SeedV[run];
       Clust.FindBestCut(SeedNId, K, SizeFrac);
       const int Sz = Clust.BestCutNodes();
       const int Vol = Clust.GetCutVol();
       const double Phi = TMath::Round(Clust.GetCutPhi(), 4);
       if (Sz == 0 || Vol == 0 || Phi == 0) { continue; }
-      MeanSz+=Sz;  MeanVol+=Vol;  Count+= 1;
+      Stat.MeanSz+=Sz;  Stat.MeanVol+=Vol;  Stat.Count+= 1;
       if (SaveAllSweeps) { // save the full cut set and conductances for all trials
-        SweepsV.Add(TNodeSweep(SeedNId, Clust.GetNIdV(), Clust.GetPhiV())); }
+        RunSweepV[run] = TNodeSweep(SeedNId, Clust.GetNIdV(), Clust.GetPhiV()); }
       int SAtBestPhi=-1;
       for (int s = 0; s < Clust.Len(); s++) {
         const int size = s+1;
@@ -353,45 +427,78 @@ void TLocClustStat::Run(const PUNGraph& _Graph, const bool& SaveAllSweeps, const
         IAssert((Clust.GetVol(s) - cut) % 2 == 0);
         IAssert(phi == double(cut)/double(2*edges+cut));
         IAssert(phi >= 1.0/double((1+s)*s+1));
-        //// If we want to take pieces that minimize some other community goodness measure
-        // TCutInfo CutInfo(size, edges, cut); Clust.GetNIdV().GetSubValV(0, size-1, CutInfo.CutNIdV);
-        //double MxFrac=0, AvgFrac=0, MedianFrac=0, Pct9Frac=0, Flake=0;
-        //CutInfo.GetFracDegOut(Graph, MxFrac, AvgFrac, MedianFrac, Pct9Frac, Flake);
-        //const double phi = MxFrac;
-        if (BestPhi >= phi) {
-          BestPhi = phi;
-          BestCut = TCutInfo(size, edges, cut);
+        if (Stat.BestPhi >= phi) {
+          Stat.BestPhi = phi;
+          Stat.BestCut = TCutInfo(size, edges, cut);
+          Stat.BestRun = run;
           SAtBestPhi = s;
         }
-        //// If we want to take pieces that minimize some other community goodness measure
-        //bool TAKE=false;  if (! BestCutH.IsKey(size)) { TAKE=true; }
-        //else { BestCutH.GetDat(size).GetFracDegOut(Graph, MxFrac, AvgFrac, MedianFrac, Pct9Frac, Flake);  if (MxFrac >= phi) { TAKE = true; } }
-        // if (TAKE) {
-        if (! BestCutH.IsKey(size) || BestCutH.GetDat(size).GetPhi() >= phi) { //new best cut (size, edges inside and nodes)
-          BestCutH.AddDat(size, TCutInfo(size, edges, cut));  // for every size store best cut (NIds inside the cut)
+        if (! Stat.BestCutH.IsKey(size) || Stat.BestCutH.GetDat(size).GetPhi() >= phi) { //new best cut (size, edges inside and nodes)
+          Stat.BestCutH.AddDat(size, TCutInfo(size, edges, cut));  // for every size store best cut (NIds inside the cut)
+          Stat.BestRunH.AddDat(size, run);
           if (SaveBestNodesAtK) { // store node ids in best community for each size k
             if (! SizeBucketSet.Empty() && ! SizeBucketSet.IsKey(size)) { continue; } // only save best clusters at SizeBucketSet
-            Clust.GetNIdV().GetSubValV(0, size-1, BestCutH.GetDat(size).CutNIdV); }
+            Clust.GetNIdV().GetSubValV(0, size-1, Stat.BestCutH.GetDat(size).CutNIdV); }
         }
         if (SaveAllCond) { // for every size store all conductances
-          SizePhiH.AddDat(size).Add(phi); }
+          Stat.SizePhiH.AddDat(size).Add(phi); }
       }
       if (SAtBestPhi != -1) { // take nodes in best cluster
         const int size = SAtBestPhi+1;
-        Clust.GetNIdV().GetSubValV(0, size-1, BestCut.CutNIdV); 
+        Clust.GetNIdV().GetSubValV(0, size-1, Stat.BestCut.CutNIdV); 
       }
-      if (TLocClust::Verbose) {
+      if (TLocClust::Verbose && GetNcpThreadN() == 0) { // only the master thread reports progress
         printf(".");
         if (run % 50 == 0) {
           printf("\r                                                   %d / %d \r", run, Runs); }
       }
     }
+    // merge the thread statistics, among cuts of equal conductance the one of the later run wins
+    double MeanSz=0.0, MeanVol=0.0, Count=0.0;
+    THash<TInt, TIntPr> SizeBestH; // size --> (thread, run) of the best cut at the size
+    int BestThread=-1;
+    for (int t = 0; t < Threads; t++) {
+      const TLocClustRunStat& Stat = RunStatV[t];
+      MeanSz+=Stat.MeanSz;  MeanVol+=Stat.MeanVol;  Count+=Stat.Count;
+      if (Stat.BestRun != -1 && (BestThread == -1 || Stat.BestPhi < RunStatV[BestThread].BestPhi ||
+       (Stat.BestPhi == RunStatV[BestThread].BestPhi && Stat.BestRun > RunStatV[BestThread].BestRun))) {
+        BestThread = t; }
+      for (int c = 0; c < Stat.BestCutH.Len(); c++) {
+        const int size = Stat.BestCutH.GetKey(c);
+        const double phi = Stat.BestCutH[c].GetPhi();
+        const int run = Stat.BestRunH.GetDat(size);
+        const int KeyId = SizeBestH.GetKeyId(size);
+        if (KeyId == -1) { SizeBestH.AddDat(size, TIntPr(t, run)); continue; }
+        const TIntPr& ThreadRun = SizeBestH[KeyId];
+        const double BestSizePhi = RunStatV[ThreadRun.Val1].BestCutH.GetDat(size).GetPhi();
+        if (phi < BestSizePhi || (phi == BestSizePhi && run > ThreadRun.Val2)) {
+          SizeBestH[KeyId] = TIntPr(t, run); }
+      }
+      for (int c = 0; c < Stat.SizePhiH.Len(); c++) {
+        SizePhiH.AddDat(Stat.SizePhiH.GetKey(c)).AddV(Stat.SizePhiH[c]); }
+    }
+    if (BestThread != -1 && BestPhi >= RunStatV[BestThread].BestPhi) {
+      BestPhi = RunStatV[BestThread].BestPhi;
+      BestCut = RunStatV[BestThread].BestCut;
+    }
+    for (int c = 0; c < SizeBestH.Len(); c++) {
+      const int size = SizeBestH.GetKey(c);
+      const TCutInfo& Cut = RunStatV[SizeBestH[c].Val1].BestCutH.GetDat(size);
+      if (! BestCutH.IsKey(size) || BestCutH.GetDat(size).GetPhi() >= Cut.GetPhi()) {
+        BestCutH.AddDat(size, Cut); }
+    }
+    if (SaveAllSweeps) {
+      for (int run = 0; run < Runs; run++) {
+        if (RunSweepV[run].Len() > 0) { SweepsV.Add(RunSweepV[run]); } }
+    }
     if (TLocClust::Verbose) {
       printf("\r  %d / %d: %s                                                   \n", Runs, Runs, ExeTm.GetStr()); 
     }
     MeanSz/=Count;  MeanVol/=Count;
     printf("  Graph(%d, %d)  ", Nodes, Edges);
     printf("       mean:  sz: %.2f  vol: %.2f [%s] %s\n", MeanSz, MeanVol, ExeTm.GetStr(), TExeTm::GetCurTm());
+    if (! IncOutFNm.Empty()) { SaveTxtNcp(IncOutFNm); }
+    if (TimeUp) { printf("Time limit of %gs reached.\n", MxSecs()); break; }
   }
   SizePhiH.SortByKey();
   for (int k = 0; k < SizePhiH.Len(); k++) { 
@@ -896,6 +1003,18 @@ void TLocClustStat::SaveTxtInfo(const TStr& OutFNmPref, const TStr& Desc, const
   GP.SavePng();
 }
 
+void TLocClustStat::SaveTxtNcp(const TStr& OutFNm) const {
+  TIntV SizeV;  BestCutH.GetKeyV(SizeV);  SizeV.Sort();
+  FILE *F = fopen(OutFNm.CStr(), "wt");
+  fprintf(F, "# %s\n", ParamStr().CStr());
+  fprintf(F, "#Size\tN_inside\tE_inside\tE_across\tConductance\n");
+  for (int i = 0; i < SizeV.Len(); i++) {
+    const TCutInfo& C = BestCutH.GetDat(SizeV[i]);
+    fprintf(F, "%d\t%d\t%d\t%d\t%g\n", SizeV[i](), C.GetNodes(), C.GetEdges(), C.GetCutSz(), C.GetPhi());
+  }
+  fclose(F);
+}
+
 // conductances if clusters are composed of disjoint pieces that can be separated
 // from the graph by a single edge
 void TLocClustStat::BagOfWhiskers(const PUNGraph& Graph, TFltPrV& SizePhiV, TFltPr& MaxWhisk) {
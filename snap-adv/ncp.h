@@ -14,8 +14,11 @@ public:
   static bool Verbose;
 private:
   PUNGraph Graph;
+  PCsrGraph Csr;           // CSR snapshot of Graph, the random walk works on its node indices
   int Nodes, Edges2;       // Nodes, 2*edges in Graph
-  TIntFltH ProbH, ResH;
+  TFltV ProbV, ResV;       // PageRank and residual of each node index (zero for nodes the walk did not touch)
+  TIntV ProbIdxV, ResIdxV; // node indices with non-zero PageRank (in the sweep order after FindBestCut()) and residual
+  TIntV RankV;             // position of a node index in ProbIdxV, -1 for nodes the walk did not touch
   TIntQ NodeQ;
   double Alpha;            // PageRank jump probability (smaller Alpha diffuses the mass farther away)
   int SeedNId;             // Seed node
@@ -23,9 +26,15 @@ private:
   TIntV NIdV, VolV, CutV;  // Vol=2*edges_inside+cut (vol = sum of the degrees)
   TFltV PhiV;              // Conductance
   int BestCutIdx;          // Index K to vectors where the conductance of the bounding cut (PhiV[K]) achieves its minimum
+private:
+  void Init();             // allocates the per-node vectors of the random walk
 public:
+  TLocClust() : Nodes(0), Edges2(0), Alpha(0), SeedNId(-1), BestCutIdx(-1) { }
   TLocClust(const PUNGraph& GraphPt, const double& AlphaVal) :
-    Graph(GraphPt), Nodes(GraphPt->GetNodes()), Edges2(2*GraphPt->GetEdges()), Alpha(AlphaVal) { }
+    Graph(GraphPt), Csr(TCsrGraph::New(GraphPt)), Nodes(GraphPt->GetNodes()), Edges2(2*GraphPt->GetEdges()), Alpha(AlphaVal) { Init(); }
+  /// Shares the CSR snapshot CsrPt of GraphPt, so that many clusterings (one per thread) can run over the same graph.
+  TLocClust(const PUNGraph& GraphPt, const PCsrGraph& CsrPt, const double& AlphaVal) :
+    Graph(GraphPt), Csr(CsrPt), Nodes(GraphPt->GetNodes()), Edges2(2*GraphPt->GetEdges()), Alpha(AlphaVal) { IAssert(Csr->GetNodes()==Nodes); Init(); }
   /// Returns the support of the approximate random walk, the number of nodes with non-zero PageRank score.   
   int Len() const { return GetRndWalkSup(); }
   /// Returns the support of the approximate random walk, the number of nodes with non-zero PageRank score.
@@ -148,6 +157,8 @@ private:
   TFlt Alpha, SizeFrac, KFac;
   TInt KMin, KMax, Coverage;
   PUNGraph Graph; // set at ::Run()
+  TFlt MxSecs;     // time budget of ::Run() in seconds (-1 for no limit)
+  TStr IncOutFNm;  // file the NCP is rewritten to after every cluster size K of ::Run()
 //private:
 public:
   TVec<TNodeSweep> SweepsV;       // node ids and conductances for each run of local clustering
@@ -162,6 +173,8 @@ public:
   void Save(TSOut& SOut) const;
   void Clr();
   void SetGraph(const PUNGraph& GraphPt) { Graph=GraphPt; }
+  void SetTimeLimit(const double& Secs) { MxSecs = Secs; } // Run() stops starting new local clusterings after Secs seconds
+  void SetIncOut(const TStr& OutFNm) { IncOutFNm = OutFNm; } // Run() saves the NCP to OutFNm after every cluster size (SaveTxtNcp())
   void Run(const PUNGraph& Graph, const bool& SaveAllSweeps=false, const bool& SaveAllCond=false, const bool& SaveBestNodesAtK=false);
   void AddBagOfWhiskers();
   void AddCut(const TIntV& NIdV);
@@ -199,6 +212,7 @@ public:
   void ImposeNCP(const TLocClustStat& LcStat2, TStr OutFNm, TStr Desc, TStr Desc1, TStr Desc2) const;
   void ImposeNCP(const TLocClustStat& LcStat2, const TLocClustStat& LcStat3, TStr OutFNm, TStr Desc, TStr Desc1, TStr Desc2, TStr Desc3) const;
   void SaveTxtInfo(const TStr& OutFNmPref, const TStr& Desc, const bool& SetMaxAt1) const;
+  void SaveTxtNcp(const TStr& OutFNm) const; // (size, nodes, edges inside, cut size, conductance) of the best cut at each size
 
   static void BagOfWhiskers(const PUNGraph& Graph, TFltPrV& SizePhiV, TFltPr& BestWhisk);
   static void BagOfWhiskers2(const PUNGraph& Graph, TFltPrV& SizePhiV);
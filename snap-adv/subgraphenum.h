@@ -57,6 +57,32 @@ private:
 		inline const TIntV &getVec() const { return m_v; }
 		inline int operator[](int i) const { return m_arr[i]; }
 	};
+	// Per-thread state of the parallel enumeration. Nodes are CSR node indices, the subgraph
+	// extension of every subgraph size is a vector and exclusive neighbors are found with
+	// counts of subgraph nodes that every node is in or adjacent to.
+	class TSThread {
+	protected:
+		const PNGraph &m_graph;
+		const TVec<TInt64> &m_nbrOffV;
+		const TVec<TInt,int64> &m_nbrV;
+		const TIntV &m_nIdV;
+		int m_subGraphSz;
+		TGraphCounter &m_functor;
+		int m_root;
+		TIntV m_sg;
+		TIntV m_cntV;
+		TVec<TIntV> m_extV;
+	protected:
+		void AddNode(int nIdx, TIntV &newExt);
+		void DelNode(int nIdx);
+		void Extend(int sgSz);
+	public:
+		TSThread(const PNGraph &graph, const TVec<TInt64> &nbrOffV, const TVec<TInt,int64> &nbrV,
+		 const TIntV &nIdV, int subGraphSz, TGraphCounter &functor) : m_graph(graph), m_nbrOffV(nbrOffV),
+		 m_nbrV(nbrV), m_nIdV(nIdV), m_subGraphSz(subGraphSz), m_functor(functor), m_root(-1),
+		 m_sg(subGraphSz), m_cntV(nIdV.Len()), m_extV(subGraphSz+1) { }
+		void GetSubGraphs(int vIdx);
+	};
 private:
 	PNGraph m_graph;
 	int m_nodes;
@@ -70,10 +96,16 @@ public:
 	//Graph must be normalized (vertex ids are 0,1,2,...)
 	void GetSubGraphs(PNGraph &Graph, int SubGraphSz, TGraphCounter& Counter);
 	void GetSubGraphs(PNGraph &Graph, int NId, int SubGraphSz, TGraphCounter& Counter);
+	//Parallel enumeration, subgraphs rooted at different nodes are enumerated by different threads.
+	//Every thread counts into its own copy of Counter, which are added to Counter at the end.
+	//Node ids do not have to be normalized.
+	void GetSubGraphsMP(const PNGraph &Graph, int SubGraphSz, TGraphCounter& Counter);
 };
 // TGraphCounter must implement 
 // void operator()(const PNGraph &G, const TIntV &SubGraphNIdV);
-// which gets called whenever a new subgraph on nodes in SubGraphNIdV is identified
+// which gets called whenever a new subgraph on nodes in SubGraphNIdV is identified.
+// For GetSubGraphsMP TGraphCounter must also be copyable and implement
+// void ClrCnt(); and void AddCnt(const TGraphCounter &Counter);
 
 /////////////////////////////////////////////////
 // TSubGraphEnum implementation
@@ -195,4 +227,94 @@ void TSubGraphEnum<TGraphCounter>::GetSubGraphs(PNGraph &Graph, int NId, int Sub
 }
 
 
+template <class TGraphCounter>
+void TSubGraphEnum<TGraphCounter>::TSThread::AddNode(int nIdx, TIntV &newExt) {
+	m_cntV[nIdx]++;
+	for(int64 e=m_nbrOffV[nIdx]; e<m_nbrOffV[nIdx+1]; e++) {
+		const int nbrIdx = m_nbrV[e];
+		if(m_cntV[nbrIdx]==0 && nbrIdx > m_root) newExt.Add(nbrIdx);
+		m_cntV[nbrIdx]++;
+	}
+}
+
+template <class TGraphCounter>
+void TSubGraphEnum<TGraphCounter>::TSThread::DelNode(int nIdx) {
+	m_cntV[nIdx]--;
+	for(int64 e=m_nbrOffV[nIdx]; e<m_nbrOffV[nIdx+1]; e++) m_cntV[m_nbrV[e]]--;
+}
+
+template <class TGraphCounter>
+void TSubGraphEnum<TGraphCounter>::TSThread::Extend(int sgSz) {
+	TIntV &ext = m_extV[sgSz];
+	while(!ext.Empty()) {
+		const int wIdx = ext.Last();
+		ext.DelLast();
+		m_sg[sgSz] = m_nIdV[wIdx];
+		if(sgSz+1 == m_subGraphSz) { m_functor(m_graph, m_sg); continue; }
+		//
+		TIntV &newExt = m_extV[sgSz+1];
+		newExt.Clr(false);
+		newExt.AddV(ext);
+		AddNode(wIdx, newExt);
+		Extend(sgSz+1);
+		DelNode(wIdx);
+	}
+}
+
+template <class TGraphCounter>
+void TSubGraphEnum<TGraphCounter>::TSThread::GetSubGraphs(int vIdx) {
+	m_root = vIdx;
+	m_sg[0] = m_nIdV[vIdx];
+	if(m_subGraphSz == 1) { m_functor(m_graph, m_sg); return; }
+	m_extV[1].Clr(false);
+	AddNode(vIdx, m_extV[1]);
+	Extend(1);
+	DelNode(vIdx);
+}
+
+template <class TGraphCounter>
+void TSubGraphEnum<TGraphCounter>::GetSubGraphsMP(const PNGraph &Graph, int SubGraphSz, TGraphCounter &Counter) {
+	IAssert(SubGraphSz > 0);
+	//Merged in- and out-neighbors of every node, without self-loops
+	const TCsrGraph csrG(Graph);
+	const int nodes = csrG.GetNodes();
+	TVec<TInt64> nbrOffV(nodes+1);
+	TVec<TInt,int64> nbrV(2*csrG.GetArcs(), 0);
+	for(int n=0; n<nodes; n++) {
+		int i=0, j=0;
+		while(i < csrG.GetOutDeg(n) || j < csrG.GetInDeg(n)) {
+			int nbr;
+			if(j == csrG.GetInDeg(n) || (i < csrG.GetOutDeg(n) && csrG.GetOutNbr(n, i) < csrG.GetInNbr(n, j))) nbr = csrG.GetOutNbr(n, i++);
+			else nbr = csrG.GetInNbr(n, j++);
+			if(nbr != n && (nbrV.Len() == nbrOffV[n] || nbrV.Last() != nbr)) nbrV.Add(nbr);
+		}
+		nbrOffV[n+1] = nbrV.Len();
+	}
+	//
+	int threads = 1;
+#ifdef USE_OPENMP
+	threads = omp_get_max_threads();
+#endif
+	TVec<TGraphCounter*> counterV(threads);
+	TVec<TSThread*> threadV(threads);
+	for(int t=0; t<threads; t++) {
+		if(t == 0) counterV[t] = &Counter;
+		else { counterV[t] = new TGraphCounter(Counter); counterV[t]->ClrCnt(); }
+		threadV[t] = new TSThread(Graph, nbrOffV, nbrV, csrG.GetNIdV(), SubGraphSz, *counterV[t]);
+	}
+	#pragma omp parallel for schedule(dynamic,1)
+	for(int vIdx=0; vIdx<nodes; vIdx++) {
+#ifdef USE_OPENMP
+		const int t = omp_get_thread_num();
+#else
+		const int t = 0;
+#endif
+		threadV[t]->GetSubGraphs(vIdx);
+	}
+	for(int t=0; t<threads; t++) {
+		delete threadV[t];
+		if(t > 0) { Counter.AddCnt(*counterV[t]);  delete counterV[t]; }
+	}
+}
+
 #endif
@@ -29,6 +29,15 @@ TempMotifCounter::TempMotifCounter(const TStr& filename) {
     int tim = data_ptr->GetIntValAtRowIdx(tim_idx, row_idx).Val;
     temporal_data_[src](dst).Add(tim);
   }
+  // Sort the timestamps of every static edge once, so that counting only
+  // needs to merge them.
+  #pragma omp parallel for schedule(dynamic)
+  for (int src = 0; src < temporal_data_.Len(); src++) {
+    for (int i = 0; i < temporal_data_[src].Len(); i++) {
+      TIntV& timestamps = temporal_data_[src][i];
+      TSnap::SortMP(timestamps);
+    }
+  }
 }
 
 void TempMotifCounter::GetAllNodes(TIntV& nodes) {
@@ -43,6 +52,37 @@ bool TempMotifCounter::HasEdges(int u, int v) {
   return temporal_data_[u].IsKey(v);
 }
 
+void TempMotifCounter::MergeSortedRuns(TVec<TIntPair>& combined,
+                                       TIntV& run_starts) {
+  // Drop empty runs
+  int runs = 0;
+  for (int r = 0; r < run_starts.Len(); r++) {
+    int end = (r + 1 < run_starts.Len()) ? run_starts[r + 1].Val : combined.Len();
+    if (run_starts[r] < end) { run_starts[runs++] = run_starts[r]; }
+  }
+  run_starts.Trunc(runs);
+  TVec<TIntPair> merged(combined.Len());
+  // Merge pairs of adjacent runs until a single run is left
+  while (run_starts.Len() > 1) {
+    TIntV merged_starts;
+    for (int r = 0; r < run_starts.Len(); r += 2) {
+      int beg1 = run_starts[r];
+      int end1 = (r + 1 < run_starts.Len()) ? run_starts[r + 1].Val : combined.Len();
+      int end2 = (r + 2 < run_starts.Len()) ? run_starts[r + 2].Val : combined.Len();
+      merged_starts.Add(beg1);
+      int i = beg1, j = end1, k = beg1;
+      while (i < end1 && j < end2) {
+        if (combined[j] < combined[i]) { merged[k++] = combined[j++]; }
+        else { merged[k++] = combined[i++]; }
+      }
+      while (i < end1) { merged[k++] = combined[i++]; }
+      while (j < end2) { merged[k++] = combined[j++]; }
+    }
+    combined.Swap(merged);
+    run_starts = merged_starts;
+  }
+}
+
 void TempMotifCounter::GetAllNeighbors(int node, TIntV& nbrs) {
   nbrs = TIntV();
   TNGraph::TNodeI NI = static_graph_->GetNI(node);
@@ -78,38 +118,51 @@ void TempMotifCounter::GetAllStaticTriangles(TIntV& Us, TIntV& Vs, TIntV& Ws) {
   for (int i = 0; i < order.Len(); i++) {
     order[degrees[i].Dat] = i;
   }
-
-  // Get triangles centered at a given node where that node is the smallest in
-  // the degree ordering.
-  #pragma omp parallel for schedule(dynamic)  
+  // Neighbors of every node that come later in the ordering
+  TVec<TIntV> higher_nbrs(max_nodes);
+  #pragma omp parallel for schedule(dynamic)
   for (int node_id = 0; node_id < nodes.Len(); node_id++) {
     int src = nodes[node_id];
-    int src_pos = order[src];
-    
-    // Get all neighbors who come later in the ordering
     TIntV nbrs;
-    GetAllNeighbors(src, nbrs);    
-    TIntV neighbors_higher;
+    GetAllNeighbors(src, nbrs);
     for (int i = 0; i < nbrs.Len(); i++) {
-      int nbr = nbrs[i];
-      if (order[nbr] > src_pos) { neighbors_higher.Add(nbr); }
+      if (order[nbrs[i]] > order[src]) { higher_nbrs[src].Add(nbrs[i]); }
     }
+  }
 
-    for (int ind1 = 0; ind1 < neighbors_higher.Len(); ind1++) {
-      for (int ind2 = ind1 + 1; ind2 < neighbors_higher.Len(); ind2++) {
+  // Get triangles centered at a given node where that node is the smallest in
+  // the degree ordering.  Later neighbors of src are marked with src + 1.
+  #pragma omp parallel
+  {
+    TIntV local_us, local_vs, local_ws;
+    TIntV marks(max_nodes);
+    #pragma omp for schedule(dynamic)
+    for (int node_id = 0; node_id < nodes.Len(); node_id++) {
+      int src = nodes[node_id];
+      const TIntV& neighbors_higher = higher_nbrs[src];
+      for (int i = 0; i < neighbors_higher.Len(); i++) {
+        marks[neighbors_higher[i]] = src + 1;
+      }
+      for (int ind1 = 0; ind1 < neighbors_higher.Len(); ind1++) {
         int dst1 = neighbors_higher[ind1];
-        int dst2 = neighbors_higher[ind2];
-        // Check for triangle formation
-        if (static_graph_->IsEdge(dst1, dst2) || static_graph_->IsEdge(dst2, dst1)) {
-          #pragma omp critical
-          {
-            Us.Add(src);
-            Vs.Add(dst1);
-            Ws.Add(dst2);
+        const TIntV& dst1_higher = higher_nbrs[dst1];
+        for (int ind2 = 0; ind2 < dst1_higher.Len(); ind2++) {
+          int dst2 = dst1_higher[ind2];
+          // Check for triangle formation
+          if (marks[dst2] == src + 1) {
+            local_us.Add(src);
+            local_vs.Add(dst1);
+            local_ws.Add(dst2);
           }
         }
       }
     }
+    #pragma omp critical
+    {
+      Us.AddV(local_us);
+      Vs.AddV(local_vs);
+      Ws.AddV(local_ws);
+    }
   }
 }
 
@@ -180,28 +233,38 @@ void TempMotifCounter::Count3TEdge2Node(double delta, Counter2D& counts) {
     }
   }
   counts = Counter2D(2, 2);
-  #pragma omp parallel for schedule(dynamic)
-  for (int i = 0; i < undir_edges.Len(); i++) {
-    TIntPair edge = undir_edges[i];
-    Counter3D local;
-    Count3TEdge2Node(edge.Key, edge.Dat, delta, local);
+  #pragma omp parallel
+  {
+    Counter2D thread_counts(2, 2);
+    #pragma omp for schedule(dynamic)
+    for (int i = 0; i < undir_edges.Len(); i++) {
+      TIntPair edge = undir_edges[i];
+      Counter3D local;
+      Count3TEdge2Node(edge.Key, edge.Dat, delta, local);
+      thread_counts(0, 0) += local(0, 1, 0) + local(1, 0, 1);  // M_{5,1}
+      thread_counts(0, 1) += local(1, 0, 0) + local(0, 1, 1);  // M_{5,2}
+      thread_counts(1, 0) += local(0, 0, 0) + local(1, 1, 1);  // M_{6,1}
+      thread_counts(1, 1) += local(0, 0, 1) + local(1, 1, 0);  // M_{6,2}
+    }
     #pragma omp critical
     {
-      counts(0, 0) += local(0, 1, 0) + local(1, 0, 1);  // M_{5,1}
-      counts(0, 1) += local(1, 0, 0) + local(0, 1, 1);  // M_{5,2}
-      counts(1, 0) += local(0, 0, 0) + local(1, 1, 1);  // M_{6,1}
-      counts(1, 1) += local(0, 0, 1) + local(1, 1, 0);  // M_{6,2}
+      for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) { counts(i, j) += thread_counts(i, j); }
+      }
     }
   }
 }
 
 void TempMotifCounter::Count3TEdge2Node(int u, int v, double delta,
                                         Counter3D& counts) {
-  // Sort event list by time
+  // Merge the event lists by time
   TVec<TIntPair> combined;
+  TIntV run_starts;
+  run_starts.Add(combined.Len());
   AddStarEdges(combined, u, v, 0);
+  run_starts.Add(combined.Len());
   AddStarEdges(combined, v, u, 1);
-  combined.Sort();
+  MergeSortedRuns(combined, run_starts);
 
   // Get the counts
   ThreeTEdgeMotifCounter counter(2);
@@ -250,7 +313,7 @@ void TempMotifCounter::Count3TEdge3NodeStarsNaive(
         AddStarEdges(combined, nbr1, center, 1);
         AddStarEdges(combined, center, nbr2, 2);
         AddStarEdges(combined, nbr2, center, 3);
-        combined.Sort();
+        TSnap::SortMP(combined);
         ThreeTEdgeMotifCounter counter(4);
         TIntV edge_id(combined.Len());
         TIntV timestamps(combined.Len());
@@ -297,71 +360,89 @@ void TempMotifCounter::AddStarEdgeData(TVec<TIntPair>& ts_indices,
 void TempMotifCounter::Count3TEdge3NodeStars(double delta, Counter3D& pre_counts,
                                              Counter3D& pos_counts,
                                              Counter3D& mid_counts) {
-  TIntV centers;
-  GetAllNodes(centers);
+  // Process centers with the most neighbors first, so that heavy hubs do not
+  // end up as the last work items of a thread
+  TVec<TIntPair> center_degs;
+  for (TNGraph::TNodeI it = static_graph_->BegNI();
+       it < static_graph_->EndNI(); it++) {
+    center_degs.Add(TIntPair(it.GetDeg(), it.GetId()));
+  }
+  center_degs.Sort(false);
   pre_counts = Counter3D(2, 2, 2);
   pos_counts = Counter3D(2, 2, 2);
   mid_counts = Counter3D(2, 2, 2);
-  // Get counts for each node as the center
-  #pragma omp parallel for schedule(dynamic)  
-  for (int c = 0; c < centers.Len(); c++) {
-    // Gather all adjacent events
-    int center = centers[c];
-    TVec<TIntPair> ts_indices;
-    TVec<StarEdgeData> events;
-    TNGraph::TNodeI NI = static_graph_->GetNI(center);
-    int index = 0;
-    TIntV nbrs;
-    GetAllNeighbors(center, nbrs);
-    int nbr_index = 0;
-    for (int i = 0; i < nbrs.Len(); i++) {
-      int nbr = nbrs[i];
-      AddStarEdgeData(ts_indices, events, index, center, nbr, nbr_index, 0);
-      AddStarEdgeData(ts_indices, events, index, nbr, center, nbr_index, 1);
-      nbr_index++;
-    }
-    ts_indices.Sort();
-    TIntV timestamps;
-    TVec<StarEdgeData> ordered_events;
-    for (int j = 0; j < ts_indices.Len(); j++) {
-      timestamps.Add(ts_indices[j].Key);
-      ordered_events.Add(events[ts_indices[j].Dat]);
-    }
+  #pragma omp parallel
+  {
+    Counter3D thread_pre(2, 2, 2), thread_pos(2, 2, 2), thread_mid(2, 2, 2);
+    // Get counts for each node as the center
+    #pragma omp for schedule(dynamic)
+    for (int c = 0; c < center_degs.Len(); c++) {
+      // Gather all adjacent events
+      int center = center_degs[c].Dat;
+      TVec<TIntPair> ts_indices;
+      TIntV run_starts;
+      TVec<StarEdgeData> events;
+      int index = 0;
+      TIntV nbrs;
+      GetAllNeighbors(center, nbrs);
+      int nbr_index = 0;
+      for (int i = 0; i < nbrs.Len(); i++) {
+        int nbr = nbrs[i];
+        run_starts.Add(ts_indices.Len());
+        AddStarEdgeData(ts_indices, events, index, center, nbr, nbr_index, 0);
+        run_starts.Add(ts_indices.Len());
+        AddStarEdgeData(ts_indices, events, index, nbr, center, nbr_index, 1);
+        nbr_index++;
+      }
+      MergeSortedRuns(ts_indices, run_starts);
+      TIntV timestamps(ts_indices.Len());
+      TVec<StarEdgeData> ordered_events(ts_indices.Len());
+      for (int j = 0; j < ts_indices.Len(); j++) {
+        timestamps[j] = ts_indices[j].Key;
+        ordered_events[j] = events[ts_indices[j].Dat];
+      }
     
-    ThreeTEdgeStarCounter tesc(nbr_index);
-    // dirs: outgoing --> 0, incoming --> 1
-    tesc.Count(ordered_events, timestamps, delta);
-    #pragma omp critical
-    { // Update counts
+      ThreeTEdgeStarCounter tesc(nbr_index);
+      // dirs: outgoing --> 0, incoming --> 1
+      tesc.Count(ordered_events, timestamps, delta);
       for (int dir1 = 0; dir1 < 2; ++dir1) {
         for (int dir2 = 0; dir2 < 2; ++dir2) {
           for (int dir3 = 0; dir3 < 2; ++dir3) {
-            pre_counts(dir1, dir2, dir3) += tesc.PreCount(dir1, dir2, dir3);
-            pos_counts(dir1, dir2, dir3) += tesc.PosCount(dir1, dir2, dir3);
-            mid_counts(dir1, dir2, dir3) += tesc.MidCount(dir1, dir2, dir3);
+            thread_pre(dir1, dir2, dir3) += tesc.PreCount(dir1, dir2, dir3);
+            thread_pos(dir1, dir2, dir3) += tesc.PosCount(dir1, dir2, dir3);
+            thread_mid(dir1, dir2, dir3) += tesc.MidCount(dir1, dir2, dir3);
           }
         }
       }
-    }
 
-    // Subtract off edge-wise counts
-    for (int nbr_id = 0; nbr_id < nbrs.Len(); nbr_id++) {
-      int nbr = nbrs[nbr_id];
-      Counter3D edge_counts;
-      Count3TEdge2Node(center, nbr, delta, edge_counts);
-      #pragma omp critical
-      {
+      // Subtract off edge-wise counts
+      for (int nbr_id = 0; nbr_id < nbrs.Len(); nbr_id++) {
+        int nbr = nbrs[nbr_id];
+        Counter3D edge_counts;
+        Count3TEdge2Node(center, nbr, delta, edge_counts);
         for (int dir1 = 0; dir1 < 2; ++dir1) {
           for (int dir2 = 0; dir2 < 2; ++dir2) {
             for (int dir3 = 0; dir3 < 2; ++dir3) {
-              pre_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
-              pos_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
-              mid_counts(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
+              thread_pre(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
+              thread_pos(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
+              thread_mid(dir1, dir2, dir3) -= edge_counts(dir1, dir2, dir3);
             }
           }
         }
       }
     }
+    #pragma omp critical
+    { // Update counts
+      for (int dir1 = 0; dir1 < 2; ++dir1) {
+        for (int dir2 = 0; dir2 < 2; ++dir2) {
+          for (int dir3 = 0; dir3 < 2; ++dir3) {
+            pre_counts(dir1, dir2, dir3) += thread_pre(dir1, dir2, dir3);
+            pos_counts(dir1, dir2, dir3) += thread_pos(dir1, dir2, dir3);
+            mid_counts(dir1, dir2, dir3) += thread_mid(dir1, dir2, dir3);
+          }
+        }
+      }
+    }
   }
 }
 
@@ -386,7 +467,7 @@ void TempMotifCounter::Count3TEdgeTriadsNaive(double delta, Counter3D& counts) {
     AddStarEdges(combined, v, w, vw);
     AddStarEdges(combined, w, v, wv);        
     // Get the counts for this triangle
-    combined.Sort();
+    TSnap::SortMP(combined);
     ThreeTEdgeMotifCounter counter(6);
     TIntV edge_id(combined.Len());
     TIntV timestamps(combined.Len());
@@ -461,7 +542,8 @@ void TempMotifCounter::Count3TEdgeTriads(double delta, Counter3D& counts) {
   // Assign triangles to the edge with the most events
   TIntV Us, Vs, Ws;
   GetAllStaticTriangles(Us, Vs, Ws);
-  #pragma omp parallel for schedule(dynamic)
+  TIntV owners(Us.Len());
+  #pragma omp parallel for schedule(dynamic, 1000)
   for (int i = 0; i < Us.Len(); i++) {
     int u = Us[i];
     int v = Vs[i];
@@ -470,26 +552,28 @@ void TempMotifCounter::Count3TEdgeTriads(double delta, Counter3D& counts) {
     int counts_uw = edge_counts[MIN(u, w)].GetDat(MAX(u, w));
     int counts_vw = edge_counts[MIN(v, w)].GetDat(MAX(v, w));
     if        (counts_uv >= MAX(counts_uw, counts_vw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(u, v)].GetDat(MAX(u, v));
-        assignment.Add(w);
-      }
+      owners[i] = 0;
     } else if (counts_uw >= MAX(counts_uv, counts_vw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(u, w)].GetDat(MAX(u, w));
-        assignment.Add(v);      
-      }
-    } else if (counts_vw >= MAX(counts_uv, counts_uw)) {
-      #pragma omp critical
-      {
-        TIntV& assignment = assignments[MIN(v, w)].GetDat(MAX(v, w));
-        assignment.Add(u);              
-      }
+      owners[i] = 1;
+    } else {
+      owners[i] = 2;
+    }
+  }
+  for (int i = 0; i < Us.Len(); i++) {
+    int u = Us[i];
+    int v = Vs[i];
+    int w = Ws[i];
+    if (owners[i] == 0) {
+      assignments[MIN(u, v)].GetDat(MAX(u, v)).Add(w);
+    } else if (owners[i] == 1) {
+      assignments[MIN(u, w)].GetDat(MAX(u, w)).Add(v);
+    } else {
+      assignments[MIN(v, w)].GetDat(MAX(v, w)).Add(u);
     }
   }
 
+  // Edges with the most assigned triangles go first
+  TVec<TIntPair> edge_loads;
   TVec<TIntPair> all_edges;
   TIntV all_nodes;
   GetAllNodes(all_nodes);  
@@ -500,59 +584,75 @@ void TempMotifCounter::Count3TEdgeTriads(double delta, Counter3D& counts) {
     for (int nbr_id = 0; nbr_id < nbrs.Len(); nbr_id++) {
       int v = nbrs[nbr_id];
       if (assignments[u].IsKey(v) && assignments[u].GetDat(v).Len() > 0) {
+        edge_loads.Add(TIntPair(assignments[u].GetDat(v).Len(), all_edges.Len()));
         all_edges.Add(TIntPair(u, v));
       }
     }
   }
+  edge_loads.Sort(false);
 
   // Count triangles on edges with the assigned neighbors
-  #pragma omp parallel for schedule(dynamic)
-  for (int edge_id = 0; edge_id < all_edges.Len(); edge_id++) {
-    TIntPair edge = all_edges[edge_id];
-    int u = edge.Key;
-    int v = edge.Dat;
-    // Continue if no assignment
-    if (!assignments[u].IsKey(v)) { continue; }
-    TIntV& uv_assignment = assignments[u].GetDat(v);
-    // Continue if no data
-    if (uv_assignment.Len() == 0) { continue; }
-    // Get all events on (u, v)
-    TVec<TriadEdgeData> events;
-    TVec<TIntPair> ts_indices;
-    int index = 0;
-    int nbr_index = 0;
-    // Assign indices from 0, 1, ..., num_nbrs + 2
-    AddTriadEdgeData(events, ts_indices, index, u, v, nbr_index, 0, 1);
-    nbr_index++;
-    AddTriadEdgeData(events, ts_indices, index, v, u, nbr_index, 0, 0);
-    nbr_index++;
-    // Get all events on triangles assigned to (u, v)
-    for (int w_id = 0; w_id < uv_assignment.Len(); w_id++) {
-      int w = uv_assignment[w_id];
-      AddTriadEdgeData(events, ts_indices, index, w, u, nbr_index, 0, 0);
-      AddTriadEdgeData(events, ts_indices, index, w, v, nbr_index, 0, 1);
-      AddTriadEdgeData(events, ts_indices, index, u, w, nbr_index, 1, 0);
-      AddTriadEdgeData(events, ts_indices, index, v, w, nbr_index, 1, 1);
-      nbr_index++;      
-    }
-    // Put events in sorted order
-    ts_indices.Sort();
-    TIntV timestamps(ts_indices.Len());
-    TVec<TriadEdgeData> sorted_events(ts_indices.Len());
-    for (int i = 0; i < ts_indices.Len(); i++) {
-      timestamps[i] = ts_indices[i].Key;
-      sorted_events[i] = events[ts_indices[i].Dat];
-    }
+  #pragma omp parallel
+  {
+    Counter3D thread_counts(2, 2, 2);
+    #pragma omp for schedule(dynamic)
+    for (int load_id = 0; load_id < edge_loads.Len(); load_id++) {
+      TIntPair edge = all_edges[edge_loads[load_id].Dat];
+      int u = edge.Key;
+      int v = edge.Dat;
+      TIntV& uv_assignment = assignments[u].GetDat(v);
+      // Get all events on (u, v)
+      TVec<TriadEdgeData> events;
+      TVec<TIntPair> ts_indices;
+      TIntV run_starts;
+      int index = 0;
+      int nbr_index = 0;
+      // Assign indices from 0, 1, ..., num_nbrs + 2
+      run_starts.Add(ts_indices.Len());
+      AddTriadEdgeData(events, ts_indices, index, u, v, nbr_index, 0, 1);
+      nbr_index++;
+      run_starts.Add(ts_indices.Len());
+      AddTriadEdgeData(events, ts_indices, index, v, u, nbr_index, 0, 0);
+      nbr_index++;
+      // Get all events on triangles assigned to (u, v)
+      for (int w_id = 0; w_id < uv_assignment.Len(); w_id++) {
+        int w = uv_assignment[w_id];
+        run_starts.Add(ts_indices.Len());
+        AddTriadEdgeData(events, ts_indices, index, w, u, nbr_index, 0, 0);
+        run_starts.Add(ts_indices.Len());
+        AddTriadEdgeData(events, ts_indices, index, w, v, nbr_index, 0, 1);
+        run_starts.Add(ts_indices.Len());
+        AddTriadEdgeData(events, ts_indices, index, u, w, nbr_index, 1, 0);
+        run_starts.Add(ts_indices.Len());
+        AddTriadEdgeData(events, ts_indices, index, v, w, nbr_index, 1, 1);
+        nbr_index++;      
+      }
+      // Put events in sorted order
+      MergeSortedRuns(ts_indices, run_starts);
+      TIntV timestamps(ts_indices.Len());
+      TVec<TriadEdgeData> sorted_events(ts_indices.Len());
+      for (int i = 0; i < ts_indices.Len(); i++) {
+        timestamps[i] = ts_indices[i].Key;
+        sorted_events[i] = events[ts_indices[i].Dat];
+      }
     
-    // Get the counts and update the counter
-    ThreeTEdgeTriadCounter tetc(nbr_index, 0, 1);
-    tetc.Count(sorted_events, timestamps, delta);
+      // Get the counts and update the counter
+      ThreeTEdgeTriadCounter tetc(nbr_index, 0, 1);
+      tetc.Count(sorted_events, timestamps, delta);
+      for (int dir1 = 0; dir1 < 2; dir1++) {
+        for (int dir2 = 0; dir2 < 2; dir2++) {
+          for (int dir3 = 0; dir3 < 2; dir3++) {        
+            thread_counts(dir1, dir2, dir3) += tetc.Counts(dir1, dir2, dir3);
+          }
+        }
+      }
+    }
     #pragma omp critical
     {
       for (int dir1 = 0; dir1 < 2; dir1++) {
         for (int dir2 = 0; dir2 < 2; dir2++) {
           for (int dir3 = 0; dir3 < 2; dir3++) {        
-            counts(dir1, dir2, dir3) += tetc.Counts(dir1, dir2, dir3);
+            counts(dir1, dir2, dir3) += thread_counts(dir1, dir2, dir3);
           }
         }
       }
@@ -90,7 +90,10 @@ class StarEdgeData {
 };
 
 // Main temporal motif counting class.  This implementation has support for
-// counting motifs with three temporal edges on two or three nodes.  
+// counting motifs with three temporal edges on two or three nodes.  With
+// OpenMP, work is split over static edges, star centers, and the static edges
+// that triangles are assigned to; every thread keeps its own counters, which
+// are added together at the end.
 class TempMotifCounter {
  public:
   // Reads directed temporal graph data from the specified file, which must have
@@ -173,6 +176,11 @@ class TempMotifCounter {
   // Checks whether or not there is a temporal edge along the static edge (u, v)
   bool HasEdges(int u, int v);
 
+  // Merges consecutive sorted runs of combined into one sorted vector, where
+  // run i starts at combined[run_starts[i]] and ends where run i + 1 starts.
+  // This is the same order as sorting combined, but takes O(n log(runs)) time.
+  static void MergeSortedRuns(TVec<TIntPair>& combined, TIntV& run_starts);
+
   // A simple wrapper for adding triad edge data
   void AddTriadEdgeData(TVec<TriadEdgeData>& events, TVec<TIntPair>& ts_indices,
                         int& index, int u, int v, int nbr, int key1, int key2);
@@ -186,7 +194,7 @@ class TempMotifCounter {
   PNGraph static_graph_;  
 
   // Core data structure for storing temporal edges.  temporal_data_[u](v) is a
-  // list of temporal edges along the static edge (u, v).
+  // list of temporal edges along the static edge (u, v), sorted by timestamp.
   TVec< THash<TInt, TIntV> > temporal_data_;
 };
 
@@ -19,6 +19,7 @@
 #include "networkmp.cpp"     // networks OMP
 #include "timenet.cpp"       // time evolving networks
 #include "mmnet.cpp"         // multimodal networks
+#include "csr.cpp"           // compressed sparse row graph snapshots
 
 // table data structures and algorithms
 #include "table.cpp"         // table
@@ -28,6 +29,7 @@
 // algorithms
 #include "subgraph.cpp"      // subgraph manipulations
 #include "anf.cpp"           // approximate diameter calculation
+#include "bfsdfs.cpp"        // breadth and depth first search
 #include "cncom.cpp"         // connected components
 #include "alg.cpp"           // misc graph algorithms
 #include "gsvd.cpp"          // SVD and eigenvector computations
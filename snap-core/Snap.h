@@ -22,6 +22,7 @@
 #include "bignet.h"          // large networks
 #include "timenet.h"         // time evolving networks
 #include "mmnet.h"           // multimodal networks
+#include "csr.h"             // compressed sparse row graph snapshots
 
 // table data structures and algorithms
 #include "table.h"           // table
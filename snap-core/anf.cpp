@@ -1,3 +1,123 @@
+/////////////////////////////////////////////////
+// HyperANF
+void THyperAnf::Init(const int& RndSeed) {
+  IAssertR(4 <= LogRegs && LogRegs <= 16, "HyperANF needs between 2^4 and 2^16 registers per node");
+  WordsPerNd = (1 << LogRegs) / 8;
+  TRnd Rnd(RndSeed);
+  Seed = Rnd.GetUniDevUInt64();
+  InvPow2V.Gen(65);
+  for (int r = 0; r < InvPow2V.Len(); r++) { InvPow2V[r] = pow(2.0, -r); }
+}
+
+int THyperAnf::GetLogRegs(const int& NApprox) {
+  // 4*NApprox registers take about as much memory as NApprox Flajolet-Martin approximations
+  int LogRegisters = 2;
+  while ((1 << LogRegisters) < NApprox) { LogRegisters++; }
+  return TMath::Mx(4, TMath::Mn(16, LogRegisters+2));
+}
+
+// Every node adds itself: the top LogRegs bits of its hash select the register,
+// the register keeps the position of the first 1 bit in the remaining bits.
+void THyperAnf::InitRegs(TRegV& RegV) const {
+  const int Nodes = Graph->GetNodes();
+  RegV.Gen(int64(Nodes) * WordsPerNd);
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) {
+    uint64 Hash = Seed.Val + uint64(n) * 0x9E3779B97F4A7C15ULL; // splitmix64
+    Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBULL;
+    Hash ^= Hash >> 31;
+    const int Reg = int(Hash >> (64 - LogRegs));
+    uint64 Rest = Hash << LogRegs;
+    uint64 Rank = 1;
+    while (Rank <= uint64(64 - LogRegs) && (Rest >> 63) == 0) { Rest <<= 1;  Rank++; }
+    RegV[int64(n) * WordsPerNd + Reg / 8] = Rank << (8 * (Reg % 8));
+  }
+}
+
+bool THyperAnf::Union(TRegV& DstV, const int& DstNIdx, const TRegV& SrcV, const int& SrcNIdx) const {
+  uint64* DstI = (uint64 *) DstV.BegI() + int64(DstNIdx) * WordsPerNd;
+  const uint64* SrcI = (const uint64 *) SrcV.BegI() + int64(SrcNIdx) * WordsPerNd;
+  uint64 Changed = 0;
+  for (int w = 0; w < WordsPerNd; w++) {
+    const uint64 Max = GetRegMax(DstI[w], SrcI[w]);
+    Changed |= Max ^ DstI[w];
+    DstI[w] = Max;
+  }
+  return Changed != 0;
+}
+
+double THyperAnf::GetCount(const TRegV& RegV, const int& NIdx) const {
+  const int Regs = 1 << LogRegs;
+  const uint64* RegI = (const uint64 *) RegV.BegI() + int64(NIdx) * WordsPerNd;
+  double InvSum = 0.0;
+  int Zeros = 0;
+  for (int w = 0; w < WordsPerNd; w++) {
+    uint64 Word = RegI[w];
+    // high bit of each byte is set for non-zero registers (registers are below 128)
+    uint64 NonZero = (((Word | 0x8080808080808080ULL) - 0x0101010101010101ULL) & 0x8080808080808080ULL) >> 7;
+    NonZero = (NonZero * 0x0101010101010101ULL) >> 56; // broadword count of the non-zero registers
+    Zeros += 8 - int(NonZero);
+    for (int b = 0; b < 8; b++, Word >>= 8) { InvSum += InvPow2V[int(Word & 0xFF)]; }
+  }
+  double Alpha = 0.7213 / (1.0 + 1.079 / Regs);
+  if (Regs == 16) { Alpha = 0.673; }
+  else if (Regs == 32) { Alpha = 0.697; }
+  else if (Regs == 64) { Alpha = 0.709; }
+  const double Count = Alpha * Regs * Regs / InvSum;
+  // linear counting for small counts
+  if (Count <= 2.5 * Regs && Zeros > 0) { return Regs * log(double(Regs) / Zeros); }
+  return Count;
+}
+
+// Sets the registers of every node to the union of its own and its neighbors' registers from the last iteration.
+bool THyperAnf::Iterate(const TRegV& LastRegV, TRegV& CurRegV, const bool& IsDir) const {
+  const int Nodes = Graph->GetNodes();
+  int Changed = 0;
+  #pragma omp parallel for schedule(dynamic,1000) reduction(+:Changed)
+  for (int n = 0; n < Nodes; n++) {
+    bool NodeChanged = false;
+    for (int e = 0; e < Graph->GetOutDeg(n); e++) {
+      NodeChanged |= Union(CurRegV, n, LastRegV, Graph->GetOutNbr(n, e)); }
+    if (! IsDir && Graph->IsDir()) {
+      for (int e = 0; e < Graph->GetInDeg(n); e++) {
+        NodeChanged |= Union(CurRegV, n, LastRegV, Graph->GetInNbr(n, e)); }
+    }
+    if (NodeChanged) { Changed++; }
+  }
+  return Changed > 0;
+}
+
+void THyperAnf::GetNodeAnf(const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir) const {
+  const int SrcNIdx = Graph->GetNIdx(SrcNId);
+  TRegV CurRegV, LastRegV;
+  InitRegs(CurRegV);
+  DistNbrsV.Clr();
+  DistNbrsV.Add(TIntFltKd(0, GetCount(CurRegV, SrcNIdx)));
+  for (int dist = 1; dist < (MxDist==-1 ? TInt::Mx : MxDist); dist++) {
+    LastRegV = CurRegV;
+    if (! Iterate(LastRegV, CurRegV, IsDir)) { break; }
+    DistNbrsV.Add(TIntFltKd(dist, GetCount(CurRegV, SrcNIdx)));
+  }
+}
+
+void THyperAnf::GetGraphAnf(TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir) const {
+  const int Nodes = Graph->GetNodes();
+  TRegV CurRegV, LastRegV;
+  InitRegs(CurRegV);
+  DistNbrsV.Clr();
+  DistNbrsV.Add(TIntFltKd(0, Nodes));
+  for (int dist = 1; dist < (MxDist==-1 ? TInt::Mx : MxDist); dist++) {
+    LastRegV = CurRegV;
+    if (! Iterate(LastRegV, CurRegV, IsDir)) { break; }
+    double NPairs = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:NPairs)
+    for (int n = 0; n < Nodes; n++) { NPairs += GetCount(CurRegV, n); }
+    DistNbrsV.Add(TIntFltKd(dist, NPairs));
+    if (NPairs < 1.001*DistNbrsV.LastLast().Dat) { break; } // 0.1%  change
+  }
+}
+
 /////////////////////////////////////////////////
 // Approximate Neighborhood Function
 namespace TSnap {
@@ -7,20 +7,22 @@ namespace TSnap {
 /// @param MxDist Maximum number of hops the algorithm spreads from SrcNId.
 /// @param IsDir false: consider links as undirected (drop link directions).
 /// @param NApprox Quality of approximation. See the ANF paper.
-template <class PGraph> void GetAnf(const PGraph& Graph, const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox=32); 
+/// @param HyperAnf true: use HyperANF (THyperAnf) with the accuracy of NApprox approximations, for graphs too large for TGraphAnf.
+template <class PGraph> void GetAnf(const PGraph& Graph, const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox=32, const bool& HyperAnf=false);
 /// Approximate Neighborhood Function of a Graph: Returns the number of pairs of nodes reachable in less than H hops.
 /// For example, DistNbrsV.GetDat(0) is the number of nodes in the graph, DistNbrsV.GetDat(1) is the number of nodes+edges and so on.
 /// @param DistNbrsV Maps between the distance H (in hops) and the number of nodes reachable in <=H hops.
 /// @param MxDist Maximum number of hops the algorithm spreads from SrcNId.
 /// @param IsDir false: consider links as undirected (drop link directions).
 /// @param NApprox Quality of approximation. See the ANF paper.
-template <class PGraph> void GetAnf(const PGraph& Graph, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox=32);
+/// @param HyperAnf true: use HyperANF (THyperAnf) with the accuracy of NApprox approximations, for graphs too large for TGraphAnf.
+template <class PGraph> void GetAnf(const PGraph& Graph, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox=32, const bool& HyperAnf=false);
 /// Returns a given Percentile of the shortest path length distribution of a Graph (based on a single run of ANF of approximation quality NApprox).
 /// @param IsDir false: consider links as undirected (drop link directions).
-template <class PGraph> double GetAnfEffDiam(const PGraph& Graph, const bool& IsDir, const double& Percentile, const int& NApprox);
+template <class PGraph> double GetAnfEffDiam(const PGraph& Graph, const bool& IsDir, const double& Percentile, const int& NApprox, const bool& HyperAnf=false);
 /// Returns a 90-th percentile of the shortest path length distribution of a Graph (based on a NRuns runs of ANF of approximation quality NApprox).
 /// @param IsDir false: consider links as undirected (drop link directions).
-template <class PGraph> double GetAnfEffDiam(const PGraph& Graph, const int NRuns=1, int NApprox=-1);
+template <class PGraph> double GetAnfEffDiam(const PGraph& Graph, const int NRuns=1, int NApprox=-1, const bool& HyperAnf=false);
 } // namespace TSnap
 
 /////////////////////////////////////////////////
@@ -181,6 +183,55 @@ void TGraphAnf<PGraph>::GetGraphAnf(TIntFltKdV& DistNbrsV, const int& MxDist, co
     //TGnuPlot::SaveTs(DistNbrsV, "hops.tab", "HOPS, REACHABLE PAIRS");
   }
 }
+
+/////////////////////////////////////////////////
+/// HyperANF: Approximate Neighborhood Function based on HyperLogLog counters.
+/// Every node keeps 2^LogRegs one byte HyperLogLog registers. All registers live in a single 64-bit indexed array,
+/// 8 registers per word, so unions are word-wide (broadword) register maxima and graphs are not limited to 2^31 words.
+/// Nodes are updated in parallel. The counters take 2*Nodes*2^LogRegs bytes and the relative standard error
+/// of a count is about 1.04/sqrt(2^LogRegs).
+/// See: P. Boldi, M. Rosa and S. Vigna, HyperANF: Approximating the Neighbourhood Function of Very Large Graphs on a Budget, WWW 2011
+class THyperAnf {
+private:
+  typedef TVec<TUInt64, int64> TRegV;
+  PCsrGraph Graph;
+  TInt LogRegs, WordsPerNd;           // 2^LogRegs registers per node, 8 registers per word
+  TUInt64 Seed;
+  TFltV InvPow2V;                     // 2^-Reg for every register value
+private:
+  UndefDefaultCopyAssign(THyperAnf);
+  void Init(const int& RndSeed);
+  void InitRegs(TRegV& RegV) const;
+  bool Union(TRegV& DstV, const int& DstNIdx, const TRegV& SrcV, const int& SrcNIdx) const;
+  bool Iterate(const TRegV& LastRegV, TRegV& CurRegV, const bool& IsDir) const;
+public:
+  /// Takes a CSR snapshot of GraphPt.
+  template <class PGraph> THyperAnf(const PGraph& GraphPt, const int& LogRegisters=7, const int& RndSeed=0) :
+    Graph(TCsrGraph::New(GraphPt)), LogRegs(LogRegisters), WordsPerNd(), Seed(), InvPow2V() { Init(RndSeed); }
+  THyperAnf(const PCsrGraph& GraphPt, const int& LogRegisters=7, const int& RndSeed=0) :
+    Graph(GraphPt), LogRegs(LogRegisters), WordsPerNd(), Seed(), InvPow2V() { Init(RndSeed); }
+  /// Returns the number of registers needed for the accuracy of NApprox Flajolet-Martin approximations (TGraphAnf).
+  static int GetLogRegs(const int& NApprox);
+  /// Returns the register-wise maximum of 8 registers packed in X and Y.
+  static uint64 GetRegMax(const uint64& X, const uint64& Y) {
+    const uint64 High = 0x8080808080808080ULL;
+    const uint64 GeMask = ((((X | High) - Y) & High) >> 7) * 0xFF; // 0xFF in the bytes where X >= Y
+    return (X & GeMask) | (Y & ~GeMask); }
+  /// Returns the estimated number of elements counted by the registers of node with index NIdx.
+  double GetCount(const TRegV& RegV, const int& NIdx) const;
+  /// Returns the number of nodes reachable from SrcNId in less than H hops.
+  /// @param SrcNId Starting node.
+  /// @param DistNbrsV Maps between the distance H (in hops) and the number of nodes reachable in <=H hops.
+  /// @param MxDist Maximum number of hops the algorithm spreads from SrcNId.
+  /// @param IsDir false: consider links as undirected (drop link directions).
+  void GetNodeAnf(const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir) const;
+  /// Returns the number of pairs of nodes reachable in less than H hops.
+  /// For example, DistNbrsV.GetDat(0) is the number of nodes in the graph, DistNbrsV.GetDat(1) is the number of nodes+edges and so on.
+  /// @param DistNbrsV Maps between the distance H (in hops) and the number of nodes reachable in <=H hops.
+  /// @param MxDist Maximum number of hops the algorithm spreads.
+  /// @param IsDir false: consider links as undirected (drop link directions).
+  void GetGraphAnf(TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir) const;
+};
 /////////////////////////////////////////////////
 // Approximate Neighborhood Function
 namespace TSnap {
@@ -201,27 +252,36 @@ double CalcAvgDiamPdf(const TFltPrV& DistNbrsPdfV);
 } // TSnapDetail
 
 template <class PGraph>
-void GetAnf(const PGraph& Graph, const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox) {
+void GetAnf(const PGraph& Graph, const int& SrcNId, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox, const bool& HyperAnf) {
+  if (HyperAnf) {
+    THyperAnf Anf(Graph, THyperAnf::GetLogRegs(NApprox), 0);
+    Anf.GetNodeAnf(SrcNId, DistNbrsV, MxDist, IsDir);
+    return;
+  }
   TGraphAnf<PGraph> Anf(Graph, NApprox, 5, 0);
   Anf.GetNodeAnf(SrcNId, DistNbrsV, MxDist, IsDir);
 }
 
 template <class PGraph>
-void GetAnf(const PGraph& Graph, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox) {
+void GetAnf(const PGraph& Graph, TIntFltKdV& DistNbrsV, const int& MxDist, const bool& IsDir, const int& NApprox, const bool& HyperAnf) {
+  if (HyperAnf) {
+    THyperAnf Anf(Graph, THyperAnf::GetLogRegs(NApprox), 0);
+    Anf.GetGraphAnf(DistNbrsV, MxDist, IsDir);
+    return;
+  }
   TGraphAnf<PGraph> Anf(Graph, NApprox, 5, 0);
   Anf.GetGraphAnf(DistNbrsV, MxDist, IsDir);
 }
 
 template <class PGraph>
-double GetAnfEffDiam(const PGraph& Graph, const bool& IsDir, const double& Percentile, const int& NApprox) {
+double GetAnfEffDiam(const PGraph& Graph, const bool& IsDir, const double& Percentile, const int& NApprox, const bool& HyperAnf) {
   TIntFltKdV DistNbrsV;
-  TGraphAnf<PGraph> Anf(Graph, NApprox, 5, 0);
-  Anf.GetGraphAnf(DistNbrsV, -1, IsDir);
+  GetAnf(Graph, DistNbrsV, -1, IsDir, NApprox, HyperAnf);
   return TSnap::TSnapDetail::CalcEffDiam(DistNbrsV, Percentile);
 }
 
 template<class PGraph>
-double GetAnfEffDiam(const PGraph& Graph, const int NRuns, int NApprox) {
+double GetAnfEffDiam(const PGraph& Graph, const int NRuns, int NApprox, const bool& HyperAnf) {
   //return TSnap::GetEffDiam(Graph, IsDir, 0.9, 32);
   TMom Mom;
   if (NApprox == -1) {
@@ -231,7 +291,7 @@ double GetAnfEffDiam(const PGraph& Graph, const int NRuns, int NApprox) {
   }
   const bool IsDir = false;
   for (int r = 0; r < NRuns; r++) {
-    Mom.Add(TSnap::GetAnfEffDiam(Graph, IsDir, 0.9, NApprox));
+    Mom.Add(TSnap::GetAnfEffDiam(Graph, IsDir, 0.9, NApprox, HyperAnf));
   }
   Mom.Def();
   return Mom.GetMean();
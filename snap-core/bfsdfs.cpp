@@ -0,0 +1,266 @@
+/////////////////////////////////////////////////
+// Exact diameter, radius and eccentricities
+namespace TSnap {
+namespace TSnapDetail {
+
+//#//////////////////////////////////////////////
+/// Breadth-first search on a CSR snapshot that ignores edge directions.
+/// Keeps its arrays between runs, resetting only the nodes reached by the previous run, so it is cheap to run
+/// many BFSs over small components. Large levels are expanded in parallel if Parallel is true.
+class TCsrUndirBfs {
+private:
+  const TCsrGraph& Graph;
+  TIntV DistV;                      // distance from the source, -1 if not reached
+  TIntV OrderV;                     // reached nodes in BFS order
+  TIntV LevelOffV;                  // nodes at distance l are at OrderV[LevelOffV[l]...LevelOffV[l+1]-1]
+public:
+  TCsrUndirBfs(const TCsrGraph& CsrGraph) : Graph(CsrGraph), DistV(CsrGraph.GetNodes()), OrderV(CsrGraph.GetNodes(), 0), LevelOffV() {
+    DistV.PutAll(-1); }
+  /// Runs BFS from node index SrcNIdx and returns its eccentricity.
+  int DoBfs(const int& SrcNIdx, const bool& Parallel);
+  int GetDist(const int& NIdx) const { return DistV[NIdx]; }
+  int GetEcc() const { return LevelOffV.Len()-2; }
+  /// Returns the node farthest from the source (the last one reached).
+  int GetFarNIdx() const { return OrderV.Last(); }
+  int GetLevelBeg(const int& Level) const { return LevelOffV[Level]; }
+  int GetLevelEnd(const int& Level) const { return LevelOffV[Level+1]; }
+  const TIntV& GetOrderV() const { return OrderV; }
+  /// Returns the node at distance Dist from the source on a shortest path from the source to DstNIdx.
+  int GetPathNIdx(const int& DstNIdx, const int& Dist) const;
+};
+
+int TCsrUndirBfs::DoBfs(const int& SrcNIdx, const bool& Parallel) {
+  for (int i = 0; i < OrderV.Len(); i++) { DistV[OrderV[i]] = -1; }
+  OrderV.Reduce(0);
+  LevelOffV.Clr(false);
+  DistV[SrcNIdx] = 0;
+  OrderV.Add(SrcNIdx);
+  LevelOffV.Add(0);
+  const bool Dir = Graph.IsDir();
+  int LevelBeg = 0, Level = 0;
+  while (LevelBeg < OrderV.Len()) {
+    const int LevelEnd = OrderV.Len();
+    LevelOffV.Add(LevelEnd);
+    Level++;
+    #pragma omp parallel for schedule(dynamic,1000) if (Parallel && LevelEnd-LevelBeg > 1000)
+    for (int i = LevelBeg; i < LevelEnd; i++) {
+      const int NIdx = OrderV[i];
+      for (int e = 0; e < Graph.GetOutDeg(NIdx); e++) {
+        const int Nbr = Graph.GetOutNbr(NIdx, e);
+        if (DistV[Nbr] != -1) { continue; }
+#ifdef USE_OPENMP
+        if (__sync_bool_compare_and_swap(&DistV[Nbr].Val, -1, Level)) { OrderV.AddMP(Nbr); }
+#else
+        DistV[Nbr] = Level;  OrderV.Add(Nbr);
+#endif
+      }
+      if (! Dir) { continue; }
+      for (int e = 0; e < Graph.GetInDeg(NIdx); e++) {
+        const int Nbr = Graph.GetInNbr(NIdx, e);
+        if (DistV[Nbr] != -1) { continue; }
+#ifdef USE_OPENMP
+        if (__sync_bool_compare_and_swap(&DistV[Nbr].Val, -1, Level)) { OrderV.AddMP(Nbr); }
+#else
+        DistV[Nbr] = Level;  OrderV.Add(Nbr);
+#endif
+      }
+    }
+    LevelBeg = LevelEnd;
+  }
+  return GetEcc();
+}
+
+int TCsrUndirBfs::GetPathNIdx(const int& DstNIdx, const int& Dist) const {
+  int NIdx = DstNIdx;
+  while (DistV[NIdx] > Dist) {
+    int Prev = -1;
+    for (int e = 0; e < Graph.GetOutDeg(NIdx) && Prev == -1; e++) {
+      if (DistV[Graph.GetOutNbr(NIdx, e)] == DistV[NIdx]-1) { Prev = Graph.GetOutNbr(NIdx, e); } }
+    for (int e = 0; e < Graph.GetInDeg(NIdx) && Prev == -1; e++) {
+      if (DistV[Graph.GetInNbr(NIdx, e)] == DistV[NIdx]-1) { Prev = Graph.GetInNbr(NIdx, e); } }
+    NIdx = Prev;
+  }
+  return NIdx;
+}
+
+//#//////////////////////////////////////////////
+/// One TCsrUndirBfs per thread, created when the thread first asks for it.
+/// Parallel BFS sources reuse the arrays of their thread instead of allocating O(nodes) memory per source.
+class TCsrUndirBfsPool {
+private:
+  const TCsrGraph& Graph;
+  TVec<TCsrUndirBfs*> BfsV;
+private:
+  TCsrUndirBfsPool(const TCsrUndirBfsPool&);
+  TCsrUndirBfsPool& operator = (const TCsrUndirBfsPool&);
+public:
+  TCsrUndirBfsPool(const TCsrGraph& CsrGraph);
+  ~TCsrUndirBfsPool() { for (int t = 0; t < BfsV.Len(); t++) { delete BfsV[t]; } }
+  /// Returns the BFS of the calling thread.
+  TCsrUndirBfs& GetBfs();
+};
+
+TCsrUndirBfsPool::TCsrUndirBfsPool(const TCsrGraph& CsrGraph) : Graph(CsrGraph), BfsV() {
+#ifdef USE_OPENMP
+  BfsV.Gen(omp_get_max_threads());
+#else
+  BfsV.Gen(1);
+#endif
+  BfsV.PutAll(NULL);
+}
+
+TCsrUndirBfs& TCsrUndirBfsPool::GetBfs() {
+#ifdef USE_OPENMP
+  const int ThreadN = omp_get_thread_num();
+#else
+  const int ThreadN = 0;
+#endif
+  IAssert(ThreadN < BfsV.Len());
+  if (BfsV[ThreadN] == NULL) { BfsV[ThreadN] = new TCsrUndirBfs(Graph); }
+  return *BfsV[ThreadN];
+}
+
+/// Returns the number of neighbors of NIdx, ignoring edge directions (parallel edges count separately).
+int GetCsrUndirDeg(const TCsrGraph& Graph, const int& NIdx) {
+  return Graph.IsDir() ? Graph.GetOutDeg(NIdx) + Graph.GetInDeg(NIdx) : Graph.GetOutDeg(NIdx);
+}
+
+/// Groups node indices by connected component (ignoring edge directions). Nodes of component c are at
+/// CompNIdxV[CompOffV[c]...CompOffV[c+1]-1], in BFS order from the first node of the component.
+void GetCsrUndirComps(const TCsrGraph& Graph, TIntV& CompNIdxV, TIntV& CompOffV) {
+  TCsrUndirBfs Bfs(Graph);
+  TBoolV DoneV(Graph.GetNodes());
+  CompNIdxV.Gen(Graph.GetNodes(), 0);
+  CompOffV.Clr();
+  CompOffV.Add(0);
+  for (int n = 0; n < Graph.GetNodes(); n++) {
+    if (DoneV[n]) { continue; }
+    Bfs.DoBfs(n, true);
+    const TIntV& OrderV = Bfs.GetOrderV();
+    for (int i = 0; i < OrderV.Len(); i++) { DoneV[OrderV[i]] = true;  CompNIdxV.Add(OrderV[i]); }
+    CompOffV.Add(CompNIdxV.Len());
+  }
+}
+
+/// Returns the diameter of the component made of CompNIdxV[Beg...End-1] with iFUB (Crescenzi et al.),
+/// or LowerBound if the diameter is not larger. Starts from the midpoint of a 4-sweep path, fringe BFSs run in parallel
+/// on the per-thread BFSs of ThBfsPool.
+int GetCsrCompDiam(const TCsrGraph& Graph, const TIntV& CompNIdxV, const int& Beg, const int& End, const int& LowerBound, TCsrUndirBfs& Bfs, TCsrUndirBfsPool& ThBfsPool) {
+  if (End-Beg-1 <= LowerBound) { return LowerBound; }
+  int MxDegNIdx = CompNIdxV[Beg];
+  for (int i = Beg+1; i < End; i++) {
+    if (GetCsrUndirDeg(Graph, CompNIdxV[i]) > GetCsrUndirDeg(Graph, MxDegNIdx)) { MxDegNIdx = CompNIdxV[i]; }
+  }
+  // 4-sweep: two double sweeps, the second from the midpoint of the first path
+  int LowDiam = LowerBound, MidNIdx = MxDegNIdx;
+  for (int s = 0; s < 2; s++) {
+    Bfs.DoBfs(MidNIdx, true);
+    const int SrcNIdx = Bfs.GetFarNIdx();
+    const int Ecc = Bfs.DoBfs(SrcNIdx, true);
+    LowDiam = TMath::Mx(LowDiam, Ecc);
+    MidNIdx = Bfs.GetPathNIdx(Bfs.GetFarNIdx(), Ecc/2);
+  }
+  // iFUB: nodes at distance i from the center bound the diameter by 2i
+  const int CenterEcc = Bfs.DoBfs(MidNIdx, true);
+  LowDiam = TMath::Mx(LowDiam, CenterEcc);
+  const TIntV FringeV(Bfs.GetOrderV());
+  TIntV LevelOffV(CenterEcc+2, 0);
+  for (int l = 0; l <= CenterEcc+1; l++) { LevelOffV.Add(Bfs.GetLevelBeg(l)); }
+  for (int Level = CenterEcc; 2*Level > LowDiam; Level--) {
+    int FringeEcc = 0;
+    #pragma omp parallel for schedule(dynamic,1) reduction(max:FringeEcc)
+    for (int i = LevelOffV[Level]; i < LevelOffV[Level+1]; i++) {
+      FringeEcc = TMath::Mx(FringeEcc, ThBfsPool.GetBfs().DoBfs(FringeV[i], false));
+    }
+    LowDiam = TMath::Mx(LowDiam, FringeEcc);
+  }
+  return LowDiam;
+}
+
+/// Bounds eccentricities of the component made of CompNIdxV[Beg...End-1] with Takes-Kosters bounding.
+/// Every BFS from v gives max(d(v,w), ecc(v)-d(v,w)) <= ecc(w) <= ecc(v)+d(v,w); nodes whose bounds meet get their
+/// eccentricity in EccV, which must be -1 for unresolved nodes on entry. BFS sources alternate between the node with the largest upper bound and the candidate with
+/// the smallest lower bound, higher degree breaks ties. Candidates are the nodes whose eccentricity is still wanted.
+/// If RadiusUb is not NULL only the radius is wanted: candidates whose lower bound reaches the smallest upper bound
+/// *RadiusUb cannot be centers and are dropped, and *RadiusUb ends as the radius of the component if that is smaller
+/// than its value on entry.
+void GetCsrCompEcc(const TCsrGraph& Graph, const TIntV& CompNIdxV, const int& Beg, const int& End, TIntV& EccV, int* RadiusUb, TCsrUndirBfs& Bfs) {
+  const int Nodes = End-Beg;
+  TIntV LowV(Nodes), UpV(Nodes);
+  TBoolV CandV(Nodes);
+  UpV.PutAll(TInt::Mx);
+  CandV.PutAll(true);
+  int Cands = Nodes;
+  bool HiUp = true;
+  while (Cands > 0) {
+    int SrcN = -1;
+    for (int N = 0; N < Nodes; N++) {
+      if (HiUp ? LowV[N] == UpV[N] : ! CandV[N]) { continue; }
+      if (SrcN == -1) { SrcN = N;  continue; }
+      const int Cmp = HiUp ? UpV[N]-UpV[SrcN] : LowV[SrcN]-LowV[N];
+      if (Cmp > 0 || (Cmp == 0 && GetCsrUndirDeg(Graph, CompNIdxV[Beg+N]) > GetCsrUndirDeg(Graph, CompNIdxV[Beg+SrcN]))) { SrcN = N; }
+    }
+    HiUp = ! HiUp;
+    const int Ecc = Bfs.DoBfs(CompNIdxV[Beg+SrcN], true);
+    #pragma omp parallel for schedule(static) if (Nodes > 10000)
+    for (int N = 0; N < Nodes; N++) {
+      const int Dist = Bfs.GetDist(CompNIdxV[Beg+N]);
+      LowV[N] = TMath::Mx(LowV[N].Val, Dist, Ecc-Dist);
+      UpV[N] = TMath::Mn(UpV[N].Val, Ecc+Dist);
+    }
+    if (RadiusUb != NULL) {
+      for (int N = 0; N < Nodes; N++) { *RadiusUb = TMath::Mn(*RadiusUb, UpV[N].Val); }
+    }
+    for (int N = 0; N < Nodes; N++) {
+      const int NIdx = CompNIdxV[Beg+N];
+      // a leaf is one step farther from everything than its neighbor
+      if (LowV[N] < UpV[N] && Nodes > 2 && GetCsrUndirDeg(Graph, NIdx) == 1) {
+        const int Nbr = Graph.GetOutDeg(NIdx) == 1 ? Graph.GetOutNbr(NIdx, 0) : Graph.GetInNbr(NIdx, 0);
+        if (EccV[Nbr] != -1) { LowV[N] = EccV[Nbr]+1;  UpV[N] = LowV[N]; }
+      }
+      if (LowV[N] == UpV[N]) { EccV[NIdx] = LowV[N]; }
+      if (CandV[N] && (LowV[N] == UpV[N] || (RadiusUb != NULL && LowV[N] >= *RadiusUb))) { CandV[N] = false;  Cands--; }
+    }
+  }
+}
+
+} // namespace TSnapDetail
+
+int GetExactDiam(const TCsrGraph& Graph) {
+  TIntV CompNIdxV, CompOffV;
+  TSnapDetail::GetCsrUndirComps(Graph, CompNIdxV, CompOffV);
+  TSnapDetail::TCsrUndirBfs Bfs(Graph);
+  TSnapDetail::TCsrUndirBfsPool ThBfsPool(Graph);
+  int Diam = 0;
+  for (int c = 0; c+1 < CompOffV.Len(); c++) {
+    Diam = TSnapDetail::GetCsrCompDiam(Graph, CompNIdxV, CompOffV[c], CompOffV[c+1], Diam, Bfs, ThBfsPool);
+  }
+  return Diam;
+}
+
+int GetExactRad(const TCsrGraph& Graph) {
+  if (Graph.GetNodes() == 0) { return 0; }
+  TIntV CompNIdxV, CompOffV;
+  TSnapDetail::GetCsrUndirComps(Graph, CompNIdxV, CompOffV);
+  TSnapDetail::TCsrUndirBfs Bfs(Graph);
+  TIntV EccV(Graph.GetNodes());
+  EccV.PutAll(-1);
+  int Radius = TInt::Mx;
+  for (int c = 0; c+1 < CompOffV.Len(); c++) {
+    TSnapDetail::GetCsrCompEcc(Graph, CompNIdxV, CompOffV[c], CompOffV[c+1], EccV, &Radius, Bfs);
+  }
+  return Radius;
+}
+
+void GetExactNodeEcc(const TCsrGraph& Graph, TIntV& EccV) {
+  TIntV CompNIdxV, CompOffV;
+  TSnapDetail::GetCsrUndirComps(Graph, CompNIdxV, CompOffV);
+  TSnapDetail::TCsrUndirBfs Bfs(Graph);
+  EccV.Gen(Graph.GetNodes());
+  EccV.PutAll(-1);
+  for (int c = 0; c+1 < CompOffV.Len(); c++) {
+    TSnapDetail::GetCsrCompEcc(Graph, CompNIdxV, CompOffV[c], CompOffV[c+1], EccV, NULL, Bfs);
+  }
+}
+
+} // namespace TSnap
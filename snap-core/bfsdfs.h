@@ -31,6 +31,22 @@ template <class PGraph> double GetBfsEffDiam(const PGraph& Graph, const int& NTe
 template <class PGraph> double GetBfsEffDiam(const PGraph& Graph, const int& NTestNodes, const bool& IsDir, double& EffDiamX, int& FullDiamX, double& AvgSPLX);
 /// Use the whole graph (all edges) to measure the shortest path lengths but only report the path lengths between nodes in the SubGraphNIdV. GetBfsEffDiam4
 template <class PGraph> double GetBfsEffDiam(const PGraph& Graph, const int& NTestNodes, const TIntV& SubGraphNIdV, const bool& IsDir, double& EffDiamX, int& FullDiamX);
+/// Returns the exact diameter of a graph, the largest eccentricity over all nodes. Edge directions are ignored and
+/// the diameter of a disconnected graph is the largest diameter of its components. Uses iFUB (Crescenzi et al.), which on
+/// real graphs needs only a handful of BFS runs; BFS runs from the same fringe level are parallel. ##GetExactDiam
+template <class PGraph> int GetExactDiam(const PGraph& Graph);
+/// Returns the exact radius of a graph, the smallest eccentricity over all nodes (0 if the graph has isolated nodes).
+/// Edge directions are ignored. Uses Takes-Kosters eccentricity bounding with parallel BFS. ##GetExactRad
+template <class PGraph> int GetExactRad(const PGraph& Graph);
+/// Computes the exact eccentricity of every node, the largest distance to a node of its connected component.
+/// Edge directions are ignored. Uses Takes-Kosters eccentricity bounding with parallel BFS, see GetNodeEcc() for a single node. ##GetExactNodeEcc
+template <class PGraph> void GetExactNodeEcc(const PGraph& Graph, TIntIntH& NIdEccH);
+/// Returns the exact diameter of a CSR snapshot, see GetExactDiam().
+int GetExactDiam(const TCsrGraph& Graph);
+/// Returns the exact radius of a CSR snapshot, see GetExactRad().
+int GetExactRad(const TCsrGraph& Graph);
+/// Sets EccV[NIdx] to the exact eccentricity of every node index NIdx of a CSR snapshot, see GetExactNodeEcc().
+void GetExactNodeEcc(const TCsrGraph& Graph, TIntV& EccV);
 
 // TODO: Implement in the future
 //template <class PGraph> int GetRangeDist(const PGraph& Graph, const int& SrcNId, const int& DstNId, const bool& IsDir=false);
@@ -464,6 +480,25 @@ double GetBfsEffDiam(const PGraph& Graph, const int& NTestNodes, const TIntV& Su
   return EffDiam;                                     // average shortest path length
 }
 
+template <class PGraph>
+int GetExactDiam(const PGraph& Graph) {
+  return GetExactDiam(TCsrGraph(Graph));
+}
+
+template <class PGraph>
+int GetExactRad(const PGraph& Graph) {
+  return GetExactRad(TCsrGraph(Graph));
+}
+
+template <class PGraph>
+void GetExactNodeEcc(const PGraph& Graph, TIntIntH& NIdEccH) {
+  const TCsrGraph Csr(Graph);
+  TIntV EccV;
+  GetExactNodeEcc(Csr, EccV);
+  NIdEccH.Gen(Csr.GetNodes());
+  for (int n = 0; n < Csr.GetNodes(); n++) { NIdEccH.AddDat(Csr.GetNId(n), EccV[n]); }
+}
+
 template <class PGraph>
 int GetShortestDistances(const PGraph& Graph, const int& StartNId, const bool& FollowOut, const bool& FollowIn, TIntV& ShortestDists) {
   PSOut StdOut = TStdOut::New();
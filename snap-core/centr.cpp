@@ -1,5 +1,26 @@
 namespace TSnap {
 
+namespace TSnapDetail {
+/// Scales ValV to L2 norm 1, unless all values are 0.
+void NormalizeL2(TFltV& ValV) {
+  double Norm = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:Norm)
+  for (int i = 0; i < ValV.Len(); i++) { Norm += ValV[i]*ValV[i]; }
+  if (Norm == 0.0) { return; }
+  Norm = sqrt(Norm);
+  #pragma omp parallel for schedule(static)
+  for (int i = 0; i < ValV.Len(); i++) { ValV[i] /= Norm; }
+}
+
+/// Returns the L1 distance of equally long vectors ValV1 and ValV2.
+double GetL1Diff(const TFltV& ValV1, const TFltV& ValV2) {
+  double Diff = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:Diff)
+  for (int i = 0; i < ValV1.Len(); i++) { Diff += fabs(ValV1[i]-ValV2[i]); }
+  return Diff;
+}
+} // namespace TSnapDetail
+
 /////////////////////////////////////////////////
 // Node centrality measures
 double GetDegreeCentr(const PUNGraph& Graph, const int& NId) {
@@ -9,50 +30,66 @@ double GetDegreeCentr(const PUNGraph& Graph, const int& NId) {
 }
 
 void GetEigenVectorCentr(const PUNGraph& Graph, TIntFltH& NIdEigenH, const double& Eps, const int& MaxIter) {
-  const int NNodes = Graph->GetNodes();
-  NIdEigenH.Gen(NNodes);
-  // initialize vector values
+  const PCsrGraph CsrGraph = TCsrGraph::New(Graph);
+  TFltV EigV;
+  GetEigenVectorCentr(*CsrGraph, EigV, Eps, MaxIter);
+  NIdEigenH.Gen(Graph->GetNodes());
   for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
-    NIdEigenH.AddDat(NI.GetId(), 1.0/NNodes);
-    IAssert(NI.GetId() == NIdEigenH.GetKey(NIdEigenH.Len()-1));
-  }
-  TFltV TmpV(NNodes);
+    NIdEigenH.AddDat(NI.GetId(), EigV[CsrGraph->GetNIdx(NI.GetId())]);
+  }
+}
+
+int GetEigenVectorCentr(const TCsrGraph& Graph, TFltV& EigV, const double& Eps, const int& MaxIter, const TVec<TFlt, int64>& InWgtV) {
+  const int Nodes = Graph.GetNodes();
+  EigV.Gen(Nodes);
+  EigV.PutAll(1.0/Nodes);
+  TFltV TmpV(Nodes);
+  int Iters = 0;
+  while (Iters < MaxIter) {
+    Iters++;
+    MulCsrAdjT(Graph, EigV, TmpV, InWgtV);
+    TSnapDetail::NormalizeL2(TmpV);
+    const double Diff = TSnapDetail::GetL1Diff(EigV, TmpV);
+    EigV.Swap(TmpV);
+    if (Diff < Eps) { break; }
+  }
+  return Iters;
+}
+
+int GetKatzCentr(const TCsrGraph& Graph, TFltV& KatzV, const double& Alpha, const double& Beta, const double& Eps, const int& MaxIter, const TVec<TFlt, int64>& InWgtV) {
+  const int Nodes = Graph.GetNodes();
+  KatzV.Gen(Nodes);
+  KatzV.PutAll(Beta);
+  TFltV TmpV(Nodes);
+  int Iters = 0;
+  while (Iters < MaxIter) {
+    Iters++;
+    MulCsrAdjT(Graph, KatzV, TmpV, InWgtV);
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < Nodes; n++) { TmpV[n] = Alpha*TmpV[n] + Beta; }
+    const double Diff = TSnapDetail::GetL1Diff(KatzV, TmpV);
+    KatzV.Swap(TmpV);
+    if (Diff < Eps) { break; }
+  }
+  return Iters;
+}
+
+void GetHits(const TCsrGraph& Graph, TFltV& HubV, TFltV& AuthV, const int& MaxIter, const TVec<TFlt, int64>& OutWgtV) {
+  const int Nodes = Graph.GetNodes();
+  TVec<TFlt, int64> InWgtV;
+  if (! OutWgtV.Empty()) { GetCsrInWgtV(Graph, OutWgtV, InWgtV); }
+  HubV.Gen(Nodes);  HubV.PutAll(1.0);
+  AuthV.Gen(Nodes);  AuthV.PutAll(1.0);
   for (int iter = 0; iter < MaxIter; iter++) {
-    int j = 0;
-    // add neighbor values
-    for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++, j++) {
-      TmpV[j] = 0;
-      for (int e = 0; e < NI.GetOutDeg(); e++) {
-        TmpV[j] += NIdEigenH.GetDat(NI.GetOutNId(e)); }
-    }
-
-    // normalize
-    double sum = 0;
-    for (int i = 0; i < TmpV.Len(); i++) {
-      sum += (TmpV[i]*TmpV[i]);
-    }
-    sum = sqrt(sum);
-    for (int i = 0; i < TmpV.Len(); i++) {
-      TmpV[i] /= sum;
-    }
-
-    // compute difference
-    double diff = 0.0;
-    j = 0;
-    for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++, j++) {
-      diff += fabs(NIdEigenH.GetDat(NI.GetId())-TmpV[j]);
-    }
-
-    // set new values
-    j = 0;
-    for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++, j++) {
-      NIdEigenH.AddDat(NI.GetId(), TmpV[j]);
-    }
-
-    if (diff < Eps) {
-      break;
-    }
-  }
+    // authority scores sum hub scores of in-neighbors, hub scores sum authority scores of out-neighbors
+    MulCsrAdjT(Graph, HubV, AuthV, InWgtV);
+    TSnapDetail::NormalizeL2(AuthV);
+    MulCsrAdj(Graph, AuthV, HubV, OutWgtV);
+    TSnapDetail::NormalizeL2(HubV);
+  }
+  // make sure Hub and Authority scores normalize to L2 norm 1
+  TSnapDetail::NormalizeL2(HubV);
+  TSnapDetail::NormalizeL2(AuthV);
 }
 
 // Group centrality measures
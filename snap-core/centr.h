@@ -1,3 +1,6 @@
+/// Iteration schemes of TCsrPageRank (see TSnap::GetPageRankCsr()).
+typedef enum { prPull, prGaussSeidel, prPush } TPageRankMode;
+
 namespace TSnap {
 
 /////////////////////////////////////////////////
@@ -92,6 +95,21 @@ void GetWeightedBetweennessCentr(const PNEANet Graph, const TIntV& BtwNIdV, TInt
 /// Computes Eigenvector Centrality of all nodes in the network
 /// Eigenvector Centrality of a node N is defined recursively as the average of centrality values of N's neighbors in the network.
 void GetEigenVectorCentr(const PUNGraph& Graph, TIntFltH& NIdEigenH, const double& Eps=1e-4, const int& MaxIter=100);
+/// Computes Eigenvector Centrality of all nodes of a CSR snapshot in parallel, EigV is indexed by node index.
+/// The centrality of a node is proportional to the sum of centralities of its in-neighbors, weighted by InWgtV
+/// (arc weights aligned with GetInNbrV(), see GetCsrInWgtV()) unless it is empty. Scores have L2 norm 1.
+/// Iterates until the L1 change of scores drops below Eps, or for at most MaxIter iterations. Returns the number of iterations.
+int GetEigenVectorCentr(const TCsrGraph& Graph, TFltV& EigV, const double& Eps=1e-4, const int& MaxIter=100, const TVec<TFlt, int64>& InWgtV=TVec<TFlt, int64>());
+
+/// Katz Centrality
+/// Katz centrality of a node N is Alpha times the sum of centralities of N's in-neighbors plus Beta.
+/// Alpha must be smaller than 1/(largest eigenvalue of the adjacency matrix), otherwise the iteration diverges.
+/// For more info see: https://en.wikipedia.org/wiki/Katz_centrality
+template<class PGraph> int GetKatzCentr(const PGraph& Graph, TIntFltH& NIdKatzH, const double& Alpha=0.1, const double& Beta=1.0, const double& Eps=1e-4, const int& MaxIter=100);
+/// Computes Katz Centrality of all nodes of a CSR snapshot in parallel, KatzV is indexed by node index.
+/// In-neighbor centralities are weighted by InWgtV (arc weights aligned with GetInNbrV(), see GetCsrInWgtV()) unless it is empty.
+/// Iterates until the L1 change of scores drops below Eps, or for at most MaxIter iterations. Returns the number of iterations.
+int GetKatzCentr(const TCsrGraph& Graph, TFltV& KatzV, const double& Alpha=0.1, const double& Beta=1.0, const double& Eps=1e-4, const int& MaxIter=100, const TVec<TFlt, int64>& InWgtV=TVec<TFlt, int64>());
 
 /// PageRank
 /// For more info see: http://en.wikipedia.org/wiki/PageRank
@@ -100,6 +118,10 @@ template<class PGraph> void GetPageRank_v1(const PGraph& Graph, TIntFltH& PRankH
 #ifdef USE_OPENMP
 template<class PGraph> void GetPageRankMP(const PGraph& Graph, TIntFltH& PRankH, const double& C=0.85, const double& Eps=1e-4, const int& MaxIter=100);
 #endif
+/// PageRank computed by a parallel engine on a compressed sparse row snapshot of the Graph (TCsrPageRank).
+/// Mode selects Jacobi pull iteration, block Gauss-Seidel iteration or residual push, see TCsrPageRank.
+/// Float32 keeps the scores in single precision, which halves the memory of the score vectors.
+template<class PGraph> void GetPageRankCsr(const PGraph& Graph, TIntFltH& PRankH, const double& C=0.85, const double& Eps=1e-4, const int& MaxIter=100, const TPageRankMode& Mode=prPull, const bool& Float32=false);
 
 /// Weighted PageRank (TODO: Use template)
 int GetWeightedPageRank(const PNEANet Graph, TIntFltH& PRankH, const TStr& Attr, const double& C=0.85, const double& Eps=1e-4, const int& MaxIter=100);
@@ -113,6 +135,9 @@ template<class PGraph> void GetHits(const PGraph& Graph, TIntFltH& NIdHubH, TInt
 #ifdef USE_OPENMP
 template<class PGraph> void GetHitsMP(const PGraph& Graph, TIntFltH& NIdHubH, TIntFltH& NIdAuthH, const int& MaxIter=20);
 #endif
+/// Computes Hub and Authority scores of all nodes of a CSR snapshot in parallel, HubV and AuthV are indexed by node index.
+/// Arcs are weighted by OutWgtV (aligned with GetOutNbrV()) unless it is empty. Both score vectors have L2 norm 1.
+void GetHits(const TCsrGraph& Graph, TFltV& HubV, TFltV& AuthV, const int& MaxIter=20, const TVec<TFlt, int64>& OutWgtV=TVec<TFlt, int64>());
 
 /// Dijkstra Algorithm
 /// For more info see:  https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
@@ -522,99 +547,37 @@ void GetBetweennessCentr(const PGraph& Graph, TIntFltH& NodeBtwH, TIntPrFltH& Ed
 
 template<class PGraph>
 void GetHits(const PGraph& Graph, TIntFltH& NIdHubH, TIntFltH& NIdAuthH, const int& MaxIter) {
-  const int NNodes = Graph->GetNodes();
-  NIdHubH.Gen(NNodes);
-  NIdAuthH.Gen(NNodes);
+  const PCsrGraph CsrGraph = TCsrGraph::New(Graph);
+  TFltV HubV, AuthV;
+  GetHits(*CsrGraph, HubV, AuthV, MaxIter);
+  NIdHubH.Gen(Graph->GetNodes());
+  NIdAuthH.Gen(Graph->GetNodes());
   for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
-    NIdHubH.AddDat(NI.GetId(), 1.0);
-    NIdAuthH.AddDat(NI.GetId(), 1.0);
-  }
-  double Norm=0;
-  for (int iter = 0; iter < MaxIter; iter++) {
-    // update authority scores
-    Norm = 0;
-    for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
-      double& Auth = NIdAuthH.GetDat(NI.GetId()).Val;
-      Auth = 0;
-      for (int e = 0; e < NI.GetInDeg(); e++) {
-        Auth +=  NIdHubH.GetDat(NI.GetInNId(e)); }
-      Norm += Auth*Auth;
-    }
-    Norm = sqrt(Norm);
-    for (int i = 0; i < NIdAuthH.Len(); i++) { NIdAuthH[i] /= Norm; }
-    // update hub scores
-    for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
-      double& Hub = NIdHubH.GetDat(NI.GetId()).Val;
-      Hub = 0;
-      for (int e = 0; e < NI.GetOutDeg(); e++) {
-        Hub += NIdAuthH.GetDat(NI.GetOutNId(e)); }
-      Norm += Hub*Hub;
-    }
-    Norm = sqrt(Norm);
-    for (int i = 0; i < NIdHubH.Len(); i++) { NIdHubH[i] /= Norm; }
+    const int NIdx = CsrGraph->GetNIdx(NI.GetId());
+    NIdHubH.AddDat(NI.GetId(), HubV[NIdx]);
+    NIdAuthH.AddDat(NI.GetId(), AuthV[NIdx]);
   }
-  // make sure Hub and Authority scores normalize to L2 norm 1
-  Norm = 0.0;
-  for (int i = 0; i < NIdHubH.Len(); i++) { Norm += TMath::Sqr(NIdHubH[i]); }
-  Norm = sqrt(Norm);
-  for (int i = 0; i < NIdHubH.Len(); i++) { NIdHubH[i] /= Norm; }
-  Norm = 0.0;
-  for (int i = 0; i < NIdAuthH.Len(); i++) { Norm += TMath::Sqr(NIdAuthH[i]); }
-  Norm = sqrt(Norm);
-  for (int i = 0; i < NIdAuthH.Len(); i++) { NIdAuthH[i] /= Norm; }
 }
 
 #ifdef USE_OPENMP
+// GetHits() already runs on the parallel CSR kernels
 template<class PGraph>
 void GetHitsMP(const PGraph& Graph, TIntFltH& NIdHubH, TIntFltH& NIdAuthH, const int& MaxIter) {
-  const int NNodes = Graph->GetNodes();
-  TIntV NV;
-  NIdHubH.Gen(NNodes);
-  NIdAuthH.Gen(NNodes);
+  GetHits(Graph, NIdHubH, NIdAuthH, MaxIter);
+}
+#endif
+
+template<class PGraph>
+int GetKatzCentr(const PGraph& Graph, TIntFltH& NIdKatzH, const double& Alpha, const double& Beta, const double& Eps, const int& MaxIter) {
+  const PCsrGraph CsrGraph = TCsrGraph::New(Graph);
+  TFltV KatzV;
+  const int Iters = GetKatzCentr(*CsrGraph, KatzV, Alpha, Beta, Eps, MaxIter);
+  NIdKatzH.Gen(Graph->GetNodes());
   for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
-    NV.Add(NI.GetId());
-    NIdHubH.AddDat(NI.GetId(), 1.0);
-    NIdAuthH.AddDat(NI.GetId(), 1.0);
-  }
-  double Norm=0;
-  for (int iter = 0; iter < MaxIter; iter++) {
-    // update authority scores
-    Norm = 0;
-    #pragma omp parallel for reduction(+:Norm) schedule(dynamic,1000)
-    for (int i = 0; i < NNodes; i++) {
-      typename PGraph::TObj::TNodeI NI = Graph->GetNI(NV[i]);
-      double& Auth = NIdAuthH.GetDat(NI.GetId()).Val;
-      Auth = 0;
-      for (int e = 0; e < NI.GetInDeg(); e++) {
-        Auth +=  NIdHubH.GetDat(NI.GetInNId(e)); }
-      Norm = Norm + Auth*Auth;
-    }
-    Norm = sqrt(Norm);
-    for (int i = 0; i < NIdAuthH.Len(); i++) { NIdAuthH[i] /= Norm; }
-    // update hub scores
-    #pragma omp parallel for reduction(+:Norm) schedule(dynamic,1000)
-    for (int i = 0; i < NNodes; i++) {
-      typename PGraph::TObj::TNodeI NI = Graph->GetNI(NV[i]);
-      double& Hub = NIdHubH.GetDat(NI.GetId()).Val;
-      Hub = 0;
-      for (int e = 0; e < NI.GetOutDeg(); e++) {
-        Hub += NIdAuthH.GetDat(NI.GetOutNId(e)); }
-      Norm = Norm + Hub*Hub;
-    }
-    Norm = sqrt(Norm);
-    for (int i = 0; i < NIdHubH.Len(); i++) { NIdHubH[i] /= Norm; }
+    NIdKatzH.AddDat(NI.GetId(), KatzV[CsrGraph->GetNIdx(NI.GetId())]);
   }
-  // make sure Hub and Authority scores normalize to L2 norm 1
-  Norm = 0.0;
-  for (int i = 0; i < NIdHubH.Len(); i++) { Norm += TMath::Sqr(NIdHubH[i]); }
-  Norm = sqrt(Norm);
-  for (int i = 0; i < NIdHubH.Len(); i++) { NIdHubH[i] /= Norm; }
-  Norm = 0.0;
-  for (int i = 0; i < NIdAuthH.Len(); i++) { Norm += TMath::Sqr(NIdAuthH[i]); }
-  Norm = sqrt(Norm);
-  for (int i = 0; i < NIdAuthH.Len(); i++) { NIdAuthH[i] /= Norm; }
+  return Iters;
 }
-#endif
 
 /// Gets sequence of PageRank tables from given \c GraphSeq into \c TableSeq.
 template <class PGraph>
@@ -660,3 +623,291 @@ void MapHits(const TVec<PGraph>& GraphSeq, TVec<PTable>& TableSeq,
 
 }; // namespace TSnap
 
+/////////////////////////////////////////////////
+// PageRank on compressed sparse row snapshots
+namespace TSnap {
+namespace TSnapDetail {
+/// Atomically adds Add to Val and returns the old value.
+inline double AtomicAddFlt(TFlt& Val, const double& Add) {
+#ifdef USE_OPENMP
+  union { double Flt; int64 Int; } OldVal, NewVal;
+  do { OldVal.Flt = Val.Val;  NewVal.Flt = OldVal.Flt + Add; }
+  while (! __sync_bool_compare_and_swap((int64*) &Val.Val, OldVal.Int, NewVal.Int));
+  return OldVal.Flt;
+#else
+  const double OldVal = Val.Val;  Val.Val += Add;  return OldVal;
+#endif
+}
+/// Atomically adds Add to Val and returns the old value.
+inline double AtomicAddFlt(TSFlt& Val, const double& Add) {
+#ifdef USE_OPENMP
+  union { sdouble Flt; int Int; } OldVal, NewVal;
+  do { OldVal.Flt = Val.Val;  NewVal.Flt = sdouble(OldVal.Flt + Add); }
+  while (! __sync_bool_compare_and_swap((int*) &Val.Val, OldVal.Int, NewVal.Int));
+  return OldVal.Flt;
+#else
+  const double OldVal = Val.Val;  Val.Val = sdouble(Val.Val + Add);  return OldVal;
+#endif
+}
+/// Atomically sets Val to 0 and returns the old value.
+inline double AtomicTakeFlt(TFlt& Val) {
+#ifdef USE_OPENMP
+  union { double Flt; int64 Int; } OldVal;
+  OldVal.Int = __sync_lock_test_and_set((int64*) &Val.Val, int64(0));
+  return OldVal.Flt;
+#else
+  const double OldVal = Val.Val;  Val.Val = 0.0;  return OldVal;
+#endif
+}
+/// Atomically sets Val to 0 and returns the old value.
+inline double AtomicTakeFlt(TSFlt& Val) {
+#ifdef USE_OPENMP
+  union { sdouble Flt; int Int; } OldVal;
+  OldVal.Int = __sync_lock_test_and_set((int*) &Val.Val, 0);
+  return OldVal.Flt;
+#else
+  const double OldVal = Val.Val;  Val.Val = 0.0;  return OldVal;
+#endif
+}
+} // namespace TSnapDetail
+} // namespace TSnap
+
+//#//////////////////////////////////////////////
+/// Parallel PageRank engine on a compressed sparse row snapshot (TCsrGraph).
+/// Scores are stored as TFltType: TFlt for double precision, or TSFlt for float32 scores that take half the memory
+/// (sums are still accumulated in double). Every node keeps its precomputed inverse out-degree, and the rank of dangling
+/// nodes (nodes without out-links) is spread uniformly over all nodes, so scores match GetPageRank().
+/// Modes: prPull is a Jacobi power iteration where every node pulls the Rank/OutDeg contributions of its in-neighbors.
+/// prGaussSeidel is a block Gauss-Seidel iteration: nodes are split into contiguous blocks of GsBlockSz indices that
+/// are swept in parallel, and within a block every node already sees the new ranks of the nodes updated before it,
+/// while in-neighbors in other blocks contribute their ranks from the start of the iteration. It usually needs fewer
+/// iterations, and the scores do not depend on the number of threads. prPush pushes residual rank from active nodes to their out-neighbors and, once the residual
+/// is spread thin, only touches the few nodes whose residual still exceeds the tolerance.
+/// Time and L1 change of every iteration are kept, see GetIterTmV(), GetIterDiffV() and Dump().
+template <class TFltType>
+class TCsrPageRank {
+private:
+  enum { GsBlockSz = 4096 };        // nodes per block of Gauss-Seidel iteration
+  PCsrGraph Graph;
+  TFlt C;
+  TVec<TFltType> RankV;
+  TVec<TFltType> InvDegV;           // 1/OutDeg, 0 for dangling nodes
+  TFltV IterTmV, IterDiffV;
+private:
+  UndefDefaultCopyAssign(TCsrPageRank);
+  void Init();
+  static double GetSecs(const uint64& StartTicks) {
+    return double(TSysTm::GetPerfTimerTicks() - StartTicks) / double(TSysTm::GetPerfTimerFq()); }
+  void Normalize();
+  void RunPull(const double& Eps, const int& MaxIter, const bool& InPlace);
+  void RunPush(const double& Eps, const int& MaxIter);
+public:
+  /// Takes a CSR snapshot of Graph. C is the damping factor (probability of following a link).
+  template <class PGraph> TCsrPageRank(const PGraph& GraphPt, const double& DampC=0.85) :
+    Graph(TCsrGraph::New(GraphPt)), C(DampC), RankV(), InvDegV(), IterTmV(), IterDiffV() { Init(); }
+  TCsrPageRank(const PCsrGraph& GraphPt, const double& DampC=0.85) :
+    Graph(GraphPt), C(DampC), RankV(), InvDegV(), IterTmV(), IterDiffV() { Init(); }
+  /// Computes PageRank until the L1 change of scores in an iteration drops below Eps, or for at most MaxIter iterations.
+  /// Pull and Gauss-Seidel iterations start from the current scores (uniform after construction), push starts from scratch.
+  /// Returns the number of iterations.
+  int Run(const TPageRankMode& Mode=prPull, const double& Eps=1e-4, const int& MaxIter=100);
+  /// Returns the PageRank score of node NId.
+  double GetRank(const int& NId) const { return RankV[Graph->GetNIdx(NId)]; }
+  /// Returns PageRank scores, indexed by node index of the snapshot.
+  const TVec<TFltType>& GetRankV() const { return RankV; }
+  /// Returns PageRank scores of all nodes.
+  void GetRankH(TIntFltH& PRankH) const;
+  /// Returns the CSR snapshot.
+  const PCsrGraph& GetGraph() const { return Graph; }
+  /// Returns the number of iterations of the last Run().
+  int GetIters() const { return IterTmV.Len(); }
+  /// Returns wall-clock seconds of every iteration of the last Run().
+  const TFltV& GetIterTmV() const { return IterTmV; }
+  /// Returns the L1 change of scores in every iteration of the last Run().
+  const TFltV& GetIterDiffV() const { return IterDiffV; }
+  /// Prints time and L1 change of every iteration of the last Run().
+  void Dump() const;
+};
+
+template <class TFltType>
+void TCsrPageRank<TFltType>::Init() {
+  const int Nodes = Graph->GetNodes();
+  RankV.Gen(Nodes);
+  InvDegV.Gen(Nodes);
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) {
+    RankV[n] = 1.0/Nodes;
+    InvDegV[n] = Graph->GetOutDeg(n) > 0 ? 1.0/Graph->GetOutDeg(n) : 0.0;
+  }
+}
+
+template <class TFltType>
+void TCsrPageRank<TFltType>::Normalize() {
+  const int Nodes = Graph->GetNodes();
+  double Sum = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:Sum)
+  for (int n = 0; n < Nodes; n++) { Sum += RankV[n].Val; }
+  if (Sum <= 0.0) { return; }
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) { RankV[n] = RankV[n].Val / Sum; }
+}
+
+template <class TFltType>
+int TCsrPageRank<TFltType>::Run(const TPageRankMode& Mode, const double& Eps, const int& MaxIter) {
+  IterTmV.Clr();  IterDiffV.Clr();
+  if (Graph->GetNodes() == 0) { return 0; }
+  switch (Mode) {
+    case prPull: RunPull(Eps, MaxIter, false);  break;
+    case prGaussSeidel: RunPull(Eps, MaxIter, true);  break;
+    case prPush: RunPush(Eps, MaxIter);  break;
+    default: FailR("Unknown PageRank mode");
+  }
+  return GetIters();
+}
+
+// Berkhin, see Algorithm 1 of P. Berkhin, A Survey on PageRank Computing, Internet Mathematics, 2005
+template <class TFltType>
+void TCsrPageRank<TFltType>::RunPull(const double& Eps, const int& MaxIter, const bool& InPlace) {
+  const int Nodes = Graph->GetNodes();
+  const double Damp = C;
+  // in-place iteration keeps the contributions from the start of the iteration in ContribV, and fresh contributions
+  // of the nodes of the current block in NewContribV
+  TVec<TFltType> ContribV(Nodes), NewV(InPlace ? 0 : Nodes), NewContribV(InPlace ? Nodes : 0);
+  for (int iter = 0; iter < MaxIter; iter++) {
+    const uint64 StartTicks = TSysTm::GetPerfTimerTicks();
+    double Dangling = 0.0, Sum = 0.0, Diff = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:Dangling)
+    for (int n = 0; n < Nodes; n++) {
+      ContribV[n] = RankV[n].Val * InvDegV[n].Val;
+      if (InvDegV[n].Val == 0) { Dangling += RankV[n].Val; }
+    }
+    if (InPlace) {
+      // in-place update, contributions of nodes already updated in the same block are refreshed as we go
+      const double Leaked = (1.0 - Damp + Damp*Dangling) / double(Nodes);
+      const TVec<TInt, int64>& InNbrV = Graph->GetInNbrV();
+      const int Blocks = (Nodes - 1) / GsBlockSz + 1;
+      #pragma omp parallel for schedule(dynamic,1) reduction(+:Diff)
+      for (int b = 0; b < Blocks; b++) {
+        const int BegN = b * GsBlockSz;
+        const int EndN = TMath::Mn(BegN + GsBlockSz, Nodes);
+        for (int n = BegN; n < EndN; n++) {
+          double InSum = 0.0;
+          for (int64 e = Graph->GetInOff(n); e < Graph->GetInOff(n+1); e++) {
+            const int u = InNbrV[e];
+            InSum += (u >= BegN && u < n) ? NewContribV[u].Val : ContribV[u].Val;
+          }
+          const double NewVal = Damp*InSum + Leaked;
+          Diff += fabs(NewVal - RankV[n].Val);
+          RankV[n] = NewVal;
+          NewContribV[n] = NewVal * InvDegV[n].Val;
+        }
+      }
+      Normalize();
+    } else {
+      TSnap::MulCsrAdjT(*Graph, ContribV, NewV);
+      #pragma omp parallel for schedule(static) reduction(+:Sum)
+      for (int n = 0; n < Nodes; n++) { Sum += NewV[n].Val; }
+      const double Leaked = (1.0-Damp*Sum) / double(Nodes);
+      #pragma omp parallel for schedule(static) reduction(+:Diff)
+      for (int n = 0; n < Nodes; n++) {
+        const double NewVal = Damp*NewV[n].Val + Leaked;
+        Diff += fabs(NewVal - RankV[n].Val);
+        RankV[n] = NewVal;
+      }
+    }
+    IterTmV.Add(GetSecs(StartTicks));
+    IterDiffV.Add(Diff);
+    if (Diff < Eps) { break; }
+  }
+}
+
+// Residual rank is pushed from nodes whose residual is above Eps*(1-C)/N, so the remaining residual
+// (and the L1 error of the scores) is below Eps when no such node is left.
+template <class TFltType>
+void TCsrPageRank<TFltType>::RunPush(const double& Eps, const int& MaxIter) {
+  const int Nodes = Graph->GetNodes();
+  const double Damp = C, Tol = Eps*(1.0-Damp) / double(Nodes);
+  TVec<TFltType> ResidV(Nodes);
+  TIntV ActiveV(Nodes, 0), NextV(Nodes, 0), InNextV(Nodes);
+  for (int n = 0; n < Nodes; n++) {
+    RankV[n] = 0.0;  ResidV[n] = (1.0-Damp) / double(Nodes);  ActiveV.Add(n);
+  }
+  double Uniform = 0.0;   // dangling rank not spread yet
+  for (int iter = 0; iter < MaxIter && ! ActiveV.Empty(); iter++) {
+    const uint64 StartTicks = TSysTm::GetPerfTimerTicks();
+    double Dangling = 0.0, Diff = 0.0;
+    NextV.Clr(false);
+    #pragma omp parallel for schedule(dynamic,1000) reduction(+:Dangling,Diff)
+    for (int i = 0; i < ActiveV.Len(); i++) {
+      const int n = ActiveV[i];
+      const double Resid = TSnap::TSnapDetail::AtomicTakeFlt(ResidV[n]);
+      RankV[n] = RankV[n].Val + Resid;
+      Diff += Resid;
+      if (InvDegV[n].Val == 0) { Dangling += Damp*Resid;  continue; }
+      const double Push = Damp*Resid*InvDegV[n].Val;
+      const int64 Off = Graph->GetOutOff(n);
+      for (int e = 0; e < Graph->GetOutDeg(n); e++) {
+        const int Nbr = Graph->GetOutNbrV()[Off+e];
+        const double OldVal = TSnap::TSnapDetail::AtomicAddFlt(ResidV[Nbr], Push);
+        if (OldVal < Tol && OldVal+Push >= Tol && InNextV[Nbr] == 0) {
+#ifdef USE_OPENMP
+          if (__sync_bool_compare_and_swap(&InNextV[Nbr].Val, 0, 1)) { NextV.AddMP(Nbr); }
+#else
+          InNextV[Nbr] = 1;  NextV.Add(Nbr);
+#endif
+        }
+      }
+    }
+    // spread the dangling rank over all nodes once it is large enough to matter
+    Uniform += Dangling;
+    if (Uniform >= Eps*(1.0-Damp)) {
+      const double Add = Uniform / double(Nodes);
+      Uniform = 0.0;
+      #pragma omp parallel for schedule(static)
+      for (int n = 0; n < Nodes; n++) { ResidV[n] = ResidV[n].Val + Add; }
+      for (int n = 0; n < Nodes; n++) {
+        if (ResidV[n].Val >= Tol && InNextV[n] == 0) { InNextV[n] = 1;  NextV.Add(n); }
+      }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < NextV.Len(); i++) { InNextV[NextV[i]] = 0; }
+    ActiveV.Swap(NextV);
+    IterTmV.Add(GetSecs(StartTicks));
+    IterDiffV.Add(Diff);
+  }
+  Normalize();
+}
+
+template <class TFltType>
+void TCsrPageRank<TFltType>::GetRankH(TIntFltH& PRankH) const {
+  PRankH.Gen(Graph->GetNodes());
+  for (int n = 0; n < Graph->GetNodes(); n++) {
+    PRankH.AddDat(Graph->GetNId(n), RankV[n].Val); }
+}
+
+template <class TFltType>
+void TCsrPageRank<TFltType>::Dump() const {
+  double AllSecs = 0.0;
+  for (int i = 0; i < IterTmV.Len(); i++) {
+    printf("  iter %d: %.4fs  L1 change %g\n", i+1, IterTmV[i].Val, IterDiffV[i].Val);
+    AllSecs += IterTmV[i];
+  }
+  printf("PageRank: %d nodes, %d iterations, %.4fs\n", Graph->GetNodes(), IterTmV.Len(), AllSecs);
+}
+
+namespace TSnap {
+
+template<class PGraph>
+void GetPageRankCsr(const PGraph& Graph, TIntFltH& PRankH, const double& C, const double& Eps, const int& MaxIter, const TPageRankMode& Mode, const bool& Float32) {
+  if (Float32) {
+    TCsrPageRank<TSFlt> PageRank(Graph, C);
+    PageRank.Run(Mode, Eps, MaxIter);
+    PageRank.GetRankH(PRankH);
+  } else {
+    TCsrPageRank<TFlt> PageRank(Graph, C);
+    PageRank.Run(Mode, Eps, MaxIter);
+    PageRank.GetRankH(PRankH);
+  }
+}
+
+} // namespace TSnap
@@ -1448,4 +1448,578 @@ double CommunityCNM(const PUNGraph& Graph, TCnComV& CmtyV) {
   return TSnapDetail::TCNMQMatrix::CmtyCMN(Graph, CmtyV);
 }
 
+/////////////////////////////////////////////////
+// Louvain and Leiden modularity optimization
+namespace TSnapDetail {
+
+inline void CmtyAtomicAdd(TInt64& Val, const int64& Delta) {
+#ifdef USE_OPENMP
+  __sync_fetch_and_add(&Val.Val, Delta);
+#else
+  Val.Val += Delta;
+#endif
+}
+
+inline void CmtyAtomicAdd(TInt& Val, const int& Delta) {
+#ifdef USE_OPENMP
+  __sync_fetch_and_add(&Val.Val, Delta);
+#else
+  Val.Val += Delta;
+#endif
+}
+
+// Adds Delta to Val unless Val is 0, returns false if Val was 0.
+inline bool CmtyAtomicAddNonZero(TInt& Val, const int& Delta) {
+#ifdef USE_OPENMP
+  while (true) {
+    const int OldVal = Val.Val;
+    if (OldVal == 0) { return false; }
+    if (__sync_bool_compare_and_swap(&Val.Val, OldVal, OldVal+Delta)) { return true; }
+  }
+#else
+  if (Val.Val == 0) { return false; }
+  Val.Val += Delta;  return true;
+#endif
+}
+
+// Sets Val to NewVal if it equals OldVal.
+inline bool CmtyAtomicCas(TInt& Val, const int& OldVal, const int& NewVal) {
+#ifdef USE_OPENMP
+  return __sync_bool_compare_and_swap(&Val.Val, OldVal, NewVal);
+#else
+  if (Val.Val != OldVal) { return false; }
+  Val.Val = NewVal;  return true;
+#endif
+}
+
+// Renumbers community ids to 0...K-1 in the order of their first appearance, returns K.
+int RenumberCmtyV(TIntV& CmtyV) {
+  TIntV IdV(CmtyV.Len());
+  IdV.PutAll(-1);
+  int Cmtys = 0;
+  for (int n = 0; n < CmtyV.Len(); n++) {
+    if (IdV[CmtyV[n]] == -1) { IdV[CmtyV[n]] = Cmtys++; }
+    CmtyV[n] = IdV[CmtyV[n]];
+  }
+  return Cmtys;
+}
+
+/// Weighted undirected graph over dense node indices used by Louvain and Leiden.
+/// Every edge is stored as two arcs, a self-loop of weight W adds W to the degree of its node.
+class TModGraph {
+public:
+  TVec<TInt64> OffV;            // node index -> position of its first arc
+  TVec<TInt, int64> NbrV;       // arc -> neighbor node index
+  TVec<TInt64, int64> WgtV;     // arc -> weight
+  TVec<TInt64> DegV;            // node index -> weighted degree
+  int64 TotWgt;                 // sum of all weighted degrees (2m)
+public:
+  TModGraph() : OffV(), NbrV(), WgtV(), DegV(), TotWgt(0) { }
+  TModGraph(const TCsrGraph& Graph);
+  int GetNodes() const { return OffV.Len()-1; }
+  void Swap(TModGraph& Graph);
+  void Aggregate(const TModGraph& Graph, const TIntV& AggV, const int& Aggs);
+  int64 MoveNodes(TIntV& CmtyV, const double& Resolution) const;
+  void Refine(const TIntV& CmtyV, TIntV& RefV, const double& Resolution) const;
+};
+
+TModGraph::TModGraph(const TCsrGraph& Graph) : OffV(Graph.GetOutOffV()), NbrV(Graph.GetOutNbrV()), WgtV(), DegV(), TotWgt(0) {
+  IAssertR(! Graph.IsDir(), "Modularity optimization requires an undirected graph");
+  const int Nodes = Graph.GetNodes();
+  WgtV.Gen(NbrV.Len());
+  WgtV.PutAll(1);
+  DegV.Gen(Nodes);
+  for (int n = 0; n < Nodes; n++) {
+    DegV[n] = Graph.GetOutDeg(n);
+    TotWgt += DegV[n];
+  }
+}
+
+void TModGraph::Swap(TModGraph& Graph) {
+  OffV.Swap(Graph.OffV);  NbrV.Swap(Graph.NbrV);
+  WgtV.Swap(Graph.WgtV);  DegV.Swap(Graph.DegV);
+  const int64 Tmp = TotWgt;  TotWgt = Graph.TotWgt;  Graph.TotWgt = Tmp;
+}
+
+// Collapses nodes of Graph with the same AggV id into a single node, parallel edges are merged by summing their weights
+void TModGraph::Aggregate(const TModGraph& Graph, const TIntV& AggV, const int& Aggs) {
+  const int Nodes = Graph.GetNodes();
+  // members of each aggregate (counting sort)
+  TIntV MembOffV(Aggs+1), MembV(Nodes);
+  for (int n = 0; n < Nodes; n++) { MembOffV[AggV[n]+1].Val++; }
+  for (int a = 0; a < Aggs; a++) { MembOffV[a+1] += MembOffV[a]; }
+  { TIntV FillV(MembOffV);
+  for (int n = 0; n < Nodes; n++) { MembV[FillV[AggV[n]].Val++] = n; } }
+  // pass 1 counts distinct neighboring aggregates, pass 2 fills the arcs
+  OffV.Gen(Aggs+1);
+  DegV.Gen(Aggs);
+  TotWgt = Graph.TotWgt;
+  for (int Pass = 1; Pass <= 2; Pass++) {
+    if (Pass == 2) {
+      for (int a = 0; a < Aggs; a++) { OffV[a+1] += OffV[a]; }
+      NbrV.Gen(OffV[Aggs]);  WgtV.Gen(OffV[Aggs]);
+    }
+    #pragma omp parallel
+    {
+    TVec<TInt64> AccV(Aggs);
+    TIntV TouchV;
+    #pragma omp for schedule(dynamic,1000)
+    for (int a = 0; a < Aggs; a++) {
+      int64 Deg = 0;
+      for (int m = MembOffV[a]; m < MembOffV[a+1]; m++) {
+        const int n = MembV[m];
+        Deg += Graph.DegV[n];
+        for (int64 e = Graph.OffV[n]; e < Graph.OffV[n+1]; e++) {
+          const int Nbr = AggV[Graph.NbrV[e]];
+          if (AccV[Nbr] == 0) { TouchV.Add(Nbr); }
+          AccV[Nbr] += Graph.WgtV[e];
+        }
+      }
+      if (Pass == 1) {
+        OffV[a+1] = TouchV.Len();
+        DegV[a] = Deg;
+      } else {
+        int64 Off = OffV[a];
+        for (int i = 0; i < TouchV.Len(); i++) {
+          NbrV[Off] = TouchV[i];  WgtV[Off] = AccV[TouchV[i]];  Off++;
+        }
+      }
+      for (int i = 0; i < TouchV.Len(); i++) { AccV[TouchV[i]] = 0; }
+      TouchV.Clr(false);
+    }
+    }
+  }
+}
+
+// Local moving phase: nodes are processed in parallel and each one moves to the neighboring community with
+// the largest gain in modularity, until almost no node moves. Returns the number of moves.
+int64 TModGraph::MoveNodes(TIntV& CmtyV, const double& Resolution) const {
+  const int Nodes = GetNodes();
+  const int MxRounds = 100;
+  const double MnMoveFrac = 1e-3;
+  TVec<TInt64> CmtyTotV(Nodes);
+  TIntV CmtySzV(Nodes);
+  for (int n = 0; n < Nodes; n++) {
+    CmtyTotV[CmtyV[n]] += DegV[n];  CmtySzV[CmtyV[n]].Val++; }
+  const double Scale = TotWgt > 0 ? Resolution / double(TotWgt) : 0.0;
+  int64 AllMoves = 0;
+  // community weights of each thread, allocated once by the thread itself and kept zero between nodes
+#ifdef USE_OPENMP
+  TVec<TVec<TInt64> > AccVV(omp_get_max_threads());
+  TVec<TIntV> TouchVV(omp_get_max_threads());
+#else
+  TVec<TVec<TInt64> > AccVV(1);
+  TVec<TIntV> TouchVV(1);
+#endif
+  for (int Round = 0; Round < MxRounds; Round++) {
+    int64 Moves = 0;
+    #pragma omp parallel reduction(+:Moves)
+    {
+#ifdef USE_OPENMP
+    const int ThreadN = omp_get_thread_num();
+#else
+    const int ThreadN = 0;
+#endif
+    TVec<TInt64>& AccV = AccVV[ThreadN];
+    TIntV& TouchV = TouchVV[ThreadN];
+    if (AccV.Len() != Nodes) { AccV.Gen(Nodes); }
+    #pragma omp for schedule(dynamic,1000)
+    for (int n = 0; n < Nodes; n++) {
+      const int OldCmty = CmtyV[n];
+      for (int64 e = OffV[n]; e < OffV[n+1]; e++) {
+        const int Nbr = NbrV[e];
+        if (Nbr == n) { continue; }
+        const int Cmty = CmtyV[Nbr];
+        if (AccV[Cmty] == 0) { TouchV.Add(Cmty); }
+        AccV[Cmty] += WgtV[e];
+      }
+      // gain of joining a community, relative to being alone
+      const double Deg = double(DegV[n]);
+      int BestCmty = OldCmty;
+      double BestGain = double(AccV[OldCmty]) - Scale*Deg*double(CmtyTotV[OldCmty]-DegV[n]);
+      for (int i = 0; i < TouchV.Len(); i++) {
+        const int Cmty = TouchV[i];
+        if (Cmty == OldCmty) { continue; }
+        const double Gain = double(AccV[Cmty]) - Scale*Deg*double(CmtyTotV[Cmty]);
+        if (Gain > BestGain || (Gain == BestGain && Cmty < BestCmty)) { BestGain = Gain;  BestCmty = Cmty; }
+      }
+      for (int i = 0; i < TouchV.Len(); i++) { AccV[TouchV[i]] = 0; }
+      TouchV.Clr(false);
+      // two singletons would only swap communities, let just one of them move
+      if (BestCmty == OldCmty || (CmtySzV[OldCmty] == 1 && CmtySzV[BestCmty] == 1 && BestCmty > OldCmty)) { continue; }
+      CmtyAtomicAdd(CmtyTotV[OldCmty], -DegV[n]);  CmtyAtomicAdd(CmtySzV[OldCmty], -1);
+      CmtyAtomicAdd(CmtyTotV[BestCmty], DegV[n]);  CmtyAtomicAdd(CmtySzV[BestCmty], 1);
+      CmtyV[n] = BestCmty;
+      Moves++;
+    }
+    }
+    AllMoves += Moves;
+    if (Moves <= MnMoveFrac * Nodes) { break; }
+  }
+  return AllMoves;
+}
+
+// Leiden refinement phase: starting from singletons, nodes merge only with refined communities inside
+// their own community CmtyV, and only when both are well connected to the rest of that community.
+void TModGraph::Refine(const TIntV& CmtyV, TIntV& RefV, const double& Resolution) const {
+  const int Nodes = GetNodes();
+  const double Scale = TotWgt > 0 ? Resolution / double(TotWgt) : 0.0;
+  TVec<TInt64> CmtyTotV(Nodes), RefTotV(Nodes), RefExtV(Nodes);
+  TIntV RefSzV(Nodes);
+  RefV.Gen(Nodes);
+  for (int n = 0; n < Nodes; n++) { CmtyTotV[CmtyV[n]] += DegV[n]; }
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    RefV[n] = n;  RefTotV[n] = DegV[n];  RefSzV[n] = 1;
+    for (int64 e = OffV[n]; e < OffV[n+1]; e++) {
+      if (NbrV[e] != n && CmtyV[NbrV[e]] == CmtyV[n]) { RefExtV[n] += WgtV[e]; }
+    }
+  }
+  #pragma omp parallel
+  {
+  TVec<TInt64> AccV(Nodes);
+  TIntV TouchV;
+  #pragma omp for schedule(dynamic,1000)
+  for (int n = 0; n < Nodes; n++) {
+    const int Cmty = CmtyV[n];
+    const double Deg = double(DegV[n]);
+    // only singletons move, and only when well connected to their community
+    if (RefSzV[n] != 1 || RefV[n] != n) { continue; }
+    const int64 CmtyDeg = CmtyTotV[Cmty];
+    if (double(RefExtV[n]) < Scale*Deg*double(CmtyDeg-DegV[n])) { continue; }
+    for (int64 e = OffV[n]; e < OffV[n+1]; e++) {
+      const int Nbr = NbrV[e];
+      if (Nbr == n || CmtyV[Nbr] != Cmty) { continue; }
+      const int Ref = RefV[Nbr];
+      if (AccV[Ref] == 0) { TouchV.Add(Ref); }
+      AccV[Ref] += WgtV[e];
+    }
+    int BestRef = -1;
+    double BestGain = 0.0;
+    for (int i = 0; i < TouchV.Len(); i++) {
+      const int Ref = TouchV[i];
+      if (Ref == n) { continue; }
+      const double RefTot = double(RefTotV[Ref]);
+      if (double(RefExtV[Ref]) < Scale*RefTot*(double(CmtyDeg)-RefTot)) { continue; }
+      const double Gain = double(AccV[Ref]) - Scale*Deg*RefTot;
+      if (Gain > BestGain || (Gain == BestGain && BestRef != -1 && Ref < BestRef)) { BestGain = Gain;  BestRef = Ref; }
+    }
+    const int64 RefWgt = BestRef == -1 ? 0 : AccV[BestRef].Val;
+    for (int i = 0; i < TouchV.Len(); i++) { AccV[TouchV[i]] = 0; }
+    TouchV.Clr(false);
+    if (BestRef == -1) { continue; }
+    // leave the singleton (fails if some node just joined it), then join the target (fails if it just emptied)
+    if (! CmtyAtomicCas(RefSzV[n], 1, 0)) { continue; }
+    if (! CmtyAtomicAddNonZero(RefSzV[BestRef], 1)) { RefSzV[n] = 1;  continue; }
+    CmtyAtomicAdd(RefTotV[n], -DegV[n]);
+    CmtyAtomicAdd(RefTotV[BestRef], DegV[n]);
+    CmtyAtomicAdd(RefExtV[BestRef], RefExtV[n] - 2*RefWgt);
+    RefV[n] = BestRef;
+  }
+  }
+}
+
+// Splits communities into their connected components, returns the new number of communities.
+int SplitCmtyV(const TCsrGraph& Graph, TIntV& CmtyV) {
+  const int Nodes = Graph.GetNodes();
+  TIntV SplitV(Nodes), QueueV(Nodes, 0);
+  SplitV.PutAll(-1);
+  int Cmtys = 0;
+  for (int n = 0; n < Nodes; n++) {
+    if (SplitV[n] != -1) { continue; }
+    SplitV[n] = Cmtys;
+    QueueV.Clr(false);  QueueV.Add(n);
+    for (int q = 0; q < QueueV.Len(); q++) {
+      const int NIdx = QueueV[q];
+      for (int e = 0; e < Graph.GetOutDeg(NIdx); e++) {
+        const int Nbr = Graph.GetOutNbr(NIdx, e);
+        if (SplitV[Nbr] == -1 && CmtyV[Nbr] == CmtyV[n]) { SplitV[Nbr] = Cmtys;  QueueV.Add(Nbr); }
+      }
+    }
+    Cmtys++;
+  }
+  CmtyV.Swap(SplitV);
+  return Cmtys;
+}
+
+// Returns the modularity of communities CmtyV, computed the same way as GetModularity().
+double GetCsrModularity(const TCsrGraph& Graph, const TIntV& CmtyV, const int& Cmtys) {
+  const int Nodes = Graph.GetNodes();
+  TFltV InV(Cmtys), DegV(Cmtys);
+  int64 SelfLoops = 0;
+  for (int n = 0; n < Nodes; n++) {
+    const int Cmty = CmtyV[n];
+    DegV[Cmty] += Graph.GetOutDeg(n);
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+      const int Nbr = Graph.GetOutNbr(n, e);
+      if (CmtyV[Nbr] == Cmty) { InV[Cmty] += 1; }
+      if (Nbr == n) { SelfLoops++; }
+    }
+  }
+  const double Edges2 = double(Graph.GetArcs() + SelfLoops);
+  if (Edges2 == 0) { return 0.0; }
+  double Q = 0.0;
+  for (int c = 0; c < Cmtys; c++) {
+    Q += (InV[c] - DegV[c]*DegV[c]/Edges2) / Edges2; }
+  return Q;
+}
+
+// Converts dense community ids of nodes into communities of node ids, largest first.
+void GetCsrCmtyV(const TCsrGraph& Graph, const TIntV& CmtyIdV, const int& Cmtys, TCnComV& CmtyV) {
+  TIntPrV CmtyNIdxV(Graph.GetNodes(), 0);
+  for (int n = 0; n < Graph.GetNodes(); n++) { CmtyNIdxV.Add(TIntPr(CmtyIdV[n], n)); }
+  CmtyNIdxV.Sort();
+  CmtyV.Gen(Cmtys);
+  for (int i = 0; i < CmtyNIdxV.Len(); i++) {
+    CmtyV[CmtyNIdxV[i].Val1].Add(Graph.GetNId(CmtyNIdxV[i].Val2)); }
+  CmtyV.Sort(false);
+}
+
+double CommunityModularity(const PUNGraph& Graph, TCnComV& CmtyV, const double& Resolution, const bool& Refine) {
+  const TCsrGraph Csr(Graph);
+  TIntV CmtyIdV;
+  const int Cmtys = GetModularityCmtyIdV(Csr, CmtyIdV, Resolution, Refine);
+  GetCsrCmtyV(Csr, CmtyIdV, Cmtys, CmtyV);
+  return GetCsrModularity(Csr, CmtyIdV, Cmtys);
+}
+
+} // namespace TSnapDetail
+
+int GetModularityCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const double& Resolution, const bool& Refine) {
+  const int Nodes = Graph.GetNodes();
+  TSnapDetail::TModGraph ModGraph(Graph), AggGraph;
+  TIntV NodeAggV(Nodes), CmtyV(Nodes), RefV;
+  for (int n = 0; n < Nodes; n++) { NodeAggV[n] = n;  CmtyV[n] = n; }
+  while (true) {
+    ModGraph.MoveNodes(CmtyV, Resolution);
+    TSnapDetail::RenumberCmtyV(CmtyV);
+    // Louvain aggregates the communities, Leiden the refined (well connected) communities
+    if (Refine) { ModGraph.Refine(CmtyV, RefV, Resolution); } else { RefV = CmtyV; }
+    const int Aggs = TSnapDetail::RenumberCmtyV(RefV);
+    if (Aggs == ModGraph.GetNodes()) { break; }
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < Nodes; n++) { NodeAggV[n] = RefV[NodeAggV[n]]; }
+    AggGraph.Aggregate(ModGraph, RefV, Aggs);
+    // aggregate nodes start in the community of their members
+    TIntV AggCmtyV(Aggs);
+    for (int n = 0; n < ModGraph.GetNodes(); n++) { AggCmtyV[RefV[n]] = CmtyV[n]; }
+    CmtyV.Swap(AggCmtyV);
+    ModGraph.Swap(AggGraph);
+  }
+  CmtyIdV.Gen(Nodes);
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) { CmtyIdV[n] = CmtyV[NodeAggV[n]]; }
+  // the last local moving phase can still disconnect a community, splitting it only increases modularity
+  if (Refine) { return TSnapDetail::SplitCmtyV(Graph, CmtyIdV); }
+  return TSnapDetail::RenumberCmtyV(CmtyIdV);
+}
+
+double CommunityLouvain(const PUNGraph& Graph, TCnComV& CmtyV, const double& Resolution) {
+  return TSnapDetail::CommunityModularity(Graph, CmtyV, Resolution, false);
+}
+
+double CommunityLeiden(const PUNGraph& Graph, TCnComV& CmtyV, const double& Resolution) {
+  return TSnapDetail::CommunityModularity(Graph, CmtyV, Resolution, true);
+}
+
+/////////////////////////////////////////////////
+// Label propagation
+namespace TSnapDetail {
+
+// Greedy parallel coloring: nodes pick the smallest color unused by their neighbors,
+// conflicting neighbors (same color) are recolored in the next round. Returns the number of colors.
+int GetNodeColorV(const TCsrGraph& Graph, TIntV& ColorV) {
+  const int Nodes = Graph.GetNodes();
+  int MxDeg = 0;
+  for (int n = 0; n < Nodes; n++) { MxDeg = TMath::Mx(MxDeg, Graph.GetOutDeg(n)); }
+  ColorV.Gen(Nodes);
+  ColorV.PutAll(-1);
+  TIntV WorkV(Nodes), ConflictV(Nodes);
+  for (int n = 0; n < Nodes; n++) { WorkV[n] = n; }
+  while (! WorkV.Empty()) {
+    #pragma omp parallel
+    {
+    TIntV StampV(MxDeg+2);
+    StampV.PutAll(-1);
+    #pragma omp for schedule(dynamic,1000)
+    for (int w = 0; w < WorkV.Len(); w++) {
+      const int n = WorkV[w];
+      for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+        const int Color = ColorV[Graph.GetOutNbr(n, e)];
+        if (Color != -1 && Color <= MxDeg) { StampV[Color] = n; }
+      }
+      int Color = 0;
+      while (StampV[Color] == n) { Color++; }
+      ColorV[n] = Color;
+    }
+    }
+    #pragma omp parallel for schedule(dynamic,1000)
+    for (int w = 0; w < WorkV.Len(); w++) {
+      const int n = WorkV[w];
+      ConflictV[n] = 0;
+      for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+        const int Nbr = Graph.GetOutNbr(n, e);
+        if (Nbr < n && ColorV[Nbr] == ColorV[n]) { ConflictV[n] = 1;  break; }
+      }
+    }
+    int Conflicts = 0;
+    for (int w = 0; w < WorkV.Len(); w++) {
+      if (ConflictV[WorkV[w]]) { WorkV[Conflicts++] = WorkV[w]; } }
+    WorkV.Trunc(Conflicts);
+  }
+  int Colors = 0;
+  for (int n = 0; n < Nodes; n++) { Colors = TMath::Mx(Colors, ColorV[n]+1); }
+  return Colors;
+}
+
+// Pseudo-random priority used to break ties among equally frequent labels.
+inline uint GetLabelPri(const int& Label, const int& Sweep) {
+  uint Hash = uint(Label) * 2654435761u + uint(Sweep) * 40503u;
+  Hash ^= Hash >> 16;  Hash *= 0x85ebca6bu;  Hash ^= Hash >> 13;
+  return Hash;
+}
+
+// Label propagation from the labels CmtyIdV, the first sweep visits the nodes with ActiveV[NIdx]=1.
+// Stops when at most StopFrac of the nodes active in the first sweep change their label.
+int GetLabelPropCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, TIntV& ActiveV, const double& StopFrac, const int& MxIter) {
+  const int Nodes = Graph.GetNodes();
+  IAssert(CmtyIdV.Len() == Nodes);
+  // nodes of the same color are not adjacent, so each color class can be updated in parallel
+  TIntV ColorV, ColorOffV, ColorNIdxV(Nodes);
+  const int Colors = GetNodeColorV(Graph, ColorV);
+  ColorOffV.Gen(Colors+1);
+  for (int n = 0; n < Nodes; n++) { ColorOffV[ColorV[n]+1].Val++; }
+  for (int c = 0; c < Colors; c++) { ColorOffV[c+1] += ColorOffV[c]; }
+  { TIntV FillV(ColorOffV);
+  for (int n = 0; n < Nodes; n++) { ColorNIdxV[FillV[ColorV[n]].Val++] = n; } }
+  // after the first sweep only nodes with a neighbor that changed its label are revisited
+  TIntV NextActiveV(Nodes);
+  int Active = 0;
+  for (int n = 0; n < Nodes; n++) { Active += ActiveV[n]; }
+  // label counters of each thread, allocated once by the thread itself and kept zero between nodes
+#ifdef USE_OPENMP
+  TVec<TIntV> CntVV(omp_get_max_threads()), TouchVV(omp_get_max_threads());
+#else
+  TVec<TIntV> CntVV(1), TouchVV(1);
+#endif
+  for (int Sweep = 0; Sweep < MxIter; Sweep++) {
+    int Changes = 0;
+    for (int c = 0; c < Colors; c++) {
+      #pragma omp parallel reduction(+:Changes)
+      {
+#ifdef USE_OPENMP
+      const int ThreadN = omp_get_thread_num();
+#else
+      const int ThreadN = 0;
+#endif
+      TIntV& CntV = CntVV[ThreadN];
+      TIntV& TouchV = TouchVV[ThreadN];
+      if (CntV.Len() != Nodes) { CntV.Gen(Nodes); }
+      #pragma omp for schedule(dynamic,1000)
+      for (int i = ColorOffV[c]; i < ColorOffV[c+1]; i++) {
+        const int n = ColorNIdxV[i];
+        if (! ActiveV[n]) { continue; }
+        for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+          const int Nbr = Graph.GetOutNbr(n, e);
+          if (Nbr == n) { continue; }
+          const int Label = CmtyIdV[Nbr];
+          if (CntV[Label] == 0) { TouchV.Add(Label); }
+          CntV[Label].Val++;
+        }
+        // keep the current label when it is among the most frequent ones
+        const int OldLabel = CmtyIdV[n];
+        int BestLabel = OldLabel, BestCnt = CntV[OldLabel];
+        uint BestPri = 0;
+        for (int t = 0; t < TouchV.Len(); t++) {
+          const int Label = TouchV[t];
+          if (CntV[Label] < BestCnt || Label == OldLabel) { continue; }
+          const uint Pri = GetLabelPri(Label, Sweep);
+          if (CntV[Label] > BestCnt || (BestLabel != OldLabel && Pri < BestPri)) {
+            BestCnt = CntV[Label];  BestLabel = Label;  BestPri = Pri; }
+        }
+        for (int t = 0; t < TouchV.Len(); t++) { CntV[TouchV[t]] = 0; }
+        TouchV.Clr(false);
+        if (BestLabel == OldLabel) { continue; }
+        CmtyIdV[n] = BestLabel;
+        Changes++;
+        for (int e = 0; e < Graph.GetOutDeg(n); e++) { NextActiveV[Graph.GetOutNbr(n, e)] = 1; }
+      }
+      }
+    }
+    if (Changes <= StopFrac * Active) { break; }
+    ActiveV.Swap(NextActiveV);
+    NextActiveV.PutAll(0);
+  }
+  return RenumberCmtyV(CmtyIdV);
+}
+
+double CommunityLabelProp(const PUNGraph& Graph, const TCnComV& SeedCmtyV, const TIntV& ChangedNIdV, TCnComV& CmtyV, const bool& Seeded, const double& StopFrac, const int& MxIter) {
+  const TCsrGraph Csr(Graph);
+  TIntV CmtyIdV;
+  int Cmtys;
+  if (Seeded) {
+    // nodes not in SeedCmtyV start alone and are revisited with the changed nodes
+    CmtyIdV.Gen(Csr.GetNodes());
+    CmtyIdV.PutAll(-1);
+    for (int c = 0; c < SeedCmtyV.Len(); c++) {
+      int Label = -1;
+      for (int i = 0; i < SeedCmtyV[c].Len(); i++) {
+        if (! Csr.IsNode(SeedCmtyV[c][i])) { continue; }
+        const int NIdx = Csr.GetNIdx(SeedCmtyV[c][i]);
+        if (Label == -1) { Label = NIdx; }
+        CmtyIdV[NIdx] = Label;
+      }
+    }
+    TIntV ChangedNIdxV;
+    for (int n = 0; n < Csr.GetNodes(); n++) {
+      if (CmtyIdV[n] == -1) { CmtyIdV[n] = n;  ChangedNIdxV.Add(n); }
+    }
+    for (int i = 0; i < ChangedNIdV.Len(); i++) {
+      if (Csr.IsNode(ChangedNIdV[i])) { ChangedNIdxV.Add(Csr.GetNIdx(ChangedNIdV[i])); }
+    }
+    Cmtys = TSnap::GetLabelPropCmtyIdV(Csr, CmtyIdV, ChangedNIdxV, StopFrac, MxIter);
+  } else {
+    Cmtys = TSnap::GetLabelPropCmtyIdV(Csr, CmtyIdV, false, StopFrac, MxIter);
+  }
+  GetCsrCmtyV(Csr, CmtyIdV, Cmtys, CmtyV);
+  return GetCsrModularity(Csr, CmtyIdV, Cmtys);
+}
+
+} // namespace TSnapDetail
+
+int GetLabelPropCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const bool& Seeded, const double& StopFrac, const int& MxIter) {
+  IAssertR(! Graph.IsDir(), "Label propagation requires an undirected graph");
+  const int Nodes = Graph.GetNodes();
+  if (! Seeded) {
+    CmtyIdV.Gen(Nodes);
+    for (int n = 0; n < Nodes; n++) { CmtyIdV[n] = n; }
+  }
+  IAssert(CmtyIdV.Len() == Nodes);
+  TIntV ActiveV(Nodes);
+  ActiveV.PutAll(1);
+  return TSnapDetail::GetLabelPropCmtyIdV(Graph, CmtyIdV, ActiveV, StopFrac, MxIter);
+}
+
+int GetLabelPropCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const TIntV& ChangedNIdxV, const double& StopFrac, const int& MxIter) {
+  IAssertR(! Graph.IsDir(), "Label propagation requires an undirected graph");
+  const int Nodes = Graph.GetNodes();
+  IAssert(CmtyIdV.Len() == Nodes);
+  // only the changed nodes and their neighbors can get a different label in the first sweep
+  TIntV ActiveV(Nodes);
+  for (int i = 0; i < ChangedNIdxV.Len(); i++) {
+    const int n = ChangedNIdxV[i];
+    ActiveV[n] = 1;
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) { ActiveV[Graph.GetOutNbr(n, e)] = 1; }
+  }
+  return TSnapDetail::GetLabelPropCmtyIdV(Graph, CmtyIdV, ActiveV, StopFrac, MxIter);
+}
+
+double CommunityLabelProp(const PUNGraph& Graph, TCnComV& CmtyV, const double& StopFrac, const int& MxIter) {
+  return TSnapDetail::CommunityLabelProp(Graph, TCnComV(), TIntV(), CmtyV, false, StopFrac, MxIter);
+}
+
+double CommunityLabelProp(const PUNGraph& Graph, const TCnComV& SeedCmtyV, const TIntV& ChangedNIdV, TCnComV& CmtyV, const double& StopFrac, const int& MxIter) {
+  return TSnapDetail::CommunityLabelProp(Graph, SeedCmtyV, ChangedNIdV, CmtyV, true, StopFrac, MxIter);
+}
+
 }; //namespace TSnap
@@ -26,6 +26,41 @@ double CommunityCNM(const PUNGraph& Graph, TCnComV& CmtyV);
 /// See: Rosvall M., Bergstrom C. T., Maps of random walks on complex networks reveal community structure, Proc. Natl. Acad. Sci. USA 105, 1118-1123 (2008)
 double Infomap(PUNGraph& Graph, TCnComV& CmtyV);
 
+/// Louvain community detection method for large networks.
+/// Nodes move in parallel to the neighboring community with the largest modularity gain, then communities are
+/// aggregated into the nodes of a smaller weighted graph and the process repeats until no node moves.
+/// Resolution above 1 gives smaller communities, below 1 larger ones. Returns the modularity of CmtyV, as GetModularity().
+/// See: Fast unfolding of communities in large networks, V. D. Blondel, J.-L. Guillaume, R. Lambiotte, E. Lefebvre, 2008
+double CommunityLouvain(const PUNGraph& Graph, TCnComV& CmtyV, const double& Resolution=1.0);
+/// Leiden community detection method for large networks.
+/// Works like CommunityLouvain() but refines communities before aggregation, so that only well connected
+/// parts of communities get merged. This avoids badly connected communities and usually gives higher modularity.
+/// See: From Louvain to Leiden: guaranteeing well-connected communities, V. A. Traag, L. Waltman, N. J. van Eck, 2019
+double CommunityLeiden(const PUNGraph& Graph, TCnComV& CmtyV, const double& Resolution=1.0);
+/// Louvain (Refine=false) or Leiden (Refine=true) modularity optimization on an undirected CSR snapshot.
+/// Sets CmtyIdV[NIdx] to a dense community id in 0...K-1 for every node index NIdx and returns the number of communities K.
+int GetModularityCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const double& Resolution=1.0, const bool& Refine=true);
+
+/// Label propagation community detection method for large networks.
+/// Every node repeatedly adopts the label that is most frequent among its neighbors, nodes with the same label form a community.
+/// Nodes are colored so that adjacent nodes differ in color, and color classes are updated one after another, each in parallel.
+/// This semi-synchronous update avoids the label oscillations of the synchronous one. Stops when at most StopFrac of the nodes
+/// change their label in a sweep, or after MxIter sweeps. Returns the modularity of CmtyV, as GetModularity().
+/// See: Near linear time algorithm to detect community structures in large-scale networks, U. N. Raghavan, R. Albert, S. Kumara, 2007
+/// See: Community detection via semi-synchronous label propagation algorithms, G. Cordasco, L. Gargano, 2010
+double CommunityLabelProp(const PUNGraph& Graph, TCnComV& CmtyV, const double& StopFrac=1e-3, const int& MxIter=100);
+/// Label propagation that starts from communities SeedCmtyV, for example the communities found before a small change of the Graph.
+/// ChangedNIdV are the nodes whose edges changed since then, nodes not in SeedCmtyV start alone and count as changed.
+/// Only the changed nodes and their neighbors are visited in the first sweep, later sweeps visit only the neighbors of nodes
+/// that changed their label. Stops when at most StopFrac of the nodes visited in the first sweep change their label.
+double CommunityLabelProp(const PUNGraph& Graph, const TCnComV& SeedCmtyV, const TIntV& ChangedNIdV, TCnComV& CmtyV, const double& StopFrac=1e-3, const int& MxIter=100);
+/// Label propagation on an undirected CSR snapshot. If Seeded, CmtyIdV holds the initial labels (node indices) of all nodes.
+/// Sets CmtyIdV[NIdx] to a dense community id in 0...K-1 for every node index NIdx and returns the number of communities K.
+int GetLabelPropCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const bool& Seeded=false, const double& StopFrac=1e-3, const int& MxIter=100);
+/// Incremental label propagation on an undirected CSR snapshot from the initial labels CmtyIdV, see CommunityLabelProp().
+/// The first sweep visits only the node indices ChangedNIdxV and their neighbors.
+int GetLabelPropCmtyIdV(const TCsrGraph& Graph, TIntV& CmtyIdV, const TIntV& ChangedNIdxV, const double& StopFrac=1e-3, const int& MxIter=100);
+
 double InfomapOnline(PUNGraph& Graph, int n1, int n2, TIntFltH& PAlpha, double& SumPAlphaLogPAlpha, TIntFltH& Qi, TIntH& Module, int& Br, TCnComV& CmtyV);
 
 void CmtyEvolutionFileBatch(TStr InFNm, TIntIntHH& sizesCont, TIntIntHH& cCont, TIntIntVH& edges, double alpha, double beta, int CmtyAlg);
@@ -30,7 +30,11 @@ namespace TSnap {
 
 void GetBiConSzCnt(const PUNGraph& Graph, TIntPrV& SzCntV) {
   TCnComV BiCnComV;
+#ifdef USE_OPENMP
+  GetBiConMP(Graph, BiCnComV);
+#else
   GetBiCon(Graph, BiCnComV);
+#endif
   TIntH SzCntH;
   for (int c =0; c < BiCnComV.Len(); c++) {
     SzCntH.AddDat(BiCnComV[c].Len()) += 1;
@@ -125,7 +129,11 @@ void Get1CnCom(const PUNGraph& Graph, TCnComV& Cn1ComV) {
 
 PUNGraph GetMxBiCon(const PUNGraph& Graph, const bool& RenumberNodes) {
   TCnComV CnComV;
+#ifdef USE_OPENMP
+  GetBiConMP(Graph, CnComV);
+#else
   GetBiCon(Graph, CnComV);
+#endif
   if (CnComV.Empty()) { 
     return PUNGraph(); 
   }
@@ -139,4 +147,505 @@ PUNGraph GetMxBiCon(const PUNGraph& Graph, const bool& RenumberNodes) {
   return TSnap::GetSubGraph(Graph, CnComV[CcId](), RenumberNodes);
 }
 
+#ifdef USE_OPENMP
+namespace TSnapDetail {
+
+// Afforest link: hooks the trees of U and V together, the larger root points to the smaller one.
+void UnionLink(const int& U, const int& V, TIntV& CompV) {
+  int P1 = CompV[U], P2 = CompV[V];
+  while (P1 != P2) {
+    const int High = TMath::Mx(P1, P2), Low = P1 + P2 - High;
+    const int PHigh = CompV[High];
+    if (PHigh == Low || (PHigh == High && __sync_bool_compare_and_swap(&CompV[High].Val, High, Low))) { break; }
+    P1 = CompV[CompV[High]];  P2 = CompV[Low];
+  }
+}
+
+// Points every node directly to the root of its tree.
+void UnionCompress(TIntV& CompV) {
+  const int Nodes = CompV.Len();
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    while (CompV[n] != CompV[CompV[n]]) { CompV[n] = CompV[CompV[n]]; }
+  }
+}
+
+// Returns the most frequent component among a sample of nodes.
+int GetFrqComp(const TIntV& CompV, const int& Samples) {
+  TRnd Rnd(1);
+  TIntH CompCntH;
+  for (int i = 0; i < Samples; i++) {
+    CompCntH.AddDat(CompV[Rnd.GetUniDevInt(CompV.Len())]) += 1; }
+  CompCntH.SortByDat(false);
+  return CompCntH.GetKey(0);
+}
+
+// Replaces representative node indices with dense component ids, returns the number of components.
+int RelabelComps(TIntV& CompV) {
+  const int Nodes = CompV.Len();
+  TIntV IdV(Nodes);
+  int Comps = 0;
+  for (int n = 0; n < Nodes; n++) {
+    if (CompV[n] == n) { IdV[n] = Comps++; }
+  }
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) {
+    CompV[n] = IdV[CompV[n]];
+  }
+  return Comps;
+}
+
+// Atomically sets Val to min(Val, NewVal).
+void AtomicMin(TInt& Val, const int& NewVal) {
+  int Old = Val;
+  while (NewVal < Old && ! __sync_bool_compare_and_swap(&Val.Val, Old, NewVal)) { Old = Val; }
+}
+
+// Atomically sets Val to max(Val, NewVal).
+void AtomicMax(TInt& Val, const int& NewVal) {
+  int Old = Val;
+  while (NewVal > Old && ! __sync_bool_compare_and_swap(&Val.Val, Old, NewVal)) { Old = Val; }
+}
+
+// Builds a breadth-first spanning forest rooted at the smallest node index of every component.
+// Returns nodes in BFS order, level L occupies OrderV[LevelOffV[L]...LevelOffV[L+1]-1].
+void GetBfsForest(const TCsrGraph& Graph, TIntV& ParentV, TIntV& OrderV, TIntV& LevelOffV, TIntV& RootV) {
+  const int Nodes = Graph.GetNodes();
+  TIntV CompIdV;
+  const int Comps = GetWccIdV(Graph, CompIdV);
+  TIntV CompRootV(Comps);
+  CompRootV.PutAll(-1);
+  RootV.Gen(Comps, 0);
+  for (int n = 0; n < Nodes; n++) {
+    if (CompRootV[CompIdV[n]] == -1) { CompRootV[CompIdV[n]] = n;  RootV.Add(n); }
+  }
+  ParentV.Gen(Nodes);
+  ParentV.PutAll(-2);  // -2: not visited, -1: root
+  OrderV.Gen(Nodes, 0);
+  LevelOffV.Clr();
+  LevelOffV.Add(0);
+  for (int r = 0; r < RootV.Len(); r++) {
+    ParentV[RootV[r]] = -1;  OrderV.Add(RootV[r]); }
+  int LevelBeg = 0;
+  while (LevelBeg < OrderV.Len()) {
+    const int LevelEnd = OrderV.Len();
+    LevelOffV.Add(LevelEnd);
+    #pragma omp parallel for schedule(dynamic,1000)
+    for (int i = LevelBeg; i < LevelEnd; i++) {
+      const int NIdx = OrderV[i];
+      for (int e = 0; e < Graph.GetOutDeg(NIdx); e++) {
+        const int Nbr = Graph.GetOutNbr(NIdx, e);
+        if (ParentV[Nbr] == -2 && __sync_bool_compare_and_swap(&ParentV[Nbr].Val, -2, NIdx)) {
+          OrderV.AddMP(Nbr); }
+      }
+    }
+    LevelBeg = LevelEnd;
+  }
+}
+
+// Level-synchronous BFS from SrcNIdx over nodes with SccV[NIdx]==-1, sets MarkV[NIdx]=Mark for reached nodes.
+void MarkReach(const TCsrGraph& Graph, const int& SrcNIdx, const bool& Fwd, const TIntV& SccV, TIntV& MarkV, const int& Mark) {
+  const TVec<TInt64>& OffV = Fwd ? Graph.GetOutOffV() : Graph.GetInOffV();
+  const TVec<TInt, int64>& NbrV = Fwd ? Graph.GetOutNbrV() : Graph.GetInNbrV();
+  TIntV FrontierV(Graph.GetNodes(), 0), NextV(Graph.GetNodes(), 0);
+  MarkV[SrcNIdx] = Mark;
+  FrontierV.Add(SrcNIdx);
+  while (! FrontierV.Empty()) {
+    NextV.Reduce(0);
+    #pragma omp parallel for schedule(dynamic,1000)
+    for (int i = 0; i < FrontierV.Len(); i++) {
+      const int NIdx = FrontierV[i];
+      for (int64 e = OffV[NIdx]; e < OffV[NIdx+1]; e++) {
+        const int Nbr = NbrV[e];
+        const int Old = MarkV[Nbr];
+        if (SccV[Nbr] == -1 && Old != Mark && __sync_bool_compare_and_swap(&MarkV[Nbr].Val, Old, Mark)) {
+          NextV.AddMP(Nbr); }
+      }
+    }
+    FrontierV.Swap(NextV);
+  }
+}
+
+// Sequential Tarjan over the nodes with SccV[NIdx]==-1, sets SccV[NIdx] to the root node index of its scc.
+void GetTarjanSccV(const TCsrGraph& Graph, TIntV& SccV) {
+  const int Nodes = Graph.GetNodes();
+  TIntV IndexV(Nodes), LowV(Nodes), EdgeV(Nodes), StackV, CallV;
+  IndexV.PutAll(-1);
+  int Index = 0;
+  for (int s = 0; s < Nodes; s++) {
+    if (SccV[s] != -1 || IndexV[s] != -1) { continue; }
+    IndexV[s] = LowV[s] = Index++;
+    StackV.Add(s);  CallV.Add(s);
+    while (! CallV.Empty()) {
+      const int NIdx = CallV.Last();
+      if (EdgeV[NIdx] < Graph.GetOutDeg(NIdx)) {
+        const int Nbr = Graph.GetOutNbr(NIdx, EdgeV[NIdx].Val++);
+        if (SccV[Nbr] != -1) { continue; }
+        // visited nodes without an scc are still on the stack
+        if (IndexV[Nbr] == -1) {
+          IndexV[Nbr] = LowV[Nbr] = Index++;
+          StackV.Add(Nbr);  CallV.Add(Nbr);
+        } else { LowV[NIdx] = TMath::Mn(LowV[NIdx], IndexV[Nbr]); }
+        continue;
+      }
+      CallV.DelLast();
+      if (! CallV.Empty()) { LowV[CallV.Last()] = TMath::Mn(LowV[CallV.Last()], LowV[NIdx]); }
+      if (LowV[NIdx] == IndexV[NIdx]) {
+        int Top;
+        do { Top = StackV.Last();  StackV.DelLast();  SccV[Top] = NIdx; } while (Top != NIdx);
+      }
+    }
+  }
+}
+
+} // namespace TSnapDetail
+
+int GetWccIdV(const TCsrGraph& Graph, TIntV& CompIdV, const int& NbrRounds) {
+  const int Nodes = Graph.GetNodes();
+  CompIdV.Gen(Nodes);
+  if (Nodes == 0) { return 0; }
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) { CompIdV[n] = n; }
+  // link the first few neighbors of every node
+  for (int r = 0; r < NbrRounds; r++) {
+    #pragma omp parallel for schedule(dynamic,10000)
+    for (int n = 0; n < Nodes; n++) {
+      if (r < Graph.GetOutDeg(n)) { TSnapDetail::UnionLink(n, Graph.GetOutNbr(n, r), CompIdV); }
+    }
+    TSnapDetail::UnionCompress(CompIdV);
+  }
+  // the largest intermediate component is usually the giant one, its nodes can be skipped
+  const int FrqComp = TSnapDetail::GetFrqComp(CompIdV, 1024);
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    if (CompIdV[n] == FrqComp) { continue; }
+    for (int e = NbrRounds; e < Graph.GetOutDeg(n); e++) {
+      TSnapDetail::UnionLink(n, Graph.GetOutNbr(n, e), CompIdV); }
+    if (Graph.IsDir()) {
+      for (int e = 0; e < Graph.GetInDeg(n); e++) {
+        TSnapDetail::UnionLink(n, Graph.GetInNbr(n, e), CompIdV); }
+    }
+  }
+  TSnapDetail::UnionCompress(CompIdV);
+  return TSnapDetail::RelabelComps(CompIdV);
+}
+
+int GetSccIdV(const TCsrGraph& Graph, TIntV& CompIdV) {
+  const int Nodes = Graph.GetNodes();
+  TIntV& SccV = CompIdV; // representative node index of the scc, -1 when not assigned yet
+  SccV.Gen(Nodes);
+  SccV.PutAll(-1);
+  TIntV FrontierV(Nodes, 0), NextV(Nodes, 0);
+  // trimming to a fixpoint, nodes without active in- or out-neighbors are sccs by themselves
+  TIntV OutCntV(Nodes), InCntV(Nodes);
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+      if (Graph.GetOutNbr(n, e) != n) { OutCntV[n]++; } }
+    for (int e = 0; e < Graph.GetInDeg(n); e++) {
+      if (Graph.GetInNbr(n, e) != n) { InCntV[n]++; } }
+  }
+  for (int n = 0; n < Nodes; n++) {
+    if (OutCntV[n] == 0 || InCntV[n] == 0) { SccV[n] = n;  FrontierV.Add(n); }
+  }
+  while (! FrontierV.Empty()) {
+    NextV.Reduce(0);
+    #pragma omp parallel for schedule(dynamic,1000)
+    for (int i = 0; i < FrontierV.Len(); i++) {
+      const int NIdx = FrontierV[i];
+      for (int e = 0; e < Graph.GetOutDeg(NIdx); e++) {
+        const int Nbr = Graph.GetOutNbr(NIdx, e);
+        if (Nbr != NIdx && SccV[Nbr] == -1 && __sync_sub_and_fetch(&InCntV[Nbr].Val, 1) == 0 &&
+         __sync_bool_compare_and_swap(&SccV[Nbr].Val, -1, Nbr)) { NextV.AddMP(Nbr); }
+      }
+      for (int e = 0; e < Graph.GetInDeg(NIdx); e++) {
+        const int Nbr = Graph.GetInNbr(NIdx, e);
+        if (Nbr != NIdx && SccV[Nbr] == -1 && __sync_sub_and_fetch(&OutCntV[Nbr].Val, 1) == 0 &&
+         __sync_bool_compare_and_swap(&SccV[Nbr].Val, -1, Nbr)) { NextV.AddMP(Nbr); }
+      }
+    }
+    FrontierV.Swap(NextV);
+  }
+  // forward-backward search from the node most likely in the giant scc
+  int Pivot = -1;
+  double MxDegPrd = -1;
+  for (int n = 0; n < Nodes; n++) {
+    if (SccV[n] != -1) { continue; }
+    const double DegPrd = double(Graph.GetOutDeg(n)) * double(Graph.GetInDeg(n));
+    if (DegPrd > MxDegPrd) { MxDegPrd = DegPrd;  Pivot = n; }
+  }
+  if (Pivot != -1) {
+    TIntV FwV(Nodes), BwV(Nodes);
+    TSnapDetail::MarkReach(Graph, Pivot, true, SccV, FwV, 1);
+    TSnapDetail::MarkReach(Graph, Pivot, false, SccV, BwV, 1);
+    #pragma omp parallel for schedule(static)
+    for (int n = 0; n < Nodes; n++) {
+      if (FwV[n] == 1 && BwV[n] == 1) { SccV[n] = Pivot; }
+    }
+  }
+  // coloring: the largest node index that reaches a node is its color,
+  // the scc of a color root consists of the nodes of the same color that reach the root.
+  // Colors can be raised many times along long chains, so a round that scans more than
+  // a few times the arcs of the active nodes, or that resolves few of them, leaves the rest
+  // to sequential Tarjan, which keeps the total work O(N+E).
+  TIntV ActiveV(Nodes, 0);
+  for (int n = 0; n < Nodes; n++) {
+    if (SccV[n] == -1) { ActiveV.Add(n); }
+  }
+  TIntV ColorV(Nodes), InNextV(Nodes);
+  while (! ActiveV.Empty()) {
+    int64 Budget = 0, Work = 0;
+    #pragma omp parallel for schedule(static) reduction(+:Budget)
+    for (int i = 0; i < ActiveV.Len(); i++) {
+      ColorV[ActiveV[i]] = ActiveV[i];  InNextV[ActiveV[i]] = 0;
+      Budget += 4*(Graph.GetOutDeg(ActiveV[i])+1);
+    }
+    FrontierV.Reduce(0);
+    FrontierV.AddV(ActiveV);
+    while (! FrontierV.Empty() && Work <= Budget) {
+      NextV.Reduce(0);
+      #pragma omp parallel for schedule(dynamic,1000) reduction(+:Work)
+      for (int i = 0; i < FrontierV.Len(); i++) {
+        const int NIdx = FrontierV[i];
+        __sync_fetch_and_and(&InNextV[NIdx].Val, 0);
+        const int Color = ColorV[NIdx];
+        Work += Graph.GetOutDeg(NIdx)+1;
+        for (int e = 0; e < Graph.GetOutDeg(NIdx); e++) {
+          const int Nbr = Graph.GetOutNbr(NIdx, e);
+          if (SccV[Nbr] != -1) { continue; }
+          int Old = ColorV[Nbr];
+          while (Color > Old) {
+            if (__sync_bool_compare_and_swap(&ColorV[Nbr].Val, Old, Color)) {
+              if (__sync_bool_compare_and_swap(&InNextV[Nbr].Val, 0, 1)) { NextV.AddMP(Nbr); }
+              break;
+            }
+            Old = ColorV[Nbr];
+          }
+        }
+      }
+      FrontierV.Swap(NextV);
+    }
+    if (Work > Budget) {
+      TSnapDetail::GetTarjanSccV(Graph, SccV);  break; }
+    // backward search from every color root, restricted to its color
+    FrontierV.Reduce(0);
+    for (int i = 0; i < ActiveV.Len(); i++) {
+      const int NIdx = ActiveV[i];
+      if (ColorV[NIdx] == NIdx) { SccV[NIdx] = NIdx;  FrontierV.Add(NIdx); }
+    }
+    while (! FrontierV.Empty()) {
+      NextV.Reduce(0);
+      #pragma omp parallel for schedule(dynamic,1000)
+      for (int i = 0; i < FrontierV.Len(); i++) {
+        const int NIdx = FrontierV[i];
+        const int Color = ColorV[NIdx];
+        for (int e = 0; e < Graph.GetInDeg(NIdx); e++) {
+          const int Nbr = Graph.GetInNbr(NIdx, e);
+          if (ColorV[Nbr] == Color && SccV[Nbr] == -1 && __sync_bool_compare_and_swap(&SccV[Nbr].Val, -1, Color)) {
+            NextV.AddMP(Nbr); }
+        }
+      }
+      FrontierV.Swap(NextV);
+    }
+    // keep the unassigned nodes
+    const int Active = ActiveV.Len();
+    int Left = 0;
+    for (int i = 0; i < Active; i++) {
+      if (SccV[ActiveV[i]] == -1) { ActiveV[Left++] = ActiveV[i]; }
+    }
+    ActiveV.Reduce(Left);
+    if (Left > 0 && 8*(Active-Left) < Active) {
+      TSnapDetail::GetTarjanSccV(Graph, SccV);  break; }
+  }
+  return TSnapDetail::RelabelComps(SccV);
+}
+
+int GetBiConIdV(const TCsrGraph& Graph, TVec<TInt, int64>& BlockIdV, TIntV& ArtNIdxV, TIntPrV& BridgeV) {
+  IAssertR(! Graph.IsDir(), "Biconnected components require an undirected graph");
+  const int Nodes = Graph.GetNodes();
+  TIntV ParentV, OrderV, LevelOffV, RootV;
+  TSnapDetail::GetBfsForest(Graph, ParentV, OrderV, LevelOffV, RootV);
+  const int Levels = LevelOffV.Len()-1;
+  // subtree sizes, bottom-up
+  TIntV SizeV(Nodes);
+  SizeV.PutAll(1);
+  for (int l = Levels-1; l > 0; l--) {
+    #pragma omp parallel for schedule(static)
+    for (int i = LevelOffV[l]; i < LevelOffV[l+1]; i++) {
+      const int NIdx = OrderV[i];
+      __sync_fetch_and_add(&SizeV[ParentV[NIdx]].Val, SizeV[NIdx].Val);
+    }
+  }
+  // children of every node in the spanning forest
+  TIntV ChildOffV(Nodes+1), ChildV(Nodes);
+  for (int n = 0; n < Nodes; n++) {
+    if (ParentV[n] >= 0) { ChildOffV[ParentV[n]+1]++; } }
+  for (int n = 0; n < Nodes; n++) {
+    ChildOffV[n+1] += ChildOffV[n]; }
+  TIntV FillV(ChildOffV);
+  for (int i = 0; i < Nodes; i++) {
+    const int NIdx = OrderV[i];
+    if (ParentV[NIdx] >= 0) { ChildV[FillV[ParentV[NIdx]].Val++] = NIdx; }
+  }
+  // preorder numbers, top-down
+  TIntV PreV(Nodes);
+  int PreOff = 0;
+  for (int r = 0; r < RootV.Len(); r++) {
+    PreV[RootV[r]] = PreOff;  PreOff += SizeV[RootV[r]]; }
+  for (int l = 0; l < Levels; l++) {
+    #pragma omp parallel for schedule(dynamic,1000)
+    for (int i = LevelOffV[l]; i < LevelOffV[l+1]; i++) {
+      const int NIdx = OrderV[i];
+      int ChildPre = PreV[NIdx]+1;
+      for (int c = ChildOffV[NIdx]; c < ChildOffV[NIdx+1]; c++) {
+        PreV[ChildV[c]] = ChildPre;  ChildPre += SizeV[ChildV[c]]; }
+    }
+  }
+  // lowest and highest preorder number reachable from a subtree by a non-tree edge
+  TIntV LowV(Nodes), HighV(Nodes);
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    int Low = PreV[n], High = PreV[n];
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+      const int Nbr = Graph.GetOutNbr(n, e);
+      if (Nbr == n || ParentV[n] == Nbr || ParentV[Nbr] == n) { continue; }
+      Low = TMath::Mn(Low, PreV[Nbr].Val);  High = TMath::Mx(High, PreV[Nbr].Val);
+    }
+    LowV[n] = Low;  HighV[n] = High;
+  }
+  for (int l = Levels-1; l > 0; l--) {
+    #pragma omp parallel for schedule(static)
+    for (int i = LevelOffV[l]; i < LevelOffV[l+1]; i++) {
+      const int NIdx = OrderV[i];
+      TSnapDetail::AtomicMin(LowV[ParentV[NIdx]], LowV[NIdx]);
+      TSnapDetail::AtomicMax(HighV[ParentV[NIdx]], HighV[NIdx]);
+    }
+  }
+  // Tarjan-Vishkin: tree edge (Parent(v),v) is represented by v, connect edges of the same block
+  TIntV BlockV(Nodes);
+  #pragma omp parallel for schedule(static)
+  for (int n = 0; n < Nodes; n++) { BlockV[n] = n; }
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    const int Prn = ParentV[n];
+    if (Prn < 0) { continue; }
+    // a non-tree edge leaves the subtree of the parent
+    if (ParentV[Prn] >= 0 && (LowV[n] < PreV[Prn] || HighV[n] >= PreV[Prn]+SizeV[Prn])) {
+      TSnapDetail::UnionLink(n, Prn, BlockV); }
+    // non-tree edges between unrelated nodes
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+      const int Nbr = Graph.GetOutNbr(n, e);
+      if (PreV[Nbr] + SizeV[Nbr] <= PreV[n]) { TSnapDetail::UnionLink(n, Nbr, BlockV); }
+    }
+  }
+  TSnapDetail::UnionCompress(BlockV);
+  // dense block ids, every edge belongs to the block of its endpoint with the larger preorder number
+  TIntV BlockIdxV(Nodes);
+  int Blocks = 0;
+  for (int n = 0; n < Nodes; n++) {
+    if (ParentV[n] >= 0 && BlockV[n] == n) { BlockIdxV[n] = Blocks++; } }
+  BlockIdV.Gen(Graph.GetArcs());
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    for (int e = 0; e < Graph.GetOutDeg(n); e++) {
+      const int Nbr = Graph.GetOutNbr(n, e);
+      BlockIdV[Graph.GetOutOff(n)+e] = Nbr == n ? -1 : BlockIdxV[BlockV[PreV[n] > PreV[Nbr] ? n : Nbr]].Val;
+    }
+  }
+  // articulation points belong to more than one block, bridges are tree edges no non-tree edge jumps over
+  TIntV IsArtV(Nodes);
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    int BlockId = -1;
+    for (int64 e = Graph.GetOutOff(n); e < Graph.GetOutOff(n+1) && ! IsArtV[n]; e++) {
+      if (BlockIdV[e] == -1) { continue; }
+      if (BlockId == -1) { BlockId = BlockIdV[e]; }
+      else if (BlockId != BlockIdV[e]) { IsArtV[n] = 1; }
+    }
+  }
+  ArtNIdxV.Clr();
+  BridgeV.Clr();
+  for (int n = 0; n < Nodes; n++) {
+    if (IsArtV[n]) { ArtNIdxV.Add(n); }
+    if (ParentV[n] >= 0 && LowV[n] >= PreV[n] && HighV[n] < PreV[n]+SizeV[n]) {
+      BridgeV.Add(TIntPr(TMath::Mn(n, ParentV[n].Val), TMath::Mx(n, ParentV[n].Val))); }
+  }
+  return Blocks;
+}
+
+void GetBiConMP(const PUNGraph& Graph, TCnComV& BiCnComV) {
+  const TCsrGraph Csr(Graph);
+  TVec<TInt, int64> BlockIdV;
+  TIntV ArtNIdxV;
+  TIntPrV BridgeV;
+  const int Blocks = GetBiConIdV(Csr, BlockIdV, ArtNIdxV, BridgeV);
+  // nodes of a block are the endpoints of its edges
+  TIntPrV BlockNIdxV;
+  for (int n = 0; n < Csr.GetNodes(); n++) {
+    for (int e = 0; e < Csr.GetOutDeg(n); e++) {
+      const int BlockId = BlockIdV[Csr.GetOutOff(n)+e];
+      if (BlockId != -1) { BlockNIdxV.Add(TIntPr(BlockId, n)); }
+    }
+  }
+  BlockNIdxV.Merge();
+  BiCnComV.Gen(Blocks);
+  for (int i = 0; i < BlockNIdxV.Len(); i++) {
+    BiCnComV[BlockNIdxV[i].Val1].Add(Csr.GetNId(BlockNIdxV[i].Val2)); }
+  BiCnComV.Sort(false);
+}
+
+void GetArtPointsMP(const PUNGraph& Graph, TIntV& ArtNIdV) {
+  const TCsrGraph Csr(Graph);
+  TVec<TInt, int64> BlockIdV;
+  TIntV ArtNIdxV;
+  TIntPrV BridgeV;
+  GetBiConIdV(Csr, BlockIdV, ArtNIdxV, BridgeV);
+  ArtNIdV.Gen(ArtNIdxV.Len(), 0);
+  for (int i = 0; i < ArtNIdxV.Len(); i++) {
+    ArtNIdV.Add(Csr.GetNId(ArtNIdxV[i])); }
+}
+
+void GetEdgeBridgesMP(const PUNGraph& Graph, TIntPrV& EdgeV) {
+  const TCsrGraph Csr(Graph);
+  TVec<TInt, int64> BlockIdV;
+  TIntV ArtNIdxV;
+  TIntPrV BridgeV;
+  GetBiConIdV(Csr, BlockIdV, ArtNIdxV, BridgeV);
+  EdgeV.Gen(BridgeV.Len(), 0);
+  for (int i = 0; i < BridgeV.Len(); i++) {
+    EdgeV.Add(TIntPr(Csr.GetNId(BridgeV[i].Val1), Csr.GetNId(BridgeV[i].Val2))); }
+  EdgeV.Sort();
+}
+
+void GetCnComV(const TCsrGraph& Graph, const TIntV& CompIdV, TCnComV& CnComV) {
+  int Comps = 0;
+  for (int n = 0; n < CompIdV.Len(); n++) {
+    Comps = TMath::Mx(Comps, CompIdV[n]+1); }
+  TIntV SzV(Comps);
+  for (int n = 0; n < CompIdV.Len(); n++) {
+    SzV[CompIdV[n]]++; }
+  CnComV.Gen(Comps);
+  for (int c = 0; c < Comps; c++) {
+    CnComV[c].NIdV.Gen(SzV[c], 0); }
+  for (int n = 0; n < CompIdV.Len(); n++) {
+    CnComV[CompIdV[n]].Add(Graph.GetNId(n)); }
+  // node indices follow node ids, so the components are already sorted
+  CnComV.Sort(false);
+}
+
+void GetCnComSzCnt(const TIntV& CompIdV, TIntPrV& SzCntV) {
+  int Comps = 0;
+  for (int n = 0; n < CompIdV.Len(); n++) {
+    Comps = TMath::Mx(Comps, CompIdV[n]+1); }
+  TIntV SzV(Comps);
+  for (int n = 0; n < CompIdV.Len(); n++) {
+    SzV[CompIdV[n]]++; }
+  TIntH SzToCntH;
+  for (int c = 0; c < Comps; c++) {
+    SzToCntH.AddDat(SzV[c]) += 1; }
+  SzToCntH.GetKeyDatPrV(SzCntV);
+  SzCntV.Sort(true);
+}
+#endif // USE_OPENMP
+
 } // namespace TSnap
@@ -46,6 +46,38 @@ void Get1CnCom(const PUNGraph& Graph, TCnComV& Cn1ComV);
 /// Returns a graph representing the largest bi-connected component on an undirected Graph. ##GetMxBiCon
 PUNGraph GetMxBiCon(const PUNGraph& Graph, const bool& RenumberNodes=false);
 
+#ifdef USE_OPENMP
+/// Computes weakly connected components of a CSR snapshot in parallel (Afforest union-find with neighbor sampling).
+/// Sets CompIdV[NIdx] to a dense component id in 0...K-1 for every node index NIdx and returns the number of components K.
+int GetWccIdV(const TCsrGraph& Graph, TIntV& CompIdV, const int& NbrRounds=2);
+/// Computes strongly connected components of a CSR snapshot in parallel (trimming, forward-backward search and coloring).
+/// Coloring rounds that do too much work or resolve too few nodes hand the remaining ones to sequential Tarjan, so the running time stays O(N+E).
+/// Sets CompIdV[NIdx] to a dense component id in 0...K-1 for every node index NIdx and returns the number of components K.
+int GetSccIdV(const TCsrGraph& Graph, TIntV& CompIdV);
+/// Converts dense component ids of the nodes of a CSR snapshot into connected components, ordered like GetWccs() and GetSccs().
+void GetCnComV(const TCsrGraph& Graph, const TIntV& CompIdV, TCnComV& CnComV);
+/// Returns a distribution of component sizes given dense component ids of nodes.
+void GetCnComSzCnt(const TIntV& CompIdV, TIntPrV& SzCntV);
+/// Computes biconnected components, articulation points and bridges of an undirected CSR snapshot in parallel (Tarjan-Vishkin on a BFS spanning forest).
+/// Sets BlockIdV[Arc] to a dense block id for every arc position of Graph.GetOutNbrV() (both arcs of an edge get the same id, self-loops get -1),
+/// returns articulation points as node indices in ArtNIdxV and bridges as pairs of node indices in BridgeV. Returns the number of blocks.
+int GetBiConIdV(const TCsrGraph& Graph, TVec<TInt, int64>& BlockIdV, TIntV& ArtNIdxV, TIntPrV& BridgeV);
+/// Returns all bi-connected components of a Graph. Parallel version of GetBiCon(), components are sorted by size.
+void GetBiConMP(const PUNGraph& Graph, TCnComV& BiCnComV);
+/// Returns articulation points of a Graph. Parallel version of GetArtPoints().
+void GetArtPointsMP(const PUNGraph& Graph, TIntV& ArtNIdV);
+/// Returns bridge edges of a Graph. Parallel version of GetEdgeBridges().
+void GetEdgeBridgesMP(const PUNGraph& Graph, TIntPrV& EdgeV);
+/// Returns all weakly connected components in a Graph. Parallel version of GetWccs().
+template <class PGraph> void GetWccsMP(const PGraph& Graph, TCnComV& CnComV);
+/// Returns a distribution of weakly connected component sizes. Parallel version of GetWccSzCnt().
+template <class PGraph> void GetWccSzCntMP(const PGraph& Graph, TIntPrV& WccSzCnt);
+/// Returns all strongly connected components in a Graph. Parallel version of GetSccs().
+template <class PGraph> void GetSccsMP(const PGraph& Graph, TCnComV& CnComV);
+/// Returns a distribution of strongly connected component sizes. Parallel version of GetSccSzCnt().
+template <class PGraph> void GetSccSzCntMP(const PGraph& Graph, TIntPrV& SccSzCnt);
+#endif
+
 }; // namespace TSnap
 
 //#//////////////////////////////////////////////
@@ -398,6 +430,40 @@ void GetSccs(const PGraph& Graph, TCnComV& CnComV) {
   CnComV.Sort(false);
 }
 
+#ifdef USE_OPENMP
+template <class PGraph>
+void GetWccsMP(const PGraph& Graph, TCnComV& CnComV) {
+  const TCsrGraph Csr(Graph);
+  TIntV CompIdV;
+  GetWccIdV(Csr, CompIdV);
+  GetCnComV(Csr, CompIdV, CnComV);
+}
+
+template <class PGraph>
+void GetWccSzCntMP(const PGraph& Graph, TIntPrV& WccSzCnt) {
+  const TCsrGraph Csr(Graph);
+  TIntV CompIdV;
+  GetWccIdV(Csr, CompIdV);
+  GetCnComSzCnt(CompIdV, WccSzCnt);
+}
+
+template <class PGraph>
+void GetSccsMP(const PGraph& Graph, TCnComV& CnComV) {
+  const TCsrGraph Csr(Graph);
+  TIntV CompIdV;
+  GetSccIdV(Csr, CompIdV);
+  GetCnComV(Csr, CompIdV, CnComV);
+}
+
+template <class PGraph>
+void GetSccSzCntMP(const PGraph& Graph, TIntPrV& SccSzCnt) {
+  const TCsrGraph Csr(Graph);
+  TIntV CompIdV;
+  GetSccIdV(Csr, CompIdV);
+  GetCnComSzCnt(CompIdV, SccSzCnt);
+}
+#endif // USE_OPENMP
+
 template <class PGraph> 
 double GetMxWccSz(const PGraph& Graph) {
   TCnComV CnComV;
@@ -417,7 +483,11 @@ double GetMxSccSz(const PGraph& Graph) {
 template <class PGraph>
 PGraph GetMxWcc(const PGraph& Graph) {
   TCnComV CnComV;
+#ifdef USE_OPENMP
+  GetWccsMP(Graph, CnComV);
+#else
   GetWccs(Graph, CnComV);
+#endif
   if (CnComV.Empty()) { return PGraph::TObj::New(); }
   int CcId = 0, MxSz = 0;
   for (int i = 0; i < CnComV.Len(); i++) {
@@ -434,7 +504,11 @@ PGraph GetMxWcc(const PGraph& Graph) {
 template <class PGraph>
 PGraph GetMxScc(const PGraph& Graph) {
   TCnComV CnComV;
+#ifdef USE_OPENMP
+  GetSccsMP(Graph, CnComV);
+#else
   GetSccs(Graph, CnComV);
+#endif
   if (CnComV.Empty()) { return PGraph::TObj::New(); }
   int CcId = 0, MxSz = 0;
   for (int i = 0; i < CnComV.Len(); i++) {
@@ -451,7 +525,11 @@ PGraph GetMxScc(const PGraph& Graph) {
 template <class PGraph>
 PGraph GetMxBiCon(const PGraph& Graph) {
   TCnComV CnComV;
+#ifdef USE_OPENMP
+  GetBiConMP(TSnap::ConvertGraph<PUNGraph, PGraph>(Graph), CnComV);
+#else
   GetBiCon(TSnap::ConvertGraph<PUNGraph, PGraph>(Graph), CnComV);
+#endif
   if (CnComV.Empty()) { return PGraph::TObj::New(); }
   int CcId = 0, MxSz = 0;
   for (int i = 0; i < CnComV.Len(); i++) {
@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////
+// Compressed sparse row graph snapshot
+void TCsrGraph::BuildIdMap() {
+  DenseIds = true;
+  for (int n = 0; n < NIdV.Len(); n++) {
+    if (NIdV[n] != n) { DenseIds = false;  break; }
+  }
+  NIdToIdxH.Clr();
+  if (! DenseIds) {
+    NIdToIdxH.Gen(NIdV.Len());
+    for (int n = 0; n < NIdV.Len(); n++) {
+      NIdToIdxH.AddDat(NIdV[n], n);
+    }
+  }
+}
+
+void TCsrGraph::SortNbrs(const TVec<TInt64>& OffV, TVec<TInt, int64>& NbrV) {
+  const int Nodes = OffV.Len()-1;
+  // neighbors of TUNGraph and TNGraph are already sorted, only check them
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    for (int64 i = OffV[n]+1; i < OffV[n+1]; i++) {
+      if (NbrV[i-1] > NbrV[i]) { TSnap::SortMP(NbrV.BegI()+OffV[n].Val, NbrV.BegI()+OffV[n+1].Val);  break; }
+    }
+  }
+}
+
+bool TCsrGraph::IsArc(const int& SrcNIdx, const int& DstNIdx) const {
+  int64 LValN = OutOffV[SrcNIdx], RValN = OutOffV[SrcNIdx+1]-1;
+  while (LValN <= RValN) {
+    const int64 ValN = (LValN+RValN)/2;
+    if (OutNbrV[ValN] == DstNIdx) { return true; }
+    if (DstNIdx < OutNbrV[ValN]) { RValN = ValN-1; } else { LValN = ValN+1; }
+  }
+  return false;
+}
+
+int64 TCsrGraph::GetMemUsed() const {
+  return int64(sizeof(TCsrGraph)) + NIdV.GetMemUsed() + NIdToIdxH.GetMemUsed() +
+    OutOffV.GetMemUsed() + InOffV.GetMemUsed() + OutNbrV.GetMemUsed() + InNbrV.GetMemUsed();
+}
+
+/////////////////////////////////////////////////
+// Sparse matrix-vector products on CSR snapshots
+void TSnap::GetCsrInWgtV(const TCsrGraph& Graph, const TVec<TFlt, int64>& OutWgtV, TVec<TFlt, int64>& InWgtV) {
+  IAssert(OutWgtV.Len() == Graph.GetArcs());
+  if (! Graph.IsDir()) { InWgtV = OutWgtV;  return; }
+  const TVec<TInt, int64>& OutNbrV = Graph.GetOutNbrV();
+  const TVec<TInt, int64>& InNbrV = Graph.GetInNbrV();
+  InWgtV.Gen(OutWgtV.Len());
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Graph.GetNodes(); n++) {
+    int64 Dup = 0;
+    for (int64 e = Graph.GetOutOff(n); e < Graph.GetOutOff(n+1); e++) {
+      // arc n->Dst is at the position of n in the sorted in-neighbor list of Dst,
+      // parallel arcs of multigraphs take consecutive positions in both lists
+      const int Dst = OutNbrV[e];
+      Dup = (e > Graph.GetOutOff(n) && OutNbrV[e-1] == Dst) ? Dup+1 : 0;
+      int64 LValN = Graph.GetInOff(Dst), RValN = Graph.GetInOff(Dst+1)-1;
+      while (LValN < RValN) {
+        const int64 ValN = (LValN+RValN)/2;
+        if (InNbrV[ValN] < n) { LValN = ValN+1; } else { RValN = ValN; }
+      }
+      InWgtV[LValN+Dup] = OutWgtV[e];
+    }
+  }
+}
@@ -0,0 +1,208 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include <algorithm>
+#include <iterator>
+
+/////////////////////////////////////////////////
+// Compressed sparse row graph snapshot
+class TCsrGraph;
+/// Pointer to a compressed sparse row graph snapshot (TCsrGraph)
+typedef TPt<TCsrGraph> PCsrGraph;
+
+//#//////////////////////////////////////////////
+/// Read-only compressed sparse row (CSR) snapshot of a graph.
+/// Nodes are renumbered to dense node indices 0...N-1 in the increasing order of their ids.
+/// Out-neighbors of node index NIdx are stored as node indices at positions
+/// GetOutOff(NIdx)...GetOutOff(NIdx+1)-1 of GetOutNbrV(), in-neighbors the same way in GetInNbrV().
+/// Neighbor lists are sorted. For undirected graphs in- and out-neighbors share the same storage.
+/// The snapshot does not change after it is built, so any number of threads can read it concurrently.
+class TCsrGraph {
+private:
+  TCRef CRef;
+  TBool Dir;
+  TBool DenseIds;                   // node ids are exactly 0...N-1, NIdToIdxH is not used
+  TIntV NIdV;                       // node index -> node id
+  TIntIntH NIdToIdxH;               // node id -> node index
+  TVec<TInt64> OutOffV, InOffV;
+  TVec<TInt, int64> OutNbrV, InNbrV;
+private:
+  template <class PGraph> void Build(const PGraph& Graph);
+  void BuildIdMap();
+  static void SortNbrs(const TVec<TInt64>& OffV, TVec<TInt, int64>& NbrV);
+public:
+  TCsrGraph() : CRef(), Dir(false), DenseIds(true), NIdV(), NIdToIdxH(), OutOffV(), InOffV(), OutNbrV(), InNbrV() { }
+  /// Builds a snapshot of Graph. Directed graphs keep both out- and in-neighbor lists.
+  template <class PGraph> explicit TCsrGraph(const PGraph& Graph) : CRef(), Dir(false), DenseIds(true), NIdV(), NIdToIdxH(), OutOffV(), InOffV(), OutNbrV(), InNbrV() { Build(Graph); }
+  /// Builds a snapshot of Graph and returns a pointer to it.
+  template <class PGraph> static PCsrGraph New(const PGraph& Graph) { return new TCsrGraph(Graph); }
+
+  /// Tests whether the snapshot was taken of a directed graph.
+  bool IsDir() const { return Dir; }
+  /// Returns the number of nodes.
+  int GetNodes() const { return NIdV.Len(); }
+  /// Returns the number of stored (directed) arcs. Every undirected edge is stored twice, once in each direction.
+  int64 GetArcs() const { return OutNbrV.Len(); }
+  /// Tests whether node with id NId is in the snapshot.
+  bool IsNode(const int& NId) const { return DenseIds ? (0 <= NId && NId < NIdV.Len()) : NIdToIdxH.IsKey(NId); }
+  /// Returns the node id of the node with index NIdx.
+  int GetNId(const int& NIdx) const { return NIdV[NIdx]; }
+  /// Returns the node index of the node with id NId.
+  int GetNIdx(const int& NId) const { return DenseIds ? NId : NIdToIdxH.GetDat(NId).Val; }
+  /// Returns the vector of node ids, indexed by node index.
+  const TIntV& GetNIdV() const { return NIdV; }
+
+  /// Returns the out-degree of node with index NIdx.
+  int GetOutDeg(const int& NIdx) const { return int(OutOffV[NIdx+1] - OutOffV[NIdx]); }
+  /// Returns the in-degree of node with index NIdx.
+  int GetInDeg(const int& NIdx) const { return Dir ? int(InOffV[NIdx+1] - InOffV[NIdx]) : GetOutDeg(NIdx); }
+  /// Returns the position of the first out-neighbor of node with index NIdx in GetOutNbrV().
+  int64 GetOutOff(const int& NIdx) const { return OutOffV[NIdx]; }
+  /// Returns the position of the first in-neighbor of node with index NIdx in GetInNbrV().
+  int64 GetInOff(const int& NIdx) const { return Dir ? InOffV[NIdx] : OutOffV[NIdx]; }
+  /// Returns the index of the Nbr-th out-neighbor of node with index NIdx.
+  int GetOutNbr(const int& NIdx, const int& Nbr) const { return OutNbrV[OutOffV[NIdx]+Nbr]; }
+  /// Returns the index of the Nbr-th in-neighbor of node with index NIdx.
+  int GetInNbr(const int& NIdx, const int& Nbr) const { return Dir ? InNbrV[InOffV[NIdx]+Nbr] : OutNbrV[OutOffV[NIdx]+Nbr]; }
+  /// Returns the out-neighbor offsets, GetNodes()+1 values.
+  const TVec<TInt64>& GetOutOffV() const { return OutOffV; }
+  /// Returns the in-neighbor offsets, GetNodes()+1 values.
+  const TVec<TInt64>& GetInOffV() const { return Dir ? InOffV : OutOffV; }
+  /// Returns all out-neighbor lists, concatenated.
+  const TVec<TInt, int64>& GetOutNbrV() const { return OutNbrV; }
+  /// Returns all in-neighbor lists, concatenated.
+  const TVec<TInt, int64>& GetInNbrV() const { return Dir ? InNbrV : OutNbrV; }
+  /// Tests whether there is an arc from node index SrcNIdx to node index DstNIdx (binary search).
+  bool IsArc(const int& SrcNIdx, const int& DstNIdx) const;
+  /// Returns the number of bytes used by the snapshot.
+  int64 GetMemUsed() const;
+  friend class TPt<TCsrGraph>;
+};
+
+template <class PGraph>
+void TCsrGraph::Build(const PGraph& Graph) {
+  Dir = HasGraphFlag(typename PGraph::TObj, gfDirected);
+  const int Nodes = Graph->GetNodes();
+  NIdV.Gen(Nodes, 0);
+  for (typename PGraph::TObj::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    NIdV.Add(NI.GetId());
+  }
+  NIdV.Sort();
+  BuildIdMap();
+  // offsets
+  OutOffV.Gen(Nodes+1);
+  if (Dir) { InOffV.Gen(Nodes+1); }
+  for (int n = 0; n < Nodes; n++) {
+    const typename PGraph::TObj::TNodeI NI = Graph->GetNI(NIdV[n]);
+    OutOffV[n+1] = OutOffV[n] + NI.GetOutDeg();
+    if (Dir) { InOffV[n+1] = InOffV[n] + NI.GetInDeg(); }
+  }
+  OutNbrV.Gen(OutOffV[Nodes]);
+  if (Dir) { InNbrV.Gen(InOffV[Nodes]); }
+  // neighbors, translated to node indices
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    const typename PGraph::TObj::TNodeI NI = Graph->GetNI(NIdV[n]);
+    int64 Off = OutOffV[n];
+    for (int e = 0; e < NI.GetOutDeg(); e++) {
+      OutNbrV[Off++] = GetNIdx(NI.GetOutNId(e));
+    }
+    if (Dir) {
+      Off = InOffV[n];
+      for (int e = 0; e < NI.GetInDeg(); e++) {
+        InNbrV[Off++] = GetNIdx(NI.GetInNId(e));
+      }
+    }
+  }
+  SortNbrs(OutOffV, OutNbrV);
+  if (Dir) { SortNbrs(InOffV, InNbrV); }
+}
+
+/////////////////////////////////////////////////
+// Sparse matrix-vector products on CSR snapshots
+namespace TSnap {
+
+/// Returns the sum of XV over the out-neighbors of node index NIdx, weighted by OutWgtV (aligned with GetOutNbrV()) unless it is empty.
+template <class TVal>
+double GetCsrOutSum(const TCsrGraph& Graph, const int& NIdx, const TVec<TVal>& XV, const TVec<TFlt, int64>& OutWgtV) {
+  const TVec<TInt, int64>& NbrV = Graph.GetOutNbrV();
+  const int64 EndOff = Graph.GetOutOff(NIdx+1);
+  double Sum = 0.0;
+  if (OutWgtV.Empty()) {
+    for (int64 e = Graph.GetOutOff(NIdx); e < EndOff; e++) { Sum += XV[NbrV[e]].Val; }
+  } else {
+    for (int64 e = Graph.GetOutOff(NIdx); e < EndOff; e++) { Sum += OutWgtV[e] * XV[NbrV[e]].Val; }
+  }
+  return Sum;
+}
+
+/// Returns the sum of XV over the in-neighbors of node index NIdx, weighted by InWgtV (aligned with GetInNbrV()) unless it is empty.
+template <class TVal>
+double GetCsrInSum(const TCsrGraph& Graph, const int& NIdx, const TVec<TVal>& XV, const TVec<TFlt, int64>& InWgtV) {
+  const TVec<TInt, int64>& NbrV = Graph.GetInNbrV();
+  const int64 EndOff = Graph.GetInOff(NIdx+1);
+  double Sum = 0.0;
+  if (InWgtV.Empty()) {
+    for (int64 e = Graph.GetInOff(NIdx); e < EndOff; e++) { Sum += XV[NbrV[e]].Val; }
+  } else {
+    for (int64 e = Graph.GetInOff(NIdx); e < EndOff; e++) { Sum += InWgtV[e] * XV[NbrV[e]].Val; }
+  }
+  return Sum;
+}
+
+/// Computes YV = A*XV in parallel, where A is the adjacency matrix of Graph (A[u][v] is the weight of arc u->v).
+/// Vectors are indexed by node index. OutWgtV holds arc weights aligned with GetOutNbrV(), if empty all weights are 1.
+template <class TVal>
+void MulCsrAdj(const TCsrGraph& Graph, const TVec<TVal>& XV, TVec<TVal>& YV, const TVec<TFlt, int64>& OutWgtV=TVec<TFlt, int64>()) {
+  const int Nodes = Graph.GetNodes();
+  IAssert(XV.Len() == Nodes && (OutWgtV.Empty() || OutWgtV.Len() == Graph.GetArcs()));
+  if (YV.Len() != Nodes) { YV.Gen(Nodes); }
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    YV[n] = GetCsrOutSum(Graph, n, XV, OutWgtV);
+  }
+}
+
+/// Computes YV = A^T*XV in parallel, where A is the adjacency matrix of Graph (A[u][v] is the weight of arc u->v).
+/// Vectors are indexed by node index. InWgtV holds arc weights aligned with GetInNbrV() (see GetCsrInWgtV()), if empty all weights are 1.
+template <class TVal>
+void MulCsrAdjT(const TCsrGraph& Graph, const TVec<TVal>& XV, TVec<TVal>& YV, const TVec<TFlt, int64>& InWgtV=TVec<TFlt, int64>()) {
+  const int Nodes = Graph.GetNodes();
+  IAssert(XV.Len() == Nodes && (InWgtV.Empty() || InWgtV.Len() == Graph.GetArcs()));
+  if (YV.Len() != Nodes) { YV.Gen(Nodes); }
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Nodes; n++) {
+    YV[n] = GetCsrInSum(Graph, n, XV, InWgtV);
+  }
+}
+
+/// Reorders arc weights OutWgtV, aligned with GetOutNbrV(), into InWgtV, aligned with GetInNbrV().
+/// Undirected snapshots share the storage of both lists, so the weights are copied (they must be symmetric).
+void GetCsrInWgtV(const TCsrGraph& Graph, const TVec<TFlt, int64>& OutWgtV, TVec<TFlt, int64>& InWgtV);
+
+} // namespace TSnap
+
+/////////////////////////////////////////////////
+// Sorting inside parallel regions
+namespace TSnap {
+
+/// Sorts the values between iterators BI and EI in ascending (Asc=true) or descending order.
+/// TVec and THash sorts draw their pivots from TInt::Rnd, which all threads share, so parallel code sorts with SortMP() instead.
+template <class TIter>
+void SortMP(TIter BI, TIter EI, const bool& Asc=true) {
+  typedef typename std::iterator_traits<TIter>::value_type TVal;
+  if (Asc) { std::sort(BI, EI, TLss<TVal>()); }
+  else { std::sort(BI, EI, TGtr<TVal>()); }
+}
+
+/// Sorts all the values of ValV, see SortMP(BI, EI, Asc).
+template <class TVal, class TSizeTy>
+void SortMP(TVec<TVal, TSizeTy>& ValV, const bool& Asc=true) { SortMP(ValV.BegI(), ValV.EndI(), Asc); }
+
+/// Sorts the values between iterators BI and EI under the comparator Cmp, see SortMP(BI, EI, Asc).
+template <class TIter, class TCmp>
+void SortCmpMP(TIter BI, TIter EI, const TCmp& Cmp) { std::sort(BI, EI, Cmp); }
+
+} // namespace TSnap
+
+#endif // CSR_H
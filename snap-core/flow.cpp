@@ -426,3 +426,236 @@ int GetMaxFlowIntPR (PNEANet &Net, const int& SrcNId, const int& SnkNId) {
 
 
 };
+
+/////////////////////////////////////////////////
+// Flow network
+TFlowNet::TFlowNet(const PNEANet& Net, const TStr& CapAttr) : CRef(), NIdV(), NIdToIdxH(), OffV(), HeadV(), RevV(), CapV(), EIdV() {
+  const int CapIndex = Net->GetIntAttrIndE(CapAttr);
+  const int Nodes = Net->GetNodes();
+  NIdV.Gen(Nodes, 0);
+  for (TNEANet::TNodeI NI = Net->BegNI(); NI < Net->EndNI(); NI++) { NIdV.Add(NI.GetId()); }
+  NIdV.Sort();
+  NIdToIdxH.Gen(Nodes);
+  for (int n = 0; n < Nodes; n++) { NIdToIdxH.AddDat(NIdV[n], n); }
+  // every edge u->v adds an arc to u and its reverse arc to v
+  OffV.Gen(Nodes+1);
+  for (TNEANet::TEdgeI EI = Net->BegEI(); EI < Net->EndEI(); EI++) {
+    if (EI.GetSrcNId() == EI.GetDstNId()) { continue; }
+    OffV[GetNIdx(EI.GetSrcNId())+1]++;
+    OffV[GetNIdx(EI.GetDstNId())+1]++;
+  }
+  for (int n = 0; n < Nodes; n++) { OffV[n+1] += OffV[n]; }
+  const int64 Arcs = OffV[Nodes];
+  HeadV.Gen(Arcs);  RevV.Gen(Arcs);  CapV.Gen(Arcs);  EIdV.Gen(Arcs);
+  TVec<TInt64> PosV(OffV);
+  for (TNEANet::TEdgeI EI = Net->BegEI(); EI < Net->EndEI(); EI++) {
+    if (EI.GetSrcNId() == EI.GetDstNId()) { continue; }
+    const int Cap = Net->GetIntAttrIndDatE(EI, CapIndex);
+    IAssertR(Cap >= 0, TStr::Fmt("Edge %d has negative capacity", EI.GetId()));
+    const int SrcNIdx = GetNIdx(EI.GetSrcNId()), DstNIdx = GetNIdx(EI.GetDstNId());
+    const int64 Fwd = PosV[SrcNIdx]++, Bwd = PosV[DstNIdx]++;
+    HeadV[Fwd] = DstNIdx;  RevV[Fwd] = Bwd;  CapV[Fwd] = Cap;  EIdV[Fwd] = EI.GetId();
+    HeadV[Bwd] = SrcNIdx;  RevV[Bwd] = Fwd;  CapV[Bwd] = 0;    EIdV[Bwd] = -1;
+  }
+}
+
+namespace TSnap {
+namespace TSnapDetail {
+
+//#//////////////////////////////////////////////
+/// Highest-label push-relabel on a TFlowNet, with global and gap relabeling. ##TFlowNetPR
+/// Holds the residual capacities, excesses and labels of one query, so one instance per thread can answer many queries.
+/// Only the first phase is run: it computes a maximum preflow, which gives the flow value and a minimum cut.
+class TFlowNetPR {
+private:
+  const TFlowNet& Net;
+  int Nodes, SrcNIdx, SnkNIdx;
+  TVec<TInt, int64> ResV;           // residual capacities
+  TVec<TInt64> ExcessV;
+  TIntV LabelV;                     // distance label, Nodes if the sink is not reachable
+  TVec<TInt64> CurArcV;             // next residual arc to scan in discharge
+  TIntV ActFirstV, ActNextV;        // active nodes of every label, singly linked
+  TIntV AllFirstV, AllNextV, AllPrevV; // all nodes of every label below Nodes, doubly linked (for gap relabeling)
+  int MxActLabel, MxLabel;
+  int64 WorkSinceUpd;
+  TIntV OrderV;                     // nodes in the order of global relabel BFS
+private:
+  void AddActive(const int& NIdx) { const int Label = LabelV[NIdx];
+    ActNextV[NIdx] = ActFirstV[Label];  ActFirstV[Label] = NIdx;  MxActLabel = TMath::Mx(MxActLabel, Label); }
+  void AddAll(const int& NIdx) { const int Label = LabelV[NIdx];
+    AllPrevV[NIdx] = -1;  AllNextV[NIdx] = AllFirstV[Label];
+    if (AllFirstV[Label] != -1) { AllPrevV[AllFirstV[Label]] = NIdx; }
+    AllFirstV[Label] = NIdx;  MxLabel = TMath::Mx(MxLabel, Label); }
+  void DelAll(const int& NIdx) {
+    if (AllPrevV[NIdx] == -1) { AllFirstV[LabelV[NIdx]] = AllNextV[NIdx]; } else { AllNextV[AllPrevV[NIdx]] = AllNextV[NIdx]; }
+    if (AllNextV[NIdx] != -1) { AllPrevV[AllNextV[NIdx]] = AllPrevV[NIdx]; } }
+  void Gap(const int& GapLabel);
+  void Discharge(const int& NIdx);
+public:
+  TFlowNetPR(const TFlowNet& FlowNet);
+  /// Computes a maximum preflow from SrcNIdx to SnkNIdx and returns its value.
+  int64 Run(const int& SrcNIdx, const int& SnkNIdx);
+  /// Relabels nodes with their exact distance to the sink in the residual graph (reverse BFS, parallel for large levels).
+  void GlobalRelabel();
+  /// Tests whether node index NIdx is on the source side of the minimum cut. Valid after Run().
+  bool IsSrcSide(const int& NIdx) const { return LabelV[NIdx] == Nodes; }
+};
+
+TFlowNetPR::TFlowNetPR(const TFlowNet& FlowNet) : Net(FlowNet), Nodes(FlowNet.GetNodes()), SrcNIdx(-1), SnkNIdx(-1),
+  ResV(FlowNet.GetArcs()), ExcessV(FlowNet.GetNodes()), LabelV(FlowNet.GetNodes()), CurArcV(FlowNet.GetNodes()),
+  ActFirstV(FlowNet.GetNodes()), ActNextV(FlowNet.GetNodes()), AllFirstV(FlowNet.GetNodes()), AllNextV(FlowNet.GetNodes()),
+  AllPrevV(FlowNet.GetNodes()), MxActLabel(-1), MxLabel(-1), WorkSinceUpd(0), OrderV(FlowNet.GetNodes(), 0) {
+  ActFirstV.PutAll(-1);  AllFirstV.PutAll(-1);
+}
+
+void TFlowNetPR::GlobalRelabel() {
+  LabelV.PutAll(Nodes);
+  LabelV[SnkNIdx] = 0;
+  OrderV.Reduce(0);
+  OrderV.Add(SnkNIdx);
+  int LevelBeg = 0, Level = 0;
+  while (LevelBeg < OrderV.Len()) {
+    const int LevelEnd = OrderV.Len();
+    Level++;
+    // u gets label Level if it has a residual arc to a node of the previous level
+    #pragma omp parallel for schedule(dynamic,1000) if (LevelEnd-LevelBeg > 10000)
+    for (int i = LevelBeg; i < LevelEnd; i++) {
+      const int NIdx = OrderV[i];
+      for (int64 a = Net.GetOff(NIdx); a < Net.GetOff(NIdx+1); a++) {
+        const int Nbr = Net.GetHead(a);
+        if (LabelV[Nbr] == Nodes && Nbr != SrcNIdx && ResV[Net.GetRev(a)] > 0) {
+#ifdef USE_OPENMP
+          if (__sync_bool_compare_and_swap(&LabelV[Nbr].Val, Nodes, Level)) { OrderV.AddMP(Nbr); }
+#else
+          LabelV[Nbr] = Level;  OrderV.Add(Nbr);
+#endif
+        }
+      }
+    }
+    LevelBeg = LevelEnd;
+  }
+  // rebuild the buckets
+  for (int l = 0; l <= TMath::Mn(TMath::Mx(Level, MxLabel), Nodes-1); l++) { ActFirstV[l] = -1;  AllFirstV[l] = -1; }
+  MxActLabel = -1;  MxLabel = -1;
+  for (int i = 1; i < OrderV.Len(); i++) {
+    const int NIdx = OrderV[i];
+    CurArcV[NIdx] = Net.GetOff(NIdx);
+    AddAll(NIdx);
+    if (ExcessV[NIdx] > 0) { AddActive(NIdx); }
+  }
+  WorkSinceUpd = 0;
+}
+
+// No node has label GapLabel anymore, so nodes above it cannot reach the sink.
+void TFlowNetPR::Gap(const int& GapLabel) {
+  for (int l = GapLabel; l <= MxLabel; l++) {
+    for (int NIdx = AllFirstV[l]; NIdx != -1; NIdx = AllNextV[NIdx]) { LabelV[NIdx] = Nodes; }
+    AllFirstV[l] = -1;  ActFirstV[l] = -1;
+  }
+  MxLabel = GapLabel-1;
+  MxActLabel = TMath::Mn(MxActLabel, MxLabel);
+}
+
+void TFlowNetPR::Discharge(const int& NIdx) {
+  const int64 EndArc = Net.GetOff(NIdx+1);
+  while (true) {
+    const int Label = LabelV[NIdx];
+    int64 a;
+    for (a = CurArcV[NIdx]; a < EndArc; a++) {
+      const int Nbr = Net.GetHead(a);
+      if (ResV[a] == 0 || LabelV[Nbr] != Label-1) { continue; }
+      const int Push = int(TMath::Mn(int64(ResV[a]), ExcessV[NIdx].Val));
+      ResV[a] -= Push;  ResV[Net.GetRev(a)] += Push;
+      if (ExcessV[Nbr] == 0 && Nbr != SnkNIdx) { AddActive(Nbr); }
+      ExcessV[Nbr] += Push;  ExcessV[NIdx] -= Push;
+      if (ExcessV[NIdx] == 0) { break; }
+    }
+    if (a < EndArc) { CurArcV[NIdx] = a;  return; }
+    // relabel, the node left alone at its label leaves a gap
+    if (AllFirstV[Label] == NIdx && AllNextV[NIdx] == -1) { Gap(Label);  return; }
+    DelAll(NIdx);
+    int MnLabel = Nodes;
+    for (a = Net.GetOff(NIdx); a < EndArc; a++) {
+      if (ResV[a] > 0 && LabelV[Net.GetHead(a)] < MnLabel) { MnLabel = LabelV[Net.GetHead(a)];  CurArcV[NIdx] = a; }
+    }
+    WorkSinceUpd += EndArc - Net.GetOff(NIdx) + 12;
+    if (MnLabel+1 >= Nodes) { LabelV[NIdx] = Nodes;  return; }
+    LabelV[NIdx] = MnLabel+1;
+    AddAll(NIdx);
+  }
+}
+
+int64 TFlowNetPR::Run(const int& SrcNIdx, const int& SnkNIdx) {
+  this->SrcNIdx = SrcNIdx;  this->SnkNIdx = SnkNIdx;
+  const TVec<TInt, int64>& CapV = Net.GetCapV();
+  #pragma omp parallel for schedule(static) if (CapV.Len() > 100000)
+  for (int64 a = 0; a < CapV.Len(); a++) { ResV[a] = CapV[a]; }
+  ExcessV.PutAll(0);
+  for (int64 a = Net.GetOff(SrcNIdx); a < Net.GetOff(SrcNIdx+1); a++) {
+    const int Push = ResV[a];
+    ResV[a] = 0;  ResV[Net.GetRev(a)] += Push;
+    ExcessV[Net.GetHead(a)] += Push;
+  }
+  GlobalRelabel();
+  // global relabel after about as much relabel work as scanning the whole graph a few times
+  const int64 UpdWork = 12*int64(Nodes) + 2*Net.GetArcs();
+  while (MxActLabel >= 0) {
+    const int NIdx = ActFirstV[MxActLabel];
+    if (NIdx == -1) { MxActLabel--;  continue; }
+    ActFirstV[MxActLabel] = ActNextV[NIdx];
+    Discharge(NIdx);
+    if (WorkSinceUpd > UpdWork) { GlobalRelabel(); }
+  }
+  return ExcessV[SnkNIdx];
+}
+
+} // namespace TSnapDetail
+} // namespace TSnap
+
+int64 TFlowNet::GetMaxFlow(const int& SrcNId, const int& SnkNId) const {
+  IAssert(IsNode(SrcNId) && IsNode(SnkNId));
+  if (SrcNId == SnkNId) { return 0; }
+  TSnap::TSnapDetail::TFlowNetPR PR(*this);
+  return PR.Run(GetNIdx(SrcNId), GetNIdx(SnkNId));
+}
+
+int64 TFlowNet::GetMinCut(const int& SrcNId, const int& SnkNId, TIntV& SrcSideNIdV, TIntV& CutEIdV) const {
+  IAssert(IsNode(SrcNId) && IsNode(SnkNId));
+  SrcSideNIdV.Clr(false);  CutEIdV.Clr(false);
+  if (SrcNId == SnkNId) { return 0; }
+  TSnap::TSnapDetail::TFlowNetPR PR(*this);
+  const int64 Flow = PR.Run(GetNIdx(SrcNId), GetNIdx(SnkNId));
+  // labels are only lower bounds on the distances to the sink, exact distances give the cut
+  PR.GlobalRelabel();
+  for (int n = 0; n < GetNodes(); n++) {
+    if (! PR.IsSrcSide(n)) { continue; }
+    SrcSideNIdV.Add(GetNId(n));
+    for (int64 a = GetOff(n); a < GetOff(n+1); a++) {
+      if (GetEId(a) != -1 && ! PR.IsSrcSide(GetHead(a))) { CutEIdV.Add(GetEId(a)); }
+    }
+  }
+  return Flow;
+}
+
+void TFlowNet::GetMaxFlowBatch(const TIntPrV& SrcSnkNIdPrV, TVec<TInt64>& FlowV, TVec<TIntV>* SrcSideNIdVV) const {
+  const int Queries = SrcSnkNIdPrV.Len();
+  for (int q = 0; q < Queries; q++) { IAssert(IsNode(SrcSnkNIdPrV[q].Val1) && IsNode(SrcSnkNIdPrV[q].Val2)); }
+  FlowV.Gen(Queries);
+  if (SrcSideNIdVV != NULL) { SrcSideNIdVV->Gen(Queries); }
+  #pragma omp parallel
+  {
+    TSnap::TSnapDetail::TFlowNetPR PR(*this);
+    #pragma omp for schedule(dynamic,1)
+    for (int q = 0; q < Queries; q++) {
+      if (SrcSnkNIdPrV[q].Val1 == SrcSnkNIdPrV[q].Val2) { FlowV[q] = 0;  continue; }
+      FlowV[q] = PR.Run(GetNIdx(SrcSnkNIdPrV[q].Val1), GetNIdx(SrcSnkNIdPrV[q].Val2));
+      if (SrcSideNIdVV != NULL) {
+        PR.GlobalRelabel();
+        TIntV& SrcSideNIdV = (*SrcSideNIdVV)[q];
+        for (int n = 0; n < GetNodes(); n++) {
+          if (PR.IsSrcSide(n)) { SrcSideNIdV.Add(GetNId(n)); }
+        }
+      }
+    }
+  }
+}
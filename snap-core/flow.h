@@ -9,3 +9,69 @@ int GetMaxFlowIntEK (PNEANet &Net, const int &SrcNId, const int &SnkNId);
 int GetMaxFlowIntPR (PNEANet &Net, const int &SrcNId, const int &SnkNId);
 
 };
+
+/////////////////////////////////////////////////
+// Flow network
+class TFlowNet;
+/// Pointer to a flow network (TFlowNet)
+typedef TPt<TFlowNet> PFlowNet;
+
+//#//////////////////////////////////////////////
+/// Flow network with integer capacities, stored as a flat residual graph for repeated max-flow/min-cut queries.
+/// Nodes are renumbered to node indices 0...N-1 in the increasing order of their ids. Every edge of the network
+/// is stored as a pair of residual arcs, the edge itself and its reverse arc with capacity 0, grouped by tail node.
+/// Residual arcs of node index NIdx are at positions GetOff(NIdx)...GetOff(NIdx+1)-1. Self-loops are dropped.
+/// The network does not change after it is built, so any number of queries can run concurrently on it.
+class TFlowNet {
+private:
+  TCRef CRef;
+  TIntV NIdV;                       // node index -> node id
+  TIntIntH NIdToIdxH;               // node id -> node index
+  TVec<TInt64> OffV;
+  TVec<TInt, int64> HeadV;          // head node index of the residual arc
+  TVec<TInt64, int64> RevV;         // position of the reverse residual arc
+  TVec<TInt, int64> CapV;           // capacity, 0 for reverse arcs
+  TVec<TInt, int64> EIdV;           // edge id for edges of the network, -1 for reverse arcs
+public:
+  TFlowNet() : CRef(), NIdV(), NIdToIdxH(), OffV(), HeadV(), RevV(), CapV(), EIdV() { }
+  /// Builds the residual graph of Net, capacities are taken from the integer edge attribute CapAttr and must be nonnegative.
+  TFlowNet(const PNEANet& Net, const TStr& CapAttr=TSnap::CapAttrName);
+  /// Builds the residual graph of Net and returns a pointer to it.
+  static PFlowNet New(const PNEANet& Net, const TStr& CapAttr=TSnap::CapAttrName) { return new TFlowNet(Net, CapAttr); }
+
+  /// Returns the number of nodes.
+  int GetNodes() const { return NIdV.Len(); }
+  /// Returns the number of residual arcs, twice the number of edges that are not self-loops.
+  int64 GetArcs() const { return HeadV.Len(); }
+  /// Tests whether node with id NId is in the network.
+  bool IsNode(const int& NId) const { return NIdToIdxH.IsKey(NId); }
+  /// Returns the node id of the node with index NIdx.
+  int GetNId(const int& NIdx) const { return NIdV[NIdx]; }
+  /// Returns the node index of the node with id NId.
+  int GetNIdx(const int& NId) const { return NIdToIdxH.GetDat(NId); }
+  /// Returns the position of the first residual arc of node index NIdx.
+  int64 GetOff(const int& NIdx) const { return OffV[NIdx]; }
+  /// Returns the head node index of residual arc ArcN.
+  int GetHead(const int64& ArcN) const { return HeadV[ArcN]; }
+  /// Returns the position of the reverse arc of residual arc ArcN.
+  int64 GetRev(const int64& ArcN) const { return RevV[ArcN]; }
+  /// Returns the capacity of residual arc ArcN, 0 for reverse arcs.
+  int GetCap(const int64& ArcN) const { return CapV[ArcN]; }
+  /// Returns the edge id of residual arc ArcN, -1 for reverse arcs.
+  int GetEId(const int64& ArcN) const { return EIdV[ArcN]; }
+  /// Returns the capacities of all residual arcs.
+  const TVec<TInt, int64>& GetCapV() const { return CapV; }
+
+  /// Returns the maximum flow from SrcNId to SnkNId, 0 if SrcNId == SnkNId.
+  /// Uses highest-label push-relabel with global and gap relabeling. ##TFlowNet::GetMaxFlow
+  int64 GetMaxFlow(const int& SrcNId, const int& SnkNId) const;
+  /// Returns the maximum flow from SrcNId to SnkNId and a minimum cut: SrcSideNIdV holds the ids of nodes on the source
+  /// side (nodes that cannot reach SnkNId in the final residual graph) and CutEIdV the ids of the edges from the source
+  /// to the sink side. Their capacities sum to the returned flow. Both vectors are empty if SrcNId == SnkNId.
+  int64 GetMinCut(const int& SrcNId, const int& SnkNId, TIntV& SrcSideNIdV, TIntV& CutEIdV) const;
+  /// Answers many max-flow queries, FlowV[i] is the maximum flow from SrcSnkNIdPrV[i].Val1 to SrcSnkNIdPrV[i].Val2.
+  /// Queries run in parallel, each thread reuses one set of residual arrays. If SrcSideNIdVV is not NULL,
+  /// (*SrcSideNIdVV)[i] holds the source side of the minimum cut of query i (see GetMinCut()).
+  void GetMaxFlowBatch(const TIntPrV& SrcSnkNIdPrV, TVec<TInt64>& FlowV, TVec<TIntV>* SrcSideNIdVV=NULL) const;
+  friend class TPt<TFlowNet>;
+};
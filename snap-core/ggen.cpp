@@ -540,6 +540,150 @@ PNGraph GenRMat(const int& Nodes, const int& Edges, const double& A, const doubl
   return GraphPt;
 }
 
+namespace TSnapDetail {
+// one stable counting sort pass of InV into OutV by source (BySrc) or destination node id
+static void CntSortEdgeV(const int& Nodes, const bool& BySrc, const TIntPrV& InV, TIntPrV& OutV) {
+  TIntV OffV(Nodes+1);
+  for (int e = 0; e < InV.Len(); e++) {
+    OffV[(BySrc ? InV[e].Val1 : InV[e].Val2) + 1]++; }
+  for (int n = 0; n < Nodes; n++) { OffV[n+1] += OffV[n]; }
+  OutV.Gen(InV.Len());
+  for (int e = 0; e < InV.Len(); e++) {
+    OutV[OffV[BySrc ? InV[e].Val1 : InV[e].Val2].Val++] = InV[e]; }
+}
+
+void SortEdgeV(const int& Nodes, TIntPrV& EdgeV) {
+  // counting sort takes O(Nodes), only use it when there are enough edges
+  if (EdgeV.Len() < Nodes / 4) { EdgeV.Sort();  return; }
+  TIntPrV TmpV;
+  CntSortEdgeV(Nodes, false, EdgeV, TmpV);
+  CntSortEdgeV(Nodes, true, TmpV, EdgeV);
+}
+
+void MergeEdgeV(TIntPrV& DistEdgeV, const TIntPrV& EdgeV) {
+  TIntPrV MergeV(DistEdgeV.Len() + EdgeV.Len(), 0);
+  int i = 0, j = 0;
+  while (i < DistEdgeV.Len() || j < EdgeV.Len()) {
+    const TIntPr& Edge = (j == EdgeV.Len() || (i < DistEdgeV.Len() && DistEdgeV[i] < EdgeV[j])) ? DistEdgeV[i++] : EdgeV[j++];
+    if (MergeV.Empty() || !(MergeV.Last() == Edge)) { MergeV.Add(Edge); }
+  }
+  DistEdgeV.Swap(MergeV);
+}
+
+PNGraph GetEdgeVGraph(const int& Nodes, const TIntPrV& EdgeV, const bool& IsDir) {
+  TIntPrV ArcV;
+  if (! IsDir) {
+    ArcV.Gen(2*EdgeV.Len(), 0);
+    for (int e = 0; e < EdgeV.Len(); e++) {
+      ArcV.Add(EdgeV[e]);
+      if (EdgeV[e].Val1 != EdgeV[e].Val2) { ArcV.Add(TIntPr(EdgeV[e].Val2, EdgeV[e].Val1)); }
+    }
+    SortEdgeV(Nodes, ArcV);
+  }
+  const TIntPrV& SortArcV = IsDir ? EdgeV : ArcV;
+  const int Arcs = SortArcV.Len();
+  // out- and in-neighbors of each node, sorted since arcs are sorted by (source, destination)
+  TIntV OutOffV(Nodes+1), InOffV(Nodes+1), OutNIdV(Arcs), InNIdV(Arcs);
+  for (int e = 0; e < Arcs; e++) {
+    OutOffV[SortArcV[e].Val1+1]++;  InOffV[SortArcV[e].Val2+1]++; }
+  for (int n = 0; n < Nodes; n++) {
+    OutOffV[n+1] += OutOffV[n];  InOffV[n+1] += InOffV[n]; }
+  TIntV InPosV(InOffV);
+  for (int e = 0; e < Arcs; e++) {
+    OutNIdV[e] = SortArcV[e].Val2;
+    InNIdV[InPosV[SortArcV[e].Val2].Val++] = SortArcV[e].Val1;
+  }
+  PNGraph Graph = TNGraph::New(Nodes, Arcs);
+  TIntV InV, OutV; // views into InNIdV and OutNIdV
+  for (int n = 0; n < Nodes; n++) {
+    InV.GenExt(InNIdV.BegI()+InOffV[n], InOffV[n+1]-InOffV[n]);
+    OutV.GenExt(OutNIdV.BegI()+OutOffV[n], OutOffV[n+1]-OutOffV[n]);
+    Graph->AddNode(n, InV, OutV);
+  }
+  return Graph;
+}
+
+int GetEdgeTxt(char* Bf, const int& SrcNId, const int& DstNId) {
+  char DigitBf[12];
+  int Len = 0;
+  const int NIdV[] = { SrcNId, DstNId };
+  for (int i = 0; i < 2; i++) {
+    int NId = NIdV[i], Digits = 0;
+    if (NId < 0) { Bf[Len++] = '-';  NId = -NId; }
+    do { DigitBf[Digits++] = char('0' + NId % 10);  NId /= 10; } while (NId > 0);
+    while (Digits > 0) { Bf[Len++] = DigitBf[--Digits]; }
+    Bf[Len++] = i == 0 ? '\t' : '\n';
+  }
+  return Len;
+}
+
+// R-MAT edge sampler for GenRMatMP() and SaveRMatMP(), same recursive descent as GenRMat()
+class TRMatEdgeGen {
+private:
+  int Nodes;
+  uint64 Seed;
+  TFltV SumAV, SumABV, SumACV, SumABCV; // cumulative quadrant probabilities per depth
+public:
+  TRMatEdgeGen(const int& _Nodes, const double& A, const double& B, const double& C, const int& _Seed) :
+      Nodes(_Nodes), Seed(_Seed), SumAV(128, 0), SumABV(128, 0), SumACV(128, 0), SumABCV(128, 0) {
+    IAssert(A+B+C < 1.0 && Nodes > 1);
+    // noise on the parameters comes from a stream no edge uses
+    TCntRnd Rnd(Seed, ~uint64(0));
+    for (int i = 0; i < 128; i++) {
+      const double a = A * (Rnd.GetUniDev() + 0.5);
+      const double b = B * (Rnd.GetUniDev() + 0.5);
+      const double c = C * (Rnd.GetUniDev() + 0.5);
+      const double d = (1.0 - (A+B+C)) * (Rnd.GetUniDev() + 0.5);
+      const double abcd = a+b+c+d;
+      SumAV.Add(a / abcd);
+      SumABV.Add((a+b) / abcd);
+      SumACV.Add((a+c) / abcd);
+      SumABCV.Add((a+b+c) / abcd);
+    }
+  }
+  // self-loops are redrawn from the same stream
+  void GetEdge(const int64& EdgeN, int& SrcNId, int& DstNId) const {
+    TCntRnd Rnd(Seed, EdgeN);
+    do {
+      int rngX = Nodes, rngY = Nodes, offX = 0, offY = 0, Depth = 0;
+      while (rngX > 1 || rngY > 1) {
+        const double RndProb = Rnd.GetUniDev();
+        if (rngX>1 && rngY>1) {
+          if (RndProb < SumAV[Depth]) { rngX/=2; rngY/=2; }
+          else if (RndProb < SumABV[Depth]) { offX+=rngX/2;  rngX-=rngX/2;  rngY/=2; }
+          else if (RndProb < SumABCV[Depth]) { offY+=rngY/2;  rngX/=2;  rngY-=rngY/2; }
+          else { offX+=rngX/2;  offY+=rngY/2;  rngX-=rngX/2;  rngY-=rngY/2; }
+        } else
+        if (rngX>1) { // row vector
+          if (RndProb < SumACV[Depth]) { rngX/=2; rngY/=2; }
+          else { offX+=rngX/2;  rngX-=rngX/2;  rngY/=2; }
+        } else { // column vector
+          if (RndProb < SumABV[Depth]) { rngX/=2; rngY/=2; }
+          else { offY+=rngY/2;  rngX/=2;  rngY-=rngY/2; }
+        }
+        Depth++;
+      }
+      SrcNId = offX;  DstNId = offY;
+    } while (SrcNId == DstNId);
+  }
+};
+} // namespace TSnapDetail
+
+PNGraph GenRMatMP(const int& Nodes, const int& Edges, const double& A, const double& B, const double& C, const int& Seed) {
+  const TSnapDetail::TRMatEdgeGen EdgeGen(Nodes, A, B, C, Seed);
+  int64 Draws = 0;
+  PNGraph Graph = TSnapDetail::GenEdgeGraphMP(EdgeGen, Nodes, Edges, true, Draws);
+  const int64 Collisions = Draws - Edges;
+  printf("\r  RMat: nodes:%d, edges:%d, Iterations:%s, Collisions:%s (%.1f%%).\n", Nodes, Edges,
+    TInt::GetStr(Draws).CStr(), TInt::GetStr(Collisions).CStr(), 100*Collisions/double(Draws));
+  return Graph;
+}
+
+void SaveRMatMP(const TStr& OutFNm, const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, const bool& Binary, const int& Seed) {
+  const TSnapDetail::TRMatEdgeGen EdgeGen(Nodes, A, B, C, Seed);
+  TSnapDetail::SaveEdgesMP(EdgeGen, OutFNm, Nodes, Edges, Binary, TStr::Fmt("RMat: A=%g B=%g C=%g seed=%d", A, B, C, Seed));
+}
+
 /// R-Mat generator with parameters set so that it generates a synthetic copy
 /// of the Epinions social network.
 /// The original Epinions social network can be downloaded at 
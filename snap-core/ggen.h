@@ -48,6 +48,10 @@ PNGraph GenCopyModel(const int& Nodes, const double& Beta, TRnd& Rnd=TInt::Rnd);
 PNGraph GenRMat(const int& Nodes, const int& Edges, const double& A, const double& B, const double& C, TRnd& Rnd=TInt::Rnd);
 /// Generates a R-Mat graph, with a synthetic copy of the Epinions social network.
 PNGraph GenRMatEpinions();
+/// Generates a R-MAT graph in parallel. Edge i is drawn from the counter-based random stream (Seed, i), so the graph depends only on Seed and not on the number of threads.
+PNGraph GenRMatMP(const int& Nodes, const int& Edges, const double& A, const double& B, const double& C, const int& Seed=1);
+/// Streams Edges R-MAT edges to OutFNm in parallel without building the graph. Duplicate edges are kept. Text files have one tab separated edge per line, binary files are (SrcNId, DstNId) pairs of 32-bit integers.
+void SaveRMatMP(const TStr& OutFNm, const int& Nodes, const int64& Edges, const double& A, const double& B, const double& C, const bool& Binary=false, const int& Seed=1);
 
   
 /// Rewire a random undirected graph. Keeps node degrees the same, but randomly rewires the edges.
@@ -262,6 +266,89 @@ TIntPr GetRndEdgeNonAdjNode(const PGraph& Graph, int NId1, int NId2) {
   return TIntPr(NI1.GetId(), NI2.GetId());
 }
 
+// Parallel edge sampling. TEdgeGen::GetEdge(EdgeN, SrcNId, DstNId) const returns the
+// EdgeN-th sampled edge and must depend only on EdgeN (use a TCntRnd stream per edge).
+
+/// Sorts EdgeV by (source, destination) node id.
+void SortEdgeV(const int& Nodes, TIntPrV& EdgeV);
+/// Merges sorted EdgeV into sorted DistEdgeV, keeping a single copy of each edge.
+void MergeEdgeV(TIntPrV& DistEdgeV, const TIntPrV& EdgeV);
+/// Builds a directed graph on nodes 0...Nodes-1 from sorted distinct EdgeV. If not IsDir, edges are added in both directions.
+PNGraph GetEdgeVGraph(const int& Nodes, const TIntPrV& EdgeV, const bool& IsDir);
+/// Writes "SrcNId\tDstNId\n" to Bf and returns the number of characters.
+int GetEdgeTxt(char* Bf, const int& SrcNId, const int& DstNId);
+
+/// Samples edges FromN...FromN+EdgeV.Len()-1 in parallel. If not IsDir, edges are stored as (min, max) pairs.
+template <class TEdgeGen>
+void GetEdgesMP(const TEdgeGen& EdgeGen, const int64& FromN, const bool& IsDir, TIntPrV& EdgeV) {
+  const int Edges = EdgeV.Len();
+  #pragma omp parallel for schedule(static, 10000)
+  for (int e = 0; e < Edges; e++) {
+    int SrcNId, DstNId;
+    EdgeGen.GetEdge(FromN+e, SrcNId, DstNId);
+    if (! IsDir && SrcNId > DstNId) { EdgeV[e] = TIntPr(DstNId, SrcNId); }
+    else { EdgeV[e] = TIntPr(SrcNId, DstNId); }
+  }
+}
+
+/// Samples edges until there are Edges distinct ones and returns the graph. Draws is set to the number of sampled edges.
+/// The result is the same as adding the sampled edges one by one and skipping the duplicates.
+template <class TEdgeGen>
+PNGraph GenEdgeGraphMP(const TEdgeGen& EdgeGen, const int& Nodes, const int& Edges, const bool& IsDir, int64& Draws) {
+  TIntPrV DistEdgeV, EdgeV;
+  Draws = 0;
+  while (DistEdgeV.Len() < Edges) {
+    // the missing edges can only be found among the next Edges-DistEdgeV.Len() draws
+    EdgeV.Gen(Edges - DistEdgeV.Len());
+    GetEdgesMP(EdgeGen, Draws, IsDir, EdgeV);
+    Draws += EdgeV.Len();
+    SortEdgeV(Nodes, EdgeV);
+    MergeEdgeV(DistEdgeV, EdgeV);
+  }
+  return GetEdgeVGraph(Nodes, DistEdgeV, IsDir);
+}
+
+/// Streams Edges sampled edges to OutFNm (text or binary, see TSnap::SaveRMatMP()). Chunks of edges
+/// are sampled in parallel and written in order, so the file does not depend on the number of threads.
+template <class TEdgeGen>
+void SaveEdgesMP(const TEdgeGen& EdgeGen, const TStr& OutFNm, const int& Nodes, const int64& Edges, const bool& Binary, const TStr& Desc) {
+  const int ChunkEdges = 1<<18;
+  FILE *F = fopen(OutFNm.CStr(), Binary ? "wb" : "wt");
+  if (F == NULL) { TExcept::Throw("Can not open file", OutFNm); }
+  if (! Binary) {
+    fprintf(F, "# Directed graph: %s \n", OutFNm.CStr());
+    if (! Desc.Empty()) { fprintf(F, "# %s\n", Desc.CStr()); }
+    fprintf(F, "# Nodes: %d Edges: %s\n", Nodes, TInt::GetStr(Edges).CStr());
+    fprintf(F, "# FromNodeId\tToNodeId\n");
+  }
+  const int64 Chunks = (Edges + ChunkEdges - 1) / ChunkEdges;
+  #pragma omp parallel
+  {
+    int* NIdBf = new int[2*ChunkEdges];
+    char* TxtBf = Binary ? NULL : new char[24*ChunkEdges];
+    #pragma omp for ordered schedule(dynamic, 1)
+    for (int64 c = 0; c < Chunks; c++) {
+      const int64 FromN = c*ChunkEdges;
+      const int Len = (int) TMath::Mn<int64>(ChunkEdges, Edges-FromN);
+      int64 TxtLen = 0;
+      for (int e = 0; e < Len; e++) {
+        int SrcNId, DstNId;
+        EdgeGen.GetEdge(FromN+e, SrcNId, DstNId);
+        if (Binary) { NIdBf[2*e] = SrcNId;  NIdBf[2*e+1] = DstNId; }
+        else { TxtLen += GetEdgeTxt(TxtBf+TxtLen, SrcNId, DstNId); }
+      }
+      #pragma omp ordered
+      {
+        if (Binary) { fwrite(NIdBf, sizeof(int), 2*Len, F); }
+        else { fwrite(TxtBf, 1, (size_t) TxtLen, F); }
+      }
+    }
+    delete[] NIdBf;
+    delete[] TxtBf;
+  }
+  fclose(F);
+}
+
 } // namespace TSnapDetail
 
 }; // namespace TSnap
@@ -399,7 +399,11 @@ void TGStat::TakeConnComp(const PGraph& Graph, TFSet StatFSet) {
   if (StatFSet.In(gsdWcc)) {
     printf("wcc...");
     TIntPrV WccSzCntV1;
+#ifdef USE_OPENMP
+    TSnap::GetWccSzCntMP(Graph, WccSzCntV1);
+#else
     TSnap::GetWccSzCnt(Graph, WccSzCntV1);
+#endif
     TFltPrV& WccSzCntV = DistrStatH.AddDat(gsdWcc);
     WccSzCntV.Gen(WccSzCntV1.Len(), 0);
     for (int i = 0; i < WccSzCntV1.Len(); i++)
@@ -408,7 +412,11 @@ void TGStat::TakeConnComp(const PGraph& Graph, TFSet StatFSet) {
   if (StatFSet.In(gsdScc)) {
     printf("scc...");
     TIntPrV SccSzCntV1;
+#ifdef USE_OPENMP
+    TSnap::GetSccSzCntMP(Graph, SccSzCntV1);
+#else
     TSnap::GetSccSzCnt(Graph, SccSzCntV1);
+#endif
     TFltPrV& SccSzCntV = DistrStatH.AddDat(gsdScc);
     SccSzCntV.Gen(SccSzCntV1.Len(), 0);
     for (int i = 0; i < SccSzCntV1.Len(); i++)
@@ -151,6 +151,28 @@ void TUNGraphMtx::PMultiplyT(const TFltV& Vec, TFltV& Result) const {
   }
 }
 
+/////////////////////////////////////////////////
+// Adjacency or Laplacian matrix of a CSR snapshot
+void TCsrGraphMtx::MultiplyBlock(const TVec<TInt64>& OffV, const TVec<TInt, int64>& NbrV, const TVec<TFlt, int64>& XV, TVec<TFlt, int64>& YV, const int& Cols) const {
+  const int Rows = GetRows();
+  IAssert(Cols > 0 && XV.Len() == int64(Rows)*Cols);
+  if (YV.Len() != XV.Len()) { YV.Gen(XV.Len()); }
+  #pragma omp parallel for schedule(dynamic,10000)
+  for (int n = 0; n < Rows; n++) {
+    TFlt* Y = YV.BegI() + int64(n)*Cols;
+    for (int c = 0; c < Cols; c++) { Y[c] = 0.0; }
+    for (int64 e = OffV[n]; e < OffV[n+1]; e++) {
+      const TFlt* X = XV.BegI() + int64(NbrV[e])*Cols;
+      for (int c = 0; c < Cols; c++) { Y[c] += X[c]; }
+    }
+    if (Laplacian) {
+      const double Deg = double(Graph->GetOutDeg(n));
+      const TFlt* X = XV.BegI() + int64(n)*Cols;
+      for (int c = 0; c < Cols; c++) { Y[c] = Deg*X[c] - Y[c]; }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 // Graphs Singular Value Decomposition
 namespace TSnap {
@@ -172,7 +194,539 @@ bool IsAllValVNeg(TFltV& ValV, const bool& InvertSign) {
   return IsAllNeg;
 }
 
-void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV) {
+namespace TSnapDetail {
+/// Returns the dot product of equally long vectors XV and YV.
+double GetDotProductMP(const TVec<TFlt, int64>& XV, const TVec<TFlt, int64>& YV) {
+  double Sum = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:Sum)
+  for (int64 i = 0; i < XV.Len(); i++) { Sum += XV[i]*YV[i]; }
+  return Sum;
+}
+
+/// Adds K*XV to YV.
+void AddVecMP(const double& K, const TVec<TFlt, int64>& XV, TVec<TFlt, int64>& YV) {
+  #pragma omp parallel for schedule(static)
+  for (int64 i = 0; i < XV.Len(); i++) { YV[i] += K*XV[i]; }
+}
+
+/// Scales XV to L2 norm 1, unless it is 0. Returns the original norm.
+double NormalizeMP(TVec<TFlt, int64>& XV) {
+  const double Norm = sqrt(GetDotProductMP(XV, XV));
+  if (Norm == 0.0) { return 0.0; }
+  #pragma omp parallel for schedule(static)
+  for (int64 i = 0; i < XV.Len(); i++) { XV[i] /= Norm; }
+  return Norm;
+}
+
+/// Fills a block of Cols vectors stored row by row with standard normal values.
+/// Every row gets its own generator derived from Seed, so rows are filled in parallel and the result does not depend on the number of threads.
+void GetRndNrmV(const int& Seed, TVec<TFlt, int64>& XV, const int& Cols) {
+  const int Rows = int(XV.Len() / Cols);
+  #pragma omp parallel for schedule(static)
+  for (int r = 0; r < Rows; r++) {
+    TRnd Rnd(int((uint64(r+1)*0x9E3779B97F4A7C15ULL + uint64(Seed)) >> 34) + 1);
+    for (int c = 0; c < Cols; c++) { XV[int64(r)*Cols+c] = Rnd.GetNrmDev(); }
+  }
+}
+
+/// Computes the Cols x Cols Gram matrix X'X of a block of Cols vectors stored row by row.
+void GetGramMP(const TVec<TFlt, int64>& XV, const int& Cols, TFltVV& GramVV) {
+  const int Rows = int(XV.Len() / Cols);
+  GramVV.Gen(Cols, Cols);
+  #pragma omp parallel
+  {
+    TFltV SumV(Cols*Cols);
+    #pragma omp for schedule(static)
+    for (int r = 0; r < Rows; r++) {
+      const TFlt* X = XV.BegI() + int64(r)*Cols;
+      for (int i = 0; i < Cols; i++) {
+        for (int j = i; j < Cols; j++) { SumV[i*Cols+j] += X[i]*X[j]; }
+      }
+    }
+    #pragma omp critical
+    {
+      for (int i = 0; i < Cols; i++) {
+        for (int j = i; j < Cols; j++) { GramVV(i, j) += SumV[i*Cols+j]; }
+      }
+    }
+  }
+  for (int i = 0; i < Cols; i++) {
+    for (int j = 0; j < i; j++) { GramVV(i, j) = GramVV(j, i); }
+  }
+}
+
+/// Computes YV = XV*Mtx for a block XV of Cols vectors stored row by row and a Cols x NewCols matrix Mtx.
+void MulBlockMP(const TVec<TFlt, int64>& XV, const int& Cols, const TFltVV& Mtx, const int& NewCols, TVec<TFlt, int64>& YV) {
+  const int Rows = int(XV.Len() / Cols);
+  YV.Gen(int64(Rows)*NewCols);
+  #pragma omp parallel for schedule(static)
+  for (int r = 0; r < Rows; r++) {
+    const TFlt* X = XV.BegI() + int64(r)*Cols;
+    TFlt* Y = YV.BegI() + int64(r)*NewCols;
+    for (int i = 0; i < Cols; i++) {
+      for (int j = 0; j < NewCols; j++) { Y[j] += X[i]*Mtx(i, j); }
+    }
+  }
+}
+
+/// Orthonormalizes the columns of a block of Cols vectors stored row by row (SVQB, Stathopoulos and Wu).
+/// Uses the eigenvectors of the Gram matrix, so it only needs two passes over the block; columns in its null space become 0.
+void OrthBlockMP(TVec<TFlt, int64>& XV, const int& Cols) {
+  TVec<TFlt, int64> YV;
+  for (int Pass = 0; Pass < 2; Pass++) {
+    TFltVV GramVV, EigVecVV;
+    TFltV EigValV;
+    GetGramMP(XV, Cols, GramVV);
+    GetSymEig(GramVV, EigValV, EigVecVV);
+    for (int c = 0; c < Cols; c++) {
+      const double Scale = EigValV[c] > 1e-12*EigValV[0] ? 1.0/sqrt(EigValV[c]) : 0.0;
+      for (int r = 0; r < Cols; r++) { EigVecVV(r, c) *= Scale; }
+    }
+    MulBlockMP(XV, Cols, EigVecVV, Cols, YV);
+    XV.Swap(YV);
+  }
+}
+
+/// Computes the Ritz vector YV = Q*SV from Lanczos vectors QV and an eigenvector SV of the tridiagonal matrix.
+void GetRitzVecMP(const TVec<TVec<TFlt, int64> >& QV, const TFltV& SV, TVec<TFlt, int64>& YV) {
+  const int64 N = QV[0].Len();
+  YV.Gen(N);
+  #pragma omp parallel for schedule(static)
+  for (int64 n = 0; n < N; n++) {
+    double Sum = 0.0;
+    for (int j = 0; j < SV.Len(); j++) { Sum += SV[j]*QV[j][n]; }
+    YV[n] = Sum;
+  }
+  NormalizeMP(YV);
+}
+
+/// Computes DotV[i] = QV[i]'*WV for the first Vecs vectors of QV in one parallel pass over blocks of rows.
+void GetDotProductsMP(const TVec<TVec<TFlt, int64> >& QV, const int& Vecs, const TVec<TFlt, int64>& WV, TFltV& DotV) {
+  const int64 N = WV.Len(), RowBlock = 1024, Blocks = (N + RowBlock - 1) / RowBlock;
+  DotV.Gen(Vecs);
+  #pragma omp parallel
+  {
+    TFltV SumV(Vecs);
+    #pragma omp for schedule(static)
+    for (int64 b = 0; b < Blocks; b++) {
+      const int64 Beg = b*RowBlock, End = TMath::Mn(N, Beg+RowBlock);
+      for (int i = 0; i < Vecs; i++) {
+        double Sum = 0.0;
+        for (int64 n = Beg; n < End; n++) { Sum += QV[i][n]*WV[n]; }
+        SumV[i] += Sum;
+      }
+    }
+    #pragma omp critical
+    {
+      for (int i = 0; i < Vecs; i++) { DotV[i] += SumV[i]; }
+    }
+  }
+}
+
+/// Subtracts the sum of DotV[i]*QV[i] over the first Vecs vectors of QV from WV.
+void SubVecsMP(const TVec<TVec<TFlt, int64> >& QV, const int& Vecs, const TFltV& DotV, TVec<TFlt, int64>& WV) {
+  const int64 N = WV.Len(), RowBlock = 1024, Blocks = (N + RowBlock - 1) / RowBlock;
+  #pragma omp parallel for schedule(static)
+  for (int64 b = 0; b < Blocks; b++) {
+    const int64 Beg = b*RowBlock, End = TMath::Mn(N, Beg+RowBlock);
+    for (int i = 0; i < Vecs; i++) {
+      const double Dot = DotV[i];
+      for (int64 n = Beg; n < End; n++) { WV[n] -= Dot*QV[i][n]; }
+    }
+  }
+}
+
+/// Replaces the first ColV.Len() vectors of QV by the Ritz vectors Q*SVV(:,ColV[c]), where Q are the first Vecs vectors of QV.
+/// Works in place on blocks of rows, so it needs no memory proportional to the length of the vectors.
+void RotateVecsMP(TVec<TVec<TFlt, int64> >& QV, const int& Vecs, const TFltVV& SVV, const TIntV& ColV) {
+  const int64 N = QV[0].Len(), RowBlock = 64, Blocks = (N + RowBlock - 1) / RowBlock;
+  const int Cols = ColV.Len();
+  #pragma omp parallel
+  {
+    TFltV RowV(int(RowBlock)*Cols);
+    #pragma omp for schedule(static)
+    for (int64 b = 0; b < Blocks; b++) {
+      const int64 Beg = b*RowBlock, End = TMath::Mn(N, Beg+RowBlock);
+      RowV.PutAll(0.0);
+      for (int i = 0; i < Vecs; i++) {
+        for (int c = 0; c < Cols; c++) {
+          const double S = SVV(i, ColV[c]);
+          for (int64 n = Beg; n < End; n++) { RowV[c*int(RowBlock)+int(n-Beg)] += S*QV[i][n]; }
+        }
+      }
+      for (int c = 0; c < Cols; c++) {
+        for (int64 n = Beg; n < End; n++) { QV[c][n] = RowV[c*int(RowBlock)+int(n-Beg)]; }
+      }
+    }
+  }
+}
+
+/// Solves (T-Shift*I)*X = B for the symmetric tridiagonal matrix T = (AlphaV, BetaV), XV holds B on input.
+/// Gaussian elimination with partial pivoting as in LAPACK dgtsv, zero pivots are replaced by Tiny.
+void SolveTridiag(const TFltV& AlphaV, const TFltV& BetaV, const double& Shift, const double& Tiny, TFltV& XV) {
+  const int K = AlphaV.Len();
+  TFltV DV(K), DLV(K), DUV(K), DU2V(K);
+  for (int i = 0; i < K; i++) {
+    DV[i] = AlphaV[i] - Shift;
+    if (i < K-1) { DLV[i] = BetaV[i];  DUV[i] = BetaV[i]; }
+  }
+  for (int i = 0; i < K-1; i++) {
+    if (fabs(DV[i]) >= fabs(DLV[i])) {
+      // no row interchange
+      if (DV[i] == 0.0) { DV[i] = Tiny; }
+      const double Fact = DLV[i] / DV[i];
+      DV[i+1] -= Fact*DUV[i];
+      XV[i+1] -= Fact*XV[i];
+    } else {
+      // interchange rows i and i+1
+      const double Fact = DV[i] / DLV[i];
+      const double Tmp = DV[i+1];
+      DV[i] = DLV[i];
+      DV[i+1] = DUV[i] - Fact*Tmp;
+      if (i < K-2) { DU2V[i] = DUV[i+1];  DUV[i+1] = -Fact*DU2V[i]; }
+      DUV[i] = Tmp;
+      const double TmpX = XV[i];
+      XV[i] = XV[i+1];
+      XV[i+1] = TmpX - Fact*XV[i+1];
+    }
+  }
+  if (DV[K-1] == 0.0) { DV[K-1] = Tiny; }
+  // back substitution
+  XV[K-1] /= DV[K-1];
+  if (K > 1) { XV[K-2] = (XV[K-2] - DUV[K-2]*XV[K-1]) / DV[K-2]; }
+  for (int i = K-3; i >= 0; i--) {
+    XV[i] = (XV[i] - DUV[i]*XV[i+1] - DU2V[i]*XV[i+2]) / DV[i];
+  }
+}
+
+// QL algorithm with implicit shifts (tqli of Numerical Recipes, see TNumericalStuff::EigSymmetricTridiag()).
+// Rows of the eigenvector matrix transform independently, so only the last row is tracked.
+void GetTridiagEig(const TFltV& AlphaV, const TFltV& BetaV, TFltV& EigValV, TFltV& LastV) {
+  const int K = AlphaV.Len();
+  TFltV DV(AlphaV), EV(K);
+  for (int i = 0; i < K-1; i++) { EV[i] = BetaV[i]; }
+  LastV.Gen(K);
+  LastV[K-1] = 1.0;
+  for (int l = 0; l < K; l++) {
+    int Iter = 0, m;
+    do {
+      // look for a single small subdiagonal element to split the matrix
+      for (m = l; m < K-1; m++) {
+        const double DD = fabs(DV[m]) + fabs(DV[m+1]);
+        if (fabs(EV[m]) + DD == DD) { break; }
+      }
+      if (m != l) {
+        IAssertR(Iter++ < 60, "Too many iterations in GetTridiagEig");
+        double G = (DV[l+1]-DV[l]) / (2.0*EV[l]);
+        double R = sqrt(G*G + 1.0);
+        G = DV[m] - DV[l] + EV[l] / (G + (G >= 0.0 ? R : -R));
+        double S = 1.0, C = 1.0, P = 0.0;
+        int i;
+        for (i = m-1; i >= l; i--) {
+          const double F = S*EV[i], B = C*EV[i];
+          EV[i+1] = (R = sqrt(F*F + G*G));
+          if (R == 0.0) { DV[i+1] -= P;  EV[m] = 0.0;  break; }
+          S = F/R;  C = G/R;
+          G = DV[i+1] - P;
+          R = (DV[i]-G)*S + 2.0*C*B;
+          DV[i+1] = G + (P = S*R);
+          G = C*R - B;
+          const double Z = LastV[i+1];
+          LastV[i+1] = S*LastV[i] + C*Z;
+          LastV[i] = C*LastV[i] - S*Z;
+        }
+        if (R == 0.0 && i >= l) { continue; }
+        DV[l] -= P;  EV[l] = G;  EV[m] = 0.0;
+      }
+    } while (m != l);
+  }
+  EigValV = DV;
+}
+
+// Inverse iteration, three steps are enough since EigVal is accurate to the working precision
+void GetTridiagEigVec(const TFltV& AlphaV, const TFltV& BetaV, const double& EigVal, const TVec<TFltV>& OrthV, TFltV& EigVecV) {
+  const int K = AlphaV.Len();
+  double Norm = 0.0;
+  for (int i = 0; i < K; i++) {
+    Norm = TMath::Mx(Norm, fabs(AlphaV[i]) + (i > 0 ? fabs(BetaV[i-1]) : 0.0) + (i < K-1 ? fabs(BetaV[i]) : 0.0));
+  }
+  const double Tiny = 1e-14 * (Norm > 0.0 ? Norm : 1.0);
+  TRnd Rnd(1);
+  EigVecV.Gen(K);
+  for (int i = 0; i < K; i++) { EigVecV[i] = Rnd.GetUniDev() + 0.5; }
+  for (int Iter = 0; Iter < 3; Iter++) {
+    SolveTridiag(AlphaV, BetaV, EigVal, Tiny, EigVecV);
+    for (int v = 0; v < OrthV.Len(); v++) {
+      const double Dot = TLinAlg::DotProduct(OrthV[v], EigVecV);
+      TLinAlg::AddVec(-Dot, OrthV[v], EigVecV, EigVecV);
+    }
+    TLinAlg::Normalize(EigVecV);
+  }
+}
+
+void GetSymEig(const TFltVV& Mtx, TFltV& EigValV, TFltVV& EigVecVV) {
+  const int Dim = Mtx.GetRows();
+  TFltVV QVV(Mtx), ZVV(Dim, Dim), VecVV(Dim, Dim);
+  TFltV DV(Dim+1), EV(Dim+1);
+  // QVV becomes the transformation to the tridiagonal form, ZVV the eigenvectors of the tridiagonal matrix
+  TNumericalStuff::SymetricToTridiag(QVV, Dim, DV, EV);
+  TLAMisc::FillIdentity(ZVV);
+  TNumericalStuff::EigSymmetricTridiag(DV, EV, Dim, ZVV);
+  TLinAlg::Multiply(QVV, ZVV, VecVV);
+  TFltIntPrV ValIdV(Dim, 0);
+  for (int i = 0; i < Dim; i++) { ValIdV.Add(TFltIntPr(DV[i+1], i)); }
+  ValIdV.Sort(false);
+  EigValV.Gen(Dim);
+  EigVecVV.Gen(Dim, Dim);
+  for (int v = 0; v < Dim; v++) {
+    EigValV[v] = ValIdV[v].Val1;
+    for (int r = 0; r < Dim; r++) { EigVecVV(r, v) = VecVV(r, ValIdV[v].Val2); }
+  }
+}
+
+// Thick-restart Lanczos, see K. Wu and H. Simon, Thick-restart Lanczos method for large symmetric eigenvalue problems,
+// SIAM Journal on Matrix Analysis and Applications, 2000. At most Basis Lanczos vectors are kept; when the basis is full,
+// it is restarted from the Ritz vectors of largest magnitude. New vectors are orthogonalized against the whole basis,
+// a second time if the first pass cancelled most of their norm (Daniel, Gragg, Kaufman and Stewart).
+int GetEigThickRestart(const TCsrGraphMtx& Mtx, const int& EigVals, TFltV& EigValV, TVec<TFltV>* EigVecV, const int& Basis, const int& MxSteps, const double& MxSecs) {
+  const int N = Mtx.GetRows();
+  const double ConvTol = 1e-10;
+  const uint64 StartTicks = TSysTm::GetPerfTimerTicks();
+  TVec<TVec<TFlt, int64> > QV(Basis);
+  TFltVV HVV(Basis, Basis);  // upper triangle of the projection Q'*M*Q
+  TFltVV TVV, SVV;
+  TFltV DotV, RitzV;
+  TFltIntPrV ValIdV;
+  TIntV KeepV;
+  TVec<TFlt, int64> WV;
+  QV[0].Gen(N);
+  GetRndNrmV(1, QV[0], 1);
+  NormalizeMP(QV[0]);
+  int Kept = 0, Dim = 0, Steps = 0;
+  double Beta = 0.0, TNorm = 0.0;
+  while (true) {
+    bool Done = false;
+    for (int j = Kept; j < Basis && ! Done; j++) {
+      Mtx.Multiply(QV[j], WV);
+      Steps++;
+      double ColNorm = 0.0;
+      for (int i = 0; i <= j; i++) { HVV(i, j) = 0.0; }
+      Beta = sqrt(GetDotProductMP(WV, WV));
+      for (int Pass = 0; Pass < 2; Pass++) {
+        GetDotProductsMP(QV, j+1, WV, DotV);
+        SubVecsMP(QV, j+1, DotV, WV);
+        for (int i = 0; i <= j; i++) { HVV(i, j) += DotV[i]; }
+        const double PrevBeta = Beta;
+        Beta = sqrt(GetDotProductMP(WV, WV));
+        if (Beta > 0.7071*PrevBeta) { break; }
+      }
+      for (int i = 0; i <= j; i++) { ColNorm += fabs(HVV(i, j)); }
+      TNorm = TMath::Mx(TNorm, ColNorm + Beta);
+      Dim = j+1;
+      const bool OutOfTime = MxSecs > 0 && double(TSysTm::GetPerfTimerTicks()-StartTicks) / double(TSysTm::GetPerfTimerFq()) > MxSecs;
+      // stop at the step limit or when the Krylov subspace is invariant, otherwise WV/Beta is the next Lanczos vector
+      Done = Steps >= MxSteps || OutOfTime || Beta <= 1e-12*TNorm;
+      if (! Done && j+1 < Basis) {
+        if (QV[j+1].Empty()) { QV[j+1].Gen(N); }
+        #pragma omp parallel for schedule(static)
+        for (int64 n = 0; n < N; n++) { QV[j+1][n] = WV[n] / Beta; }
+      }
+    }
+    // Ritz pairs of the projection, the residual norm of pair i is Beta*|SVV(Dim-1, i)|
+    TVV.Gen(Dim, Dim);
+    for (int i = 0; i < Dim; i++) {
+      for (int l = i; l < Dim; l++) { TVV(i, l) = HVV(i, l);  TVV(l, i) = HVV(i, l); }
+    }
+    GetSymEig(TVV, RitzV, SVV);
+    ValIdV.Gen(Dim, 0);
+    for (int i = 0; i < Dim; i++) { ValIdV.Add(TFltIntPr(fabs(RitzV[i]), i)); }
+    ValIdV.Sort(false);
+    bool Converged = Dim >= EigVals;
+    for (int v = 0; v < EigVals && v < Dim; v++) {
+      if (Beta*fabs(SVV(Dim-1, ValIdV[v].Val2)) > ConvTol*TNorm) { Converged = false; }
+    }
+    if (Converged || Done) { break; }
+    // restart from the Ritz vectors of largest magnitude, M*q_i = Ritz_i*q_i + Beta*SVV(Dim-1, i)*q_Kept
+    Kept = TMath::Mn(EigVals + (Basis-EigVals)/2, Basis-1);
+    KeepV.Gen(Kept, 0);
+    for (int v = 0; v < Kept; v++) { KeepV.Add(ValIdV[v].Val2); }
+    RotateVecsMP(QV, Dim, SVV, KeepV);
+    for (int i = 0; i < Kept; i++) {
+      for (int l = i; l < Kept; l++) { HVV(i, l) = 0.0; }
+      HVV(i, i) = RitzV[KeepV[i]];
+    }
+    #pragma omp parallel for schedule(static)
+    for (int64 n = 0; n < N; n++) { QV[Kept][n] = WV[n] / Beta; }
+  }
+  // Ritz pairs of largest magnitude, the basis is released as the eigenvectors are copied out
+  const int Vals = TMath::Mn(EigVals, Dim);
+  KeepV.Gen(Vals, 0);
+  for (int v = 0; v < Vals; v++) {
+    KeepV.Add(ValIdV[v].Val2);
+    EigValV.Add(RitzV[ValIdV[v].Val2]);
+  }
+  if (EigVecV != NULL) {
+    RotateVecsMP(QV, Dim, SVV, KeepV);
+    for (int v = 0; v < Vals; v++) {
+      EigVecV->Add(TFltV(N));
+      for (int n = 0; n < N; n++) { EigVecV->Last()[n] = QV[v][n]; }
+      QV[v].Clr();
+    }
+  }
+  return Steps;
+}
+} // namespace TSnapDetail
+
+// Lanczos iteration with selective orthogonalization, see B. N. Parlett and D. S. Scott,
+// The Lanczos algorithm with selective orthogonalization, Mathematics of Computation, 1979
+int GetEigLanczos(const TCsrGraphMtx& Mtx, const int& EigVals, TFltV& EigValV, TVec<TFltV>* EigVecV, const int& Steps, const int& BlockSize, const double& MxSecs, const int& MxBasis) {
+  IAssertR(Mtx.IsSymmetric(), "Lanczos iteration needs a symmetric matrix (a snapshot of an undirected graph).");
+  IAssert(BlockSize > 0);
+  const int N = Mtx.GetRows();
+  EigValV.Clr();
+  if (EigVecV != NULL) { EigVecV->Clr(); }
+  if (N == 0 || EigVals <= 0) { return 0; }
+  const int MxSteps = TMath::Mn(N, Steps > 0 ? Steps : TMath::Mx(4*EigVals, EigVals+100));
+  // the Lanczos vectors take N*MxSteps doubles, longer iterations are restarted
+  const int Basis = TMath::Mn(N, MxBasis > 0 ? MxBasis : EigVals + TMath::Mx(100, EigVals/2));
+  if (MxSteps > Basis) {
+    IAssertR(Basis > EigVals+1, "The Lanczos basis has to be larger than the number of eigenvalues plus one.");
+    return TSnapDetail::GetEigThickRestart(Mtx, EigVals, EigValV, EigVecV, Basis, MxSteps, MxSecs);
+  }
+  const double SqrtEps = 1.5e-8, ConvTol = 1e-10;
+  const uint64 StartTicks = TSysTm::GetPerfTimerTicks();
+  TVec<TVec<TFlt, int64> > QV(MxSteps, 0), ConvVecV;
+  TFltV AlphaV, BetaV, ConvValV, RitzV, LastV;
+  TFltV OmegaOldV, OmegaV, OmegaNewV(1);  // estimated dot products of the last Lanczos vectors with all previous ones
+  OmegaNewV[0] = 1.0;
+  const double Eps1 = 2.2e-16*sqrt(double(N));
+  TVec<TFlt, int64> WV;
+  QV.Add(TVec<TFlt, int64>(N));
+  TSnapDetail::GetRndNrmV(1, QV[0], 1);
+  TSnapDetail::NormalizeMP(QV[0]);
+  double Beta = 0.0, TNorm = 0.0;
+  for (int j = 0; j < MxSteps; j++) {
+    Mtx.Multiply(QV[j], WV);
+    const double Alpha = TSnapDetail::GetDotProductMP(QV[j], WV);
+    TSnapDetail::AddVecMP(-Alpha, QV[j], WV);
+    if (j > 0) { TSnapDetail::AddVecMP(-Beta, QV[j-1], WV); }
+    for (int c = 0; c < ConvVecV.Len(); c++) {
+      TSnapDetail::AddVecMP(-TSnapDetail::GetDotProductMP(ConvVecV[c], WV), ConvVecV[c], WV); }
+    AlphaV.Add(Alpha);
+    const double PrevBeta = Beta;
+    Beta = sqrt(TSnapDetail::GetDotProductMP(WV, WV));
+    TNorm = TMath::Mx(TNorm, fabs(Alpha) + PrevBeta + Beta);
+    const int K = j+1;
+    // stop at the step limit or when the Krylov subspace is invariant
+    if (K == MxSteps || Beta <= 1e-12*TNorm) { break; }
+    // omega recurrence of H. D. Simon, Math. Comp. 1984, estimates the loss of orthogonality of the next Lanczos vector
+    OmegaOldV.Swap(OmegaV);
+    OmegaV.Swap(OmegaNewV);
+    OmegaNewV.Gen(K+1);
+    double MxOmega = 0.0;
+    for (int k = 0; k < j; k++) {
+      const double Val = BetaV[k]*OmegaV[k+1] + (AlphaV[k]-Alpha)*OmegaV[k] + (k > 0 ? BetaV[k-1]*OmegaV[k-1] : 0.0) - PrevBeta*OmegaOldV[k];
+      OmegaNewV[k] = (Val + (Val >= 0.0 ? Eps1 : -Eps1)*TNorm) / Beta;
+      MxOmega = TMath::Mx(MxOmega, fabs(OmegaNewV[k]));
+    }
+    OmegaNewV[j] = Eps1;
+    OmegaNewV[j+1] = 1.0;
+    // Ritz values are checked every BlockSize steps and when the estimated loss of orthogonality exceeds sqrt(eps)
+    const bool OutOfTime = MxSecs > 0 && double(TSysTm::GetPerfTimerTicks()-StartTicks) / double(TSysTm::GetPerfTimerFq()) > MxSecs;
+    if (K % BlockSize == 0 || OutOfTime || MxOmega > SqrtEps) {
+      // error bound of Ritz value i is Beta*|last component of its eigenvector of T|
+      TSnapDetail::GetTridiagEig(AlphaV, BetaV, RitzV, LastV);
+      TFltIntPrV ValIdV(K, 0);
+      for (int i = 0; i < K; i++) { ValIdV.Add(TFltIntPr(fabs(RitzV[i]), i)); }
+      ValIdV.Sort(false);
+      bool Converged = K >= EigVals;
+      for (int v = 0; v < EigVals && v < K; v++) {
+        if (Beta*fabs(LastV[ValIdV[v].Val2]) > ConvTol*TNorm) { Converged = false; }
+      }
+      if (Converged || OutOfTime) { break; }
+      // newly converged Ritz vectors, Lanczos vectors lose orthogonality in their direction
+      TFltV SV;
+      for (int i = 0; i < K; i++) {
+        if (Beta*fabs(LastV[i]) > SqrtEps*TNorm) { continue; }
+        bool Known = false;
+        for (int c = 0; c < ConvValV.Len() && ! Known; c++) { Known = fabs(ConvValV[c]-RitzV[i]) <= SqrtEps*TNorm; }
+        if (Known) { continue; }
+        TSnapDetail::GetTridiagEigVec(AlphaV, BetaV, RitzV[i], TVec<TFltV>(), SV);
+        ConvVecV.Add();
+        TSnapDetail::GetRitzVecMP(QV, SV, ConvVecV.Last());
+        ConvValV.Add(RitzV[i]);
+        for (int k = 0; k <= j; k++) { OmegaNewV[k] = Eps1; }
+      }
+    }
+    // next Lanczos vector, orthogonal to converged Ritz vectors
+    BetaV.Add(Beta);
+    QV.Add();
+    QV.Last().Swap(WV);
+    for (int c = 0; c < ConvVecV.Len(); c++) {
+      TSnapDetail::AddVecMP(-TSnapDetail::GetDotProductMP(ConvVecV[c], QV.Last()), ConvVecV[c], QV.Last()); }
+    TSnapDetail::NormalizeMP(QV.Last());
+  }
+  // Ritz values of largest magnitude
+  const int K = AlphaV.Len();
+  TSnapDetail::GetTridiagEig(AlphaV, BetaV, RitzV, LastV);
+  TFltIntPrV ValIdV(K, 0);
+  for (int i = 0; i < K; i++) { ValIdV.Add(TFltIntPr(fabs(RitzV[i]), i)); }
+  ValIdV.Sort(false);
+  TVec<TFltV> SVecV;
+  for (int v = 0; v < EigVals && v < K; v++) {
+    const double EigVal = RitzV[ValIdV[v].Val2];
+    EigValV.Add(EigVal);
+    if (EigVecV == NULL) { continue; }
+    SVecV.Add();
+    TSnapDetail::GetTridiagEigVec(AlphaV, BetaV, EigVal, SVecV, SVecV.Last());
+    TVec<TFlt, int64> YV;
+    TSnapDetail::GetRitzVecMP(QV, SVecV.Last(), YV);
+    EigVecV->Add(TFltV(N));
+    for (int n = 0; n < N; n++) { EigVecV->Last()[n] = YV[n]; }
+  }
+  return K;
+}
+
+// Randomized SVD, see N. Halko, P. G. Martinsson and J. A. Tropp, Finding structure with randomness, SIAM Review, 2011
+void GetSvdRnd(const TCsrGraphMtx& Mtx, const int& SngVals, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV, const int& BlockSize, const int& PowerIters, TRnd& Rnd) {
+  const int N = Mtx.GetRows();
+  SngValV.Clr();  LeftSV.Clr();  RightSV.Clr();
+  if (N == 0 || SngVals <= 0) { return; }
+  const int Cols = TMath::Mn(N, BlockSize > 0 ? BlockSize : SngVals+10);
+  // Q is an orthonormal basis of the range of M*Omega, refined by power iterations
+  TVec<TFlt, int64> QV, ZV(int64(N)*Cols);
+  TSnapDetail::GetRndNrmV(Rnd.GetUniDevInt(TInt::Mx), ZV, Cols);
+  Mtx.Multiply(ZV, QV, Cols);
+  TSnapDetail::OrthBlockMP(QV, Cols);
+  for (int Iter = 0; Iter < PowerIters; Iter++) {
+    Mtx.MultiplyT(QV, ZV, Cols);
+    TSnapDetail::OrthBlockMP(ZV, Cols);
+    Mtx.Multiply(ZV, QV, Cols);
+    TSnapDetail::OrthBlockMP(QV, Cols);
+  }
+  // B = Q'*M is kept transposed in ZV, eigenvectors of B*B' are the left singular vectors of B
+  Mtx.MultiplyT(QV, ZV, Cols);
+  TFltVV GramVV, UVV;
+  TFltV LambdaV;
+  TSnapDetail::GetGramMP(ZV, Cols, GramVV);
+  TSnapDetail::GetSymEig(GramVV, LambdaV, UVV);
+  const int Vals = TMath::Mn(SngVals, Cols);
+  TVec<TFlt, int64> LeftV, RightV;
+  TSnapDetail::MulBlockMP(QV, Cols, UVV, Vals, LeftV);
+  TSnapDetail::MulBlockMP(ZV, Cols, UVV, Vals, RightV);
+  for (int v = 0; v < Vals; v++) {
+    const double SngVal = sqrt(TMath::Mx(LambdaV[v].Val, 0.0));
+    SngValV.Add(SngVal);
+    LeftSV.Add(TFltV(N));
+    RightSV.Add(TFltV(N));
+    for (int n = 0; n < N; n++) {
+      LeftSV.Last()[n] = LeftV[int64(n)*Vals+v];
+      RightSV.Last()[n] = SngVal > 0.0 ? RightV[int64(n)*Vals+v] / SngVal : 0.0;
+    }
+  }
+}
+
+void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV, const bool& RndSvd) {
   const int Nodes = Graph->GetNodes();
   IAssert(SngVals > 0);
   if (Nodes < 100) {
@@ -194,6 +748,12 @@ void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV) {
       TSvd::Svd1Based(AdjMtx, LSingV, SngValV, RSingV); }
     catch(...) {
       printf("\n***No SVD convergence: G(%d, %d)\n", Nodes, Graph->GetEdges()); }
+  } else if (RndSvd) {
+    // randomized SVD on a CSR snapshot
+    TVec<TFltV> LeftSV, RightSV;
+    GetSvdRnd(TCsrGraphMtx(TCsrGraph::New(Graph)), SngVals, SngValV, LeftSV, RightSV, 0, 4);
+    if (SngValV.Len() < SngVals) {
+      printf("  ***TRIED %d GOT %d values** \n", SngVals, SngValV.Len()); }
   } else {
     // Lanczos
     TNGraphMtx GraphMtx(Graph);
@@ -222,7 +782,7 @@ void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV) {
   //IAssert(SngValV.Len() == SngVals);
 }
 
-void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV) {
+void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV, const bool& RndSvd) {
   const int Nodes = Graph->GetNodes();
   TFltVV LSingV, RSingV;
   TFltV SngValV;
@@ -244,6 +804,14 @@ void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV) {
       TSvd::Svd1Based(AdjMtx, LSingV, SngValV, RSingV); }
     catch(...) {
       printf("\n***No SVD convergence: G(%d, %d)\n", Nodes, Graph->GetEdges()); }
+  } else if (RndSvd) { // randomized SVD on a CSR snapshot
+    TVec<TFltV> LeftSVV, RightSVV;
+    GetSvdRnd(TCsrGraphMtx(TCsrGraph::New(Graph)), 1, SngValV, LeftSVV, RightSVV, 0, 4);
+    LeftSV = LeftSVV[0];
+    RightSV = RightSVV[0];
+    IsAllValVNeg(LeftSV, true);
+    IsAllValVNeg(RightSV, true);
+    return;
   } else { // Lanczos
     TNGraphMtx GraphMtx(Graph);
     TSparseSVD::LanczosSVD(GraphMtx, 1, 8, ssotFull, SngValV, LSingV, RSingV);
@@ -258,7 +826,7 @@ void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV) {
   IsAllValVNeg(RightSV, true);
 }
 
-void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV) {
+void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV, const bool& RndSvd) {
   const int Nodes = Graph->GetNodes();
   SngValV.Clr();
   LeftSV.Clr();
@@ -283,11 +851,14 @@ void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TF
     } catch(...) {
       printf("\n***No SVD convergence: G(%d, %d)\n", Nodes, Graph->GetEdges()); 
     }
+  } else if (RndSvd) { // randomized SVD on a CSR snapshot
+    GetSvdRnd(TCsrGraphMtx(TCsrGraph::New(Graph)), SngVecs, SngValV, LeftSV, RightSV, 0, 4);
+    IsAllValVNeg(LeftSV[0], true);
+    IsAllValVNeg(RightSV[0], true);
+    return;
   } else { // Lanczos
     TNGraphMtx GraphMtx(Graph);
     TSparseSVD::LanczosSVD(GraphMtx, SngVecs, 2*SngVecs, ssotFull, SngValV, LSingV, RSingV);
-    //TGAlg::SaveFullMtx(Graph, "adj_mtx.txt");
-    //TLAMisc::DumpTFltVVMjrSubMtrx(LSingV, LSingV.GetRows(), LSingV.GetCols(), "LSingV2.txt"); // save MTX
   }
   TFltIntPrV SngValIdV;
   for (int i = 0; i < SngValV.Len(); i++) {
@@ -307,67 +878,36 @@ void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TF
 
 void GetEigVals(const PUNGraph& Graph, const int& EigVals, TFltV& EigValV) {
   // Lanczos
-  TUNGraphMtx GraphMtx(Graph);
-  //const int Nodes = Graph->GetNodes();
-  //int CalcVals = int(2*EigVals);
-  //if (CalcVals > Nodes) { CalcVals = Nodes; }
-  //while (EigValV.Len() < EigVals && CalcVals < 3*EigVals) {
-  try {
-    if (EigVals > 4) { 
-      TSparseSVD::SimpleLanczos(GraphMtx, 2*EigVals, EigValV, false); }
-    else { TFltVV EigVecVV; // this is much more precise, but also much slower
-      TSparseSVD::Lanczos(GraphMtx, EigVals, 3*EigVals, ssotFull, EigValV, EigVecVV, false); }
-  }
-  catch(...) {
-    printf("\n  ***EXCEPTION:  TRIED %d GOT %d values** \n", 2*EigVals, EigValV.Len()); }
+  GetEigLanczos(TCsrGraphMtx(TCsrGraph::New(Graph)), EigVals, EigValV);
   if (EigValV.Len() < EigVals) {
-    printf("  ***TRIED %d GOT %d values** \n", 2*EigVals, EigValV.Len()); }
-  //  CalcVals += EigVals;
-  //}
+    printf("  ***TRIED %d GOT %d values** \n", EigVals, EigValV.Len()); }
   EigValV.Sort(false);
-  /*if (EigValV.Len() > EigVals) {
-    EigValV.Del(EigVals, EigValV.Len()-1); }
-  else {
-    while (EigValV.Len() < EigVals) EigValV.Add(1e-6); 
-  }
-  IAssert(EigValV.Len() == EigVals);*/
 }
 
 void GetEigVec(const PUNGraph& Graph, TFltV& EigVecV) {
-  TUNGraphMtx GraphMtx(Graph);
   TFltV EigValV;
-  TFltVV EigVecVV;
-  TSparseSVD::Lanczos(GraphMtx, 1, 8, ssotFull, EigValV, EigVecVV, false);
-  EigVecVV.GetCol(0, EigVecV); // vector components are not sorted!!!
+  TVec<TFltV> EigVecVV;
+  GetEigLanczos(TCsrGraphMtx(TCsrGraph::New(Graph)), 1, EigValV, &EigVecVV);
+  EigVecV = EigVecVV[0];
   IsAllValVNeg(EigVecV, true);
 }
 
 // to get first few eigenvectors
 void GetEigVec(const PUNGraph& Graph, const int& EigVecs, TFltV& EigValV, TVec<TFltV>& EigVecV) {
-  const int Nodes = Graph->GetNodes();
   // Lanczos
-  TUNGraphMtx GraphMtx(Graph);
-  int CalcVals = int(2*EigVecs);
-  if (CalcVals > Nodes) { CalcVals = Nodes; }
-  TFltVV EigVecVV;
-  //while (EigValV.Len() < EigVecs && CalcVals < 10*EigVecs) {
-  try {
-    TSparseSVD::Lanczos(GraphMtx, EigVecs, 2*EigVecs, ssotFull, EigValV, EigVecVV, false); }
-  catch(...) {
-    printf("\n  ***EXCEPTION:  TRIED %d GOT %d values** \n", CalcVals, EigValV.Len()); }
+  TVec<TFltV> EigVecVV;
+  GetEigLanczos(TCsrGraphMtx(TCsrGraph::New(Graph)), EigVecs, EigValV, &EigVecVV);
   if (EigValV.Len() < EigVecs) {
-    printf("  ***TRIED %d GOT %d values** \n", CalcVals, EigValV.Len()); }
-  //  CalcVals += EigVecs;
-  //}
+    printf("  ***TRIED %d GOT %d values** \n", EigVecs, EigValV.Len()); }
   TFltIntPrV EigValIdV;
   for (int i = 0; i < EigValV.Len(); i++) {
     EigValIdV.Add(TFltIntPr(EigValV[i], i)); 
   }
   EigValIdV.Sort(false);
   EigValV.Sort(false);
-  for (int v = 0; v < EigValIdV.Len(); v++) { // vector components are not sorted!!!
-    EigVecV.Add();
-    EigVecVV.GetCol(EigValIdV[v].Val2, EigVecV.Last());
+  EigVecV.Clr();
+  for (int v = 0; v < EigValIdV.Len(); v++) {
+    EigVecV.Add(EigVecVV[EigValIdV[v].Val2]);
   }
   IsAllValVNeg(EigVecV[0], true);
 }
@@ -375,24 +915,18 @@ void GetEigVec(const PUNGraph& Graph, const int& EigVecs, TFltV& EigValV, TVec<T
 // Inverse participation ratio: normalize EigVec to have L2=1 and then I=sum_k EigVec[i]^4
 // see Spectra of "real-world" graphs: Beyond the semicircle law by Farkas, Derenyi, Barabasi and Vicsek
 void GetInvParticipRat(const PUNGraph& Graph, int MaxEigVecs, int TimeLimit, TFltPrV& EigValIprV) {
-  TUNGraphMtx GraphMtx(Graph);
-  TFltVV EigVecVV;
+  TVec<TFltV> EigVecVV;
   TFltV EigValV;
   TExeTm ExeTm;
   if (MaxEigVecs<=1) { MaxEigVecs=1000; }
   int EigVecs = TMath::Mn(Graph->GetNodes(), MaxEigVecs);
   printf("start %d vecs...", EigVecs);
-  try {
-    TSparseSVD::Lanczos2(GraphMtx, EigVecs, TimeLimit, ssotFull, EigValV, EigVecVV, false);
-  } catch(...) {
-    printf("\n  ***EXCEPTION:  TRIED %d GOT %d values** \n", EigVecs, EigValV.Len()); }
+  GetEigLanczos(TCsrGraphMtx(TCsrGraph::New(Graph)), EigVecs, EigValV, &EigVecVV, 0, 10, TimeLimit);
   printf("  ***TRIED %d GOT %d values in %s\n", EigVecs, EigValV.Len(), ExeTm.GetStr());
-  TFltV EigVec;
   EigValIprV.Clr();
   if (EigValV.Empty()) { return; }
-  for (int v = 0; v < EigVecVV.GetCols(); v++) {
-    EigVecVV.GetCol(v, EigVec);
-    EigValIprV.Add(TFltPr(EigValV[v], TSnapDetail::GetInvParticipRatEig(EigVec)));
+  for (int v = 0; v < EigVecVV.Len(); v++) {
+    EigValIprV.Add(TFltPr(EigValV[v], TSnapDetail::GetInvParticipRatEig(EigVecVV[v])));
   }
   EigValIprV.Sort();
 }
@@ -46,23 +46,69 @@ public:
   void PMultiplyT(const TFltV& Vec, TFltV& Result) const;
 };
 
+//#//////////////////////////////////////////////
+/// Adjacency or Laplacian matrix of a compressed sparse row graph snapshot (TCsrGraph).
+/// Row and column i correspond to node index i of the snapshot, the Laplacian is D-A where D holds the out-degrees.
+/// Products with single vectors or with blocks of vectors are computed in parallel directly on the snapshot,
+/// the matrix itself is never materialized. The class is used by the parallel spectral solvers (see TSnap::GetEigLanczos()).
+class TCsrGraphMtx {
+private:
+  PCsrGraph Graph;
+  TBool Laplacian;
+private:
+  void MultiplyBlock(const TVec<TInt64>& OffV, const TVec<TInt, int64>& NbrV, const TVec<TFlt, int64>& XV, TVec<TFlt, int64>& YV, const int& Cols) const;
+public:
+  TCsrGraphMtx(const PCsrGraph& GraphPt, const bool& LaplacianMtx=false) : Graph(GraphPt), Laplacian(LaplacianMtx) { }
+  int GetRows() const { return Graph->GetNodes(); }
+  int GetCols() const { return Graph->GetNodes(); }
+  /// Tests whether the matrix is symmetric, which is the case for snapshots of undirected graphs.
+  bool IsSymmetric() const { return ! Graph->IsDir(); }
+  bool IsLaplacian() const { return Laplacian; }
+  const PCsrGraph& GetGraph() const { return Graph; }
+  /// Computes YV = M*XV for a block of Cols vectors. Blocks are stored row by row, element (Row, Col) is at Row*Cols+Col.
+  void Multiply(const TVec<TFlt, int64>& XV, TVec<TFlt, int64>& YV, const int& Cols=1) const {
+    MultiplyBlock(Graph->GetOutOffV(), Graph->GetOutNbrV(), XV, YV, Cols); }
+  /// Computes YV = M'*XV for a block of Cols vectors stored row by row.
+  void MultiplyT(const TVec<TFlt, int64>& XV, TVec<TFlt, int64>& YV, const int& Cols=1) const {
+    MultiplyBlock(Graph->GetInOffV(), Graph->GetInNbrV(), XV, YV, Cols); }
+};
+
 /////////////////////////////////////////////////
 // Graphs Singular Value Decomposition of Graph Adjacency Matrix
 namespace TSnap {
 
+/// Computes EigVals eigenvalues of largest magnitude (and the corresponding eigenvectors, if EigVecV is not NULL) of a symmetric Mtx.
+/// Uses parallel Lanczos iteration with selective orthogonalization against converged Ritz vectors (Parlett and Scott).
+/// Steps bounds the number of Lanczos steps (0 means max(4*EigVals, EigVals+100)). Ritz values are checked for
+/// convergence every BlockSize steps and whenever the loss of orthogonality estimated by Simon's omega recurrence
+/// exceeds sqrt(eps); converged Ritz vectors are formed at these checks. The iteration also stops after
+/// MxSecs seconds if MxSecs > 0. Eigenvalues are returned in the order of decreasing magnitude. Returns the number of Lanczos steps.
+/// At most MxBasis Lanczos vectors are kept (0 means EigVals+max(100, EigVals/2)), so the solver needs 8*N*MxBasis bytes
+/// besides the returned eigenvectors. If Steps exceeds MxBasis, thick-restart Lanczos (Wu and Simon) with full
+/// reorthogonalization is used instead: the basis is restarted from its Ritz vectors of largest magnitude whenever it is full.
+int GetEigLanczos(const TCsrGraphMtx& Mtx, const int& EigVals, TFltV& EigValV, TVec<TFltV>* EigVecV=NULL, const int& Steps=0, const int& BlockSize=10, const double& MxSecs=0, const int& MxBasis=0);
+/// Computes SngVals largest singular values and the corresponding left and right singular vectors of Mtx with randomized SVD
+/// (Halko, Martinsson and Tropp). The range of Mtx is sampled by a block of BlockSize random vectors (0 means SngVals+10),
+/// refined by PowerIters power iterations. Products with the block are computed in one parallel pass over the snapshot.
+void GetSvdRnd(const TCsrGraphMtx& Mtx, const int& SngVals, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV, const int& BlockSize=0, const int& PowerIters=2, TRnd& Rnd=TInt::Rnd);
+
 /// Computes largest SngVals singular values of the adjacency matrix representing a directed Graph.
-void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV);
+/// Small graphs use full SVD, larger ones Lanczos, or the faster but approximate randomized SVD (GetSvdRnd()) if RndSvd is true.
+void GetSngVals(const PNGraph& Graph, const int& SngVals, TFltV& SngValV, const bool& RndSvd=false);
 /// Computes the leading left and right singular vector of the adjacency matrix representing a directed Graph.
-void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV);
+/// Small graphs use full SVD, larger ones Lanczos, or the faster but approximate randomized SVD (GetSvdRnd()) if RndSvd is true.
+void GetSngVec(const PNGraph& Graph, TFltV& LeftSV, TFltV& RightSV, const bool& RndSvd=false);
 /// Computes the singular values and left and right singular vectors of the adjacency matrix representing a directed Graph.
+/// Small graphs use full SVD, larger ones Lanczos, or the faster but approximate randomized SVD (GetSvdRnd()) if RndSvd is true.
 /// @param SngVecs Number of singular values/vectors to compute.
-void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV);
+void GetSngVec(const PNGraph& Graph, const int& SngVecs, TFltV& SngValV, TVec<TFltV>& LeftSV, TVec<TFltV>& RightSV, const bool& RndSvd=false);
 
 /// Computes top EigVals eigenvalues of the adjacency matrix representing a given undirected Graph.
 void GetEigVals(const PUNGraph& Graph, const int& EigVals, TFltV& EigValV);
 /// Computes the leading eigenvector of the adjacency matrix representing a given undirected Graph.
 void GetEigVec(const PUNGraph& Graph, TFltV& EigVecV);
 /// Computes top EigVecs eigenvalues and eigenvectors of the adjacency matrix representing a given undirected Graph.
+/// Vector components correspond to nodes in the increasing order of their ids.
 void GetEigVec(const PUNGraph& Graph, const int& EigVecs, TFltV& EigValV, TVec<TFltV>& EigVecV);
 /// Computes Inverse participation ratio of a given graph.
 /// See Spectra of "real-world" graphs: Beyond the semicircle law by Farkas, Derenyi, Barabasi and Vicsek
@@ -70,6 +116,12 @@ void GetInvParticipRat(const PUNGraph& Graph, int MaxEigVecs, int TimeLimit, TFl
 
 namespace TSnapDetail {
 double GetInvParticipRatEig(const TFltV& EigVec);
+/// Computes eigenvalues of the symmetric tridiagonal matrix with diagonal AlphaV and off-diagonal BetaV, and the last components of the eigenvectors.
+void GetTridiagEig(const TFltV& AlphaV, const TFltV& BetaV, TFltV& EigValV, TFltV& LastV);
+/// Computes the eigenvector of the symmetric tridiagonal matrix (AlphaV, BetaV) with eigenvalue EigVal by inverse iteration, orthogonal to OrthV.
+void GetTridiagEigVec(const TFltV& AlphaV, const TFltV& BetaV, const double& EigVal, const TVec<TFltV>& OrthV, TFltV& EigVecV);
+/// Computes all eigenvalues (in decreasing order) and eigenvectors (columns of EigVecVV) of a small dense symmetric matrix.
+void GetSymEig(const TFltVV& Mtx, TFltV& EigValV, TFltVV& EigVecVV);
 } // namespace TSnapDetail
 
 }; // namespace TSnap
@@ -9,6 +9,7 @@
 #define snap_core_randwalk_h
 
 #include <stdio.h>
+#include <algorithm>
 #include "priorityqueue.h"
 #include "Snap.h"
 
@@ -144,6 +145,151 @@ template <class PGraph>
                                                 minProbability, relativeError, proveRelativeError, PrintTimeForTuning);
   }
 
+/// Number of seeds processed together by GetPersonalizedPageRankBatch. Every node keeps one score and one residual lane per seed of the block.
+const int PprBatchLanes = 8;
+
+namespace TSnapDetail {
+/// Per-thread state of the batched forward push. Every node visited by a block gets a slot (its key id in NIdxSet) and
+/// the lane vectors hold PprBatchLanes values per slot, so the state is as large as the visited part of the graph, like
+/// the hash tables of the serial push, while the lanes of a node stay contiguous. Clr() keeps the memory for the next block.
+class TPprBatchState {
+public:
+  TIntSet NIdxSet;           // node index of each slot
+  TVec<TFlt, int64> PV, RV;  // score and residual lanes of the slots
+  TBoolV InQueueB;           // slot is in QueueV
+  TIntV QueueV;              // slots waiting for a push
+public:
+  TPprBatchState() : NIdxSet(), PV(), RV(), InQueueB(), QueueV() { }
+  /// Returns the slot of node NIdx, the lanes of a new slot are zero.
+  int GetSlot(const int& NIdx) {
+    const int Slot = NIdxSet.AddKey(NIdx);
+    if (Slot == InQueueB.Len()) {
+      InQueueB.Add(false);
+      for (int l = 0; l < PprBatchLanes; l++) { PV.Add(0.0);  RV.Add(0.0); }
+    }
+    return Slot;
+  }
+  int GetSlots() const { return NIdxSet.Len(); }
+  int GetNIdx(const int& Slot) const { return NIdxSet.GetKey(Slot); }
+  void Clr() { NIdxSet.Clr(false);  PV.Clr(false);  RV.Clr(false);  InQueueB.Clr(false);  QueueV.Clr(false); }
+};
+
+/// Orders (score, node index) pairs by decreasing score, ties by increasing node index.
+class TPprScoreCmp {
+public:
+  bool operator () (const TFltIntKd& Kd1, const TFltIntKd& Kd2) const {
+    return Kd1.Key > Kd2.Key || (Kd1.Key == Kd2.Key && Kd1.Dat < Kd2.Dat); }
+};
+
+/// Tests whether any residual lane of the node in Slot is above Eps times the out-degree of the node.
+inline bool IsPprActive(const TPprBatchState& State, const int& Slot, const int& Deg, const double& Eps) {
+  const double Thresh = Eps * TMath::Mx(Deg, 1);
+  const int64 Off = int64(Slot)*PprBatchLanes;
+  for (int l = 0; l < PprBatchLanes; l++) {
+    if (State.RV[Off+l] > Thresh) { return true; }
+  }
+  return false;
+}
+
+/// Forward push (Andersen, Chung and Lang) for up to PprBatchLanes seeds at once. Every push moves all lanes of a node,
+/// so the lane loops run over contiguous memory. A walk at a node without out-links restarts at the seed of its lane.
+inline void GetPprPushBlock(const TCsrGraph& Graph, const TInt* SeedNIdx, const int& Seeds, const double& JumpProb, const double& Eps,
+ const int& TopN, TPprBatchState& State, TIntFltKdV* TopNV) {
+  const TVec<TInt64>& OffV = Graph.GetOutOffV();
+  const TVec<TInt, int64>& NbrV = Graph.GetOutNbrV();
+  int SeedSlot[PprBatchLanes];
+  for (int l = 0; l < Seeds; l++) {
+    SeedSlot[l] = State.GetSlot(SeedNIdx[l]);
+    State.RV[int64(SeedSlot[l])*PprBatchLanes+l] += 1.0;
+    if (! State.InQueueB[SeedSlot[l]]) { State.InQueueB[SeedSlot[l]] = true;  State.QueueV.Add(SeedSlot[l]); }
+  }
+  double PushV[PprBatchLanes];
+  for (int q = 0; q < State.QueueV.Len(); q++) {
+    const int Slot = State.QueueV[q];
+    const int NIdx = State.GetNIdx(Slot);
+    State.InQueueB[Slot] = false;
+    const int64 Off = int64(Slot)*PprBatchLanes;
+    const int Deg = int(OffV[NIdx+1] - OffV[NIdx]);
+    for (int l = 0; l < PprBatchLanes; l++) {
+      State.PV[Off+l] += JumpProb * State.RV[Off+l];
+      PushV[l] = (1.0-JumpProb) * State.RV[Off+l] / TMath::Mx(Deg, 1);
+      State.RV[Off+l] = 0.0;
+    }
+    if (Deg == 0) {
+      for (int l = 0; l < Seeds; l++) {
+        State.RV[int64(SeedSlot[l])*PprBatchLanes+l] += PushV[l];
+        if (! State.InQueueB[SeedSlot[l]] && IsPprActive(State, SeedSlot[l], Graph.GetOutDeg(SeedNIdx[l]), Eps)) {
+          State.InQueueB[SeedSlot[l]] = true;  State.QueueV.Add(SeedSlot[l]); }
+      }
+      continue;
+    }
+    for (int64 e = OffV[NIdx]; e < OffV[NIdx+1]; e++) {
+      const int DstNIdx = NbrV[e];
+      const int DstSlot = State.GetSlot(DstNIdx);
+      const int64 DstOff = int64(DstSlot)*PprBatchLanes;
+      for (int l = 0; l < PprBatchLanes; l++) { State.RV[DstOff+l] += PushV[l]; }
+      if (! State.InQueueB[DstSlot] && IsPprActive(State, DstSlot, Graph.GetOutDeg(DstNIdx), Eps)) {
+        State.InQueueB[DstSlot] = true;  State.QueueV.Add(DstSlot); }
+    }
+    // compact the queue once its consumed prefix dominates
+    if (q > 1024 && 2*q > State.QueueV.Len()) {
+      State.QueueV.Del(0, q);  q = -1;
+    }
+  }
+  State.QueueV.Clr(false);
+  // top-N per lane
+  TFltIntKdV ScoreV;
+  for (int l = 0; l < Seeds; l++) {
+    ScoreV.Clr(false);
+    for (int s = 0; s < State.GetSlots(); s++) {
+      const double Score = State.PV[int64(s)*PprBatchLanes+l];
+      if (Score > 0.0) { ScoreV.Add(TFltIntKd(Score, State.GetNIdx(s))); }
+    }
+    const int Top = TMath::Mn(TopN, ScoreV.Len());
+    std::partial_sort(ScoreV.BegI(), ScoreV.BegI()+Top, ScoreV.EndI(), TPprScoreCmp());
+    TopNV[l].Gen(Top, 0);
+    for (int i = 0; i < Top; i++) {
+      TopNV[l].Add(TIntFltKd(Graph.GetNId(ScoreV[i].Dat), ScoreV[i].Key));
+    }
+  }
+  State.Clr();
+}
+} // namespace TSnapDetail
+
+/// Computes personalized PageRank for every seed in SeedNIdV and returns the TopN highest scoring nodes of each seed.
+/// TopNV[i] holds (node id, score) pairs of seed SeedNIdV[i] sorted by decreasing score. As in SamplePersonalizedPageRank,
+/// the walk stops at every step with probability JumpProb and restarts at the seed at nodes without out-links.
+/// Uses forward push until every residual is below Eps times the out-degree of its node, so each score underestimates
+/// the true value by at most Eps times the number of arcs. Seeds are processed in blocks of PprBatchLanes, blocks run in parallel.
+inline void GetPersonalizedPageRankBatch(const PCsrGraph& Graph, const TIntV& SeedNIdV, TVec<TIntFltKdV>& TopNV,
+ const double& JumpProb=0.15, const int& TopN=100, const double& Eps=1e-6) {
+  IAssert(0.0 < JumpProb && JumpProb <= 1.0 && Eps > 0.0);
+  TIntV SeedNIdxV(SeedNIdV.Len());
+  for (int i = 0; i < SeedNIdV.Len(); i++) {
+    IAssertR(Graph->IsNode(SeedNIdV[i]), TStr::Fmt("Seed node %d does not exist.", SeedNIdV[i].Val));
+    SeedNIdxV[i] = Graph->GetNIdx(SeedNIdV[i]);
+  }
+  TopNV.Gen(SeedNIdV.Len());
+  const int Blocks = (SeedNIdV.Len() + PprBatchLanes-1) / PprBatchLanes;
+  #pragma omp parallel
+  {
+    TSnapDetail::TPprBatchState State;
+    #pragma omp for schedule(dynamic,1)
+    for (int b = 0; b < Blocks; b++) {
+      const int Beg = b*PprBatchLanes;
+      TSnapDetail::GetPprPushBlock(*Graph, SeedNIdxV.BegI()+Beg, TMath::Mn(PprBatchLanes, SeedNIdV.Len()-Beg),
+        JumpProb, Eps, TopN, State, TopNV.BegI()+Beg);
+    }
+  }
+}
+
+/// Computes personalized PageRank for every seed in SeedNIdV on a CSR snapshot of Graph. See the PCsrGraph overload.
+template <class PGraph>
+void GetPersonalizedPageRankBatch(const PGraph& Graph, const TIntV& SeedNIdV, TVec<TIntFltKdV>& TopNV,
+ const double& JumpProb=0.15, const int& TopN=100, const double& Eps=1e-6) {
+  GetPersonalizedPageRankBatch(TCsrGraph::New(Graph), SeedNIdV, TopNV, JumpProb, TopN, Eps);
+}
+
 }; // namespace TSnap
 
 #endif
@@ -19,7 +19,8 @@ template <class PGraph> void PlotSccDistr(const PGraph& Graph, const TStr& FNmPr
 template <class PGraph> void PlotClustCf(const PGraph& Graph, const TStr& FNmPref, TStr DescStr=TStr());
 /// Plots the cumulative distribution of the shortest path lengths of a Graph. Implementation is based on ANF.
 /// @param IsDir false: ignore edge directions and consider graph as undirected.
-template <class PGraph> void PlotHops(const PGraph& Graph, const TStr& FNmPref, TStr DescStr=TStr(), const bool& IsDir=false, const int& NApprox=32);
+/// @param HyperAnf true: use HyperANF (THyperAnf), for graphs too large for TGraphAnf.
+template <class PGraph> void PlotHops(const PGraph& Graph, const TStr& FNmPref, TStr DescStr=TStr(), const bool& IsDir=false, const int& NApprox=32, const bool& HyperAnf=false);
 /// Plots the distribution of the shortest path lengths of a Graph. Implementation is based on BFS.
 template <class PGraph> void PlotShortPathDistr(const PGraph& Graph, const TStr& FNmPref, TStr DescStr=TStr(), int TestNodes=TInt::Mx);
 /// Plots the k-Core node-size distribution: Core k vs. number of nodes in k-core
@@ -123,9 +124,9 @@ void PlotClustCf(const PGraph& Graph, const TStr& FNmPref, TStr DescStr) {
 }
 
 template <class PGraph>
-void PlotHops(const PGraph& Graph, const TStr& FNmPref, TStr DescStr, const bool& IsDir, const int& NApprox) {
+void PlotHops(const PGraph& Graph, const TStr& FNmPref, TStr DescStr, const bool& IsDir, const int& NApprox, const bool& HyperAnf) {
   TIntFltKdV DistNbrsV;
-  TSnap::GetAnf(Graph, DistNbrsV, -1, IsDir, NApprox);
+  TSnap::GetAnf(Graph, DistNbrsV, -1, IsDir, NApprox, HyperAnf);
   const double EffDiam = TSnap::TSnapDetail::CalcEffDiam(DistNbrsV, 0.9);
   if (DescStr.Empty()) { DescStr = FNmPref; }
   TGnuPlot GnuPlot("hop."+FNmPref, TStr::Fmt("%s. Hop plot. EffDiam: %g, G(%d, %d)",
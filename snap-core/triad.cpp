@@ -99,3 +99,203 @@ int GetCommon(TIntV& A, TIntV& B) {
 }
 
 } // namespace TSnap
+
+/////////////////////////////////////////////////
+// Streaming triangle estimation
+void TTriadStreamEst::TEdgeSample::AddEdge(const int& NId1, const int& NId2, const int64& EdgeN) {
+  // count the triangles closed by the new edge before it is (possibly) sampled
+  const double M = MxEdges;
+  const double Eta = TMath::Mx(1.0, (double(EdgeN-1)*double(EdgeN-2))/(M*(M-1.0)));
+  const int KeyId1 = NbrH.GetKeyId(NId1);
+  const int KeyId2 = NbrH.GetKeyId(NId2);
+  if (KeyId1 != -1 && KeyId2 != -1) {
+    const TIntH& Nbr1 = NbrH[KeyId1];
+    const TIntH& Nbr2 = NbrH[KeyId2];
+    const TIntH& SmallSet = Nbr1.Len() < Nbr2.Len() ? Nbr1 : Nbr2;
+    const TIntH& LargeSet = Nbr1.Len() < Nbr2.Len() ? Nbr2 : Nbr1;
+    double Closed = 0;
+    for (int k = SmallSet.FFirstKeyId(); SmallSet.FNextKeyId(k); ) {
+      const int NId = SmallSet.GetKey(k);
+      if (LargeSet.IsKey(NId)) {
+        LocalH.AddDat(NId) += Eta;
+        Closed += Eta;
+      }
+    }
+    if (Closed > 0) {
+      GlobalCnt += Closed;
+      LocalH.AddDat(NId1) += Closed;
+      LocalH.AddDat(NId2) += Closed;
+    }
+  }
+  // reservoir sampling
+  if (EdgeN <= MxEdges) {
+    EdgeV.Add(TIntPr(NId1, NId2));
+    AddSampleEdge(NId1, NId2);
+  } else if (Rnd.GetUniDev() < M / double(EdgeN)) {
+    TIntPr& Edge = EdgeV[Rnd.GetUniDevInt(EdgeV.Len())];
+    DelSampleEdge(Edge.Val1, Edge.Val2);
+    Edge = TIntPr(NId1, NId2);
+    AddSampleEdge(NId1, NId2);
+  }
+}
+
+// the reservoir may hold several copies of an edge, the adjacency is kept until the last one is evicted
+void TTriadStreamEst::TEdgeSample::AddSampleEdge(const int& NId1, const int& NId2) {
+  NbrH.AddDat(NId1).AddDat(NId2).Val++;
+  NbrH.AddDat(NId2).AddDat(NId1).Val++;
+}
+
+void TTriadStreamEst::TEdgeSample::DelSampleEdge(const int& NId1, const int& NId2) {
+  TIntH& Nbr1 = NbrH.GetDat(NId1);
+  if (--Nbr1.GetDat(NId2).Val == 0) { Nbr1.DelKey(NId2); }
+  if (Nbr1.Empty()) { NbrH.DelKey(NId1); }
+  TIntH& Nbr2 = NbrH.GetDat(NId2);
+  if (--Nbr2.GetDat(NId1).Val == 0) { Nbr2.DelKey(NId1); }
+  if (Nbr2.Empty()) { NbrH.DelKey(NId2); }
+}
+
+TTriadStreamEst::TTriadStreamEst(const int& _MxEdges, const int& NEst, const int& _RndSeed, const bool& _SkipDup) : MxEdges(_MxEdges), RndSeed(_RndSeed), SkipDup(_SkipDup), EdgeSet(), EstV(NEst), Edges(0), DegH(), Wedges(0) {
+  IAssertR(NEst > 0 && MxEdges / NEst >= 2, "Each estimator needs to sample at least 2 edges");
+  Clr();
+}
+
+void TTriadStreamEst::Clr() {
+  for (int i = 0; i < EstV.Len(); i++) {
+    EstV[i] = TEdgeSample(MxEdges / EstV.Len(), RndSeed + i);
+  }
+  Edges = 0;
+  EdgeSet.Clr();
+  DegH.Clr();
+  Wedges = 0;
+}
+
+bool TTriadStreamEst::AddEdge(const int& NId1, const int& NId2) {
+  if (NId1 == NId2) { return false; }
+  if (SkipDup) {
+    const TIntPr Edge(TMath::Mn(NId1, NId2), TMath::Mx(NId1, NId2));
+    if (EdgeSet.IsKey(Edge)) { return false; }
+    EdgeSet.AddKey(Edge);
+  }
+  Edges++;
+  int& Deg1 = DegH.AddDat(NId1).Val;
+  Wedges += Deg1;  Deg1++;
+  int& Deg2 = DegH.AddDat(NId2).Val;
+  Wedges += Deg2;  Deg2++;
+  for (int i = 0; i < EstV.Len(); i++) {
+    EstV[i].AddEdge(NId1, NId2, Edges);
+  }
+  return true;
+}
+
+int64 TTriadStreamEst::AddEdgeList(const TStr& InFNm, const int& SrcColId, const int& DstColId, const int64& ReportEvery) {
+  TSsParser Ss(InFNm, ssfWhiteSep, true, true, true);
+  int SrcNId, DstNId;
+  int64 EdgesRead = 0;
+  while (Ss.Next()) {
+    if (! Ss.GetInt(SrcColId, SrcNId) || ! Ss.GetInt(DstColId, DstNId)) { continue; }
+    if (! AddEdge(SrcNId, DstNId)) { continue; }
+    EdgesRead++;
+    if (ReportEvery > 0 && EdgesRead % ReportEvery == 0) { Report(); }
+  }
+  return EdgesRead;
+}
+
+int64 TTriadStreamEst::AddTable(const PTable& Table, const TStr& SrcCol, const TStr& DstCol, const int64& ReportEvery) {
+  IAssertR(Table->GetColType(SrcCol) == atInt && Table->GetColType(DstCol) == atInt, "Source and destination columns must be of integer type");
+  const TInt SrcColIdx = Table->GetColIdx(SrcCol);
+  const TInt DstColIdx = Table->GetColIdx(DstCol);
+  int64 EdgesRead = 0;
+  for (TRowIterator RowI = Table->BegRI(); RowI < Table->EndRI(); RowI++) {
+    if (! AddEdge(RowI.GetIntAttr(SrcColIdx), RowI.GetIntAttr(DstColIdx))) { continue; }
+    EdgesRead++;
+    if (ReportEvery > 0 && EdgesRead % ReportEvery == 0) { Report(); }
+  }
+  return EdgesRead;
+}
+
+double TTriadStreamEst::GetTriangles() const {
+  double LowCnt, HighCnt;
+  return GetTriangles(LowCnt, HighCnt);
+}
+
+double TTriadStreamEst::GetTriangles(double& LowCnt, double& HighCnt, const double& ZScore) const {
+  TFltV CntV(EstV.Len(), 0);
+  for (int i = 0; i < EstV.Len(); i++) {
+    CntV.Add(EstV[i].GlobalCnt); }
+  return GetMeanCI(CntV, LowCnt, HighCnt, ZScore);
+}
+
+double TTriadStreamEst::GetNodeTriangles(const int& NId) const {
+  double LowCnt, HighCnt;
+  return GetNodeTriangles(NId, LowCnt, HighCnt);
+}
+
+double TTriadStreamEst::GetNodeTriangles(const int& NId, double& LowCnt, double& HighCnt, const double& ZScore) const {
+  TFltV CntV(EstV.Len(), 0);
+  for (int i = 0; i < EstV.Len(); i++) {
+    const int KeyId = EstV[i].LocalH.GetKeyId(NId);
+    CntV.Add(KeyId == -1 ? 0.0 : EstV[i].LocalH[KeyId].Val);
+  }
+  return GetMeanCI(CntV, LowCnt, HighCnt, ZScore);
+}
+
+void TTriadStreamEst::GetNodeTriangles(TIntFltH& NIdTriadH) const {
+  NIdTriadH.Clr();
+  for (int i = 0; i < EstV.Len(); i++) {
+    const TIntFltH& LocalH = EstV[i].LocalH;
+    for (int k = LocalH.FFirstKeyId(); LocalH.FNextKeyId(k); ) {
+      NIdTriadH.AddDat(LocalH.GetKey(k)) += LocalH[k] / double(EstV.Len());
+    }
+  }
+}
+
+double TTriadStreamEst::GetGlobalClustCf() const {
+  double LowCf, HighCf;
+  return GetGlobalClustCf(LowCf, HighCf);
+}
+
+double TTriadStreamEst::GetGlobalClustCf(double& LowCf, double& HighCf, const double& ZScore) const {
+  if (Wedges.Val == 0.0) { LowCf = HighCf = 0.0;  return 0.0; }
+  TFltV CfV(EstV.Len(), 0);
+  for (int i = 0; i < EstV.Len(); i++) {
+    CfV.Add(3.0 * EstV[i].GlobalCnt / Wedges); }
+  return GetMeanCI(CfV, LowCf, HighCf, ZScore);
+}
+
+double TTriadStreamEst::GetNodeClustCf(const int& NId) const {
+  const int KeyId = DegH.GetKeyId(NId);
+  if (KeyId == -1 || DegH[KeyId] < 2) { return 0.0; }
+  const double Deg = DegH[KeyId];
+  return TMath::Mn(1.0, GetNodeTriangles(NId) / (Deg*(Deg-1.0)/2.0));
+}
+
+double TTriadStreamEst::GetClustCf() const {
+  if (DegH.Empty()) { return 0.0; }
+  TIntFltH NIdTriadH;
+  GetNodeTriangles(NIdTriadH);
+  double SumCcf = 0.0;
+  for (int k = NIdTriadH.FFirstKeyId(); NIdTriadH.FNextKeyId(k); ) {
+    const double Deg = DegH.GetDat(NIdTriadH.GetKey(k));
+    if (Deg < 2) { continue; }
+    SumCcf += TMath::Mn(1.0, NIdTriadH[k] / (Deg*(Deg-1.0)/2.0));
+  }
+  return SumCcf / double(DegH.Len());
+}
+
+double TTriadStreamEst::GetMeanCI(const TFltV& ValV, double& LowVal, double& HighVal, const double& ZScore) {
+  double Mean = 0.0;
+  for (int i = 0; i < ValV.Len(); i++) { Mean += ValV[i]; }
+  Mean /= double(ValV.Len());
+  double Var = 0.0;
+  for (int i = 0; i < ValV.Len(); i++) { Var += TMath::Sqr(ValV[i] - Mean); }
+  const double StdErr = ValV.Len() > 1 ? sqrt(Var / double(ValV.Len()-1) / double(ValV.Len())) : 0.0;
+  LowVal = TMath::Mx(0.0, Mean - ZScore * StdErr);
+  HighVal = Mean + ZScore * StdErr;
+  return Mean;
+}
+
+void TTriadStreamEst::Report() const {
+  double LowCnt, HighCnt;
+  const double TriadCnt = GetTriangles(LowCnt, HighCnt);
+  printf("  %lld edges, %d nodes: %g triangles [%g, %g], clust cf %g\n", (long long) Edges.Val, GetNodes(), TriadCnt, LowCnt, HighCnt, GetGlobalClustCf());
+}
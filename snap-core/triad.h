@@ -889,5 +889,86 @@ void TNetConstraint<PGraph>::Test() {
   printf("middle node network constraint: %f\n", NetConstraint.GetNodeC(0));
 }
 
+/////////////////////////////////////////////////
+// Streaming triangle estimation
+/// Fixed-memory estimator of global and local triangle counts over an undirected edge stream.
+/// Implements TRIEST-IMPR (De Stefani et al., KDD 2016): each of the NEst independent estimators keeps a
+/// uniform reservoir sample of MxEdges/NEst edges and updates its (unbiased) triangle estimates on every edge.
+/// Averaging the estimators gives the estimate, their spread gives the confidence interval. Self-loops are
+/// ignored. By default every undirected edge is expected to appear in the stream only once, and repeated edges
+/// are counted again. If SkipDup is true, repeated and reciprocal edges are skipped, which needs a set of all
+/// edges seen (O(edges) memory), so it is only meant for streams that fit in memory. Node degrees are counted
+/// exactly (O(nodes) memory) so that clustering coefficients can be reported as well.
+class TTriadStreamEst {
+private:
+  class TEdgeSample {
+  public:
+    TInt MxEdges;
+    TRnd Rnd;
+    TIntPrV EdgeV;                  // reservoir of sampled edges
+    THash<TInt, TIntH> NbrH;        // adjacency of the sampled edges, with the number of sampled copies of each edge
+    TFlt GlobalCnt;                 // estimated number of triangles
+    TIntFltH LocalH;                // estimated number of triangles for each node
+  public:
+    TEdgeSample() : MxEdges(0), Rnd(1), EdgeV(), NbrH(), GlobalCnt(0), LocalH() { }
+    TEdgeSample(const int& _MxEdges, const int& RndSeed) : MxEdges(_MxEdges), Rnd(RndSeed), EdgeV(_MxEdges, 0), NbrH(), GlobalCnt(0), LocalH() { }
+    void AddEdge(const int& NId1, const int& NId2, const int64& EdgeN);
+  private:
+    void AddSampleEdge(const int& NId1, const int& NId2);
+    void DelSampleEdge(const int& NId1, const int& NId2);
+  };
+private:
+  TInt MxEdges, RndSeed;
+  TBool SkipDup;
+  THashSet<TIntPr> EdgeSet;         // edges seen so far as (min, max) pairs, if SkipDup
+  TVec<TEdgeSample> EstV;
+  TInt64 Edges;
+  TIntIntH DegH;
+  TFlt Wedges;
+public:
+  /// Creates an estimator which samples at most MxEdges edges in total, split among NEst independent estimators.
+  /// If SkipDup is true, repeated and reciprocal edges of the stream are skipped at O(edges) memory (see the class description).
+  TTriadStreamEst(const int& _MxEdges, const int& NEst=4, const int& _RndSeed=1, const bool& _SkipDup=false);
+  /// Clears the estimator and starts a new stream.
+  void Clr();
+  /// Adds an undirected edge (NId1, NId2) of the stream. Returns false for self-loops and, if SkipDup, for edges
+  /// seen before in either direction, which are skipped.
+  bool AddEdge(const int& NId1, const int& NId2);
+  /// Streams the edges from a text file InFNm with 1 edge per line (whitespace separated columns, integer node ids).
+  /// If ReportEvery > 0 the running estimate and its confidence interval are printed every ReportEvery edges. Returns the number of edges read.
+  int64 AddEdgeList(const TStr& InFNm, const int& SrcColId=0, const int& DstColId=1, const int64& ReportEvery=0);
+  /// Streams the edges from the integer columns SrcCol and DstCol of the rows of Table. Returns the number of edges read.
+  int64 AddTable(const PTable& Table, const TStr& SrcCol, const TStr& DstCol, const int64& ReportEvery=0);
+  /// Returns the number of (non-loop, non-skipped) edges seen so far.
+  int64 GetEdges() const { return Edges; }
+  /// Returns the number of nodes seen so far.
+  int GetNodes() const { return DegH.Len(); }
+  /// Returns the number of independent estimators.
+  int GetEstimators() const { return EstV.Len(); }
+  /// Returns the estimated number of triangles in the graph seen so far.
+  double GetTriangles() const;
+  /// Returns the estimated number of triangles in the graph and its confidence interval (mean +/- ZScore standard errors over the estimators).
+  double GetTriangles(double& LowCnt, double& HighCnt, const double& ZScore=1.96) const;
+  /// Returns the estimated number of triangles node NId participates in.
+  double GetNodeTriangles(const int& NId) const;
+  /// Returns the estimated number of triangles node NId participates in and its confidence interval.
+  double GetNodeTriangles(const int& NId, double& LowCnt, double& HighCnt, const double& ZScore=1.96) const;
+  /// Returns the estimated number of triangles for every node with a non-zero estimate.
+  void GetNodeTriangles(TIntFltH& NIdTriadH) const;
+  /// Returns the exact number of open and closed triads (wedges) in the graph seen so far.
+  double GetWedges() const { return Wedges; }
+  /// Returns the estimated global clustering coefficient (transitivity): 3 * triangles / wedges.
+  double GetGlobalClustCf() const;
+  /// Returns the estimated global clustering coefficient and its confidence interval.
+  double GetGlobalClustCf(double& LowCf, double& HighCf, const double& ZScore=1.96) const;
+  /// Returns the estimated clustering coefficient of node NId.
+  double GetNodeClustCf(const int& NId) const;
+  /// Returns the estimated average clustering coefficient as defined in Watts and Strogatz (nodes of degree less than 2 count as 0).
+  double GetClustCf() const;
+private:
+  static double GetMeanCI(const TFltV& ValV, double& LowVal, double& HighVal, const double& ZScore);
+  void Report() const;
+};
+
 #endif // TRIAD_H
 
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// Returns the exact number of pairs of nodes reachable in <=H hops
+template <class PGraph>
+void GetExactNbrsV(const PGraph& G, const bool& IsDir, TFltV& NbrsV) {
+  NbrsV.Clr();
+  for (typename PGraph::TObj::TNodeI NI = G->BegNI(); NI < G->EndNI(); NI++) {
+    TIntH NIdDistH;
+    TSnap::GetShortPath(G, NI.GetId(), NIdDistH, IsDir);
+    for (int i = 0; i < NIdDistH.Len(); i++) {
+      const int Dist = NIdDistH[i];
+      while (NbrsV.Len() <= Dist) { NbrsV.Add(0.0); }
+      NbrsV[Dist] += 1.0;
+    }
+  }
+  for (int d = 1; d < NbrsV.Len(); d++) { NbrsV[d] += NbrsV[d-1]; }
+}
+
+// Compares HyperANF estimates to the exact neighborhood function
+template <class PGraph>
+void TestHyperAnf(const PGraph& G, const bool& IsDir, const int& RndSeed=1) {
+  TFltV ExactV;
+  GetExactNbrsV(G, IsDir, ExactV);
+  THyperAnf Anf(G, 10, RndSeed);
+  TIntFltKdV DistNbrsV;
+  Anf.GetGraphAnf(DistNbrsV, -1, IsDir);
+  EXPECT_EQ(G->GetNodes(), DistNbrsV[0].Dat);
+  for (int d = 1; d < DistNbrsV.Len(); d++) {
+    EXPECT_EQ(d, DistNbrsV[d].Key);
+    EXPECT_NEAR(1.0, DistNbrsV[d].Dat / ExactV[TMath::Mn(d, ExactV.Len()-1)], 0.1);
+  }
+}
+
+// Test HyperANF against exact neighborhood functions
+TEST(AnfTest, HyperAnf) {
+  TestHyperAnf(TSnap::GenGrid<PUNGraph>(30, 30, false), false);
+  TRnd Rnd(1);
+  TestHyperAnf(TSnap::GenRndGnm<PNGraph>(2000, 5000, true, Rnd), true);
+  TestHyperAnf(TSnap::GenRndGnm<PNGraph>(2000, 3000, true, Rnd), false);
+
+  // node neighborhood function of the center of a star
+  PUNGraph G = TSnap::GenStar<PUNGraph>(1000, false);
+  TIntFltKdV DistNbrsV;
+  TSnap::GetAnf(G, 0, DistNbrsV, -1, false, 256, true);
+  EXPECT_NEAR(1.0, DistNbrsV[0].Dat, 0.1);
+  EXPECT_NEAR(1.0, DistNbrsV[1].Dat / 1000.0, 0.15);
+
+  // effective diameter, HyperANF vs. BFS
+  G = TSnap::GenGrid<PUNGraph>(40, 40, false);
+  const double EffDiam = TSnap::GetBfsEffDiam(G, G->GetNodes(), false);
+  EXPECT_NEAR(EffDiam, TSnap::GetAnfEffDiam(G, false, 0.9, 64, true), 0.1*EffDiam);
+  EXPECT_NEAR(EffDiam, TSnap::GetAnfEffDiam(G, 1, 64, true), 0.1*EffDiam);
+}
+
+// Test broadword register maximum
+TEST(AnfTest, HyperAnfRegMax) {
+  TRnd Rnd(1);
+  for (int t = 0; t < 1000; t++) {
+    uint64 X = 0, Y = 0, Max = 0;
+    for (int b = 0; b < 8; b++) {
+      const uint64 RegX = Rnd.GetUniDevInt(t < 500 ? 4 : 128), RegY = Rnd.GetUniDevInt(t < 500 ? 4 : 128);
+      X |= RegX << (8*b);  Y |= RegY << (8*b);  Max |= TMath::Mx(RegX, RegY) << (8*b);
+    }
+    EXPECT_EQ(Max, THyperAnf::GetRegMax(X, Y));
+  }
+}
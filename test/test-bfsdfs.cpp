@@ -343,3 +343,44 @@ TEST(BfsDfsTest, CompleteGraph) {
   TestFullBfsDfs<PNEGraph>();
   
 }
+
+// Test exact diameter, radius and eccentricities against BFS from every node
+TEST(BfsDfsTest, ExactDiamEcc) {
+  TRnd Rnd(1);
+  for (int t = 0; t < 6; t++) {
+    // sparse graphs have long paths and many components, the directed ones are treated as undirected
+    PUNGraph UGraph = TSnap::GenRndGnm<PUNGraph>(300, 250 + 100*t, false, Rnd);
+    PNGraph NGraph = TSnap::GenRndGnm<PNGraph>(300, 250 + 100*t, true, Rnd);
+    for (int d = 0; d < 2; d++) {
+      PUNGraph Graph = d == 0 ? UGraph : TSnap::ConvertGraph<PUNGraph>(NGraph);
+      int Diam = 0, Rad = TInt::Mx;
+      TIntIntH NIdEccH;
+      if (d == 0) { TSnap::GetExactNodeEcc(UGraph, NIdEccH); } else { TSnap::GetExactNodeEcc(NGraph, NIdEccH); }
+      ASSERT_EQ(Graph->GetNodes(), NIdEccH.Len());
+      for (TUNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+        const int Ecc = TSnap::GetNodeEcc(Graph, NI.GetId());
+        EXPECT_EQ(Ecc, NIdEccH.GetDat(NI.GetId()));
+        Diam = TMath::Mx(Diam, Ecc);
+        Rad = TMath::Mn(Rad, Ecc);
+      }
+      EXPECT_EQ(Diam, d == 0 ? TSnap::GetExactDiam(UGraph) : TSnap::GetExactDiam(NGraph));
+      EXPECT_EQ(Rad, d == 0 ? TSnap::GetExactRad(UGraph) : TSnap::GetExactRad(NGraph));
+      // radius of the largest component
+      PUNGraph MxWcc = TSnap::GetMxWcc(Graph);
+      int MxWccRad = TInt::Mx;
+      for (TUNGraph::TNodeI NI = MxWcc->BegNI(); NI < MxWcc->EndNI(); NI++) {
+        MxWccRad = TMath::Mn(MxWccRad, TSnap::GetNodeEcc(MxWcc, NI.GetId()));
+      }
+      EXPECT_EQ(MxWccRad, TSnap::GetExactRad(MxWcc));
+    }
+  }
+  // path and grid
+  PUNGraph Path = TUNGraph::New();
+  for (int n = 0; n < 101; n++) { Path->AddNode(n); }
+  for (int n = 0; n < 100; n++) { Path->AddEdge(n, n+1); }
+  EXPECT_EQ(100, TSnap::GetExactDiam(Path));
+  EXPECT_EQ(50, TSnap::GetExactRad(Path));
+  PUNGraph Grid = TSnap::GenGrid<PUNGraph>(20, 30, false);
+  EXPECT_EQ(48, TSnap::GetExactDiam(Grid));
+  EXPECT_EQ(0, TSnap::GetExactDiam(TUNGraph::New()));
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// Compares PageRank scores to the scores of GetPageRank()
+template <class PGraph>
+void TestPageRankCsr(const PGraph& G) {
+  TIntFltH PRankH, CsrPRankH;
+  TSnap::GetPageRank(G, PRankH, 0.85, 1e-10, 1000);
+  const TPageRankMode ModeV[] = { prPull, prGaussSeidel, prPush };
+  for (int m = 0; m < 3; m++) {
+    TSnap::GetPageRankCsr(G, CsrPRankH, 0.85, 1e-10, 1000, ModeV[m]);
+    EXPECT_EQ(PRankH.Len(), CsrPRankH.Len());
+    for (int i = 0; i < PRankH.Len(); i++) {
+      EXPECT_NEAR(PRankH[i], CsrPRankH.GetDat(PRankH.GetKey(i)), 1e-8);
+    }
+    TSnap::GetPageRankCsr(G, CsrPRankH, 0.85, 1e-6, 1000, ModeV[m], true);
+    for (int i = 0; i < PRankH.Len(); i++) {
+      EXPECT_NEAR(PRankH[i], CsrPRankH.GetDat(PRankH.GetKey(i)), 1e-5);
+    }
+  }
+}
+
+// Test PageRank on CSR snapshots
+TEST(CentrTest, PageRankCsr) {
+  TRnd Rnd(1);
+  // directed graph with dangling nodes and node ids which are not 0...N-1
+  PNGraph G = TSnap::GenRndGnm<PNGraph>(2000, 4000, true, Rnd);
+  G->AddNode(5000);
+  G->AddEdge(5000, 7);
+  TestPageRankCsr(G);
+  TestPageRankCsr(TSnap::GenRndGnm<PUNGraph>(1000, 3000, false, Rnd));
+  TestPageRankCsr(TSnap::GenStar<PNGraph>(100, true));
+
+  // iteration statistics
+  TCsrPageRank<TFlt> PageRank(G);
+  const int Iters = PageRank.Run(prGaussSeidel, 1e-8, 100);
+  EXPECT_TRUE(Iters > 1 && Iters < 100);
+  EXPECT_EQ(Iters, PageRank.GetIterTmV().Len());
+  EXPECT_EQ(Iters, PageRank.GetIterDiffV().Len());
+  EXPECT_TRUE(PageRank.GetIterDiffV().Last() < 1e-8);
+  double Sum = 0.0;
+  for (int n = 0; n < PageRank.GetRankV().Len(); n++) { Sum += PageRank.GetRankV()[n]; }
+  EXPECT_NEAR(1.0, Sum, 1e-9);
+  EXPECT_EQ(PageRank.GetRank(5000), PageRank.GetRankV()[PageRank.GetGraph()->GetNIdx(5000)]);
+  // Gauss-Seidel converges faster than Jacobi iteration
+  TCsrPageRank<TFlt> JacobiPageRank(G);
+  EXPECT_TRUE(Iters < JacobiPageRank.Run(prPull, 1e-8, 100));
+  // pull iterations continue from the current scores
+  EXPECT_TRUE(JacobiPageRank.Run(prPull, 1e-8, 100) <= 2);
+}
+
+// Test that block Gauss-Seidel iteration over many blocks converges to the scores of Jacobi iteration
+TEST(CentrTest, PageRankCsrGaussSeidel) {
+  TRnd Rnd(1);
+  PNGraph G = TSnap::GenRndGnm<PNGraph>(20000, 100000, true, Rnd);
+  TCsrPageRank<TFlt> JacobiPageRank(G), GsPageRank(G);
+  JacobiPageRank.Run(prPull, 1e-10, 1000);
+  const int Iters = GsPageRank.Run(prGaussSeidel, 1e-10, 1000);
+  EXPECT_TRUE(Iters < JacobiPageRank.GetIters());
+  for (int n = 0; n < G->GetNodes(); n++) {
+    EXPECT_NEAR(JacobiPageRank.GetRankV()[n], GsPageRank.GetRankV()[n], 1e-9);
+  }
+#ifdef USE_OPENMP
+  // blocks do not depend on the number of threads, only rounding of the normalization does
+  const int Threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TCsrPageRank<TFlt> SerialPageRank(G);
+  SerialPageRank.Run(prGaussSeidel, 1e-10, 1000);
+  omp_set_num_threads(Threads);
+  for (int n = 0; n < G->GetNodes(); n++) {
+    EXPECT_NEAR(GsPageRank.GetRankV()[n], SerialPageRank.GetRankV()[n], 1e-15);
+  }
+#endif
+}
+
+// Test sparse matrix-vector products on CSR snapshots
+TEST(CentrTest, CsrAdjMul) {
+  TRnd Rnd(1);
+  PNGraph G = TSnap::GenRndGnm<PNGraph>(500, 3000, true, Rnd);
+  const PCsrGraph CsrG = TCsrGraph::New(G);
+  const int Nodes = CsrG->GetNodes();
+  // arc weights are a function of the endpoints
+  TVec<TFlt, int64> OutWgtV(CsrG->GetArcs()), InWgtV;
+  for (int n = 0; n < Nodes; n++) {
+    for (int e = 0; e < CsrG->GetOutDeg(n); e++) {
+      OutWgtV[CsrG->GetOutOff(n)+e] = n + 0.001*CsrG->GetOutNbr(n, e);
+    }
+  }
+  TSnap::GetCsrInWgtV(*CsrG, OutWgtV, InWgtV);
+  ASSERT_EQ(OutWgtV.Len(), InWgtV.Len());
+  for (int n = 0; n < Nodes; n++) {
+    for (int e = 0; e < CsrG->GetInDeg(n); e++) {
+      EXPECT_EQ(CsrG->GetInNbr(n, e) + 0.001*n, InWgtV[CsrG->GetInOff(n)+e]);
+    }
+  }
+  TFltV XV(Nodes), YV, YTV, ExpYV(Nodes), ExpYTV(Nodes);
+  for (int n = 0; n < Nodes; n++) { XV[n] = Rnd.GetUniDev(); }
+  TSnap::MulCsrAdj(*CsrG, XV, YV, OutWgtV);
+  TSnap::MulCsrAdjT(*CsrG, XV, YTV, InWgtV);
+  for (TNGraph::TEdgeI EI = G->BegEI(); EI < G->EndEI(); EI++) {
+    const int Src = CsrG->GetNIdx(EI.GetSrcNId()), Dst = CsrG->GetNIdx(EI.GetDstNId());
+    ExpYV[Src] += (Src + 0.001*Dst) * XV[Dst];
+    ExpYTV[Dst] += (Src + 0.001*Dst) * XV[Src];
+  }
+  for (int n = 0; n < Nodes; n++) {
+    EXPECT_NEAR(ExpYV[n], YV[n], 1e-9);
+    EXPECT_NEAR(ExpYTV[n], YTV[n], 1e-9);
+  }
+}
+
+// Test HITS, eigenvector and Katz centrality
+TEST(CentrTest, SpectralCentr) {
+  // star: the center is the only hub, leaves are equal authorities
+  PNGraph Star = TSnap::GenStar<PNGraph>(11, true);
+  TIntFltH HubH, AuthH;
+  TSnap::GetHits(Star, HubH, AuthH);
+  EXPECT_NEAR(1.0, HubH.GetDat(0), 1e-9);
+  EXPECT_NEAR(0.0, AuthH.GetDat(0), 1e-9);
+  for (int n = 1; n <= 10; n++) {
+    EXPECT_NEAR(0.0, HubH.GetDat(n), 1e-9);
+    EXPECT_NEAR(1.0/sqrt(10.0), AuthH.GetDat(n), 1e-9);
+  }
+
+  // all nodes of a complete graph are equally central
+  TIntFltH EigH;
+  TSnap::GetEigenVectorCentr(TSnap::GenFull<PUNGraph>(9), EigH);
+  EXPECT_EQ(9, EigH.Len());
+  for (int i = 0; i < EigH.Len(); i++) {
+    EXPECT_NEAR(1.0/3.0, EigH[i], 1e-9);
+  }
+
+  // path 0->1->2->3: Katz centralities are 1, 1+a, 1+a+a^2, 1+a+a^2+a^3
+  PNGraph Path = TNGraph::New();
+  for (int n = 0; n < 4; n++) { Path->AddNode(n); }
+  for (int n = 0; n < 3; n++) { Path->AddEdge(n, n+1); }
+  TIntFltH KatzH;
+  const int Iters = TSnap::GetKatzCentr(Path, KatzH, 0.5, 1.0, 1e-10);
+  EXPECT_TRUE(Iters <= 5);
+  EXPECT_NEAR(1.0, KatzH.GetDat(0), 1e-9);
+  EXPECT_NEAR(1.5, KatzH.GetDat(1), 1e-9);
+  EXPECT_NEAR(1.75, KatzH.GetDat(2), 1e-9);
+  EXPECT_NEAR(1.875, KatzH.GetDat(3), 1e-9);
+  // arc weights scale the contributions of in-neighbors
+  const PCsrGraph CsrPath = TCsrGraph::New(Path);
+  TVec<TFlt, int64> WgtV(CsrPath->GetArcs());
+  WgtV.PutAll(2.0);
+  TFltV KatzV;
+  TSnap::GetKatzCentr(*CsrPath, KatzV, 0.5, 1.0, 1e-10, 100, WgtV);
+  for (int n = 0; n < 4; n++) { EXPECT_NEAR(n+1.0, KatzV[n], 1e-9); }
+}
+
+// Test HITS and eigenvector centrality against scores of the implementations on TNGraph and TUNGraph
+// that preceded the CSR kernels
+TEST(CentrTest, SpectralCentrRegression) {
+  const int EdgeV[][2] = {
+    {1,2}, {1,3}, {2,3}, {3,1}, {3,4}, {4,5}, {5,3}, {5,6}, {6,7}, {7,5}, {7,8}, {8,9},
+    {9,7}, {2,9}, {10,1}, {10,4}, {10,7}, {11,10}, {12,3}, {12,11}, {4,12}, {6,2}, {8,1}, {9,10}
+  };
+  PNGraph G = TNGraph::New();
+  for (int i = 0; i < int(sizeof(EdgeV)/sizeof(EdgeV[0])); i++) {
+    if (!G->IsNode(EdgeV[i][0])) { G->AddNode(EdgeV[i][0]); }
+    if (!G->IsNode(EdgeV[i][1])) { G->AddNode(EdgeV[i][1]); }
+    G->AddEdge(EdgeV[i][0], EdgeV[i][1]);
+  }
+  ASSERT_EQ(12, G->GetNodes());
+  const double HubV[] = { 0.2394032493, 0.2487205590, 0.4141193429, 0.0000007245, 0.1780124554, 0.2933583285,
+    0.0000007245, 0.3380380016, 0.2539981033, 0.6150553175, 0.0530621286, 0.1780124554 };
+  const double AuthV[] = { 0.5680015162, 0.2221599930, 0.3533049456, 0.4274367784, 0.0000011611, 0.0745920316,
+    0.4829993271, 0.0000005805, 0.2445564519, 0.1275479539, 0.0745920316, 0.0000005805 };
+  TIntFltH HubH, AuthH;
+  TSnap::GetHits(G, HubH, AuthH);
+  for (int n = 1; n <= 12; n++) {
+    EXPECT_NEAR(HubV[n-1], HubH.GetDat(n), 1e-8);
+    EXPECT_NEAR(AuthV[n-1], AuthH.GetDat(n), 1e-8);
+  }
+
+  const PUNGraph UG = TSnap::ConvertGraph<PUNGraph>(G);
+  const double EigV[] = { 0.3059372455, 0.2976731978, 0.3472137663, 0.2964070543, 0.3075631292, 0.2388346681,
+    0.3580340644, 0.2411384181, 0.3086185872, 0.3478650958, 0.1340603558, 0.1928149018 };
+  TIntFltH EigH;
+  TSnap::GetEigenVectorCentr(UG, EigH);
+  for (int n = 1; n <= 12; n++) { EXPECT_NEAR(EigV[n-1], EigH.GetDat(n), 1e-8); }
+  // converged scores
+  const double ConvEigV[] = { 0.3059334266, 0.2976758339, 0.3472138327, 0.2964037659, 0.3075652937, 0.2388338040,
+    0.3580318163, 0.2411416126, 0.3086156365, 0.3478702356, 0.1340578903, 0.1928167883 };
+  TSnap::GetEigenVectorCentr(UG, EigH, 1e-10, 1000);
+  for (int n = 1; n <= 12; n++) { EXPECT_NEAR(ConvEigV[n-1], EigH.GetDat(n), 1e-8); }
+}
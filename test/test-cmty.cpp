@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// Generates Cmtys groups of CmtySz nodes, nodes in the same group link with probability PIn, other nodes with POut
+PUNGraph GenPlantedPartition(const int& Cmtys, const int& CmtySz, const double& PIn, const double& POut, TRnd& Rnd) {
+  PUNGraph G = TUNGraph::New();
+  const int Nodes = Cmtys*CmtySz;
+  for (int n = 0; n < Nodes; n++) { G->AddNode(n); }
+  for (int n1 = 0; n1 < Nodes; n1++) {
+    for (int n2 = n1+1; n2 < Nodes; n2++) {
+      if (Rnd.GetUniDev() < (n1/CmtySz == n2/CmtySz ? PIn : POut)) { G->AddEdge(n1, n2); }
+    }
+  }
+  return G;
+}
+
+// Checks that communities partition the nodes of G and that the returned modularity is correct
+void VerifyCmtyV(const PUNGraph& G, const TCnComV& CmtyV, const double& Q) {
+  TIntSet NIdSet;
+  for (int c = 0; c < CmtyV.Len(); c++) {
+    EXPECT_TRUE(CmtyV[c].Len() > 0);
+    for (int i = 0; i < CmtyV[c].Len(); i++) {
+      EXPECT_TRUE(G->IsNode(CmtyV[c][i]));
+      EXPECT_FALSE(NIdSet.IsKey(CmtyV[c][i]));
+      NIdSet.AddKey(CmtyV[c][i]);
+    }
+  }
+  EXPECT_EQ(G->GetNodes(), NIdSet.Len());
+  EXPECT_NEAR(TSnap::GetModularity(G, CmtyV), Q, 1e-9);
+}
+
+// Test Louvain and Leiden on two cliques joined by a single edge
+TEST(CmtyTest, LouvainTwoCliques) {
+  PUNGraph G = TUNGraph::New();
+  for (int n = 0; n < 20; n++) { G->AddNode(3*n+1); }
+  for (int n1 = 0; n1 < 20; n1++) {
+    for (int n2 = n1+1; n2 < 20; n2++) {
+      if (n1/10 == n2/10) { G->AddEdge(3*n1+1, 3*n2+1); }
+    }
+  }
+  G->AddEdge(1, 3*19+1);
+
+  TCnComV CmtyV;
+  double Q = TSnap::CommunityLouvain(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, Q);
+  EXPECT_EQ(2, CmtyV.Len());
+  EXPECT_EQ(10, CmtyV[0].Len());
+
+  Q = TSnap::CommunityLeiden(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, Q);
+  EXPECT_EQ(2, CmtyV.Len());
+  EXPECT_EQ(10, CmtyV[1].Len());
+}
+
+// Test that Louvain and Leiden find planted communities and match CNM modularity
+TEST(CmtyTest, LouvainLeiden) {
+  TRnd Rnd(1);
+  PUNGraph G = GenPlantedPartition(10, 50, 0.3, 0.01, Rnd);
+  TCnComV CmtyV, CnmCmtyV;
+  const double CnmQ = TSnap::CommunityCNM(G, CnmCmtyV);
+
+  const double LouvainQ = TSnap::CommunityLouvain(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, LouvainQ);
+  EXPECT_EQ(10, CmtyV.Len());
+  EXPECT_GE(LouvainQ, CnmQ - 1e-6);
+
+  const double LeidenQ = TSnap::CommunityLeiden(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, LeidenQ);
+  EXPECT_EQ(10, CmtyV.Len());
+  EXPECT_GE(LeidenQ, CnmQ - 1e-6);
+
+  // a sparse graph with isolated nodes and a self-loop, Leiden communities are connected
+  G = TSnap::GenRndGnm<PUNGraph>(3000, 4500, false, Rnd);
+  G->AddEdge(5, 5);
+  const double LeidenGnmQ = TSnap::CommunityLeiden(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, LeidenGnmQ);
+  EXPECT_GT(LeidenGnmQ, 0.5);
+  for (int c = 0; c < CmtyV.Len(); c++) {
+    TCnComV WccV;
+    TSnap::GetWccs(TSnap::GetSubGraph(G, CmtyV[c].NIdV), WccV);
+    EXPECT_EQ(1, WccV.Len());
+  }
+  VerifyCmtyV(G, CmtyV, TSnap::CommunityLouvain(G, CmtyV));
+
+  // higher resolution splits communities
+  TCnComV SmallCmtyV;
+  TSnap::CommunityLeiden(G, CmtyV, 0.5);
+  TSnap::CommunityLeiden(G, SmallCmtyV, 4.0);
+  EXPECT_GT(SmallCmtyV.Len(), CmtyV.Len());
+
+  // dense community ids on a CSR snapshot
+  const TCsrGraph Csr(G);
+  TIntV CmtyIdV;
+  const int Cmtys = TSnap::GetModularityCmtyIdV(Csr, CmtyIdV);
+  EXPECT_EQ(G->GetNodes(), CmtyIdV.Len());
+  for (int n = 0; n < CmtyIdV.Len(); n++) {
+    EXPECT_TRUE(0 <= CmtyIdV[n] && CmtyIdV[n] < Cmtys);
+  }
+}
+
+// Test label propagation and its seeded mode
+TEST(CmtyTest, LabelProp) {
+  TRnd Rnd(1);
+  PUNGraph G = GenPlantedPartition(10, 50, 0.3, 0.005, Rnd);
+  TCnComV CmtyV, SeedCmtyV;
+  double Q = TSnap::CommunityLabelProp(G, CmtyV);
+  VerifyCmtyV(G, CmtyV, Q);
+  EXPECT_EQ(10, CmtyV.Len());
+  EXPECT_EQ(50, CmtyV[0].Len());
+
+  // a few new edges and nodes do not change the planted communities
+  for (int n = 500; n < 505; n++) {
+    G->AddNode(n);
+    for (int i = 0; i < 5; i++) { G->AddEdge(n, 50*(n-500)+i); }
+  }
+  SeedCmtyV = CmtyV;
+  Q = TSnap::CommunityLabelProp(G, SeedCmtyV, TIntV(), CmtyV, 0.0);
+  VerifyCmtyV(G, CmtyV, Q);
+  EXPECT_EQ(10, CmtyV.Len());
+  EXPECT_EQ(51, CmtyV[0].Len());
+
+  // only changed nodes and their neighbors are revisited, so unchanged seeds are kept as they are
+  SeedCmtyV.Clr();
+  SeedCmtyV.Add(TCnCom());
+  for (int n = 0; n < 505; n++) { SeedCmtyV[0].Add(n); }
+  TSnap::CommunityLabelProp(G, SeedCmtyV, TIntV(), CmtyV, 0.0);
+  EXPECT_EQ(1, CmtyV.Len());
+  TIntV ChangedNIdV;
+  ChangedNIdV.Add(0);
+  TSnap::CommunityLabelProp(G, SeedCmtyV, ChangedNIdV, CmtyV, 0.0);
+  EXPECT_EQ(1, CmtyV.Len());
+
+  // nodes of the same community share a label, labels are dense
+  G = TSnap::GenRndGnm<PUNGraph>(2000, 6000, false, Rnd);
+  const TCsrGraph Csr(G);
+  TIntV CmtyIdV;
+  const int Cmtys = TSnap::GetLabelPropCmtyIdV(Csr, CmtyIdV);
+  EXPECT_EQ(G->GetNodes(), CmtyIdV.Len());
+  TIntSet CmtySet;
+  for (int n = 0; n < CmtyIdV.Len(); n++) { CmtySet.AddKey(CmtyIdV[n]); }
+  EXPECT_EQ(Cmtys, CmtySet.Len());
+  VerifyCmtyV(G, CmtyV, TSnap::CommunityLabelProp(G, CmtyV));
+}
@@ -257,6 +257,155 @@ TEST(CnComTest, DirectedDisconnected) {
   
 }
 
+#ifdef USE_OPENMP
+// Sorts nodes within components and components by size, as GetWccs() returns them
+void NormalizeCnComV(TCnComV& CnComV) {
+  for (int c = 0; c < CnComV.Len(); c++) {
+    CnComV[c].Sort();
+  }
+  CnComV.Sort(false);
+}
+
+// Compares parallel components on CSR snapshots to the sequential ones
+template <class PGraph>
+void TestParallelCnCom(const PGraph& G) {
+  TCnComV CnComV, CnComMPV;
+  GetWccs(G, CnComV);
+  GetWccsMP(G, CnComMPV);
+  NormalizeCnComV(CnComV);
+  EXPECT_TRUE(CnComV == CnComMPV);
+
+  TIntPrV SzCntV, SzCntMPV;
+  GetWccSzCnt(G, SzCntV);
+  GetWccSzCntMP(G, SzCntMPV);
+  EXPECT_TRUE(SzCntV == SzCntMPV);
+
+  GetSccs(G, CnComV);
+  GetSccsMP(G, CnComMPV);
+  NormalizeCnComV(CnComV);
+  EXPECT_TRUE(CnComV == CnComMPV);
+
+  GetSccSzCnt(G, SzCntV);
+  GetSccSzCntMP(G, SzCntMPV);
+  EXPECT_TRUE(SzCntV == SzCntMPV);
+
+  // dense component ids map back to the same components
+  const TCsrGraph Csr(G);
+  TIntV CompIdV;
+  const int Comps = GetWccIdV(Csr, CompIdV);
+  EXPECT_EQ(Csr.GetNodes(), CompIdV.Len());
+  GetWccs(G, CnComV);
+  EXPECT_EQ(CnComV.Len(), Comps);
+}
+
+// Compares parallel biconnected components to the sequential ones
+void TestParallelBiCon(const PUNGraph& G) {
+  TCnComV CnComV, CnComMPV;
+  GetBiCon(G, CnComV);
+  GetBiConMP(G, CnComMPV);
+  NormalizeCnComV(CnComV);
+  EXPECT_TRUE(CnComV == CnComMPV);
+
+  // GetArtPoints() handles only the first DFS root correctly, so compare on a connected graph
+  const PUNGraph WccG = GetMxWcc(G);
+  TIntV ArtNIdV, ArtNIdMPV;
+  GetArtPoints(WccG, ArtNIdV);
+  GetArtPointsMP(WccG, ArtNIdMPV);
+  ArtNIdV.Sort();  ArtNIdMPV.Sort();
+  EXPECT_TRUE(ArtNIdV == ArtNIdMPV);
+
+  TIntPrV EdgeV, EdgeMPV;
+  GetEdgeBridges(G, EdgeV);
+  GetEdgeBridgesMP(G, EdgeMPV);
+  EdgeV.Sort();
+  EXPECT_TRUE(EdgeV == EdgeMPV);
+}
+
+// Test parallel weakly and strongly connected components
+TEST(CnComTest, ParallelComponents) {
+  TestParallelCnCom(LoadEdgeList<PNGraph>(TStr::Fmt("%s/sample_cncom_ngraph.txt", DIRNAME)));
+  TestParallelCnCom(LoadEdgeList<PUNGraph>(TStr::Fmt("%s/sample_cncom_unpower.txt", DIRNAME)));
+  TestParallelCnCom(GenRndGnm<PNGraph>(2000, 2600));
+  TestParallelCnCom(GenRndGnm<PUNGraph>(2000, 1500));
+  TestParallelCnCom(GenForestFire(3000, 0.3, 0.2));
+
+  // node ids which are not 0...N-1
+  PNGraph G = GenRndGnm<PNGraph>(1000, 1800);
+  PNGraph G2 = TNGraph::New();
+  for (TNGraph::TEdgeI EI = G->BegEI(); EI < G->EndEI(); EI++) {
+    const int Src = 7*EI.GetSrcNId()+3, Dst = 7*EI.GetDstNId()+3;
+    if (! G2->IsNode(Src)) { G2->AddNode(Src); }
+    if (! G2->IsNode(Dst)) { G2->AddNode(Dst); }
+    G2->AddEdge(Src, Dst);
+  }
+  G2->AddNode(1);
+  TestParallelCnCom(G2);
+
+  // largest components
+  EXPECT_EQ(GetMxWcc(G2)->GetNodes(), int(GetMxWccSz(G2)*G2->GetNodes()+0.5));
+  EXPECT_EQ(GetMxScc(G2)->GetNodes(), int(GetMxSccSz(G2)*G2->GetNodes()+0.5));
+}
+
+// Test parallel strongly connected components on long chains, where coloring alone needs a round per scc
+TEST(CnComTest, ParallelSccChains) {
+  const int Len = 50000;
+  // a long directed path, every node is an scc by itself
+  PNGraph G = TNGraph::New();
+  for (int n = 0; n < Len; n++) {
+    G->AddNode(n);
+    if (n > 0) { G->AddEdge(n, n-1); }
+  }
+  TIntPrV SzCntV;
+  GetSccSzCntMP(G, SzCntV);
+  EXPECT_EQ(1, SzCntV.Len());
+  EXPECT_EQ(1, SzCntV[0].Val1);
+  EXPECT_EQ(Len, SzCntV[0].Val2);
+
+  // a path of 2-cycles directed towards smaller node ids and closed into a cycle of
+  // Len nodes at the end, trimming does not remove the 2-cycles
+  G = TNGraph::New();
+  for (int n = 0; n < 2*Len; n++) { G->AddNode(n); }
+  for (int p = 0; p < Len/2; p++) {
+    G->AddEdge(2*p, 2*p+1);  G->AddEdge(2*p+1, 2*p);
+    if (p > 0) { G->AddEdge(2*p, 2*p-1); }
+  }
+  G->AddEdge(Len, Len-1);
+  for (int n = Len; n < 2*Len; n++) { G->AddEdge(n, n+1 < 2*Len ? n+1 : Len); }
+  GetSccSzCntMP(G, SzCntV);
+  EXPECT_EQ(2, SzCntV.Len());
+  EXPECT_EQ(2, SzCntV[0].Val1);
+  EXPECT_EQ(Len/2, SzCntV[0].Val2);
+  EXPECT_EQ(Len, SzCntV[1].Val1);
+  EXPECT_EQ(1, SzCntV[1].Val2);
+  TestParallelCnCom(G);
+}
+
+// Test parallel biconnected components, articulation points and bridges
+TEST(CnComTest, ParallelBiConnected) {
+  TestParallelBiCon(LoadEdgeList<PUNGraph>(TStr::Fmt("%s/sample_cncom_unpower.txt", DIRNAME)));
+  TestParallelBiCon(ConvertGraph<PUNGraph>(LoadEdgeList<PNGraph>(TStr::Fmt("%s/sample_cncom_ngraph.txt", DIRNAME))));
+  TestParallelBiCon(GenRndGnm<PUNGraph>(2000, 2200));
+  TestParallelBiCon(GenRndGnm<PUNGraph>(500, 3000));
+  TestParallelBiCon(ConvertGraph<PUNGraph>(GenForestFire(3000, 0.3, 0.2)));
+  TestParallelBiCon(GenFull<PUNGraph>(50));
+  TestParallelBiCon(GenStar<PUNGraph>(50));
+
+  // a long path with a cycle at each end
+  PUNGraph G = TUNGraph::New();
+  for (int n = 0; n < 10000; n++) {
+    G->AddNode(n);
+    if (n > 0) { G->AddEdge(n-1, n); }
+  }
+  G->AddEdge(0, 2);  G->AddEdge(9999, 9997);
+  TIntPrV EdgeV;
+  GetEdgeBridgesMP(G, EdgeV);
+  EXPECT_EQ(9999-4, EdgeV.Len());
+  TIntV ArtNIdV;
+  GetArtPointsMP(G, ArtNIdV);
+  EXPECT_EQ(9999-4+1, ArtNIdV.Len());
+}
+#endif
+
 // Test connected components on full graphs of each type
 TEST(CnComTest, CompleteGraph) {
   
@@ -44,3 +44,51 @@ TEST(FlowTest, BasicTest) {
   EXPECT_EQ (PRFlow3, 2074);
   EXPECT_EQ (PRFlow4, 0);
 }
+
+// Test the flow network object against Edmonds-Karp, min-cut capacities and batched queries
+TEST(FlowTest, FlowNet) {
+  PNEANet Net;
+  BuildCapacityNetwork("flow/small_sample.txt", Net);
+  PFlowNet FlowNet = TFlowNet::New(Net);
+  EXPECT_EQ(Net->GetNodes(), FlowNet->GetNodes());
+  EXPECT_EQ(1735, FlowNet->GetMaxFlow(53, 2));
+  EXPECT_EQ(3959, FlowNet->GetMaxFlow(86, 77));
+  EXPECT_EQ(2074, FlowNet->GetMaxFlow(62, 81));
+  EXPECT_EQ(0, FlowNet->GetMaxFlow(92, 92));
+
+  // random networks with parallel and antiparallel edges
+  TRnd Rnd(1);
+  for (int t = 0; t < 5; t++) {
+    PNEANet RndNet = TNEANet::New();
+    for (int n = 0; n < 60; n++) { RndNet->AddNode(3*n); }
+    for (int e = 0; e < 300; e++) {
+      const int EId = RndNet->AddEdge(3*Rnd.GetUniDevInt(60), 3*Rnd.GetUniDevInt(60));
+      RndNet->AddIntAttrDatE(EId, Rnd.GetUniDevInt(100), TSnap::CapAttrName);
+    }
+    PFlowNet RndFlowNet = TFlowNet::New(RndNet);
+    TIntPrV SrcSnkNIdPrV;
+    for (int q = 0; q < 20; q++) { SrcSnkNIdPrV.Add(TIntPr(3*Rnd.GetUniDevInt(60), 3*Rnd.GetUniDevInt(60))); }
+    TVec<TInt64> FlowV;
+    TVec<TIntV> SrcSideNIdVV;
+    RndFlowNet->GetMaxFlowBatch(SrcSnkNIdPrV, FlowV, &SrcSideNIdVV);
+    ASSERT_EQ(SrcSnkNIdPrV.Len(), FlowV.Len());
+    for (int q = 0; q < SrcSnkNIdPrV.Len(); q++) {
+      const int SrcNId = SrcSnkNIdPrV[q].Val1, SnkNId = SrcSnkNIdPrV[q].Val2;
+      EXPECT_EQ(TSnap::GetMaxFlowIntEK(RndNet, SrcNId, SnkNId), FlowV[q]);
+      TIntV SrcSideNIdV, CutEIdV;
+      EXPECT_EQ(FlowV[q], RndFlowNet->GetMinCut(SrcNId, SnkNId, SrcSideNIdV, CutEIdV));
+      EXPECT_EQ(SrcSideNIdV, SrcSideNIdVV[q]);
+      if (SrcNId == SnkNId) { continue; }
+      EXPECT_TRUE(SrcSideNIdV.IsIn(SrcNId));
+      EXPECT_FALSE(SrcSideNIdV.IsIn(SnkNId));
+      // cut edges go from the source side to the sink side and their capacities sum to the flow
+      int64 CutCap = 0;
+      for (int e = 0; e < CutEIdV.Len(); e++) {
+        const TNEANet::TEdgeI EI = RndNet->GetEI(CutEIdV[e]);
+        EXPECT_TRUE(SrcSideNIdV.IsIn(EI.GetSrcNId()) && ! SrcSideNIdV.IsIn(EI.GetDstNId()));
+        CutCap += RndNet->GetIntAttrDatE(EI, TSnap::CapAttrName);
+      }
+      EXPECT_EQ(FlowV[q], CutCap);
+    }
+  }
+}
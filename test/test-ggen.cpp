@@ -888,6 +888,59 @@ TEST(GGenTest, GenRMat) {
   } // end loop - NNodes
 }
 
+// Test parallel generation of RMat graph
+TEST(GGenTest, GenRMatMP) {
+  const int NNodes = 1000;
+  const int NEdges = 20000;
+
+  PNGraph Graph = TSnap::GenRMatMP(NNodes, NEdges, 0.45, 0.15, 0.15, 5);
+  EXPECT_TRUE(Graph->IsOk());
+  EXPECT_EQ(NNodes, Graph->GetNodes());
+  EXPECT_EQ(NEdges, Graph->GetEdges());
+  for (TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+    EXPECT_NE(EI.GetSrcNId(), EI.GetDstNId());
+  }
+
+  // same seed gives the same graph, a different seed a different one
+  PNGraph Graph2 = TSnap::GenRMatMP(NNodes, NEdges, 0.45, 0.15, 0.15, 5);
+  PNGraph Graph3 = TSnap::GenRMatMP(NNodes, NEdges, 0.45, 0.15, 0.15, 6);
+  int Diff2 = 0, Diff3 = 0;
+  for (TNGraph::TEdgeI EI = Graph->BegEI(); EI < Graph->EndEI(); EI++) {
+    if (! Graph2->IsEdge(EI.GetSrcNId(), EI.GetDstNId())) { Diff2++; }
+    if (! Graph3->IsEdge(EI.GetSrcNId(), EI.GetDstNId())) { Diff3++; }
+  }
+  EXPECT_EQ(0, Diff2);
+  EXPECT_LT(0, Diff3);
+
+  // streamed edges are the draws of GenRMatMP(), including duplicates
+  const TStr TxtFNm = "test-GenRMatMP.txt", BinFNm = "test-GenRMatMP.bin";
+  TSnap::SaveRMatMP(TxtFNm, NNodes, NEdges, 0.45, 0.15, 0.15, false, 5);
+  TSnap::SaveRMatMP(BinFNm, NNodes, NEdges, 0.45, 0.15, 0.15, true, 5);
+  int Lines = 0, NotInGraph = 0;
+  {
+    TSsParser Ss(TxtFNm, ssfTabSep);
+    while (Ss.Next()) {
+      if (Ss.GetFld(0)[0] == '#') { continue; }
+      Lines++;
+      if (! Graph->IsEdge(Ss.GetInt(0), Ss.GetInt(1))) { NotInGraph++; }
+    }
+  }
+  EXPECT_EQ(NEdges, Lines);
+  EXPECT_EQ(0, NotInGraph);
+  int Bin = 0, SrcNId = 0, DstNId = 0;
+  {
+    TFIn FIn(BinFNm);
+    EXPECT_EQ(NEdges*2*(int)sizeof(int), FIn.Len());
+    while (! FIn.Eof()) {
+      FIn.Load(SrcNId);  FIn.Load(DstNId);
+      if (Graph->IsEdge(SrcNId, DstNId)) { Bin++; }
+    }
+  }
+  EXPECT_EQ(NEdges, Bin);
+  remove(TxtFNm.CStr());
+  remove(BinFNm.CStr());
+}
+
 template <class PGraph> void TestRewire(const PGraph& Graph) {
   PGraph GraphOut;
   TIntPrV DegToCntV;
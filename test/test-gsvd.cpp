@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+
+// Returns the largest L2 norm of M*v - Val*v over eigenpairs (Val, v)
+double GetMxEigResid(const TCsrGraphMtx& Mtx, const TFltV& EigValV, const TVec<TFltV>& EigVecV) {
+  double MxResid = 0.0;
+  for (int v = 0; v < EigVecV.Len(); v++) {
+    TVec<TFlt, int64> XV(EigVecV[v].Len()), YV;
+    for (int n = 0; n < XV.Len(); n++) { XV[n] = EigVecV[v][n]; }
+    Mtx.Multiply(XV, YV);
+    double Resid = 0.0;
+    for (int n = 0; n < XV.Len(); n++) { Resid += TMath::Sqr(YV[n] - EigValV[v]*XV[n]); }
+    MxResid = TMath::Mx(MxResid, sqrt(Resid));
+  }
+  return MxResid;
+}
+
+// Test Lanczos eigenvalues and eigenvectors on graphs with known spectra
+TEST(GSvdTest, EigLanczos) {
+  TFltV EigValV;
+  TVec<TFltV> EigVecV;
+  // cycle: eigenvalues 2cos(2 pi k/n)
+  const int Nodes = 200;
+  TCsrGraphMtx CycleMtx(TCsrGraph::New(TSnap::GenCircle<PUNGraph>(Nodes, 1, false)));
+  TSnap::GetEigLanczos(CycleMtx, 5, EigValV, &EigVecV, Nodes, 5);
+  ASSERT_EQ(5, EigValV.Len());
+  // eigenvalues are ordered by magnitude: 2 (k=0) and -2 (k=n/2), then 2cos(2 pi/n) (k=1, n-1)
+  TFltV MagV;
+  for (int i = 0; i < 5; i++) { MagV.Add(fabs(EigValV[i])); }
+  MagV.Sort(false);
+  EXPECT_NEAR(2.0, MagV[0], 1e-8);
+  EXPECT_NEAR(2.0, MagV[1], 1e-8);
+  EXPECT_NEAR(2.0*cos(2.0*TMath::Pi/Nodes), MagV[2], 1e-6);
+  EXPECT_TRUE(GetMxEigResid(CycleMtx, EigValV, EigVecV) < 1e-4);
+
+  // star: +-sqrt(n-1)
+  TCsrGraphMtx StarMtx(TCsrGraph::New(TSnap::GenStar<PUNGraph>(50, false)));
+  TSnap::GetEigLanczos(StarMtx, 2, EigValV, &EigVecV);
+  ASSERT_EQ(2, EigValV.Len());
+  EXPECT_NEAR(7.0, fabs(EigValV[0]), 1e-8);
+  EXPECT_NEAR(-EigValV[0], EigValV[1], 1e-8);
+  EXPECT_TRUE(GetMxEigResid(StarMtx, EigValV, EigVecV) < 1e-6);
+
+  // Laplacian of a path: 2 - 2cos(pi k/n)
+  PUNGraph Path = TUNGraph::New();
+  for (int n = 0; n < Nodes; n++) { Path->AddNode(n); }
+  for (int n = 0; n < Nodes-1; n++) { Path->AddEdge(n, n+1); }
+  TCsrGraphMtx LapMtx(TCsrGraph::New(Path), true);
+  TSnap::GetEigLanczos(LapMtx, 3, EigValV, &EigVecV, Nodes);
+  for (int k = 0; k < 3; k++) {
+    EXPECT_NEAR(2.0 - 2.0*cos(TMath::Pi*(Nodes-1-k)/Nodes), EigValV[k], 1e-6);
+  }
+
+  // all eigenvalues of a small graph, eigenvectors are orthogonal
+  TRnd Rnd(1);
+  PUNGraph G = TSnap::GenRndGnm<PUNGraph>(60, 200, false, Rnd);
+  TCsrGraphMtx GMtx(TCsrGraph::New(G));
+  const int Steps = TSnap::GetEigLanczos(GMtx, 60, EigValV, &EigVecV, 60);
+  EXPECT_TRUE(Steps <= 60);
+  double Trace2 = 0.0;
+  for (int i = 0; i < EigValV.Len(); i++) { Trace2 += TMath::Sqr(EigValV[i]); }
+  // trace of A^2 is twice the number of edges
+  EXPECT_NEAR(2.0*G->GetEdges(), Trace2, 1e-8);
+  EXPECT_TRUE(GetMxEigResid(GMtx, EigValV, EigVecV) < 1e-4);
+  for (int i = 0; i < EigVecV.Len(); i++) {
+    for (int j = 0; j < i; j++) { EXPECT_NEAR(0.0, TLinAlg::DotProduct(EigVecV[i], EigVecV[j]), 1e-4); }
+  }
+
+  // thick restarts with a small basis find the same eigenpairs as an unrestarted iteration
+  PUNGraph BigG = TSnap::GenRndGnm<PUNGraph>(2000, 10000, false, Rnd);
+  TCsrGraphMtx BigMtx(TCsrGraph::New(BigG));
+  TFltV FullValV;
+  TVec<TFltV> FullVecV;
+  TSnap::GetEigLanczos(BigMtx, 20, FullValV, &FullVecV, 400, 10, 0, 400);
+  TSnap::GetEigLanczos(BigMtx, 20, EigValV, &EigVecV, 2000, 10, 0, 40);
+  ASSERT_EQ(20, EigValV.Len());
+  for (int i = 0; i < 20; i++) { EXPECT_NEAR(FullValV[i], EigValV[i], 1e-6); }
+  EXPECT_TRUE(GetMxEigResid(BigMtx, EigValV, EigVecV) < 1e-4);
+  for (int i = 0; i < EigVecV.Len(); i++) {
+    for (int j = 0; j < i; j++) { EXPECT_NEAR(0.0, TLinAlg::DotProduct(EigVecV[i], EigVecV[j]), 1e-6); }
+  }
+
+  // graph wrappers
+  TSnap::GetEigVals(G, 5, EigValV);
+  ASSERT_EQ(5, EigValV.Len());
+  for (int i = 1; i < EigValV.Len(); i++) { EXPECT_TRUE(EigValV[i-1] >= EigValV[i]); }
+  TFltV EigVec;
+  TSnap::GetEigVec(G, EigVec);
+  EXPECT_EQ(G->GetNodes(), EigVec.Len());
+  for (int n = 0; n < EigVec.Len(); n++) { EXPECT_TRUE(EigVec[n] >= -1e-9); }
+}
+
+// Test randomized SVD against the full SVD of a small directed graph
+TEST(GSvdTest, SvdRnd) {
+  TRnd Rnd(1);
+  PNGraph G = TSnap::GenRndGnm<PNGraph>(80, 400, true, Rnd);
+  TFltV SngValV, ExactSngValV;
+  TVec<TFltV> LeftSV, RightSV;
+  TSnap::GetSngVals(G, 10, ExactSngValV);   // full SVD for less than 100 nodes
+  const PCsrGraph CsrG = TCsrGraph::New(G);
+  TCsrGraphMtx Mtx(CsrG);
+  // the block spans the whole space
+  TSnap::GetSvdRnd(Mtx, 10, SngValV, LeftSV, RightSV, 80, 0, Rnd);
+  ASSERT_EQ(10, SngValV.Len());
+  for (int i = 0; i < 10; i++) { EXPECT_NEAR(ExactSngValV[i], SngValV[i], 1e-8); }
+  // a small block with power iterations
+  TSnap::GetSvdRnd(Mtx, 3, SngValV, LeftSV, RightSV, 20, 6, Rnd);
+  ASSERT_EQ(3, SngValV.Len());
+  EXPECT_NEAR(ExactSngValV[0], SngValV[0], 1e-6);
+  EXPECT_NEAR(ExactSngValV[1], SngValV[1], 1e-2);
+  // M*v = s*u
+  TVec<TFlt, int64> XV(80), YV;
+  for (int n = 0; n < 80; n++) { XV[n] = RightSV[0][n]; }
+  Mtx.Multiply(XV, YV);
+  for (int n = 0; n < 80; n++) { EXPECT_NEAR(SngValV[0]*LeftSV[0][n], YV[n], 1e-5); }
+}
+
+// Test that singular values of larger graphs come from Lanczos unless randomized SVD is requested
+TEST(GSvdTest, SngValsRndSvd) {
+  TRnd Rnd(1);
+  PNGraph G = TSnap::GenRndGnm<PNGraph>(600, 6000, true, Rnd);
+  TFltV SngValV, RndSngValV;
+  TSnap::GetSngVals(G, 3, SngValV);
+  TSnap::GetSngVals(G, 3, RndSngValV, true);
+  ASSERT_TRUE(SngValV.Len() >= 1 && RndSngValV.Len() >= 1);
+  EXPECT_NEAR(SngValV[0], RndSngValV[0], 1e-3*SngValV[0]);
+  TFltV LeftSV, RightSV, RndLeftSV, RndRightSV;
+  TSnap::GetSngVec(G, LeftSV, RightSV);
+  TSnap::GetSngVec(G, RndLeftSV, RndRightSV, true);
+  ASSERT_EQ(LeftSV.Len(), RndLeftSV.Len());
+  double Dot = 0.0;
+  for (int n = 0; n < LeftSV.Len(); n++) { Dot += LeftSV[n] * RndLeftSV[n]; }
+  EXPECT_NEAR(1.0, fabs(Dot), 1e-3);
+}
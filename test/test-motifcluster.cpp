@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "Snap.h"
+#include "motifcluster.h"
+
+class MotifClusterTest { };  // For gtest highlighting
+
+static const MotifType DirMotifs[] = {
+  M1, M2, M3, M4, M5, M6, M7, M8, M9, M10, M11, M12, M13, edge
+};
+static const int NDirMotifs = sizeof(DirMotifs) / sizeof(DirMotifs[0]);
+
+// Checks that the parallel CSR motif adjacency matches the one built from
+// the hash table weights
+static void CheckCsrAdjacency(PNGraph Graph, MotifType Motif) {
+  TWeightCsr Csr, Expected;
+  MotifCluster::MotifAdjacency(Graph, Motif, Csr);
+  WeightVH WeightsVH;
+  MotifCluster::MotifAdjacency(Graph, Motif, WeightsVH);
+  MotifCluster::WeightsToCsr(WeightsVH, Expected);
+  ASSERT_EQ(Expected.num_rows(), Csr.num_rows());
+  for (int Row = 0; Row <= Csr.num_rows(); Row++) {
+    ASSERT_EQ(Expected.offsets[Row], Csr.offsets[Row])
+      << "motif " << Motif << " row " << Row;
+  }
+  for (int64 i = 0; i < Csr.cols.Len(); i++) {
+    EXPECT_EQ(Expected.cols[i], Csr.cols[i]) << "motif " << Motif;
+    EXPECT_DOUBLE_EQ(Expected.vals[i], Csr.vals[i]) << "motif " << Motif;
+  }
+}
+
+// Motif adjacency of a small directed graph whose last nodes have no edges
+// other than self-loops
+TEST(MotifClusterTest, CsrAdjacencyTrailingIsolated) {
+  PNGraph Graph = TNGraph::New();
+  for (int i = 0; i < 9; i++) { Graph->AddNode(i); }
+  Graph->AddEdge(0, 1);
+  Graph->AddEdge(1, 0);
+  Graph->AddEdge(1, 2);
+  Graph->AddEdge(2, 0);
+  Graph->AddEdge(0, 3);
+  Graph->AddEdge(3, 4);
+  Graph->AddEdge(4, 3);
+  Graph->AddEdge(2, 4);
+  Graph->AddEdge(5, 4);
+  Graph->AddEdge(4, 6);
+  Graph->AddEdge(6, 1);
+  Graph->AddEdge(7, 7);
+  for (int i = 0; i < NDirMotifs; i++) {
+    CheckCsrAdjacency(Graph, DirMotifs[i]);
+  }
+}
+
+// Motif adjacency of graphs without edges
+TEST(MotifClusterTest, CsrAdjacencyEdgeless) {
+  PNGraph Graph = TNGraph::New();
+  for (int i = 0; i < NDirMotifs; i++) {
+    CheckCsrAdjacency(Graph, DirMotifs[i]);
+  }
+  for (int i = 0; i < 5; i++) { Graph->AddNode(i); }
+  for (int i = 0; i < NDirMotifs; i++) {
+    TWeightCsr Csr;
+    MotifCluster::MotifAdjacency(Graph, DirMotifs[i], Csr);
+    EXPECT_EQ(0, Csr.cols.Len());
+    CheckCsrAdjacency(Graph, DirMotifs[i]);
+  }
+}
+
+// Wedge motif weights on a random graph with many wedges per node pair
+TEST(MotifClusterTest, CsrAdjacencyWedges) {
+  TInt::Rnd.PutSeed(1);
+  PNGraph Graph = TSnap::GenRndGnm<PNGraph>(200, 3000);
+  for (int i = 0; i < NDirMotifs; i++) {
+    CheckCsrAdjacency(Graph, DirMotifs[i]);
+  }
+}
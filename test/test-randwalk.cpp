@@ -36,3 +36,61 @@ TEST(RandWalkTest, CorrectOnLineGraph) {
     EXPECT_TRUE( relError < 0.2);
   }
 }
+
+TEST(RandWalkTest, BatchOnCycleGraph) {
+  // on a directed cycle ppr(s, s+i) = JumpProb (1-JumpProb)^i / (1 - (1-JumpProb)^n)
+  const int Nodes = 50;
+  const double JumpProb = 0.2;
+  PNGraph Graph = TNGraph::New();
+  for (int i = 0; i < Nodes; i++) {
+    Graph->AddNode(i);
+  }
+  for (int i = 0; i < Nodes; i++) {
+    Graph->AddEdge(i, (i + 1) % Nodes);
+  }
+  TIntV SeedV;
+  for (int i = Nodes - 1; i >= 0; i--) {
+    SeedV.Add(i);
+  }
+  TVec<TIntFltKdV> TopNV;
+  TSnap::GetPersonalizedPageRankBatch(Graph, SeedV, TopNV, JumpProb, 5, 1e-9);
+  ASSERT_EQ(SeedV.Len(), TopNV.Len());
+  const double Norm = 1.0 - pow(1.0 - JumpProb, Nodes);
+  for (int s = 0; s < SeedV.Len(); s++) {
+    ASSERT_EQ(5, TopNV[s].Len());
+    for (int i = 0; i < TopNV[s].Len(); i++) {
+      EXPECT_EQ((SeedV[s] + i) % Nodes, TopNV[s][i].Key);
+      EXPECT_NEAR(JumpProb * pow(1.0 - JumpProb, i) / Norm, TopNV[s][i].Dat, 1e-6);
+    }
+  }
+}
+
+TEST(RandWalkTest, BatchMatchesBidirectional) {
+  PNGraph Graph = TSnap::LoadEdgeList<PNGraph>("randwalk/test_graph.txt", false);
+  TIntV SeedV;
+  for (TNGraph::TNodeI NI = Graph->BegNI(); NI < Graph->EndNI(); NI++) {
+    SeedV.Add(NI.GetId());
+  }
+  TVec<TIntFltKdV> TopNV;
+  TSnap::GetPersonalizedPageRankBatch(Graph, SeedV, TopNV, 0.2, Graph->GetNodes(), 1e-9);
+  for (int s = 0; s < SeedV.Len(); s++) {
+    double Sum = 0.0;
+    for (int i = 0; i < TopNV[s].Len(); i++) {
+      Sum += TopNV[s][i].Dat;
+      if (i > 0) { EXPECT_TRUE(TopNV[s][i-1].Dat >= TopNV[s][i].Dat); }
+    }
+    EXPECT_NEAR(1.0, Sum, 1e-5);
+  }
+  FILE* TruePPRFile = fopen("randwalk/test_pprs.txt", "r");
+  int S, T;
+  float TruePPR;
+  while (fscanf(TruePPRFile, "%d %d %f", &S, &T, &TruePPR) == 3) {
+    const TIntFltKdV& TopN = TopNV[SeedV.SearchForw(S)];
+    double Estimate = 0.0;
+    for (int i = 0; i < TopN.Len(); i++) {
+      if (TopN[i].Key == T) { Estimate = TopN[i].Dat; }
+    }
+    EXPECT_NEAR(TruePPR, Estimate, 1e-4);
+  }
+  fclose(TruePPRFile);
+}
@@ -471,6 +471,82 @@ TEST(triad, TestGetLen2Paths) {
   }
 }
 
+// Test streaming triangle estimation
+TEST(triad, TestTriadStreamEst) {
+  PUNGraph GraphTUN = TriadGetTestTUNGraph();
+
+  // the reservoir holds all edges, estimates are exact
+  TTriadStreamEst TriadEst(100, 2);
+  for (TUNGraph::TEdgeI EI = GraphTUN->BegEI(); EI < GraphTUN->EndEI(); EI++) {
+    EXPECT_TRUE(TriadEst.AddEdge(EI.GetSrcNId(), EI.GetDstNId()));
+  }
+  EXPECT_FALSE(TriadEst.AddEdge(1, 1));
+  EXPECT_EQ(GraphTUN->GetEdges(), TriadEst.GetEdges());
+  EXPECT_EQ(GraphTUN->GetNodes(), TriadEst.GetNodes());
+
+  double LowCnt, HighCnt;
+  EXPECT_DOUBLE_EQ(3.0, TriadEst.GetTriangles(LowCnt, HighCnt));
+  EXPECT_DOUBLE_EQ(3.0, LowCnt);
+  EXPECT_DOUBLE_EQ(3.0, HighCnt);
+  for (TUNGraph::TNodeI NI = GraphTUN->BegNI(); NI < GraphTUN->EndNI(); NI++) {
+    EXPECT_DOUBLE_EQ(TSnap::GetNodeTriads(GraphTUN, NI.GetId()), TriadEst.GetNodeTriangles(NI.GetId()));
+    EXPECT_NEAR(TSnap::GetNodeClustCf(GraphTUN, NI.GetId()), TriadEst.GetNodeClustCf(NI.GetId()), 1e-6);
+  }
+  EXPECT_DOUBLE_EQ(18.0, TriadEst.GetWedges());
+  EXPECT_DOUBLE_EQ(0.5, TriadEst.GetGlobalClustCf());
+  EXPECT_NEAR(TSnap::GetClustCf(GraphTUN), TriadEst.GetClustCf(), 1e-6);
+
+  // stream the same graph from an edge list file
+  TSnap::SaveEdgeList(GraphTUN, "test.triadstream.dat");
+  TTriadStreamEst FileEst(100, 2);
+  EXPECT_EQ(GraphTUN->GetEdges(), FileEst.AddEdgeList("test.triadstream.dat"));
+  EXPECT_DOUBLE_EQ(3.0, FileEst.GetTriangles());
+
+  // the reservoir holds a sample only, the estimate is unbiased
+  PUNGraph GraphFF = TSnap::ConvertGraph<PUNGraph>(TSnap::GenForestFire(1000, 0.35, 0.35));
+  const int64 Triads = TSnap::GetTriads(GraphFF);
+  double SumCnt = 0;
+  const int Runs = 20;
+  for (int r = 0; r < Runs; r++) {
+    TTriadStreamEst SampleEst(GraphFF->GetEdges()/2, 2, 1+2*r);
+    for (TUNGraph::TEdgeI EI = GraphFF->BegEI(); EI < GraphFF->EndEI(); EI++) {
+      SampleEst.AddEdge(EI.GetSrcNId(), EI.GetDstNId());
+    }
+    SumCnt += SampleEst.GetTriangles();
+  }
+  EXPECT_NEAR(1.0, SumCnt / Runs / double(Triads), 0.1);
+
+  // repeated and reciprocal edges are skipped
+  TTriadStreamEst DupEst(100, 2, 1, true);
+  for (TUNGraph::TEdgeI EI = GraphTUN->BegEI(); EI < GraphTUN->EndEI(); EI++) {
+    EXPECT_TRUE(DupEst.AddEdge(EI.GetSrcNId(), EI.GetDstNId()));
+    EXPECT_FALSE(DupEst.AddEdge(EI.GetSrcNId(), EI.GetDstNId()));
+    EXPECT_FALSE(DupEst.AddEdge(EI.GetDstNId(), EI.GetSrcNId()));
+  }
+  EXPECT_EQ(GraphTUN->GetEdges(), DupEst.GetEdges());
+  EXPECT_DOUBLE_EQ(3.0, DupEst.GetTriangles());
+  EXPECT_DOUBLE_EQ(18.0, DupEst.GetWedges());
+
+  // without skipping, evicting one copy of a repeated edge keeps the sampled adjacency of the others,
+  // so a graph without triangles never gets any
+  PUNGraph GraphGrid = TSnap::GenGrid<PUNGraph>(10, 10, false);
+  EXPECT_EQ(0, TSnap::GetTriads(GraphGrid));
+  TTriadStreamEst RepEst(20, 2);
+  for (int r = 0; r < 20; r++) {
+    for (TUNGraph::TEdgeI EI = GraphGrid->BegEI(); EI < GraphGrid->EndEI(); EI++) {
+      EXPECT_TRUE(RepEst.AddEdge(EI.GetSrcNId(), EI.GetDstNId()));
+      EXPECT_TRUE(RepEst.AddEdge(EI.GetDstNId(), EI.GetSrcNId()));
+      EXPECT_FALSE(RepEst.AddEdge(EI.GetSrcNId(), EI.GetSrcNId()));
+    }
+  }
+  EXPECT_EQ(2*20*GraphGrid->GetEdges(), RepEst.GetEdges());
+  EXPECT_DOUBLE_EQ(0.0, RepEst.GetTriangles());
+  TIntFltH NIdTriadH;
+  RepEst.GetNodeTriangles(NIdTriadH);
+  EXPECT_EQ(0, NIdTriadH.Len());
+  remove("test.triadstream.dat");
+}
+
 // Helper: Testing Opened/Closed Triads for Specific Generated Graph
 void TestOpenCloseVector(TIntTrV& NIdCOTriadV) {
   for (TIntTr *Vec = NIdCOTriadV.BegI(); Vec < NIdCOTriadV.EndI(); Vec++) {